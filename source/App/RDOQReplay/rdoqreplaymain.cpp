@@ -0,0 +1,389 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     rdoqreplaymain.cpp
+    \brief    Replays the RDOQ calls dumped by an encoder built with DEBUG_RDOQ_DUMP_TUS, with and without the all-zero
+              coefficient group fast path, and compares and times both
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <vector>
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComTU.h"
+#include "TLibCommon/TComTrQuant.h"
+
+//! \ingroup RDOQReplay
+//! \{
+
+/// result of the RDOQ of a TU
+struct RDOQResult
+{
+  TCoeff levels   [MAX_TU_SIZE * MAX_TU_SIZE];
+  TCoeff arlLevels[MAX_TU_SIZE * MAX_TU_SIZE];
+  TCoeff absSum;
+  Double bestCost;
+  Double seconds;                               ///< time of one RDOQ call
+};
+
+/// timings of the TUs of one component and size
+struct RDOQTimings
+{
+  RDOQTimings() : numTUs(0), generalSeconds(0), fastPathSeconds(0) {}
+  UInt   numTUs;
+  Double generalSeconds;
+  Double fastPathSeconds;
+};
+
+/// one-CTU picture with the parameter sets of the dumped TUs, and the quantiser replaying them
+class RDOQReplayContext
+{
+public:
+  RDOQReplayContext() : m_pcPic(NULL) { memset( &m_params, 0, sizeof(m_params) ); }
+  ~RDOQReplayContext() { xDestroy(); }
+
+  Bool replay( const RDOQDumpRecord &record, TCoeff *coeff, const Bool useZeroCGFastPath, const Int numRuns, RDOQResult &result );
+
+private:
+  Void xInit   ( const RDOQDumpRecord &record );
+  Void xDestroy();
+  Bool xReplayTU( TComTU &rTu, const UInt trDepth, const RDOQDumpRecord &record, TCoeff *coeff, const Bool useZeroCGFastPath, const Int numRuns, RDOQResult &result );
+
+  RDOQDumpRecord m_params;                      ///< sequence-level parameters of the current picture
+  TComSPS        m_sps;
+  TComPPS        m_pps;
+  TComPic*       m_pcPic;
+  TComTrQuant    m_trQuant;
+};
+
+/** Returns true if the sequence-level parameters of two records differ.
+ */
+static Bool isNewSequence( const RDOQDumpRecord &a, const RDOQDumpRecord &b )
+{
+  return a.chromaFormat != b.chromaFormat || a.bitDepths[CHANNEL_TYPE_LUMA] != b.bitDepths[CHANNEL_TYPE_LUMA] || a.bitDepths[CHANNEL_TYPE_CHROMA] != b.bitDepths[CHANNEL_TYPE_CHROMA]
+      || a.maxCUSize != b.maxCUSize || a.extendedPrecision != b.extendedPrecision || a.persistentRiceAdaptation != b.persistentRiceAdaptation
+      || a.transformSkipContext != b.transformSkipContext || a.signDataHiding != b.signDataHiding || a.adaptQpSelect != b.adaptQpSelect;
+}
+
+Void RDOQReplayContext::xDestroy()
+{
+  if (m_pcPic != NULL)
+  {
+    m_pcPic->destroy();
+    delete m_pcPic;
+    m_pcPic = NULL;
+  }
+}
+
+/** Creates the picture and the quantiser for the sequence-level parameters of a record.
+ */
+Void RDOQReplayContext::xInit( const RDOQDumpRecord &record )
+{
+  xDestroy();
+  m_params = record;
+
+  const UInt maxCUSize  = record.maxCUSize;
+  const UInt maxCUDepth = g_aucConvertToBit[maxCUSize];   // down to 4x4 partitions
+
+  m_sps = TComSPS();
+  m_sps.setChromaFormatIdc( ChromaFormat(record.chromaFormat) );
+  m_sps.setPicWidthInLumaSamples( maxCUSize );
+  m_sps.setPicHeightInLumaSamples( maxCUSize );
+  m_sps.setMaxCUWidth( maxCUSize );
+  m_sps.setMaxCUHeight( maxCUSize );
+  m_sps.setMaxTotalCUDepth( maxCUDepth );
+  m_sps.setLog2DiffMaxMinCodingBlockSize( maxCUDepth - 1 );
+  m_sps.setQuadtreeTULog2MaxSize( g_aucConvertToBit[MAX_TU_SIZE] + 2 );
+  m_sps.setQuadtreeTULog2MinSize( 2 );
+  for (UInt ch = 0; ch < MAX_NUM_CHANNEL_TYPE; ch++)
+  {
+    m_sps.setBitDepth( ChannelType(ch), record.bitDepths[ch] );
+  }
+  m_sps.getSpsRangeExtension().setExtendedPrecisionProcessingFlag( record.extendedPrecision != 0 );
+  m_sps.getSpsRangeExtension().setPersistentRiceAdaptationEnabledFlag( record.persistentRiceAdaptation != 0 );
+  m_sps.getSpsRangeExtension().setTransformSkipContextEnabledFlag( record.transformSkipContext != 0 );
+
+  m_pps = TComPPS();
+  m_pps.setSignDataHidingEnabledFlag( record.signDataHiding != 0 );
+
+  m_pcPic = new TComPic;
+#if REDUCED_ENCODER_MEMORY
+#if SHUTTER_INTERVAL_SEI_PROCESSING
+  m_pcPic->create( m_sps, m_pps, false, true, false );
+#else
+  m_pcPic->create( m_sps, m_pps, false, true );
+#endif
+#else
+#if SHUTTER_INTERVAL_SEI_PROCESSING
+  m_pcPic->create( m_sps, m_pps, false, false );
+#else
+  m_pcPic->create( m_sps, m_pps, false );
+#endif
+#endif
+
+  UInt* piTmp = &g_auiZscanToRaster[0];
+  initZscanToRaster( maxCUDepth + 1, 1, 0, piTmp );
+  initRasterToZscan( maxCUSize, maxCUSize, maxCUDepth + 1 );
+  initRasterToPelXY( maxCUSize, maxCUSize, maxCUDepth + 1 );
+
+  m_trQuant.init( MAX_TU_SIZE, true, true, false, true, false
+#if ADAPTIVE_QP_SELECTION
+                , record.adaptQpSelect != 0
+#endif
+                );
+  const Int maxLog2TrDynamicRange[MAX_NUM_CHANNEL_TYPE] =
+  {
+    m_sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_LUMA),
+    m_sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_CHROMA)
+  };
+  m_trQuant.setFlatScalingList( maxLog2TrDynamicRange, m_sps.getBitDepths() );
+  m_trQuant.setUseScalingList( false );
+}
+
+/** Runs the RDOQ of a dumped TU.
+ * \param record             dumped parameters of the TU
+ * \param coeff              dumped coefficients of the TU
+ * \param useZeroCGFastPath  use the all-zero coefficient group fast path
+ * \param numRuns            number of times the RDOQ is run, for the timing
+ * \param result             levels, RD cost and time of one call
+ * \returns false if the TU cannot be replayed
+ */
+Bool RDOQReplayContext::replay( const RDOQDumpRecord &record, TCoeff *coeff, const Bool useZeroCGFastPath, const Int numRuns, RDOQResult &result )
+{
+  if (record.scalingList != 0 || record.maxCUSize < 8 || record.maxCUSize > MAX_CU_SIZE || record.cuDepth > Int(g_aucConvertToBit[record.maxCUSize]))
+  {
+    return false;
+  }
+  if (m_pcPic == NULL || isNewSequence( m_params, record ))
+  {
+    xInit( record );
+  }
+
+  // a CU covering the TU, with the data of the TU
+  const UInt  depth = record.cuDepth;
+  const UInt  size  = record.maxCUSize >> depth;
+  TComDataCU* pcCU  = m_pcPic->getCtu( 0 );
+  pcCU->initCtu( m_pcPic, 0 );
+  pcCU->setDepthSubParts( depth, 0 );
+  pcCU->setSizeSubParts( size, size, 0, depth );
+  pcCU->setPartSizeSubParts( SIZE_2Nx2N, 0, depth );
+  pcCU->setPredModeSubParts( PredMode(record.predMode), 0, depth );
+  pcCU->setCUTransquantBypassSubParts( record.transquantBypass != 0, 0, depth );
+  pcCU->setTrIdxSubParts( record.trDepth, 0, depth );
+  pcCU->setTransformSkipSubParts( record.transformSkip, ComponentID(record.compID), 0, depth );
+  pcCU->setIntraDirSubParts( CHANNEL_TYPE_LUMA,   record.intraDir[CHANNEL_TYPE_LUMA],   0, depth );
+  pcCU->setIntraDirSubParts( CHANNEL_TYPE_CHROMA, record.intraDir[CHANNEL_TYPE_CHROMA], 0, depth );
+
+  TComTURecurse tuRecurse( pcCU, 0 );
+  return xReplayTU( tuRecurse, 0, record, coeff, useZeroCGFastPath, numRuns, result );
+}
+
+/** Descends to the dumped TU, then runs its RDOQ.
+ */
+Bool RDOQReplayContext::xReplayTU( TComTU &rTu, const UInt trDepth, const RDOQDumpRecord &record, TCoeff *coeff, const Bool useZeroCGFastPath, const Int numRuns, RDOQResult &result )
+{
+  const ComponentID compID = ComponentID(record.compID);
+  if (Int(trDepth) < record.trDepth)
+  {
+    TComTURecurse tuRecurseChild( rTu, false );
+    return xReplayTU( tuRecurseChild, trDepth + 1, record, coeff, useZeroCGFastPath, numRuns, result );
+  }
+  if (record.splitMode == TComTU::VERTICAL_SPLIT && rTu.GetSplitMode() != TComTU::VERTICAL_SPLIT)
+  {
+    // 4:2:2 chroma TUs are processed as two square TUs
+    TComTURecurse subTUIterator( rTu, false, TComTU::VERTICAL_SPLIT, true, compID );
+    while (Int(subTUIterator.GetSectionNumber()) < record.section && subTUIterator.nextSection( rTu ))
+    {
+    }
+    return xReplayTU( subTUIterator, trDepth, record, coeff, useZeroCGFastPath, numRuns, result );
+  }
+  if (Int(rTu.getRect(compID).width) != record.width || Int(rTu.getRect(compID).height) != record.height)
+  {
+    return false;
+  }
+
+  QpParam cQP( record.qp, toChannelType(compID), 0, 0, ChromaFormat(record.chromaFormat) );
+  cQP.Qp  = record.qp;
+  cQP.per = record.qpPer;
+  cQP.rem = record.qpRem;
+
+#if RDOQ_CHROMA_LAMBDA
+  const Double lambdas[MAX_NUM_COMPONENT] = { record.lambda, record.lambda, record.lambda };
+  m_trQuant.setLambdas( lambdas );
+  m_trQuant.selectLambda( compID );
+#else
+  m_trQuant.setLambda( record.lambda );
+#endif
+  estBitsSbacStruct estBits = record.estBits;
+  m_trQuant.m_pcEstBitsSbac = &estBits;
+
+  const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  for (Int run = 0; run < numRuns; run++)
+  {
+    result.absSum = 0;
+#if ADAPTIVE_QP_SELECTION
+    m_trQuant.rateDistOptQuant( rTu, coeff, result.levels, result.arlLevels, result.absSum, compID, cQP, useZeroCGFastPath, result.bestCost );
+#else
+    m_trQuant.rateDistOptQuant( rTu, coeff, result.levels, result.absSum, compID, cQP, useZeroCGFastPath, result.bestCost );
+#endif
+  }
+  result.seconds = std::chrono::duration<Double>( std::chrono::steady_clock::now() - startTime ).count() / numRuns;
+  m_trQuant.m_pcEstBitsSbac = NULL;
+  return true;
+}
+
+/** Returns true if the levels, the absolute sum and the RD cost of two results are identical.
+ */
+static Bool isEqual( const RDOQResult &a, const RDOQResult &b, const UInt numCoeff, const Bool compareArlLevels )
+{
+  if (a.absSum != b.absSum || a.bestCost != b.bestCost)
+  {
+    return false;
+  }
+  for (UInt n = 0; n < numCoeff; n++)
+  {
+    if (a.levels[n] != b.levels[n] || (compareArlLevels && a.arlLevels[n] != b.arlLevels[n]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main( int argc, char* argv[] )
+{
+  if (argc < 2)
+  {
+    printf( "usage: %s <RDOQ dump file> [number of runs per TU (default 20)]\n", argv[0] );
+    printf( "Replays the RDOQ calls dumped by an encoder built with DEBUG_RDOQ_DUMP_TUS=1 without and with the all-zero\n"
+            "coefficient group fast path, checks that the levels and RD costs are identical and reports the time per TU.\n"
+            "Returns 0 if all TUs match, 1 on a mismatch and 2 if the dump cannot be read or replayed.\n" );
+    return 2;
+  }
+  const Int numRuns = argc > 2 ? std::max( 1, atoi( argv[2] ) ) : 20;
+
+  FILE* dumpFile = fopen( argv[1], "rb" );
+  if (dumpFile == NULL)
+  {
+    fprintf( stderr, "Error: could not open RDOQ dump file %s\n", argv[1] );
+    return 2;
+  }
+
+  initROM();
+
+  RDOQReplayContext*    context = new RDOQReplayContext;
+  RDOQDumpRecord        record;
+  std::vector<TCoeff>   coeff( MAX_TU_SIZE * MAX_TU_SIZE );
+  RDOQResult*           generalResult  = new RDOQResult;
+  RDOQResult*           fastPathResult = new RDOQResult;
+  std::map<std::pair<Int, Int>, RDOQTimings> timings;   // by component and TU size
+  UInt                  numTUs         = 0;
+  UInt                  numMismatches  = 0;
+  UInt                  numUnsupported = 0;
+  Int                   returnCode     = 0;
+
+  while (fread( &record, sizeof(record), 1, dumpFile ) == 1)
+  {
+    const UInt numCoeff = record.width * record.height;
+    if (record.width < 4 || record.height < 4 || numCoeff > MAX_TU_SIZE * MAX_TU_SIZE || record.compID < 0 || record.compID >= MAX_NUM_COMPONENT)
+    {
+      fprintf( stderr, "Error: invalid TU %u in the RDOQ dump file\n", numTUs );
+      returnCode = 2;
+      break;
+    }
+    if (fread( &coeff[0], sizeof(TCoeff), numCoeff, dumpFile ) != numCoeff)
+    {
+      fprintf( stderr, "Error: truncated TU %u in the RDOQ dump file\n", numTUs );
+      returnCode = 2;
+      break;
+    }
+
+    if (!context->replay( record, &coeff[0], false, numRuns, *generalResult ) || !context->replay( record, &coeff[0], true, numRuns, *fastPathResult ))
+    {
+      numUnsupported++;
+    }
+    else
+    {
+      if (!isEqual( *generalResult, *fastPathResult, numCoeff, record.adaptQpSelect != 0 ))
+      {
+        if (numMismatches < 10)
+        {
+          fprintf( stderr, "Mismatch in TU %u: component %d, %dx%d, QP %d, abs sum %d/%d, cost %.17g/%.17g\n", numTUs, record.compID, record.width, record.height,
+                   record.qp, Int(generalResult->absSum), Int(fastPathResult->absSum), generalResult->bestCost, fastPathResult->bestCost );
+        }
+        numMismatches++;
+      }
+      RDOQTimings &timing = timings[std::make_pair( record.compID, record.width * 100 + record.height )];
+      timing.numTUs++;
+      timing.generalSeconds  += generalResult->seconds;
+      timing.fastPathSeconds += fastPathResult->seconds;
+    }
+    numTUs++;
+  }
+  fclose( dumpFile );
+
+  printf( "%8s %9s %8s %14s %14s %8s\n", "comp", "size", "TUs", "general ns/TU", "fast ns/TU", "speedup" );
+  RDOQTimings total;
+  for (std::map<std::pair<Int, Int>, RDOQTimings>::const_iterator it = timings.begin(); it != timings.end(); it++)
+  {
+    const RDOQTimings &timing = it->second;
+    printf( "%8d %5dx%-3d %8u %14.1f %14.1f %8.3f\n", it->first.first, it->first.second / 100, it->first.second % 100, timing.numTUs,
+            timing.generalSeconds * 1e9 / timing.numTUs, timing.fastPathSeconds * 1e9 / timing.numTUs, timing.generalSeconds / timing.fastPathSeconds );
+    total.numTUs          += timing.numTUs;
+    total.generalSeconds  += timing.generalSeconds;
+    total.fastPathSeconds += timing.fastPathSeconds;
+  }
+  if (total.numTUs > 0)
+  {
+    printf( "%8s %9s %8u %14.1f %14.1f %8.3f\n", "all", "", total.numTUs, total.generalSeconds * 1e9 / total.numTUs, total.fastPathSeconds * 1e9 / total.numTUs,
+            total.generalSeconds / total.fastPathSeconds );
+  }
+  printf( "%u TUs read, %u replayed, %u not supported (scaling lists), %u mismatches\n", numTUs, total.numTUs, numUnsupported, numMismatches );
+
+  delete generalResult;
+  delete fastPathResult;
+  delete context;
+  destroyROM();
+
+  if (returnCode == 0 && numMismatches > 0)
+  {
+    returnCode = 1;
+  }
+  return returnCode;
+}
+
+//! \}
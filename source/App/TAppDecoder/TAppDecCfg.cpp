@@ -101,6 +101,8 @@ Bool TAppDecCfg::parseCfg( Int argc, TChar* argv[] )
 #if MCTS_ENC_CHECK
   ("TMCTSCheck",                  m_tmctsCheck,                          false,    "If enabled, the decoder checks for violations of mc_exact_sample_value_match_flag in Temporal MCTS ")
 #endif
+  ("CtuThreads",                m_numCtuThreads,                       1,          "Number of threads decoding CTU rows concurrently: wavefront (entropy coding sync) slice segments are decoded row-parallel, other slice segments are parsed while worker threads reconstruct the parsed CTU rows (1: serial decoding)")
+  ("CtuRowLoopFilter",          m_ctuRowLoopFilter,                    false,      "Apply deblocking and SAO CTU row by row while the picture is decoded, each row once the row below it has been reconstructed, instead of once the picture has been decoded")
   ;
 
   po::setDefaults(opts);
@@ -140,6 +142,12 @@ Bool TAppDecCfg::parseCfg( Int argc, TChar* argv[] )
     return false;
   }
 
+  if (m_numCtuThreads < 1)
+  {
+    fprintf(stderr, "CtuThreads must be at least 1\n");
+    return false;
+  }
+
   if ( !cfg_TargetDecLayerIdSetFile.empty() )
   {
     FILE* targetDecLayerIdSetFile = fopen ( cfg_TargetDecLayerIdSetFile.c_str(), "r" );
@@ -83,6 +83,8 @@ protected:
 #if MCTS_ENC_CHECK
   Bool          m_tmctsCheck;
 #endif
+  Int           m_numCtuThreads;                      ///< number of threads decoding or reconstructing CTU rows concurrently
+  Bool          m_ctuRowLoopFilter;                   ///< apply the in-loop filters CTU row by row
 
 public:
   TAppDecCfg()
@@ -112,6 +114,8 @@ public:
 #if MCTS_ENC_CHECK
   , m_tmctsCheck(false)
 #endif
+  , m_numCtuThreads(1)
+  , m_ctuRowLoopFilter(false)
   {
     for (UInt channelTypeIndex = 0; channelTypeIndex < MAX_NUM_CHANNEL_TYPE; channelTypeIndex++)
     {
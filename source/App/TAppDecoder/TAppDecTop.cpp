@@ -367,6 +367,7 @@ Void TAppDecTop::decode()
 Void TAppDecTop::xCreateDecLib()
 {
   // create decoder class
+  m_cTDecTop.setNumCtuThreads(m_numCtuThreads);
   m_cTDecTop.create();
 }
 
@@ -406,6 +407,7 @@ Void TAppDecTop::xInitDecLib()
   // initialize decoder class
   m_cTDecTop.init();
   m_cTDecTop.setDecodedPictureHashSEIEnabled(m_decodedPictureHashSEIEnabled);
+  m_cTDecTop.setCtuRowLoopFilterEnabled(m_ctuRowLoopFilter);
 #if MCTS_ENC_CHECK
   m_cTDecTop.setTMctsCheckEnabled(m_tmctsCheck);
 #endif
@@ -674,6 +674,48 @@ automaticallySelectRExtProfile(const Bool bUsingGeneralRExtTools,
     }
   }
 }
+
+/// error reporter discarding the messages, used when the options are scanned a second time
+struct SilentErrorReporter : public po::ErrorReporter
+{
+  std::ostream& error(const std::string&) { is_errored = true; m_discarded.str(""); return m_discarded; }
+  std::ostream& warn (const std::string&) { m_discarded.str(""); return m_discarded; }
+  std::ostringstream m_discarded;
+};
+
+/** Returns the arguments of the command line without the configuration files (option c), so that scanning them again
+ *  only sets the options given on the command line.
+ * \param  argc  number of arguments
+ * \param  argv  array of arguments
+ * \retval       arguments, starting with the program name
+ */
+static std::vector<const TChar*> getArgvWithoutCfgFiles( Int argc, TChar* argv[] )
+{
+  std::vector<const TChar*> args( 1, argv[0] );
+  for (Int i = 1; i < argc; i++)
+  {
+    const std::string arg( argv[i] );
+    if (arg.size() > 1 && arg[0] == '-' && arg[1] != '-')
+    {
+      // short options take the next argument as their value
+      if (arg.substr(1) != "c")
+      {
+        args.push_back( argv[i] );
+        if (i + 1 < argc)
+        {
+          args.push_back( argv[i + 1] );
+        }
+      }
+      i++;
+    }
+    else if (arg != "--c" && arg.compare(0, 4, "--c=") != 0)
+    {
+      args.push_back( argv[i] );
+    }
+  }
+  return args;
+}
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -708,6 +750,7 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   SMultiValueInput<Int>  cfg_targetPivotValue                (std::numeric_limits<Int>::min(), std::numeric_limits<Int>::max(), 0, 1<<16);
 
   SMultiValueInput<Double> cfg_adIntraLambdaModifier         (0, std::numeric_limits<Double>::max(), 0, MAX_TLAYER); ///< Lambda modifier for Intra pictures, one for each temporal layer. If size>temporalLayer, then use [temporalLayer], else if size>0, use [size()-1], else use m_adLambdaModifier.
+  SMultiValueInput<UInt>   cfg_temporalLayerMaxCUDepth       (0, MAX_CU_DEPTH, 0, MAX_TLAYER); ///< Maximum CU depth evaluated, one for each temporal layer. If size>temporalLayer, then use [temporalLayer], else if size>0, use [size()-1], else no limit.
 
   const Int defaultLumaLevelTodQp_QpChangePoints[]   =  {-3,  -2,  -1,   0,   1,   2,   3,   4,   5,   6};
   const Int defaultLumaLevelTodQp_LumaChangePoints[] =  { 0, 301, 367, 434, 501, 567, 634, 701, 767, 834};
@@ -896,6 +939,9 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("BipredSearchRange",                               m_bipredSearchRange,                                  4, "Motion search range for bipred refinement")
   ("MinSearchWindow",                                 m_minSearchWindow,                                    8, "Minimum motion search window size for the adaptive window ME")
   ("RestrictMESampling",                              m_bRestrictMESampling,                            false, "Restrict ME Sampling for selective inter motion search")
+  ("HierarchicalME",                                  m_useHierarchicalME,                              false, "Use coarse MVs from a motion search on 1/2 and 1/4 resolution original pictures as start candidates")
+  ("HierarchicalMESearchRange",                       m_hierarchicalMESearchRange,                         64, "Search range of the hierarchical motion search, in full-resolution samples")
+  ("SubpelPlanes",                                    m_subpelPlanes,                                       0, "Interpolate reference pictures once for the fractional motion search: 0:off, 1:half-sample planes (3 per picture), 2:half- and quarter-sample planes (15 per picture)")
   ("ClipForBiPredMEEnabled",                          m_bClipForBiPredMeEnabled,                        false, "Enables clipping in the Bi-Pred ME. It is disabled to reduce encoder run-time")
   ("FastMEAssumingSmootherMVEnabled",                 m_bFastMEAssumingSmootherMVEnabled,                true, "Enables fast ME assuming a smoother MV.")
 
@@ -958,6 +1004,7 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("RDOQ",                                            m_useRDOQ,                                         true)
   ("RDOQTS",                                          m_useRDOQTS,                                       true)
   ("SelectiveRDOQ",                                   m_useSelectiveRDOQ,                               false, "Enable selective RDOQ")
+  ("RDOQMaxTemporalLayer",                            m_rdoqMaxTemporalLayer,                              -1, "Highest temporal layer in which RDOQ and RDOQTS are used (-1: all layers)")
   ("RDpenalty",                                       m_rdPenalty,                                          0,  "RD-penalty for 32x32 TU for intra in non-intra slices. 0:disabled  1:RD-penalty  2:maximum RD-penalty")
 
   // Deblocking filter parameters
@@ -1027,6 +1074,9 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("TileRowHeightArray",                              cfg_RowHeight,                            cfg_RowHeight, "Array containing tile row height values in units of CTU")
   ("LFCrossTileBoundaryFlag",                         m_bLFCrossTileBoundaryFlag,                        true, "1: cross-tile-boundary loop filtering. 0:non-cross-tile-boundary loop filtering")
   ("WaveFrontSynchro",                                m_entropyCodingSyncEnabledFlag,                   false, "0: entropy coding sync disabled; 1 entropy coding sync enabled")
+  ("CtuThreads",                                      m_numCtuThreads,                                      1, "Number of threads processing the CTU rows (WaveFrontSynchro) or the tiles of a slice concurrently (1: single-threaded)")
+  ("FrameThreads",                                    m_numFrameThreads,                                    1, "Number of pictures of a GOP that do not reference each other compressed concurrently (1: one picture at a time)")
+  ("LookaheadDepth",                                  m_lookaheadDepth,                                     0, "Number of source pictures read, converted and temporally pre-filtered ahead of the encoder on a separate thread (0: read each picture when it is encoded)")
   ("ScalingList",                                     m_useScalingListId,                    SCALING_LIST_OFF, "0/off: no scaling list, 1/default: default scaling lists, 2/file: scaling lists specified in ScalingListFile")
   ("ScalingListFile",                                 m_scalingListFileName,                       string(""), "Scaling list file name. Use an empty string to produce help.")
   ("SignHideFlag,-SBH",                               m_signDataHidingEnabledFlag,                                    true)
@@ -1039,7 +1089,15 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
                                                                                                                "\t0: disable")
   ("TMVPMode",                                        m_TMVPModeId,                                         1, "TMVP mode 0: TMVP disable for all slices. 1: TMVP enable for all slices (default) 2: TMVP enable for certain slices only")
   ("FEN",                                             tmpFastInterSearchMode,   Int(FASTINTERSEARCH_DISABLED), "fast encoder setting")
+  ("Preset",                                          m_presetName,                                string(""), "Speed preset providing the defaults of the speed-related settings: placebo, slow, medium, fast, veryfast or ultrafast (empty: none)")
   ("ECU",                                             m_bUseEarlyCU,                                    false, "Early CU setting")
+  ("FastSplitDecision",                               m_useFastSplitDecision,                           false, "Predict CU split decisions from neighbouring and co-located depths, parent RD cost and luma variance")
+  ("FastSplitSkipSplitVar",                           m_fastSplitSkipSplitVar,                           100u, "FastSplitDecision: 8-bit luma variance at or below which further CU splitting may be skipped")
+  ("FastSplitSkipNonSplitVar",                        m_fastSplitSkipNonSplitVar,                        100u, "FastSplitDecision: 8-bit luma variance at or above which the unsplit CU modes may be skipped")
+  ("FastSplitCostRatio",                              m_fastSplitCostRatio,                               1.0, "FastSplitDecision: skip further splitting when the CU costs less than this fraction of a quarter of its parent's unsplit cost")
+  ("DisableNxNPartitions",                            m_disableNxNPartitions,                           false, "Do not evaluate the NxN inter and intra partitions of the smallest CUs")
+  ("TemporalLayerMaxCUDepth",                         cfg_temporalLayerMaxCUDepth, cfg_temporalLayerMaxCUDepth, "Maximum CU depth evaluated, comma separated, up to one per temporal layer. If entry for temporalLayer exists, then use it, else if some are specified, use the last, else no limit.")
+  ("FastUDINumModes",                                 m_fastUDINumModes,                                   0u, "Number of intra modes passed from the SATD-based pre-selection to the full RD search (0: size-dependent default)")
   ("FDM",                                             m_useFastDecisionForMerge,                         true, "Fast decision for Merge RD Cost")
   ("CFM",                                             m_bUseCbfFastMode,                                false, "Cbf fast mode setting")
   ("ESD",                                             m_useEarlySkipDetection,                          false, "Early SKIP detection setting")
@@ -1357,7 +1415,8 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
     ("FirstValidFrame", m_firstValidFrame, 0, "First valid frame")
     ("LastValidFrame", m_lastValidFrame, MAX_INT, "Last valid frame")
     ("TemporalFilterStrengthFrame*", m_gopBasedTemporalFilterStrengths, std::map<Int, Double>(), "Strength for every * frame in GOP based temporal filter, where * is an integer."
-                                                                                                   " E.g. --TemporalFilterStrengthFrame8 0.95 will enable GOP based temporal filter at every 8th frame with strength 0.95");
+                                                                                                   " E.g. --TemporalFilterStrengthFrame8 0.95 will enable GOP based temporal filter at every 8th frame with strength 0.95")
+    ("TemporalFilterThreads", m_gopBasedTemporalFilterThreads, 1, "Number of threads estimating the motion of the references and filtering the picture in the temporal prefilter (1: single-threaded)");
 
 #if EXTENSION_360_VIDEO
   TExt360AppEncCfg::TExt360AppEncCfgContext ext360CfgContext;
@@ -1395,6 +1454,33 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
     }
   }
 
+  /*
+   * A speed preset overrides the settings it bundles in the configuration files: apply it to the settings as scanned,
+   * then scan the command line again without the configuration files, so that the options given on the command line
+   * take precedence.
+   */
+  std::vector<std::string> settingsWithoutPreset;
+  if (!m_presetName.empty())
+  {
+    m_motionEstimationSearchMethod = MESearchMethod(tmpMotionEstimationSearchMethod);
+    m_fastInterSearchMode          = FastInterSearchMode(tmpFastInterSearchMode);
+    m_temporalLayerMaxCUDepth      = cfg_temporalLayerMaxCUDepth.values;
+    settingsWithoutPreset          = xGetPresetSettings();
+
+    if (!xApplyPreset(m_presetName))
+    {
+      fprintf(stderr, "Unknown Preset `%s'\n", m_presetName.c_str());
+      exit(EXIT_FAILURE);
+    }
+    tmpMotionEstimationSearchMethod    = Int(m_motionEstimationSearchMethod);
+    tmpFastInterSearchMode             = Int(m_fastInterSearchMode);
+    cfg_temporalLayerMaxCUDepth.values = m_temporalLayerMaxCUDepth;
+
+    const std::vector<const TChar*> cmdLineArgs = getArgvWithoutCfgFiles(argc, argv);
+    SilentErrorReporter presetErr;
+    po::scanArgv(opts, UInt(cmdLineArgs.size()), const_cast<const TChar**>(&cmdLineArgs[0]), presetErr);
+  }
+
   /*
    * Set any derived parameters
    */
@@ -1418,6 +1504,7 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
 
   m_framesToBeEncoded = ( m_framesToBeEncoded + m_temporalSubsampleRatio - 1 ) / m_temporalSubsampleRatio;
   m_adIntraLambdaModifier = cfg_adIntraLambdaModifier.values;
+  m_temporalLayerMaxCUDepth = cfg_temporalLayerMaxCUDepth.values;
   if(m_isField)
   {
     //Frame height
@@ -1538,6 +1625,18 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   }
   m_motionEstimationSearchMethod=MESearchMethod(tmpMotionEstimationSearchMethod);
 
+  if (!m_presetName.empty())
+  {
+    const std::vector<std::string> settings = xGetPresetSettings();
+    for (size_t i = 0; i < settings.size(); i++)
+    {
+      if (settings[i] != settingsWithoutPreset[i])
+      {
+        m_presetChangedSettings += (m_presetChangedSettings.empty() ? "" : " ") + settings[i];
+      }
+    }
+  }
+
   switch (UIProfile)
   {
     case UI_NONE:
@@ -2183,6 +2282,128 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
 // Private member functions
 // ====================================================================================================================
 
+/** Set the speed-related settings to those of a speed preset.
+ *  The presets are ordered from the slowest to the fastest; each preset keeps the fast decisions of the slower
+ *  presets and adds its own. parseCfg() applies the preset before the settings given explicitly.
+ * \param  presetName  name of the preset
+ * \retval             false when the name is not that of a preset
+ */
+Bool TAppEncCfg::xApplyPreset( const std::string &presetName )
+{
+  enum { PRESET_PLACEBO = 0, PRESET_SLOW, PRESET_MEDIUM, PRESET_FAST, PRESET_VERYFAST, PRESET_ULTRAFAST, NUMBER_OF_PRESETS };
+  static const TChar* const presetNames[NUMBER_OF_PRESETS] = { "placebo", "slow", "medium", "fast", "veryfast", "ultrafast" };
+
+  Int preset = 0;
+  while (preset < NUMBER_OF_PRESETS && presetName != presetNames[preset])
+  {
+    preset++;
+  }
+  if (preset == NUMBER_OF_PRESETS)
+  {
+    return false;
+  }
+
+  // motion estimation
+  m_motionEstimationSearchMethod     = preset >= PRESET_SLOW ? MESEARCH_DIAMOND : MESEARCH_DIAMOND_ENHANCED;
+  m_bRestrictMESampling              = preset >= PRESET_ULTRAFAST;
+  if (preset >= PRESET_MEDIUM)
+  {
+    m_iSearchRange                   = preset >= PRESET_ULTRAFAST ? 16 : (preset >= PRESET_VERYFAST ? 32 : 64);
+  }
+  m_bipredSearchRange                = preset >= PRESET_VERYFAST ? 2 : 4;
+  m_fastInterSearchMode              = preset >= PRESET_SLOW ? FASTINTERSEARCH_MODE1 : FASTINTERSEARCH_DISABLED;
+  m_bFastMEAssumingSmootherMVEnabled = preset >= PRESET_SLOW;
+  m_bFastMEForGenBLowDelayEnabled    = preset >= PRESET_SLOW;
+
+  // mode decision
+  m_useFastDecisionForMerge          = preset >= PRESET_SLOW;
+  m_bFastUDIUseMPMEnabled            = preset >= PRESET_SLOW;
+  m_useTransformSkipFast             = preset >= PRESET_SLOW;
+  m_bUseCbfFastMode                  = preset >= PRESET_MEDIUM;
+  m_useEarlySkipDetection            = preset >= PRESET_MEDIUM;
+  m_bUseEarlyCU                      = preset >= PRESET_FAST;
+  m_useFastSplitDecision             = preset >= PRESET_FAST;
+  m_fastSplitSkipSplitVar            = preset >= PRESET_ULTRAFAST ? 400 : 100;
+  m_fastSplitSkipNonSplitVar         = preset >= PRESET_ULTRAFAST ? 50  : 100;
+  m_fastSplitCostRatio               = preset >= PRESET_ULTRAFAST ? 1.5 : 1.0;
+  m_enableAMP                        = preset <  PRESET_VERYFAST;
+  m_disableNxNPartitions             = preset >= PRESET_VERYFAST;
+  m_fastUDINumModes                  = preset >= PRESET_ULTRAFAST ? 1 : (preset >= PRESET_VERYFAST ? 2 : 0);
+
+  // the highest temporal layers do not evaluate the smallest CUs
+  const UInt maxCUDepth = m_uiMaxCUDepth > 1 ? m_uiMaxCUDepth - 1 : 0;
+  m_temporalLayerMaxCUDepth.clear();
+  if (preset >= PRESET_ULTRAFAST)
+  {
+    const UInt depths[] = { maxCUDepth, std::max<UInt>(maxCUDepth, 1) - 1, std::max<UInt>(maxCUDepth, 1) - 1, std::max<UInt>(maxCUDepth, 2) - 2 };
+    m_temporalLayerMaxCUDepth.assign(depths, depths + 4);
+  }
+  else if (preset >= PRESET_VERYFAST)
+  {
+    const UInt depths[] = { maxCUDepth, maxCUDepth, maxCUDepth, std::max<UInt>(maxCUDepth, 1) - 1 };
+    m_temporalLayerMaxCUDepth.assign(depths, depths + 4);
+  }
+  if (preset >= PRESET_VERYFAST)
+  {
+    m_uiQuadtreeTUMaxDepthInter      = 1;
+    m_uiQuadtreeTUMaxDepthIntra      = 1;
+  }
+
+  // quantization
+  m_useSelectiveRDOQ                 = preset >= PRESET_FAST;
+  m_rdoqMaxTemporalLayer             = preset >= PRESET_ULTRAFAST ? 1 : (preset >= PRESET_VERYFAST ? 2 : -1);
+
+  return true;
+}
+
+/// append "name=value" to settings
+template <class T>
+static Void addSetting(std::vector<std::string> &settings, const TChar *name, const T &value)
+{
+  std::ostringstream oss;
+  oss << name << "=" << value;
+  settings.push_back(oss.str());
+}
+
+/** The settings bundled by the speed presets, as "Option=value", in the order of xApplyPreset().
+ *  Used to list the settings that a preset has changed.
+ */
+std::vector<std::string> TAppEncCfg::xGetPresetSettings() const
+{
+  std::vector<std::string> settings;
+  addSetting(settings, "FastSearch",                         Int(m_motionEstimationSearchMethod));
+  addSetting(settings, "RestrictMESampling",                 m_bRestrictMESampling);
+  addSetting(settings, "SearchRange",                        m_iSearchRange);
+  addSetting(settings, "BipredSearchRange",                  m_bipredSearchRange);
+  addSetting(settings, "FEN",                                Int(m_fastInterSearchMode));
+  addSetting(settings, "FastMEAssumingSmootherMVEnabled",    m_bFastMEAssumingSmootherMVEnabled);
+  addSetting(settings, "FastMEForGenBLowDelayEnabled",       m_bFastMEForGenBLowDelayEnabled);
+  addSetting(settings, "FDM",                                m_useFastDecisionForMerge);
+  addSetting(settings, "FastUDIUseMPMEnabled",               m_bFastUDIUseMPMEnabled);
+  addSetting(settings, "TransformSkipFast",                  m_useTransformSkipFast);
+  addSetting(settings, "CFM",                                m_bUseCbfFastMode);
+  addSetting(settings, "ESD",                                m_useEarlySkipDetection);
+  addSetting(settings, "ECU",                                m_bUseEarlyCU);
+  addSetting(settings, "FastSplitDecision",                  m_useFastSplitDecision);
+  addSetting(settings, "FastSplitSkipSplitVar",              m_fastSplitSkipSplitVar);
+  addSetting(settings, "FastSplitSkipNonSplitVar",           m_fastSplitSkipNonSplitVar);
+  addSetting(settings, "FastSplitCostRatio",                 m_fastSplitCostRatio);
+  addSetting(settings, "AMP",                                m_enableAMP);
+  addSetting(settings, "DisableNxNPartitions",               m_disableNxNPartitions);
+  addSetting(settings, "FastUDINumModes",                    m_fastUDINumModes);
+  std::ostringstream depths;
+  for (size_t i = 0; i < m_temporalLayerMaxCUDepth.size(); i++)
+  {
+    depths << (i ? "," : "") << m_temporalLayerMaxCUDepth[i];
+  }
+  addSetting(settings, "TemporalLayerMaxCUDepth",            depths.str());
+  addSetting(settings, "QuadtreeTUMaxDepthInter",            m_uiQuadtreeTUMaxDepthInter);
+  addSetting(settings, "QuadtreeTUMaxDepthIntra",            m_uiQuadtreeTUMaxDepthIntra);
+  addSetting(settings, "SelectiveRDOQ",                      m_useSelectiveRDOQ);
+  addSetting(settings, "RDOQMaxTemporalLayer",               m_rdoqMaxTemporalLayer);
+  return settings;
+}
+
 Void TAppEncCfg::xCheckParameter()
 {
   if (m_decodedPictureHashSEIType==HASHTYPE_NONE)
@@ -2405,6 +2626,10 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_iSearchRange < 0 ,                                                        "Search Range must be more than 0" );
   xConfirmPara( m_bipredSearchRange < 0 ,                                                   "Bi-prediction refinement search range must be more than 0" );
   xConfirmPara( m_minSearchWindow < 0,                                                      "Minimum motion search window size for the adaptive window ME must be greater than or equal to 0" );
+  xConfirmPara( m_useHierarchicalME && m_hierarchicalMESearchRange <= 0,                     "Hierarchical motion search range must be more than 0" );
+  xConfirmPara( m_subpelPlanes < 0 || m_subpelPlanes > 2,                                    "SubpelPlanes must be in the range of 0 to 2" );
+  xConfirmPara( Int(m_fastUDINumModes) > NUM_INTRA_MODE - 1,                                    "FastUDINumModes must not exceed the number of intra modes" );
+  xConfirmPara( m_rdoqMaxTemporalLayer < -1,                                                "RDOQMaxTemporalLayer must be greater than or equal to -1" );
   xConfirmPara( m_iMaxDeltaQP > 7,                                                          "Absolute Delta QP exceeds supported range (0 to 7)" );
   xConfirmPara(m_lumaLevelToDeltaQPMapping.mode &&  m_uiDeltaQpRD > 0, "Luma-level-based Delta QP cannot be used together with slice level multiple-QP optimization\n" );
   xConfirmPara( m_iMaxCuDQPDepth > m_uiMaxCUDepth - 1,                                          "Absolute depth for a minimum CuDQP exceeds maximum coding unit depth" );
@@ -2472,6 +2697,9 @@ Void TAppEncCfg::xCheckParameter()
   {
     xConfirmPara( tileFlag && m_entropyCodingSyncEnabledFlag, "Tiles and entropy-coding-sync (Wavefronts) can not be applied together, except in the High Throughput Intra 4:4:4 16 profile");
   }
+  xConfirmPara( m_numCtuThreads < 1,                                                        "CtuThreads must be at least 1" );
+  xConfirmPara( m_numFrameThreads < 1,                                                      "FrameThreads must be at least 1" );
+  xConfirmPara( m_lookaheadDepth < 0,                                                       "LookaheadDepth must not be negative" );
 
   xConfirmPara( m_sourceWidth  % TComSPS::getWinUnitX(m_chromaFormatIDC) != 0, "Picture width must be an integer multiple of the specified chroma subsampling");
   xConfirmPara( m_sourceHeight % TComSPS::getWinUnitY(m_chromaFormatIDC) != 0, "Picture height must be an integer multiple of the specified chroma subsampling");
@@ -3090,6 +3318,7 @@ Void TAppEncCfg::xCheckParameter()
     }
   }
 
+  xConfirmPara(m_gopBasedTemporalFilterThreads < 1, "TemporalFilterThreads must be at least 1");
   if (m_gopBasedTemporalFilterEnabled)
   {
     xConfirmPara(m_temporalSubsampleRatio != 1, "GOP Based Temporal Filter only support Temporal sub-sample ratio 1");
@@ -3373,6 +3602,11 @@ Void TAppEncCfg::xPrintParameter()
   }
 
   printf("Max Num Merge Candidates               : %d\n", m_maxNumMergeCand);
+  if (!m_presetName.empty())
+  {
+    printf("Preset                                 : %s\n", m_presetName.c_str());
+    printf("Settings changed by the preset         : %s\n", m_presetChangedSettings.empty() ? "none" : m_presetChangedSettings.c_str());
+  }
   printf("\n");
 
   printf("TOOL CFG: ");
@@ -3380,17 +3614,23 @@ Void TAppEncCfg::xPrintParameter()
   printf("HAD:%d ", m_bUseHADME                          );
   printf("RDQ:%d ", m_useRDOQ                            );
   printf("RDQTS:%d ", m_useRDOQTS                        );
+  printf("RDQMaxTL:%d ", m_rdoqMaxTemporalLayer          );
   printf("RDpenalty:%d ", m_rdPenalty                    );
   printf("LQP:%d ", m_lumaLevelToDeltaQPMapping.mode     );
   printf("SQP:%d ", m_uiDeltaQpRD                        );
   printf("ASR:%d ", m_bUseASR                            );
   printf("MinSearchWindow:%d ", m_minSearchWindow        );
   printf("RestrictMESampling:%d ", m_bRestrictMESampling );
+  printf("HME:%d ", m_useHierarchicalME                  );
+  printf("SubpelPlanes:%d ", m_subpelPlanes              );
   printf("FEN:%d ", Int(m_fastInterSearchMode)           );
   printf("ECU:%d ", m_bUseEarlyCU                        );
+  printf("FSD:%d ", m_useFastSplitDecision               );
   printf("FDM:%d ", m_useFastDecisionForMerge            );
   printf("CFM:%d ", m_bUseCbfFastMode                    );
   printf("ESD:%d ", m_useEarlySkipDetection              );
+  printf("NxN:%d ", !m_disableNxNPartitions              );
+  printf("UDIModes:%d ", m_fastUDINumModes               );
   printf("RQT:%d ", 1                                    );
   printf("TransformSkip:%d ",     m_useTransformSkip     );
   printf("TransformSkipFast:%d ", m_useTransformSkipFast );
@@ -3423,6 +3663,7 @@ Void TAppEncCfg::xPrintParameter()
   printf("PME:%d ", m_log2ParallelMergeLevel);
   const Int iWaveFrontSubstreams = m_entropyCodingSyncEnabledFlag ? (m_sourceHeight + m_uiMaxCUHeight - 1) / m_uiMaxCUHeight : 1;
   printf(" WaveFrontSynchro:%d WaveFrontSubstreams:%d", m_entropyCodingSyncEnabledFlag?1:0, iWaveFrontSubstreams);
+  printf(" CtuThreads:%d FrameThreads:%d TemporalFilterThreads:%d LookaheadDepth:%d", m_numCtuThreads, m_numFrameThreads, m_gopBasedTemporalFilterThreads, m_lookaheadDepth);
   printf(" ScalingList:%d ", m_useScalingListId );
   printf("TMVPMode:%d ", m_TMVPModeId     );
 #if ADAPTIVE_QP_SELECTION
@@ -252,6 +252,8 @@ protected:
   // coding tools (encoder-only parameters)
   Bool      m_bUseASR;                                        ///< flag for using adaptive motion search range
   Bool      m_bUseHADME;                                      ///< flag for using HAD in sub-pel ME
+  std::string m_presetName;                                   ///< name of the speed preset providing the defaults of the speed-related settings (empty: none)
+  std::string m_presetChangedSettings;                        ///< settings changed by the speed preset, i.e. not given explicitly and differing from the defaults
   Bool      m_useRDOQ;                                        ///< flag for using RD optimized quantization
   Bool      m_useRDOQTS;                                      ///< flag for using RD optimized quantization for transform skip
   Bool      m_useSelectiveRDOQ;                               ///< flag for using selective RDOQ
@@ -262,10 +264,21 @@ protected:
   Int       m_iSearchRange;                                   ///< ME search range
   Int       m_bipredSearchRange;                              ///< ME search range for bipred refinement
   Int       m_minSearchWindow;                                ///< ME minimum search window size for the Adaptive Window ME
+  Bool      m_useHierarchicalME;                              ///< flag for using the coarse MVs of the hierarchical motion search as start candidates
+  Int       m_hierarchicalMESearchRange;                      ///< search range of the hierarchical motion search
+  Int       m_subpelPlanes;                                   ///< interpolated reference planes for the fractional search (0: off, 1: half-sample, 2: quarter-sample)
   Bool      m_bClipForBiPredMeEnabled;                        ///< Enables clipping for Bi-Pred ME.
   Bool      m_bFastMEAssumingSmootherMVEnabled;               ///< Enables fast ME assuming a smoother MV.
   FastInterSearchMode m_fastInterSearchMode;                  ///< Parameter that controls fast encoder settings
   Bool      m_bUseEarlyCU;                                    ///< flag for using Early CU setting
+  Bool      m_useFastSplitDecision;                           ///< flag for using the neighbour/variance based CU split decision
+  UInt      m_fastSplitSkipSplitVar;                          ///< luma variance at or below which further splitting may be skipped
+  UInt      m_fastSplitSkipNonSplitVar;                       ///< luma variance at or above which the unsplit CU modes may be skipped
+  Double    m_fastSplitCostRatio;                             ///< fraction of a quarter of the parent cost below which further splitting may be skipped
+  Bool      m_disableNxNPartitions;                           ///< flag for not evaluating the NxN inter and intra partitions
+  std::vector<UInt> m_temporalLayerMaxCUDepth;                ///< maximum CU depth evaluated, one for each temporal layer. If size>temporalLayer, then use [temporalLayer], else if size>0, use [size()-1], else no limit.
+  UInt      m_fastUDINumModes;                                ///< number of intra modes passed to the full RD search (0: size-dependent default)
+  Int       m_rdoqMaxTemporalLayer;                           ///< highest temporal layer using RDOQ (-1: all layers)
   Bool      m_useFastDecisionForMerge;                        ///< flag for using Fast Decision Merge RD-Cost
   Bool      m_bUseCbfFastMode;                                ///< flag for using Cbf Fast PU Mode Decision
   Bool      m_useEarlySkipDetection;                          ///< flag for using Early SKIP Detection
@@ -282,6 +295,9 @@ protected:
   std::vector<Int> m_tileColumnWidth;
   std::vector<Int> m_tileRowHeight;
   Bool      m_entropyCodingSyncEnabledFlag;
+  Int       m_numCtuThreads;                                  ///< number of threads compressing CTU rows/tiles of a slice concurrently
+  Int       m_numFrameThreads;                                ///< number of pictures of a GOP compressed concurrently
+  Int       m_lookaheadDepth;                                 ///< number of source pictures read and pre-filtered ahead of the encoder on a separate thread (0: no lookahead thread)
 
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
   Bool      m_bFastUDIUseMPMEnabled;
@@ -424,6 +440,7 @@ protected:
   Int                   m_firstValidFrame;
   Int                   m_lastValidFrame;
   std::map<Int, Double> m_gopBasedTemporalFilterStrengths;             ///< Filter strength per frame for the GOP-based Temporal Filter
+  Int                   m_gopBasedTemporalFilterThreads;               ///< number of threads of the GOP-based Temporal Filter
 #if JVET_Y0077_BIM
   Bool                  m_bimEnabled;
 #endif
@@ -542,6 +559,8 @@ protected:
 #endif
 
   // internal member functions
+  Bool  xApplyPreset    ( const std::string &presetName );     ///< set the speed-related settings to those of a speed preset
+  std::vector<std::string> xGetPresetSettings() const;        ///< the settings bundled by the speed presets, as "Option=value"
   Void  xCheckParameter ();                                   ///< check validity of configuration values
   Void  xPrintParameter ();                                   ///< print configuration values
   Void  xPrintUsage     ();                                   ///< print usage
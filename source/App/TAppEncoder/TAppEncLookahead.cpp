@@ -0,0 +1,175 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppEncLookahead.cpp
+    \brief    Lookahead stage of the encoder application
+*/
+
+#include <assert.h>
+
+#include "TAppEncLookahead.h"
+
+//! \ingroup TAppEncoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TAppEncLookahead::TAppEncLookahead()
+ : m_terminate(false)
+{
+}
+
+TAppEncLookahead::~TAppEncLookahead()
+{
+  destroy();
+}
+
+Void TAppEncLookahead::create( Int depth, Int width, Int height, ChromaFormat chromaFormat, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth )
+{
+  assert( m_pictures.empty() );
+  for( Int i = 0; i <= depth; i++ )
+  {
+    Picture *picture = new Picture;
+    picture->picYuvOrg.create    ( width, height, chromaFormat, maxCUWidth, maxCUHeight, maxCUDepth, true );
+    picture->picYuvTrueOrg.create( width, height, chromaFormat, maxCUWidth, maxCUHeight, maxCUDepth, true );
+    picture->adaptQPmap = NULL;
+    picture->isEof      = false;
+    m_pictures.push_back( picture );
+    m_freePictures.push_back( picture );
+  }
+}
+
+Void TAppEncLookahead::destroy()
+{
+  stop();
+  for( std::vector<Picture*>::iterator it = m_pictures.begin(); it != m_pictures.end(); it++ )
+  {
+    (*it)->picYuvOrg.destroy();
+    (*it)->picYuvTrueOrg.destroy();
+    delete *it;
+  }
+  m_pictures.clear();
+  m_freePictures.clear();
+  m_readyPictures.clear();
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+Void TAppEncLookahead::start( Int numPictures, const ReadFunc &read )
+{
+  assert( !m_thread.joinable() && !m_pictures.empty() );
+  m_read      = read;
+  m_terminate = false;
+  m_thread    = std::thread( &TAppEncLookahead::xThreadMain, this, numPictures );
+}
+
+Void TAppEncLookahead::stop()
+{
+  if( !m_thread.joinable() )
+  {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_terminate = true;
+  }
+  m_pictureFree.notify_all();
+  m_thread.join();
+}
+
+TAppEncLookahead::Picture* TAppEncLookahead::getNextPicture()
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  while( m_readyPictures.empty() )
+  {
+    m_pictureReady.wait( lock );
+  }
+  Picture *picture = m_readyPictures.front();
+  m_readyPictures.pop_front();
+  return picture;
+}
+
+Void TAppEncLookahead::releasePicture( Picture *picture )
+{
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_freePictures.push_back( picture );
+  }
+  m_pictureFree.notify_one();
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+Void TAppEncLookahead::xThreadMain( Int numPictures )
+{
+  for( Int pictureIdx = 0; pictureIdx < numPictures; pictureIdx++ )
+  {
+    Picture *picture;
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      while( m_freePictures.empty() && !m_terminate )
+      {
+        m_pictureFree.wait( lock );
+      }
+      if( m_terminate )
+      {
+        return;
+      }
+      picture = m_freePictures.front();
+      m_freePictures.pop_front();
+    }
+
+    picture->adaptQPmap = NULL;
+    picture->isEof      = false;
+    m_read( *picture );
+
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      m_readyPictures.push_back( picture );
+    }
+    m_pictureReady.notify_one();
+
+    if( picture->isEof )
+    {
+      return;
+    }
+  }
+}
+
+//! \}
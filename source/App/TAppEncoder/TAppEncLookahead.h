@@ -0,0 +1,104 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppEncLookahead.h
+    \brief    Lookahead stage of the encoder application (header)
+*/
+
+#ifndef __TAPPENCLOOKAHEAD__
+#define __TAPPENCLOOKAHEAD__
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+#include "TLibCommon/TComPicYuv.h"
+
+//! \ingroup TAppEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// thread reading, converting and pre-filtering the source pictures ahead of the encoder into a bounded queue
+class TAppEncLookahead
+{
+public:
+  /// a source picture in the queue
+  struct Picture
+  {
+    TComPicYuv  picYuvOrg;                                  ///< picture to be encoded, after conversion and pre-filtering
+    TComPicYuv  picYuvTrueOrg;                              ///< picture as read, used for the PSNR
+    Int        *adaptQPmap;                                 ///< per-CTU QP offsets of the temporal filter (BIM), NULL if none
+    Bool        isEof;                                      ///< the picture could not be read as the end of the file was reached
+  };
+  typedef std::function<Void(Picture&)> ReadFunc;           ///< prepares the next source picture, called on the lookahead thread
+
+  TAppEncLookahead();
+  virtual ~TAppEncLookahead();
+
+  /// allocate the pictures of a queue holding up to depth pictures in addition to the one being encoded
+  Void  create            ( Int depth, Int width, Int height, ChromaFormat chromaFormat, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth );
+  Void  destroy           ();
+
+  /// start the thread preparing numPictures pictures in order, or fewer if the end of the file is reached
+  Void  start             ( Int numPictures, const ReadFunc &read );
+  /// wait for the thread to finish. Pictures not yet prepared are discarded
+  Void  stop              ();
+
+  /// the next picture in input order. Blocks until it has been prepared
+  Picture* getNextPicture ();
+  /// return a picture obtained with getNextPicture() once the encoder has copied it
+  Void  releasePicture    ( Picture *picture );
+
+private:
+  Void  xThreadMain       ( Int numPictures );
+
+  std::vector<Picture*>     m_pictures;
+  std::deque<Picture*>      m_freePictures;
+  std::deque<Picture*>      m_readyPictures;
+  ReadFunc                  m_read;
+  std::thread               m_thread;
+  std::mutex                m_mutex;
+  std::condition_variable   m_pictureFree;
+  std::condition_variable   m_pictureReady;
+  Bool                      m_terminate;
+};
+
+//! \}
+
+#endif // __TAPPENCLOOKAHEAD__
@@ -44,6 +44,7 @@
 #include <iomanip>
 
 #include "TAppEncTop.h"
+#include "TAppEncLookahead.h"
 #include "TLibEncoder/TEncTemporalFilter.h"
 #include "TLibEncoder/AnnexBwrite.h"
 
@@ -174,6 +175,9 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setFastMEAssumingSmootherMVEnabled                   ( m_bFastMEAssumingSmootherMVEnabled );
   m_cTEncTop.setMinSearchWindow                                   ( m_minSearchWindow );
   m_cTEncTop.setRestrictMESampling                                ( m_bRestrictMESampling );
+  m_cTEncTop.setUseHierarchicalME                                 ( m_useHierarchicalME );
+  m_cTEncTop.setHierarchicalMESearchRange                         ( m_hierarchicalMESearchRange );
+  m_cTEncTop.setSubpelPlanes                                      ( m_subpelPlanes );
 
   //====== Quality control ========
   m_cTEncTop.setMaxDeltaQP                                        ( m_iMaxDeltaQP  );
@@ -214,6 +218,7 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setUseRDOQ                                           ( m_useRDOQ     );
   m_cTEncTop.setUseRDOQTS                                         ( m_useRDOQTS   );
   m_cTEncTop.setUseSelectiveRDOQ                                  ( m_useSelectiveRDOQ );
+  m_cTEncTop.setRDOQMaxTemporalLayer                              ( m_rdoqMaxTemporalLayer );
   m_cTEncTop.setRDpenalty                                         ( m_rdPenalty );
   m_cTEncTop.setMaxCUWidth                                        ( m_uiMaxCUWidth );
   m_cTEncTop.setMaxCUHeight                                       ( m_uiMaxCUHeight );
@@ -225,6 +230,13 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setQuadtreeTUMaxDepthIntra                           ( m_uiQuadtreeTUMaxDepthIntra );
   m_cTEncTop.setFastInterSearchMode                               ( m_fastInterSearchMode );
   m_cTEncTop.setUseEarlyCU                                        ( m_bUseEarlyCU  );
+  m_cTEncTop.setUseFastSplitDecision                              ( m_useFastSplitDecision );
+  m_cTEncTop.setFastSplitSkipSplitVar                             ( m_fastSplitSkipSplitVar );
+  m_cTEncTop.setFastSplitSkipNonSplitVar                          ( m_fastSplitSkipNonSplitVar );
+  m_cTEncTop.setFastSplitCostRatio                                ( m_fastSplitCostRatio );
+  m_cTEncTop.setDisableNxNPartitions                              ( m_disableNxNPartitions );
+  m_cTEncTop.setTemporalLayerMaxCUDepth                           ( m_temporalLayerMaxCUDepth );
+  m_cTEncTop.setFastUDINumModes                                   ( m_fastUDINumModes );
   m_cTEncTop.setUseFastDecisionForMerge                           ( m_useFastDecisionForMerge  );
   m_cTEncTop.setUseCbfFastMode                                    ( m_bUseCbfFastMode  );
   m_cTEncTop.setUseEarlySkipDetection                             ( m_useEarlySkipDetection );
@@ -505,6 +517,8 @@ Void TAppEncTop::xInitLibCfg()
   }
   m_cTEncTop.setLFCrossTileBoundaryFlag                           ( m_bLFCrossTileBoundaryFlag );
   m_cTEncTop.setEntropyCodingSyncEnabledFlag                      ( m_entropyCodingSyncEnabledFlag );
+  m_cTEncTop.setNumCtuThreads                                     ( m_numCtuThreads );
+  m_cTEncTop.setNumFrameThreads                                   ( m_numFrameThreads );
   m_cTEncTop.setTMVPModeId                                        ( m_TMVPModeId );
   m_cTEncTop.setUseScalingListId                                  ( m_useScalingListId  );
   m_cTEncTop.setScalingListFileName                               ( m_scalingListFileName );
@@ -663,6 +677,13 @@ Void TAppEncTop::encode()
   TExt360AppEncTop           ext360(*this, m_cTEncTop.getGOPEncoder()->getExt360Data(), *(m_cTEncTop.getGOPEncoder()), *pcPicYuvOrg);
 #endif
   TEncTemporalFilter temporalFilter;
+  TAppEncLookahead   lookahead;
+  std::map<Int, Int*> lookaheadQPmap; ///< BIM QP offsets of the pictures filtered on the lookahead thread, not yet passed to the encoder
+#if EXTENSION_360_VIDEO
+  const Bool useLookahead = m_lookaheadDepth > 0 && !ext360.isEnabled();
+#else
+  const Bool useLookahead = m_lookaheadDepth > 0;
+#endif
 #if JVET_Y0077_BIM
   if ( m_gopBasedTemporalFilterEnabled || m_bimEnabled )
 #else
@@ -674,29 +695,28 @@ Void TAppEncTop::encode()
       m_inputColourSpaceConvert, m_iQP, m_iGOPSize, m_gopBasedTemporalFilterStrengths,
       m_gopBasedTemporalFilterPastRefs, m_gopBasedTemporalFilterFutureRefs,
 #if !JVET_Y0077_BIM
-      m_firstValidFrame, m_lastValidFrame);
+      m_firstValidFrame, m_lastValidFrame,
 #else
       m_firstValidFrame, m_lastValidFrame,
-      m_gopBasedTemporalFilterEnabled, m_cTEncTop.getAdaptQPmap(), m_bimEnabled);
+      m_gopBasedTemporalFilterEnabled, useLookahead ? &lookaheadQPmap : m_cTEncTop.getAdaptQPmap(), m_bimEnabled,
 #endif
+      m_gopBasedTemporalFilterThreads);
   }
-  while ( !bEos )
-  {
-    // get buffers
-    xGetBuffer(pcPicYuvRec);
 
-    // read input YUV file
+  // read the source picture frameIdx, convert and pre-filter it. Returns true if the end of the file was reached instead
+  auto readPicture = [&]( TComPicYuv *picYuvOrg, TComPicYuv *picYuvTrueOrg, Int frameIdx ) -> Bool
+  {
 #if EXTENSION_360_VIDEO
     if (ext360.isEnabled())
     {
-      ext360.read(m_cTVideoIOYuvInputFile, *pcPicYuvOrg, cPicYuvTrueOrg, ipCSC);
+      ext360.read(m_cTVideoIOYuvInputFile, *picYuvOrg, *picYuvTrueOrg, ipCSC);
     }
     else
     {
-      m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, &cPicYuvTrueOrg, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+      m_cTVideoIOYuvInputFile.read( picYuvOrg, picYuvTrueOrg, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
     }
 #else
-    m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, &cPicYuvTrueOrg, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+    m_cTVideoIOYuvInputFile.read( picYuvOrg, picYuvTrueOrg, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
 #endif
 
 #if JVET_Y0077_BIM
@@ -705,7 +725,62 @@ Void TAppEncTop::encode()
     if (m_gopBasedTemporalFilterEnabled)
 #endif
     {
-      temporalFilter.filter(pcPicYuvOrg, m_iFrameRcvd);
+      temporalFilter.filter(picYuvOrg, frameIdx);
+    }
+
+    const Bool isEof = m_cTVideoIOYuvInputFile.isEof();
+
+    // temporally skip frames
+    if( m_temporalSubsampleRatio > 1 )
+    {
+      m_cTVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
+    }
+    return isEof;
+  };
+
+  // the lookahead thread prepares the pictures while the encoder compresses the earlier ones; it is the only user of the
+  // input file and of the temporal filter until it has finished
+  Int numFramesRead = 0;
+  if ( useLookahead )
+  {
+    lookahead.create( m_lookaheadDepth, m_sourceWidth, m_isField ? m_sourceHeightOrg : m_sourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxTotalCUDepth );
+    lookahead.start( m_isField ? m_framesToBeEncoded >> 1 : m_framesToBeEncoded, [&]( TAppEncLookahead::Picture &picture )
+    {
+      picture.isEof = readPicture( &picture.picYuvOrg, &picture.picYuvTrueOrg, numFramesRead );
+      std::map<Int, Int*>::iterator it = lookaheadQPmap.find( numFramesRead );
+      if ( it != lookaheadQPmap.end() )
+      {
+        picture.adaptQPmap = it->second;
+        lookaheadQPmap.erase( it );
+      }
+      numFramesRead++;
+    } );
+  }
+
+  while ( !bEos )
+  {
+    // get buffers
+    xGetBuffer(pcPicYuvRec);
+
+    // read input YUV file
+    TComPicYuv *picYuvOrg     = pcPicYuvOrg;
+    TComPicYuv *picYuvTrueOrg = &cPicYuvTrueOrg;
+    TAppEncLookahead::Picture *lookaheadPicture = NULL;
+    Bool isEof;
+    if ( useLookahead )
+    {
+      lookaheadPicture = lookahead.getNextPicture();
+      picYuvOrg        = &lookaheadPicture->picYuvOrg;
+      picYuvTrueOrg    = &lookaheadPicture->picYuvTrueOrg;
+      isEof            = lookaheadPicture->isEof;
+      if ( lookaheadPicture->adaptQPmap != NULL )
+      {
+        m_cTEncTop.getAdaptQPmap()->insert( { m_iFrameRcvd, lookaheadPicture->adaptQPmap } );
+      }
+    }
+    else
+    {
+      isEof = readPicture( pcPicYuvOrg, &cPicYuvTrueOrg, m_iFrameRcvd );
     }
 
     // increase number of received frames
@@ -715,7 +790,7 @@ Void TAppEncTop::encode()
 
     Bool flush = 0;
     // if end of file (which is only detected on a read failure) flush the encoder of any queued pictures
-    if (m_cTVideoIOYuvInputFile.isEof())
+    if (isEof)
     {
       flush = true;
       bEos = true;
@@ -726,33 +801,34 @@ Void TAppEncTop::encode()
     // call encoding function for one frame
     if ( m_isField )
     {
-      m_cTEncTop.encode( bEos, flush ? 0 : pcPicYuvOrg, flush ? 0 : &cPicYuvTrueOrg, ipCSC, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded, m_isTopFieldFirst );
+      m_cTEncTop.encode( bEos, flush ? 0 : picYuvOrg, flush ? 0 : picYuvTrueOrg, ipCSC, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded, m_isTopFieldFirst );
     }
     else
     {
-      m_cTEncTop.encode( bEos, flush ? 0 : pcPicYuvOrg, flush ? 0 : &cPicYuvTrueOrg, ipCSC, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+      m_cTEncTop.encode( bEos, flush ? 0 : picYuvOrg, flush ? 0 : picYuvTrueOrg, ipCSC, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
     }
 
 #if SHUTTER_INTERVAL_SEI_PROCESSING
     if (m_ShutterFilterEnable && !m_shutterIntervalPreFileName.empty())
     {
-      m_cTVideoIOYuvSIIPreFile.write(pcPicYuvOrg, ipCSC, m_confWinLeft, m_confWinRight, m_confWinTop, m_confWinBottom,
+      m_cTVideoIOYuvSIIPreFile.write(picYuvOrg, ipCSC, m_confWinLeft, m_confWinRight, m_confWinTop, m_confWinBottom,
         NUM_CHROMA_FORMAT, m_bClipOutputVideoToRec709Range);
     }
 #endif
 
+    if ( lookaheadPicture != NULL )
+    {
+      lookahead.releasePicture( lookaheadPicture );
+    }
+
     // write bistream to file if necessary
     if ( iNumEncoded > 0 )
     {
       xWriteOutput(bitstreamFile, iNumEncoded, outputAccessUnits);
       outputAccessUnits.clear();
     }
-    // temporally skip frames
-    if( m_temporalSubsampleRatio > 1 )
-    {
-      m_cTVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
-    }
   }
+  lookahead.destroy();
 
   m_cTEncTop.printSummary(m_isField);
 
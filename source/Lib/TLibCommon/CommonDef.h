@@ -136,6 +136,9 @@ static const Int MAX_TLAYER =                                       7; ///< Expl
 
 static const Int ADAPT_SR_SCALE =                                   1; ///< division factor for adaptive search range
 
+static const Int NUM_HIERARCHICAL_ME_LEVELS =                       2; ///< number of subsampled levels (1/2 and 1/4) of the hierarchical motion search
+static const Int HIERARCHICAL_ME_BLOCK_SIZE =                       8; ///< size of the luma blocks getting a coarse MV from the hierarchical motion search
+
 static const Int MAX_NUM_PICS_IN_SOP =                           1024;
 
 static const Int MAX_NESTING_NUM_OPS =                           1024;
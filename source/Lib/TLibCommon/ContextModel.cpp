@@ -90,6 +90,7 @@ const UChar ContextModel::m_aucNextStateLPS[ ContextModel::m_totalStates ] =
 
 #if FAST_BIT_EST
 UChar ContextModel::m_nextState[ ContextModel::m_totalStates ][2 /*MPS = [0|1]*/];
+UInt  ContextModel::m_nextStateAndBits[ ContextModel::m_totalStates ][2 /*MPS = [0|1]*/];
 
 Void ContextModel::buildNextStateTable()
 {
@@ -98,6 +99,8 @@ Void ContextModel::buildNextStateTable()
     for (Int j = 0; j < 2; j++)
     {
       m_nextState[i][j] = ((i&1) == j) ? m_aucNextStateMPS[i] : m_aucNextStateLPS[i];
+      assert( m_entropyBits[i ^ j] < ( 1 << 24 ) );
+      m_nextStateAndBits[i][j] = ( UInt( m_entropyBits[i ^ j] ) << 8 ) | m_nextState[i][j];
     }
   }
 }
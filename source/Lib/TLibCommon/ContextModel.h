@@ -63,6 +63,7 @@ public:
   UChar getState  ()                { return ( m_ucState >> 1 ); }                    ///< get current state
   UChar getMps    ()                { return ( m_ucState  & 1 ); }                    ///< get curret MPS
   Void  setStateAndMps( UChar ucState, UChar ucMPS) { m_ucState = (ucState << 1) + ucMPS; } ///< set state and MPS
+  UChar getPackedState() const     { return m_ucState; }                                ///< get state and MPS packed as ( state << 1 ) | MPS
 
   Void init ( Int qp, Int initValue );   ///< initialize state with initial probability
 
@@ -76,6 +77,11 @@ public:
     m_ucState = m_aucNextStateMPS[ m_ucState ];
   }
 
+  Void updateState ( Bool bLPS )
+  {
+    m_ucState = bLPS ? m_aucNextStateLPS[ m_ucState ] : m_aucNextStateMPS[ m_ucState ];
+  }
+
   Int getEntropyBits(Short val) { return m_entropyBits[m_ucState ^ val]; }
 
 #if FAST_BIT_EST
@@ -83,10 +89,16 @@ public:
   {
     m_ucState = m_nextState[m_ucState][binVal];
   }
+  Int  updateAndGetEntropyBits( UInt binVal )                                                 ///< update state and return the fractional bits of binVal, with a single table look-up
+  {
+    const UInt entry = m_nextStateAndBits[m_ucState][binVal];
+    m_ucState = UChar( entry & 0xff );
+    return Int( entry >> 8 );
+  }
   static Void buildNextStateTable();
   static Int getEntropyBitsTrm( Int val ) { return m_entropyBits[126 ^ val]; }
 #endif
-  Void setBinsCoded(UInt val)   { m_binsCoded = val;  }
+  Void setBinsCoded(UInt val)   { m_binsCoded = val ? 1 : 0; } ///< only records whether any bin has been coded with this context
   UInt getBinsCoded()           { return m_binsCoded;   }
 
 private:
@@ -98,8 +110,9 @@ private:
   static const  Int   m_entropyBits    [m_totalStates];
 #if FAST_BIT_EST
   static UChar m_nextState[m_totalStates][2 /*MPS = [0|1]*/];
+  static UInt  m_nextStateAndBits[m_totalStates][2 /*MPS = [0|1]*/];                        ///< ( entropy bits << 8 ) | next state
 #endif
-  UInt          m_binsCoded;
+  UChar         m_binsCoded;                                                                ///< 1 if a bin has been coded; kept as a byte so that a context model is 2 bytes and RD state copies stay small
 };
 
 //! \}
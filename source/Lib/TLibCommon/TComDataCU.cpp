@@ -3135,6 +3135,7 @@ Void TComDataCU::compressMV()
     memcpy(dpbForCtu.m_pePartSize, m_pePartSize, sizeof(*m_pePartSize)*m_uiNumPartition);
     dpbForCtu.m_pSlice = getSlice();
   }
+  memcpy(dpbForCtu.m_puhDepth, m_puhDepth, sizeof(*m_puhDepth)*m_uiNumPartition);
 #else
   Int scaleFactor = 4 * AMVP_DECIMATION_FACTOR / m_unitSize;
   if (scaleFactor > 0)
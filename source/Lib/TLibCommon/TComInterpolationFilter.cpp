@@ -45,6 +45,9 @@
 #include <assert.h>
 
 #include "TComChromaFormat.h"
+#if ENABLE_SIMD_OPT_MCIF
+#include "x86/CommonDefX86.h"
+#endif
 
 #if VECTOR_CODING__INTERPOLATION_FILTER && (RExt__HIGH_BIT_DEPTH_SUPPORT==0)
 #include <emmintrin.h>
@@ -491,72 +494,51 @@ Void TComInterpolationFilter::filter(Int bitDepth, Pel const *src, Int srcStride
   }
 }
 
-/**
- * \brief Filter a block of samples (horizontal)
- *
- * \tparam N          Number of taps
- * \param  bitDepth   Bit depth of samples
- * \param  src        Pointer to source samples
- * \param  srcStride  Stride of source samples
- * \param  dst        Pointer to destination samples
- * \param  dstStride  Stride of destination samples
- * \param  width      Width of block
- * \param  height     Height of block
- * \param  isLast     Flag indicating whether it is the last filtering operation
- * \param  coeff      Pointer to filter taps
- */
-template<Int N>
-Void TComInterpolationFilter::filterHor(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isLast, TFilterCoeff const *coeff)
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+TComInterpolationFilter::TComInterpolationFilter()
 {
-  if ( isLast )
-  {
-    filter<N, false, true, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
-  }
-  else
-  {
-    filter<N, false, true, false>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
-  }
+  m_filterHor[0][0]    = filter<NTAPS_CHROMA, false, true,  false>;
+  m_filterHor[0][1]    = filter<NTAPS_CHROMA, false, true,  true >;
+  m_filterHor[1][0]    = filter<NTAPS_LUMA,   false, true,  false>;
+  m_filterHor[1][1]    = filter<NTAPS_LUMA,   false, true,  true >;
+
+  m_filterVer[0][0][0] = filter<NTAPS_CHROMA, true,  false, false>;
+  m_filterVer[0][0][1] = filter<NTAPS_CHROMA, true,  false, true >;
+  m_filterVer[0][1][0] = filter<NTAPS_CHROMA, true,  true,  false>;
+  m_filterVer[0][1][1] = filter<NTAPS_CHROMA, true,  true,  true >;
+  m_filterVer[1][0][0] = filter<NTAPS_LUMA,   true,  false, false>;
+  m_filterVer[1][0][1] = filter<NTAPS_LUMA,   true,  false, true >;
+  m_filterVer[1][1][0] = filter<NTAPS_LUMA,   true,  true,  false>;
+  m_filterVer[1][1][1] = filter<NTAPS_LUMA,   true,  true,  true >;
+
+  m_filterCopy         = filterCopy;
+
+#if ENABLE_SIMD_OPT_MCIF
+  initInterpolationFilterX86();
+#endif
 }
 
+#if ENABLE_SIMD_OPT_MCIF
 /**
- * \brief Filter a block of samples (vertical)
- *
- * \tparam N          Number of taps
- * \param  bitDepth   Bit depth
- * \param  src        Pointer to source samples
- * \param  srcStride  Stride of source samples
- * \param  dst        Pointer to destination samples
- * \param  dstStride  Stride of destination samples
- * \param  width      Width of block
- * \param  height     Height of block
- * \param  isFirst    Flag indicating whether it is the first filtering operation
- * \param  isLast     Flag indicating whether it is the last filtering operation
- * \param  coeff      Pointer to filter taps
+ * \brief Replace the C filters with the kernels for the best vector extension of the CPU
  */
-template<Int N>
-Void TComInterpolationFilter::filterVer(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff)
+Void TComInterpolationFilter::initInterpolationFilterX86()
 {
-  if ( isFirst && isLast )
-  {
-    filter<N, true, true, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
-  }
-  else if ( isFirst && !isLast )
-  {
-    filter<N, true, true, false>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
-  }
-  else if ( !isFirst && isLast )
+  const X86_VEXT vext = getX86Extension();
+
+  if( vext >= AVX2 )
   {
-    filter<N, true, false, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+    xInitInterpolationFilterX86<AVX2>();
   }
-  else
+  else if( vext >= SSE41 )
   {
-    filter<N, true, false, false>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+    xInitInterpolationFilterX86<SSE41>();
   }
 }
-
-// ====================================================================================================================
-// Public member functions
-// ====================================================================================================================
+#endif
 
 /**
  * \brief Filter a block of Luma/Chroma samples (horizontal)
@@ -577,18 +559,18 @@ Void TComInterpolationFilter::filterHor(const ComponentID compID, Pel *src, Int
 {
   if ( frac == 0 )
   {
-    filterCopy(bitDepth, src, srcStride, dst, dstStride, width, height, true, isLast );
+    m_filterCopy(bitDepth, src, srcStride, dst, dstStride, width, height, true, isLast );
   }
   else if (isLuma(compID))
   {
     assert(frac >= 0 && frac < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS);
-    filterHor<NTAPS_LUMA>(bitDepth, src, srcStride, dst, dstStride, width, height, isLast, m_lumaFilter[frac]);
+    m_filterHor[1][isLast](bitDepth, src, srcStride, dst, dstStride, width, height, m_lumaFilter[frac]);
   }
   else
   {
     const UInt csx = getComponentScaleX(compID, fmt);
     assert(frac >=0 && csx<2 && (frac<<(1-csx)) < CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS);
-    filterHor<NTAPS_CHROMA>(bitDepth, src, srcStride, dst, dstStride, width, height, isLast, m_chromaFilter[frac<<(1-csx)]);
+    m_filterHor[0][isLast](bitDepth, src, srcStride, dst, dstStride, width, height, m_chromaFilter[frac<<(1-csx)]);
   }
 }
 
@@ -613,18 +595,18 @@ Void TComInterpolationFilter::filterVer(const ComponentID compID, Pel *src, Int
 {
   if ( frac == 0 )
   {
-    filterCopy(bitDepth, src, srcStride, dst, dstStride, width, height, isFirst, isLast );
+    m_filterCopy(bitDepth, src, srcStride, dst, dstStride, width, height, isFirst, isLast );
   }
   else if (isLuma(compID))
   {
     assert(frac >= 0 && frac < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS);
-    filterVer<NTAPS_LUMA>(bitDepth, src, srcStride, dst, dstStride, width, height, isFirst, isLast, m_lumaFilter[frac]);
+    m_filterVer[1][isFirst][isLast](bitDepth, src, srcStride, dst, dstStride, width, height, m_lumaFilter[frac]);
   }
   else
   {
     const UInt csy = getComponentScaleY(compID, fmt);
     assert(frac >=0 && csy<2 && (frac<<(1-csy)) < CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS);
-    filterVer<NTAPS_CHROMA>(bitDepth, src, srcStride, dst, dstStride, width, height, isFirst, isLast, m_chromaFilter[frac<<(1-csy)]);
+    m_filterVer[0][isFirst][isLast](bitDepth, src, srcStride, dst, dstStride, width, height, m_chromaFilter[frac<<(1-csy)]);
   }
 }
 
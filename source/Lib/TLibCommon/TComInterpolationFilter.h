@@ -58,18 +58,31 @@ class TComInterpolationFilter
   static const TFilterCoeff m_lumaFilter[LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][NTAPS_LUMA];     ///< Luma filter taps
   static const TFilterCoeff m_chromaFilter[CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][NTAPS_CHROMA]; ///< Chroma filter taps
 
+  typedef Void (*FpFilter)    (Int bitDepth, Pel const *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff);
+  typedef Void (*FpFilterCopy)(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
+
+  FpFilter     m_filterHor[2][2];    ///< [isLuma][isLast]
+  FpFilter     m_filterVer[2][2][2]; ///< [isLuma][isFirst][isLast]
+  FpFilterCopy m_filterCopy;
+
   static Void filterCopy(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
 
   template<Int N, Bool isVertical, Bool isFirst, Bool isLast>
   static Void filter(Int bitDepth, Pel const *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff);
 
-  template<Int N>
-  static Void filterHor(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height,               Bool isLast, TFilterCoeff const *coeff);
-  template<Int N>
-  static Void filterVer(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff);
+#if ENABLE_SIMD_OPT_MCIF
+  // SIMD kernels (x86/TComInterpolationFilterX86.h)
+  template<X86_VEXT vext, Int N, Bool isVertical, Bool isFirst, Bool isLast>
+  static Void xFilter_SIMD(Int bitDepth, Pel const *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff);
+  template<X86_VEXT vext>
+  static Void xFilterCopy_SIMD(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
+
+  template<X86_VEXT vext> Void xInitInterpolationFilterX86();
+  Void initInterpolationFilterX86();
+#endif
 
 public:
-  TComInterpolationFilter() {}
+  TComInterpolationFilter();
   ~TComInterpolationFilter() {}
 
   Void filterHor(const ComponentID compID, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Int frac,               Bool isLast, const ChromaFormat fmt, const Int bitDepth );
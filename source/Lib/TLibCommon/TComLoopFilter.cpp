@@ -73,6 +73,7 @@ const UChar TComLoopFilter::sm_betaTable[MAX_QP + 1] =
 TComLoopFilter::TComLoopFilter()
 : m_uiNumPartitions(0)
 , m_bLFCrossTileBoundary(true)
+, m_pcThreadPool(NULL)
 {
   for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
   {
@@ -91,9 +92,20 @@ TComLoopFilter::~TComLoopFilter()
 Void TComLoopFilter::setCfg( Bool bLFCrossTileBoundary )
 {
   m_bLFCrossTileBoundary = bLFCrossTileBoundary;
+  for( Int threadIdx = 0; threadIdx < Int(m_threadLoopFilters.size()); threadIdx++ )
+  {
+    m_threadLoopFilters[threadIdx]->setCfg( bLFCrossTileBoundary );
+  }
 }
 
-Void TComLoopFilter::create( UInt uiMaxCUDepth )
+/**
+ - allocate the boundary strength buffers
+ - when a pool with several threads is given, the picture-level deblocking is distributed over its threads
+ .
+ \param uiMaxCUDepth  maximum CU depth
+ \param pcThreadPool  pool of threads, or NULL for serial deblocking
+ */
+Void TComLoopFilter::create( UInt uiMaxCUDepth, TComThreadPool* pcThreadPool )
 {
   destroy();
   m_uiNumPartitions = 1 << ( uiMaxCUDepth<<1 );
@@ -102,6 +114,18 @@ Void TComLoopFilter::create( UInt uiMaxCUDepth )
     m_aapucBS       [edgeDir] = new UChar[m_uiNumPartitions];
     m_aapbEdgeFilter[edgeDir] = new Bool [m_uiNumPartitions];
   }
+
+  if( pcThreadPool != NULL && pcThreadPool->getNumThreads() > 1 )
+  {
+    m_pcThreadPool = pcThreadPool;
+    for( Int threadIdx = 0; threadIdx < pcThreadPool->getNumThreads(); threadIdx++ )
+    {
+      TComLoopFilter* pcLoopFilter = new TComLoopFilter;
+      pcLoopFilter->create( uiMaxCUDepth );
+      pcLoopFilter->setCfg( m_bLFCrossTileBoundary );
+      m_threadLoopFilters.push_back( pcLoopFilter );
+    }
+  }
 }
 
 Void TComLoopFilter::destroy()
@@ -120,6 +144,14 @@ Void TComLoopFilter::destroy()
       m_aapbEdgeFilter[edgeDir] = NULL;
     }
   }
+
+  for( Int threadIdx = 0; threadIdx < Int(m_threadLoopFilters.size()); threadIdx++ )
+  {
+    m_threadLoopFilters[threadIdx]->destroy();
+    delete m_threadLoopFilters[threadIdx];
+  }
+  m_threadLoopFilters.clear();
+  m_pcThreadPool = NULL;
 }
 
 /**
@@ -129,35 +161,103 @@ Void TComLoopFilter::destroy()
  */
 Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
 {
-  // Horizontal filtering
-  for ( UInt ctuRsAddr = 0; ctuRsAddr < pcPic->getNumberOfCtusInFrame(); ctuRsAddr++ )
+  if( m_pcThreadPool != NULL )
   {
-    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
-
-    ::memset( m_aapucBS       [EDGE_VER], 0, sizeof( UChar ) * m_uiNumPartitions );
-    ::memset( m_aapbEdgeFilter[EDGE_VER], 0, sizeof( Bool  ) * m_uiNumPartitions );
-
-    // CU-based deblocking
-    xDeblockCU( pCtu, 0, 0, EDGE_VER );
+    xLoopFilterPicParallel( pcPic );
+    return;
   }
 
+  // Horizontal filtering
+  xDeblockCtus( pcPic, 0, pcPic->getNumberOfCtusInFrame(), EDGE_VER );
+
   // Vertical filtering
-  for ( UInt ctuRsAddr = 0; ctuRsAddr < pcPic->getNumberOfCtusInFrame(); ctuRsAddr++ )
+  xDeblockCtus( pcPic, 0, pcPic->getNumberOfCtusInFrame(), EDGE_HOR );
+}
+
+/**
+ - filter the vertical and then the horizontal edges of one CTU row
+ - the result is identical to loopFilterPic once all the rows have been filtered in top to bottom order:
+   the vertical edges of a row only modify samples of that row, and the horizontal edges at the top of a row only
+   modify the last three sample lines of the row above, which none of the edges of the row above reads or modifies
+ .
+ \param pcPic      picture class (TComPic) pointer
+ \param ctuRowIdx  CTU row to filter
+ */
+Void TComLoopFilter::loopFilterCtuRow( TComPic* pcPic, UInt ctuRowIdx )
+{
+  const UInt frameWidthInCtus  = pcPic->getFrameWidthInCtus();
+  const UInt startCtuRsAddr    = ctuRowIdx * frameWidthInCtus;
+  const UInt boundingCtuRsAddr = startCtuRsAddr + frameWidthInCtus;
+
+  xDeblockCtus( pcPic, startCtuRsAddr, boundingCtuRsAddr, EDGE_VER );
+  xDeblockCtus( pcPic, startCtuRsAddr, boundingCtuRsAddr, EDGE_HOR );
+}
+
+
+// ====================================================================================================================
+// Protected member functions
+// ====================================================================================================================
+
+/**
+ Deblocking of the edges of one direction in the CTUs [startCtuRsAddr, boundingCtuRsAddr), in raster scan order
+
+ \param pcPic              picture class (TComPic) pointer
+ \param startCtuRsAddr     first CTU to filter
+ \param boundingCtuRsAddr  CTU following the last CTU to filter
+ \param edgeDir            the direction of the edges to filter
+*/
+Void TComLoopFilter::xDeblockCtus( TComPic* pcPic, UInt startCtuRsAddr, UInt boundingCtuRsAddr, DeblockEdgeDir edgeDir )
+{
+  for ( UInt ctuRsAddr = startCtuRsAddr; ctuRsAddr < boundingCtuRsAddr; ctuRsAddr++ )
   {
     TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
 
-    ::memset( m_aapucBS       [EDGE_HOR], 0, sizeof( UChar ) * m_uiNumPartitions );
-    ::memset( m_aapbEdgeFilter[EDGE_HOR], 0, sizeof( Bool  ) * m_uiNumPartitions );
+    ::memset( m_aapucBS       [edgeDir], 0, sizeof( UChar ) * m_uiNumPartitions );
+    ::memset( m_aapbEdgeFilter[edgeDir], 0, sizeof( Bool  ) * m_uiNumPartitions );
 
     // CU-based deblocking
-    xDeblockCU( pCtu, 0, 0, EDGE_HOR );
+    xDeblockCU( pCtu, 0, 0, edgeDir );
   }
 }
 
+/**
+ Picture-level deblocking with the same result as the serial deblocking: the vertical edges are filtered one CTU row per job,
+ as they only modify samples of their own row, then the horizontal edges are filtered one band of CTU columns per job, as they
+ only modify samples of their own columns.
 
-// ====================================================================================================================
-// Protected member functions
-// ====================================================================================================================
+ \param pcPic  picture class (TComPic) pointer
+*/
+Void TComLoopFilter::xLoopFilterPicParallel( TComPic* pcPic )
+{
+  const UInt frameWidthInCtus  = pcPic->getFrameWidthInCtus();
+  const UInt frameHeightInCtus = pcPic->getFrameHeightInCtus();
+
+  // Horizontal filtering
+  for ( UInt ctuRowIdx = 0; ctuRowIdx < frameHeightInCtus; ctuRowIdx++ )
+  {
+    m_pcThreadPool->addJob( [this, pcPic, ctuRowIdx, frameWidthInCtus]( Int threadIdx )
+    {
+      m_threadLoopFilters[threadIdx]->xDeblockCtus( pcPic, ctuRowIdx*frameWidthInCtus, (ctuRowIdx+1)*frameWidthInCtus, EDGE_VER );
+    } );
+  }
+  m_pcThreadPool->waitForJobs();
+
+  // Vertical filtering
+  const UInt numBands = std::min<UInt>( frameWidthInCtus, m_pcThreadPool->getNumThreads() );
+  for ( UInt bandIdx = 0; bandIdx < numBands; bandIdx++ )
+  {
+    const UInt startCtuX    = ( bandIdx     * frameWidthInCtus ) / numBands;
+    const UInt boundingCtuX = ( (bandIdx+1) * frameWidthInCtus ) / numBands;
+    m_pcThreadPool->addJob( [this, pcPic, startCtuX, boundingCtuX, frameWidthInCtus, frameHeightInCtus]( Int threadIdx )
+    {
+      for ( UInt ctuRowIdx = 0; ctuRowIdx < frameHeightInCtus; ctuRowIdx++ )
+      {
+        m_threadLoopFilters[threadIdx]->xDeblockCtus( pcPic, ctuRowIdx*frameWidthInCtus + startCtuX, ctuRowIdx*frameWidthInCtus + boundingCtuX, EDGE_HOR );
+      }
+    } );
+  }
+  m_pcThreadPool->waitForJobs();
+}
 
 /**
  Deblocking filter process in CU-based (the same function as conventional's)
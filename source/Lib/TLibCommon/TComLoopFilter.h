@@ -40,6 +40,7 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#include "TComThreadPool.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -62,9 +63,16 @@ private:
 
   Bool      m_bLFCrossTileBoundary;
 
+  TComThreadPool*               m_pcThreadPool;       ///< threads deblocking CTU rows and CTU columns concurrently (NULL: serial deblocking)
+  std::vector<TComLoopFilter*>  m_threadLoopFilters;  ///< filters with their own boundary strength buffers, one per thread of the pool
+
 protected:
   /// CU-level deblocking function
   Void xDeblockCU                 ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir );
+  /// deblocking of the edges of one direction in a range of CTUs
+  Void xDeblockCtus               ( TComPic* pcPic, UInt startCtuRsAddr, UInt boundingCtuRsAddr, DeblockEdgeDir edgeDir );
+  /// picture-level deblocking on the threads of the pool
+  Void xLoopFilterPicParallel     ( TComPic* pcPic );
 
   // set / get functions
   Void xSetLoopfilterParam        ( TComDataCU* pcCU, UInt uiAbsZorderIdx );
@@ -122,7 +130,7 @@ public:
   TComLoopFilter();
   virtual ~TComLoopFilter();
 
-  Void  create                    ( UInt uiMaxCUDepth );
+  Void  create                    ( UInt uiMaxCUDepth, TComThreadPool* pcThreadPool = NULL );
   Void  destroy                   ();
 
   /// set configuration
@@ -130,6 +138,8 @@ public:
 
   /// picture-level deblocking filter
   Void loopFilterPic( TComPic* pcPic );
+  /// CTU-row-level deblocking filter, to be called for the CTU rows in top to bottom order
+  Void loopFilterCtuRow( TComPic* pcPic, UInt ctuRowIdx );
 
   static Int getBeta( Int qp )
   {
@@ -195,6 +195,8 @@ Void TComPicSym::prepareForReconstruction()
       memset(m_dpbPerCtuData[i].m_pePredMode, NUMBER_OF_PREDICTION_MODES, m_numPartitionsInCtu);
       m_dpbPerCtuData[i].m_pePartSize = new SChar[m_numPartitionsInCtu];
       memset(m_dpbPerCtuData[i].m_pePartSize, NUMBER_OF_PART_SIZES, m_numPartitionsInCtu);
+      m_dpbPerCtuData[i].m_puhDepth = new UChar[m_numPartitionsInCtu];
+      memset(m_dpbPerCtuData[i].m_puhDepth, 0, m_numPartitionsInCtu);
       m_dpbPerCtuData[i].m_pSlice=NULL;
     }
   }
@@ -232,6 +234,7 @@ Void TComPicSym::releaseAllReconstructionData()
       }
       delete [] m_dpbPerCtuData[i].m_pePredMode;
       delete [] m_dpbPerCtuData[i].m_pePartSize;
+      delete [] m_dpbPerCtuData[i].m_puhDepth;
     }
     delete [] m_dpbPerCtuData;
     m_dpbPerCtuData=NULL;
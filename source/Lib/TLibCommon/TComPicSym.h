@@ -116,9 +116,11 @@ public:
     PartSize getPartitionSize( const UInt absPartAddr ) const { return static_cast<PartSize>( m_pePartSize[absPartAddr] ); }
     const TComCUMvField* getCUMvField ( RefPicList e )  const { return &m_CUMvField[e];                  }
     const TComSlice* getSlice()                         const { return m_pSlice; }
+    UChar getDepth( const UInt absPartAddr )            const { return m_puhDepth[absPartAddr]; }
 
     SChar        * m_pePredMode;
     SChar        * m_pePartSize;
+    UChar        * m_puhDepth;
     TComCUMvField  m_CUMvField[NUM_REF_PIC_LIST_01];
     TComSlice    * m_pSlice;
   };
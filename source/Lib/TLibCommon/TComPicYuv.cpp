@@ -225,6 +225,45 @@ Void  TComPicYuv::copyToPic (TComPicYuv*  pcPicYuvDst) const
   }
 }
 
+/** Copies a range of lines of the picture. When the buffers have the same layout, the lines are copied together
+ *  with their margins, and with the vertical margins when the range reaches the top or the bottom of the picture,
+ *  so that copying the whole picture range by range gives the same buffer as copyToPic.
+ */
+Void  TComPicYuv::copyToPic (TComPicYuv*  pcPicYuvDst, const Int lumaPosY, const Int lumaHeight) const
+{
+  assert( m_chromaFormatIDC == pcPicYuvDst->getChromaFormat() );
+
+  for(Int comp=0; comp<getNumberValidComponents(); comp++)
+  {
+    const ComponentID compId=ComponentID(comp);
+    const Int width     = getWidth(compId);
+    const Int csy       = getComponentScaleY(compId);
+    const Int posY      = lumaPosY >> csy;
+    const Int endPosY   = std::min(lumaPosY + lumaHeight, m_picHeight) >> csy;
+    const Int strideSrc = getStride(compId);
+    assert(pcPicYuvDst->getWidth(compId) == width);
+    assert(pcPicYuvDst->getHeight(compId) == getHeight(compId));
+    if (strideSrc==pcPicYuvDst->getStride(compId) && getMarginY(compId)==pcPicYuvDst->getMarginY(compId))
+    {
+      const Int marginY   = getMarginY(compId);
+      const Int firstLine = (posY == 0) ? 0 : marginY + posY;
+      const Int endLine   = (endPosY == getHeight(compId)) ? getTotalHeight(compId) : marginY + endPosY;
+      ::memcpy ( pcPicYuvDst->getBuf(compId) + firstLine*strideSrc, getBuf(compId) + firstLine*strideSrc, sizeof(Pel)*strideSrc*(endLine-firstLine));
+    }
+    else
+    {
+      const UInt strideDest = pcPicYuvDst->getStride(compId);
+      const Pel *pSrc       = getAddr(compId) + posY*strideSrc;
+            Pel *pDest      = pcPicYuvDst->getAddr(compId) + posY*strideDest;
+
+      for(Int y=posY; y<endPosY; y++, pSrc+=strideSrc, pDest+=strideDest)
+      {
+        ::memcpy(pDest, pSrc, width*sizeof(Pel));
+      }
+    }
+  }
+}
+
 
 Void TComPicYuv::extendPicBorder ()
 {
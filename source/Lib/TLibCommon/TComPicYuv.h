@@ -159,6 +159,7 @@ public:
 
   //  Copy function to picture
   Void          copyToPic         ( TComPicYuv*  pcPicYuvDst ) const ;
+  Void          copyToPic         ( TComPicYuv*  pcPicYuvDst, const Int lumaPosY, const Int lumaHeight ) const ; ///< copies the lines [lumaPosY, lumaPosY+lumaHeight) of the picture
 
   //  Extend function of picture buffer
   Void          extendPicBorder   ();
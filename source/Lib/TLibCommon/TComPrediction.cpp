@@ -40,6 +40,10 @@
 #include "TComPic.h"
 #include "TComTU.h"
 
+#if ENABLE_SIMD_OPT_INTRA
+#include "x86/CommonDefX86.h"
+#endif
+
 //! \ingroup TLibCommon
 //! \{
 
@@ -81,8 +85,39 @@ TComPrediction::TComPrediction()
       m_piYuvExt[ch][buf] = NULL;
     }
   }
+
+  for(UInt i=0; i<MAX_INTRA_ANG_BLOCK_SIZES; i++)
+  {
+    m_fpPredIntraAngRows[i] = xPredIntraAngRows;
+  }
+  m_fpTransposeBlock  = xTransposeBlock;
+  m_fpPredIntraPlanar = xPredIntraPlanar;
+  m_fpDCPredFiltering = xDCPredFiltering;
+
+#if ENABLE_SIMD_OPT_INTRA
+  initPredictionX86();
+#endif
 }
 
+#if ENABLE_SIMD_OPT_INTRA
+/**
+ * \brief Replace the C intra prediction functions with the kernels for the best vector extension of the CPU
+ */
+Void TComPrediction::initPredictionX86()
+{
+  const X86_VEXT vext = getX86Extension();
+
+  if( vext >= AVX2 )
+  {
+    xInitPredictionX86<AVX2>();
+  }
+  else if( vext >= SSE41 )
+  {
+    xInitPredictionX86<SSE41>();
+  }
+}
+#endif
+
 TComPrediction::~TComPrediction()
 {
   destroy();
@@ -321,69 +356,79 @@ Void TComPrediction::xPredIntraAng(       Int bitDepth,
       std::swap(width, height);
     }
 
-    if (intraPredAngle == 0)  // pure vertical or pure horizontal
+    assert( g_aucConvertToBit[ width ] >= 0 && g_aucConvertToBit[ width ] < MAX_INTRA_ANG_BLOCK_SIZES );
+    m_fpPredIntraAngRows[ g_aucConvertToBit[ width ] ]( refMain, pDst, dstStride, width, height, intraPredAngle );
+
+    if (intraPredAngle == 0 && edgeFilter)  // pure vertical or pure horizontal
     {
       for (Int y=0;y<height;y++)
       {
-        for (Int x=0;x<width;x++)
-        {
-          pDst[y*dstStride+x] = refMain[x+1];
-        }
+        pDst[y*dstStride] = Clip3 (0, ((1 << bitDepth) - 1), pDst[y*dstStride] + (( refSide[y+1] - refSide[0] ) >> 1) );
       }
+    }
+
+    // Flip the block if this is the horizontal mode
+    if (!bIsModeVer)
+    {
+      m_fpTransposeBlock( pDst, dstStride, pTrueDst, dstStrideTrue, width, height );
+    }
+  }
+}
+
+/** Derive the rows of an angular prediction from the main reference.
+ * \param refMain        main reference array, refMain[1] being the sample above (or left of) the first column (row)
+ * \param pDst           pointer to the prediction sample array
+ * \param dstStride      the stride of the prediction sample array
+ * \param width          the width of the block (in the direction of the main reference)
+ * \param height         the height of the block
+ * \param intraPredAngle displacement per row in 1/32 sample units
+ */
+Void TComPrediction::xPredIntraAngRows( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle )
+{
+  Pel *pDsty=pDst;
+
+  for (Int y=0, deltaPos=intraPredAngle; y<height; y++, deltaPos+=intraPredAngle, pDsty+=dstStride)
+  {
+    const Int deltaInt   = deltaPos >> 5;
+    const Int deltaFract = deltaPos & (32 - 1);
 
-      if (edgeFilter)
+    if (deltaFract)
+    {
+      // Do linear filtering
+      const Pel *pRM=refMain+deltaInt+1;
+      Int lastRefMainPel=*pRM++;
+      for (Int x=0;x<width;pRM++,x++)
       {
-        for (Int y=0;y<height;y++)
-        {
-          pDst[y*dstStride] = Clip3 (0, ((1 << bitDepth) - 1), pDst[y*dstStride] + (( refSide[y+1] - refSide[0] ) >> 1) );
-        }
+        Int thisRefMainPel=*pRM;
+        pDsty[x+0] = (Pel) ( ((32-deltaFract)*lastRefMainPel + deltaFract*thisRefMainPel +16) >> 5 );
+        lastRefMainPel=thisRefMainPel;
       }
     }
     else
     {
-      Pel *pDsty=pDst;
-
-      for (Int y=0, deltaPos=intraPredAngle; y<height; y++, deltaPos+=intraPredAngle, pDsty+=dstStride)
+      // Just copy the integer samples
+      for (Int x=0;x<width; x++)
       {
-        const Int deltaInt   = deltaPos >> 5;
-        const Int deltaFract = deltaPos & (32 - 1);
-
-        if (deltaFract)
-        {
-          // Do linear filtering
-          const Pel *pRM=refMain+deltaInt+1;
-          Int lastRefMainPel=*pRM++;
-          for (Int x=0;x<width;pRM++,x++)
-          {
-            Int thisRefMainPel=*pRM;
-            pDsty[x+0] = (Pel) ( ((32-deltaFract)*lastRefMainPel + deltaFract*thisRefMainPel +16) >> 5 );
-            lastRefMainPel=thisRefMainPel;
-          }
-        }
-        else
-        {
-          // Just copy the integer samples
-          for (Int x=0;x<width; x++)
-          {
-            pDsty[x] = refMain[x+deltaInt+1];
-          }
-        }
+        pDsty[x] = refMain[x+deltaInt+1];
       }
     }
+  }
+}
 
-    // Flip the block if this is the horizontal mode
-    if (!bIsModeVer)
+/** Transpose a block, pDst[x*dstStride+y] = pSrc[y*srcStride+x].
+ * \param width  the number of columns of pSrc
+ * \param height the number of rows of pSrc
+ */
+Void TComPrediction::xTransposeBlock( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
+  for (Int y=0; y<height; y++)
+  {
+    for (Int x=0; x<width; x++)
     {
-      for (Int y=0; y<height; y++)
-      {
-        for (Int x=0; x<width; x++)
-        {
-          pTrueDst[x*dstStrideTrue] = pDst[x];
-        }
-        pTrueDst++;
-        pDst+=dstStride;
-      }
+      pDst[x*dstStride] = pSrc[x];
     }
+    pDst++;
+    pSrc+=srcStride;
   }
 }
 
@@ -448,7 +493,7 @@ Void TComPrediction::predIntraAng( const ComponentID compID, UInt uiDirMode, Pel
 
     if ( uiDirMode == PLANAR_IDX )
     {
-      xPredIntraPlanar( ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight );
+      m_fpPredIntraPlanar( ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight );
     }
     else
     {
@@ -465,7 +510,7 @@ Void TComPrediction::predIntraAng( const ComponentID compID, UInt uiDirMode, Pel
 
       if( uiDirMode == DC_IDX )
       {
-        xDCPredFiltering( ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight, channelType );
+        m_fpDCPredFiltering( ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight, channelType );
       }
     }
   }
@@ -64,12 +64,41 @@ typedef enum PRED_BUF_E
 } PRED_BUF;
 
 static const UInt MAX_INTRA_FILTER_DEPTHS=5;
+static const UInt MAX_INTRA_ANG_BLOCK_SIZES=5; ///< 4x4 to 64x64
 
 class TComPrediction : public TComWeightPrediction
 {
 private:
   static const UChar m_aucIntraFilter[MAX_NUM_CHANNEL_TYPE][MAX_INTRA_FILTER_DEPTHS];
 
+  typedef Void (*FpPredIntraAngRows)( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle );
+  typedef Void (*FpTransposeBlock)  ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  typedef Void (*FpPredIntraPlanar) ( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height );
+  typedef Void (*FpDCPredFiltering) ( const Pel* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, ChannelType channelType );
+
+  FpPredIntraAngRows m_fpPredIntraAngRows[MAX_INTRA_ANG_BLOCK_SIZES]; ///< [log2(width)-2] angular prediction from the main reference (xPredIntraAngRows or a SIMD version)
+  FpTransposeBlock   m_fpTransposeBlock;                              ///< transposition of horizontal-mode predictions (xTransposeBlock or a SIMD version)
+  FpPredIntraPlanar  m_fpPredIntraPlanar;                             ///< planar prediction (xPredIntraPlanar or a SIMD version)
+  FpDCPredFiltering  m_fpDCPredFiltering;                             ///< DC edge filtering (xDCPredFiltering or a SIMD version)
+
+  static Void xPredIntraAngRows ( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle );
+  static Void xTransposeBlock   ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+
+#if ENABLE_SIMD_OPT_INTRA
+  // SIMD kernels (x86/TComPredictionX86.h)
+  template<X86_VEXT vext, Int W>
+  static Void xPredIntraAngRows_SIMD( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle );
+  template<X86_VEXT vext>
+  static Void xTransposeBlock_SIMD  ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  template<X86_VEXT vext>
+  static Void xPredIntraPlanar_SIMD ( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height );
+  template<X86_VEXT vext>
+  static Void xDCPredFiltering_SIMD ( const Pel* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, ChannelType channelType );
+
+  template<X86_VEXT vext> Void xInitPredictionX86();
+  Void initPredictionX86();
+#endif
+
 protected:
   Pel*      m_piYuvExt[MAX_NUM_COMPONENT][NUM_PRED_BUF];
   Int       m_iYuvExtSize;
@@ -85,7 +114,7 @@ protected:
   Int    m_iLumaRecStride;       ///< stride of #m_pLumaRecBuffer array
 
   Void xPredIntraAng            ( Int bitDepth, const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, UInt width, UInt height, ChannelType channelType, UInt dirMode, const Bool bEnableEdgeFilters );
-  Void xPredIntraPlanar         ( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height );
+  static Void xPredIntraPlanar  ( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height );
 
   // motion compensation functions
   Void xPredInterUni            ( TComDataCU* pcCU,                          UInt uiPartAddr,               Int iWidth, Int iHeight, RefPicList eRefPicList, TComYuv* pcYuvPred, Bool bi=false          );
@@ -95,7 +124,7 @@ protected:
 
   Void xGetLLSPrediction ( const Pel* pSrc0, Int iSrcStride, Pel* pDst0, Int iDstStride, UInt uiWidth, UInt uiHeight, UInt uiExt0, const ChromaFormat chFmt  DEBUG_STRING_FN_DECLARE(sDebug) );
 
-  Void xDCPredFiltering( const Pel* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, ChannelType channelType );
+  static Void xDCPredFiltering( const Pel* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, ChannelType channelType );
   Bool xCheckIdenticalMotion    ( TComDataCU* pcCU, UInt PartAddr);
   Void destroy();
 
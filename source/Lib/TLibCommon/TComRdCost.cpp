@@ -40,6 +40,9 @@
 #include <limits>
 #include "TComRom.h"
 #include "TComRdCost.h"
+#if ENABLE_SIMD_OPT_DIST
+#include "x86/CommonDefX86.h"
+#endif
 
 #if VECTOR_CODING__DISTORTION_CALCULATIONS && (RExt__HIGH_BIT_DEPTH_SUPPORT==0)
 #include <emmintrin.h>
@@ -167,12 +170,33 @@ Void TComRdCost::init()
   m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs;
   m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs;
 
+#if ENABLE_SIMD_OPT_DIST
+  initRdCostX86();
+#endif
+
   m_costMode                   = COST_STANDARD_LOSSY;
 
   m_motionLambda               = 0;
   m_iCostScale                 = 0;
 }
 
+#if ENABLE_SIMD_OPT_DIST
+// Replace the C distortion functions with the kernels for the best vector extension of the CPU
+Void TComRdCost::initRdCostX86()
+{
+  const X86_VEXT vext = getX86Extension();
+
+  if( vext >= AVX2 )
+  {
+    xInitRdCostX86<AVX2>();
+  }
+  else if( vext >= SSE41 )
+  {
+    xInitRdCostX86<SSE41>();
+  }
+}
+#endif
+
 // Static member function
 UInt TComRdCost::xGetExpGolombNumberOfBits( Int iVal )
 {
@@ -204,6 +204,17 @@ private:
 #endif
                                       );
 
+#if ENABLE_SIMD_OPT_DIST
+  // SIMD kernels (x86/TComRdCostX86.h), fpDistFuncC is the C function used for weighted prediction
+  template<X86_VEXT vext>                                    static Distortion xGetSAD_SIMD  ( DistParam* pcDtParam );
+  template<X86_VEXT vext, Int iWidth, FpDistFunc fpDistFuncC> static Distortion xGetSADN_SIMD ( DistParam* pcDtParam );
+  template<X86_VEXT vext, Int iWidth, FpDistFunc fpDistFuncC> static Distortion xGetSSE_SIMD  ( DistParam* pcDtParam );
+  template<X86_VEXT vext>                                    static Distortion xGetHADs_SIMD ( DistParam* pcDtParam );
+
+  template<X86_VEXT vext> Void xInitRdCostX86();
+  Void    initRdCostX86();
+#endif
+
 public:
 
   Distortion   getDistPart(Int bitDepth, const Pel* piCur, Int iCurStride, const Pel* piOrg, Int iOrgStride, UInt uiBlkWidth, UInt uiBlkHeight, const ComponentID compID, DFunc eDFunc = DF_SSE );
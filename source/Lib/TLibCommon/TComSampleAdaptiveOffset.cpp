@@ -104,32 +104,21 @@ const SAOBlkParam& SAOBlkParam::operator= (const SAOBlkParam& src)
 TComSampleAdaptiveOffset::TComSampleAdaptiveOffset()
 {
   m_tempPicYuv = NULL;
-  m_lineBufWidth = 0;
-  m_signLineBuf1 = NULL;
-  m_signLineBuf2 = NULL;
+  m_pcThreadPool = NULL;
 }
 
 
 TComSampleAdaptiveOffset::~TComSampleAdaptiveOffset()
 {
   destroy();
-
-  if (m_signLineBuf1)
-  {
-    delete[] m_signLineBuf1;
-    m_signLineBuf1 = NULL;
-  }
-  if (m_signLineBuf2)
-  {
-    delete[] m_signLineBuf2;
-    m_signLineBuf2 = NULL;
-  }
 }
 
-Void TComSampleAdaptiveOffset::create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift )
+Void TComSampleAdaptiveOffset::create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift, TComThreadPool* pcThreadPool )
 {
   destroy();
 
+  m_pcThreadPool    = pcThreadPool;
+
   m_picWidth        = picWidth;
   m_picHeight       = picHeight;
   m_chromaFormatIDC = format;
@@ -164,6 +153,33 @@ Void TComSampleAdaptiveOffset::destroy()
   }
 }
 
+/** Calls ctuFunc for every CTU of the picture. When a pool with several threads is available, the CTU rows are distributed
+ *  over its threads, so ctuFunc must only modify data of its own CTU.
+ */
+Void TComSampleAdaptiveOffset::xForEachCtu(const std::function<Void(Int)> &ctuFunc)
+{
+  if (m_pcThreadPool == NULL || m_pcThreadPool->getNumThreads() <= 1)
+  {
+    for(Int ctuRsAddr= 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
+    {
+      ctuFunc(ctuRsAddr);
+    }
+    return;
+  }
+
+  for(Int ctuRowIdx = 0; ctuRowIdx < m_numCTUInHeight; ctuRowIdx++)
+  {
+    m_pcThreadPool->addJob( [this, ctuRowIdx, &ctuFunc](Int)
+    {
+      for(Int ctuRsAddr = ctuRowIdx*m_numCTUInWidth; ctuRsAddr < (ctuRowIdx+1)*m_numCTUInWidth; ctuRsAddr++)
+      {
+        ctuFunc(ctuRsAddr);
+      }
+    } );
+  }
+  m_pcThreadPool->waitForJobs();
+}
+
 Void TComSampleAdaptiveOffset::invertQuantOffsets(ComponentID compIdx, Int typeIdc, Int typeAuxInfo, Int* dstOffsets, Int* srcOffsets)
 {
   Int codedOffset[MAX_NUM_SAO_CLASSES];
@@ -290,9 +306,32 @@ Void TComSampleAdaptiveOffset::reconstructBlkSAOParams(TComPic* pic, SAOBlkParam
     m_picSAOEnabled[compIdx] = false;
   }
 
+  xReconstructBlkSAOParams(pic, saoBlkParams, 0, m_numCTUsPic);
+}
+
+/** Reconstructs the SAO parameters of the CTUs of one CTU row, the rows being passed in top to bottom order.
+ * \param pic           picture (TComPic) pointer
+ * \param saoBlkParams  SAO parameters of the CTUs of the picture
+ * \param ctuRowIdx     CTU row, whose merges refer to the row above, reconstructed before
+ */
+Void TComSampleAdaptiveOffset::reconstructBlkSAOParamsCtuRow(TComPic* pic, SAOBlkParam* saoBlkParams, Int ctuRowIdx)
+{
+  if (ctuRowIdx == 0)
+  {
+    for(Int compIdx = 0; compIdx < MAX_NUM_COMPONENT; compIdx++)
+    {
+      m_picSAOEnabled[compIdx] = false;
+    }
+  }
+
+  xReconstructBlkSAOParams(pic, saoBlkParams, ctuRowIdx*m_numCTUInWidth, (ctuRowIdx+1)*m_numCTUInWidth);
+}
+
+Void TComSampleAdaptiveOffset::xReconstructBlkSAOParams(TComPic* pic, SAOBlkParam* saoBlkParams, Int startCtuRsAddr, Int boundingCtuRsAddr)
+{
   const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
 
-  for(Int ctuRsAddr=0; ctuRsAddr< m_numCTUsPic; ctuRsAddr++)
+  for(Int ctuRsAddr=startCtuRsAddr; ctuRsAddr< boundingCtuRsAddr; ctuRsAddr++)
   {
     SAOBlkParam* mergeList[NUM_SAO_MERGE_TYPES] = { NULL };
     getMergeList(pic, ctuRsAddr, saoBlkParams, mergeList);
@@ -314,24 +353,10 @@ Void TComSampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, Int typeId
                                           , Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride,  Int width, Int height
                                           , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail)
 {
-  if(m_lineBufWidth != m_maxCUWidth)
-  {
-    m_lineBufWidth = m_maxCUWidth;
-
-    if (m_signLineBuf1)
-    {
-      delete[] m_signLineBuf1;
-      m_signLineBuf1 = NULL;
-    }
-    m_signLineBuf1 = new SChar[m_lineBufWidth+1];
-
-    if (m_signLineBuf2)
-    {
-      delete[] m_signLineBuf2;
-      m_signLineBuf2 = NULL;
-    }
-    m_signLineBuf2 = new SChar[m_lineBufWidth+1];
-  }
+  // sign line buffers local to the call, so that CTUs can be processed by several threads
+  assert(m_maxCUWidth <= MAX_CU_SIZE);
+  SChar signLineBuf1[MAX_CU_SIZE+1];
+  SChar signLineBuf2[MAX_CU_SIZE+1];
 
   const Int maxSampleValueIncl = (1<< channelBitDepth )-1;
 
@@ -369,7 +394,7 @@ Void TComSampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, Int typeId
   case SAO_TYPE_EO_90:
     {
       offset += 2;
-      SChar *signUpLine = m_signLineBuf1;
+      SChar *signUpLine = signLineBuf1;
 
       startY = isAboveAvail ? 0 : 1;
       endY   = isBelowAvail ? height : height-1;
@@ -409,8 +434,8 @@ Void TComSampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, Int typeId
       offset += 2;
       SChar *signUpLine, *signDownLine, *signTmpLine;
 
-      signUpLine  = m_signLineBuf1;
-      signDownLine= m_signLineBuf2;
+      signUpLine  = signLineBuf1;
+      signDownLine= signLineBuf2;
 
       startX = isLeftAvail ? 0 : 1 ;
       endX   = isRightAvail ? width : (width-1);
@@ -474,7 +499,7 @@ Void TComSampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, Int typeId
   case SAO_TYPE_EO_45:
     {
       offset += 2;
-      SChar *signUpLine = m_signLineBuf1+1;
+      SChar *signUpLine = signLineBuf1+1;
 
       startX = isLeftAvail ? 0 : 1;
       endX   = isRightAvail ? width : (width -1);
@@ -611,18 +636,22 @@ Void TComSampleAdaptiveOffset::offsetCTU(Int ctuRsAddr, TComPicYuv* srcYuv, TCom
 }
 
 
-Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pDecPic)
+Bool TComSampleAdaptiveOffset::isPicSAOEnabled() const
 {
   const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
-  Bool bAllDisabled=true;
   for(Int compIdx = 0; compIdx < numberOfComponents; compIdx++)
   {
     if (m_picSAOEnabled[compIdx])
     {
-      bAllDisabled=false;
+      return true;
     }
   }
-  if (bAllDisabled)
+  return false;
+}
+
+Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pDecPic)
+{
+  if (!isPicSAOEnabled())
   {
     return;
   }
@@ -630,7 +659,36 @@ Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pDecPic)
   TComPicYuv* resYuv = pDecPic->getPicYuvRec();
   TComPicYuv* srcYuv = m_tempPicYuv;
   resYuv->copyToPic(srcYuv);
-  for(Int ctuRsAddr= 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
+  SAOBlkParam* saoBlkParams = pDecPic->getPicSym()->getSAOBlkParam();
+  xForEachCtu( [&](Int ctuRsAddr)
+  {
+    offsetCTU(ctuRsAddr, srcYuv, resYuv, saoBlkParams[ctuRsAddr], pDecPic);
+  } );
+}
+
+/** CTU-row-level SAO process, giving the same result as SAOProcess once called for all the CTU rows in top to bottom order.
+ * \param pDecPic    picture (TComPic) pointer
+ * \param ctuRowIdx  CTU row whose deblocking is complete, i.e. the row below it has been deblocked as well
+ *
+ * \note The deblocked samples of the row are kept, and the offsets are applied to the row above, whose neighbouring
+ *       deblocked samples are all available now. The offsets of the last row are applied when it is passed.
+ *       With reconstructBlkSAOParamsCtuRow, the parameters of a row must be reconstructed before the row above it is
+ *       passed, so that its neighbouring deblocked samples are kept as soon as the row uses SAO.
+ */
+Void TComSampleAdaptiveOffset::SAOProcessCtuRow(TComPic* pDecPic, Int ctuRowIdx)
+{
+  if (!isPicSAOEnabled())
+  {
+    return;
+  }
+
+  TComPicYuv* resYuv = pDecPic->getPicYuvRec();
+  TComPicYuv* srcYuv = m_tempPicYuv;
+  resYuv->copyToPic(srcYuv, ctuRowIdx*m_maxCUHeight, m_maxCUHeight);
+
+  const Int firstRowIdx = std::max(ctuRowIdx-1, 0);
+  const Int endRowIdx   = (ctuRowIdx == m_numCTUInHeight-1) ? ctuRowIdx+1 : ctuRowIdx;
+  for(Int ctuRsAddr = firstRowIdx*m_numCTUInWidth; ctuRsAddr < endRowIdx*m_numCTUInWidth; ctuRsAddr++)
   {
     offsetCTU(ctuRsAddr, srcYuv, resYuv, (pDecPic->getPicSym()->getSAOBlkParam())[ctuRsAddr], pDecPic);
   } //ctu
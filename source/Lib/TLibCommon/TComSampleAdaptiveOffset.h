@@ -40,6 +40,7 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#include "TComThreadPool.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -66,9 +67,11 @@ public:
   TComSampleAdaptiveOffset();
   virtual ~TComSampleAdaptiveOffset();
   Void SAOProcess(TComPic* pDecPic);
-  Void create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift );
+  Void SAOProcessCtuRow(TComPic* pDecPic, Int ctuRowIdx);
+  Void create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift, TComThreadPool* pcThreadPool = NULL );
   Void destroy();
   Void reconstructBlkSAOParams(TComPic* pic, SAOBlkParam* saoBlkParams);
+  Void reconstructBlkSAOParamsCtuRow(TComPic* pic, SAOBlkParam* saoBlkParams, Int ctuRowIdx);
   Void PCMLFDisableProcess (TComPic* pcPic);
   static Int getMaxOffsetQVal(const Int channelBitDepth) { return (1<<(std::min<Int>(channelBitDepth,MAX_SAO_TRUNCATED_BITDEPTH)-5))-1; } //Table 9-32, inclusive
 
@@ -77,8 +80,11 @@ protected:
                   , Bool isLeftAvail, Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail);
   Void invertQuantOffsets(ComponentID compIdx, Int typeIdc, Int typeAuxInfo, Int* dstOffsets, Int* srcOffsets);
   Void reconstructBlkSAOParam(SAOBlkParam& recParam, SAOBlkParam* mergeList[NUM_SAO_MERGE_TYPES]);
+  Void xReconstructBlkSAOParams(TComPic* pic, SAOBlkParam* saoBlkParams, Int startCtuRsAddr, Int boundingCtuRsAddr);
   Int  getMergeList(TComPic* pic, Int ctuRsAddr, SAOBlkParam* blkParams, SAOBlkParam* mergeList[NUM_SAO_MERGE_TYPES]);
   Void offsetCTU(Int ctuRsAddr, TComPicYuv* srcYuv, TComPicYuv* resYuv, SAOBlkParam& saoblkParam, TComPic* pPic);
+  Bool isPicSAOEnabled() const;
+  Void xForEachCtu(const std::function<Void(Int)> &ctuFunc);
   Void xPCMRestoration(TComPic* pcPic);
   Void xPCMCURestoration ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth );
   Void xPCMSampleRestoration (TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, const ComponentID compID);
@@ -93,11 +99,8 @@ protected:
   Int m_numCTUInHeight;
   Int m_numCTUsPic;
 
-
-  Int m_lineBufWidth;
-  SChar* m_signLineBuf1;
-  SChar* m_signLineBuf2;
   ChromaFormat m_chromaFormatIDC;
+  TComThreadPool* m_pcThreadPool; //threads processing CTU rows concurrently (NULL: serial processing)
 private:
   Bool m_picSAOEnabled[MAX_NUM_COMPONENT];
 };
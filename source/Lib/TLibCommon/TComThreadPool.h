@@ -0,0 +1,110 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TComThreadPool.h
+    \brief    thread pool and CTU row progress tracking for parallel processing (header)
+*/
+
+#ifndef __TCOMTHREADPOOL__
+#define __TCOMTHREADPOOL__
+
+#include "CommonDef.h"
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// fixed-size pool of threads executing queued jobs in FIFO order
+class TComThreadPool
+{
+public:
+  typedef std::function<Void(Int)> Job; ///< a job receives the index of the thread executing it (0..numThreads-1)
+
+  TComThreadPool();
+  virtual ~TComThreadPool();
+
+  Void  create          ( Int numThreads );
+  Void  destroy         ();
+
+  Int   getNumThreads   () const { return Int(m_threads.size()); }
+
+  /// queue a job. Jobs are started in the order they were added, so a job may block on the progress of an earlier one.
+  Void  addJob          ( const Job &job );
+  /// block until the queue is empty and no job is running
+  Void  waitForJobs     ();
+
+private:
+  Void  xThreadMain     ( Int threadIdx );
+
+  std::vector<std::thread>  m_threads;
+  std::deque<Job>           m_jobs;
+  std::mutex                m_mutex;
+  std::condition_variable   m_jobAvailable;
+  std::condition_variable   m_jobsFinished;
+  Int                       m_numActiveJobs;
+  Bool                      m_terminate;
+};
+
+/// progress counters of a set of CTU rows, used to enforce wavefront dependencies between threads
+class TComCtuRowProgress
+{
+public:
+  TComCtuRowProgress() {}
+  virtual ~TComCtuRowProgress() {}
+
+  Void  init            ( UInt numRows, UInt initialValue = 0 );
+  Void  setProgress     ( UInt row, UInt value );
+  UInt  getProgress     ( UInt row );
+  /// block until the progress of the row has reached at least the given value
+  Void  waitForProgress ( UInt row, UInt value );
+
+private:
+  std::vector<UInt>         m_progress;
+  std::mutex                m_mutex;
+  std::condition_variable   m_progressMade;
+};
+
+//! \}
+
+#endif // __TCOMTHREADPOOL__
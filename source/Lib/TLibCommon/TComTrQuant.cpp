@@ -44,6 +44,12 @@
 #include "ContextTables.h"
 #include "TComTU.h"
 #include "Debug.h"
+#if DEBUG_RDOQ_DUMP_TUS
+#include <mutex>
+#endif
+#if ENABLE_SIMD_OPT_TRANSFORM || ENABLE_SIMD_OPT_QUANT
+#include "x86/CommonDefX86.h"
+#endif
 
 typedef struct
 {
@@ -63,6 +69,10 @@ typedef struct
 
 #define RDOQ_CHROMA                 1           ///< use of RDOQ in chroma
 
+// 2D transforms, defined below
+Void xTrMxN ( Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange );
+Void xITrMxN( Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange );
+
 
 // ====================================================================================================================
 // QpParam constructor
@@ -131,6 +141,14 @@ TComTrQuant::TComTrQuant()
   // allocate bit estimation class  (for RDOQ)
   m_pcEstBitsSbac = new estBitsSbacStruct;
   initScalingList();
+
+  m_fpTrMxN   = xTrMxN;
+  m_fpITrMxN  = xITrMxN;
+  m_fpQuant   = xQuantCore;
+  m_fpDeQuant = xDeQuantCore;
+#if ENABLE_SIMD_OPT_TRANSFORM || ENABLE_SIMD_OPT_QUANT
+  initTrQuantX86();
+#endif
 }
 
 TComTrQuant::~TComTrQuant()
@@ -987,6 +1005,25 @@ Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight
 }
 
 
+#if ENABLE_SIMD_OPT_TRANSFORM || ENABLE_SIMD_OPT_QUANT
+/** Replace the C transforms and quantisers with the kernels for the best vector extension of the CPU
+*/
+Void TComTrQuant::initTrQuantX86()
+{
+  const X86_VEXT vext = getX86Extension();
+
+  if( vext >= AVX2 )
+  {
+    xInitTrQuantX86<AVX2>();
+  }
+  else if( vext >= SSE41 )
+  {
+    xInitTrQuantX86<SSE41>();
+  }
+}
+#endif
+
+
 // To minimize the distortion only. No rate is considered.
 Void TComTrQuant::signBitHidingHDQ( TCoeff* pQCoef, TCoeff* pCoef, TCoeff* deltaU, const TUEntropyCodingParameters &codingParameters, const Int maxLog2TrDynamicRange )
 {
@@ -1154,6 +1191,9 @@ Void TComTrQuant::xQuant(       TComTU       &rTu,
   {
     if ( !m_useSelectiveRDOQ || xNeedRDOQ( rTu, piCoef, compID, cQP ) )
     {
+#if DEBUG_RDOQ_DUMP_TUS
+      xDumpRateDistOptQuantInput( rTu, piCoef, compID, cQP );
+#endif
 #if ADAPTIVE_QP_SELECTION
       xRateDistOptQuant( rTu, piCoef, pDes, pArlDes, uiAbsSum, compID, cQP );
 #else
@@ -1213,31 +1253,15 @@ Void TComTrQuant::xQuant(       TComTU       &rTu,
 #endif
 
     const Int iAdd   = (pcCU->getSlice()->getSliceType()==I_SLICE ? 171 : 85) << (iQBits-9);
-    const Int qBits8 = iQBits - 8;
-
-    for( Int uiBlockPos = 0; uiBlockPos < uiWidth*uiHeight; uiBlockPos++ )
-    {
-      const TCoeff iLevel   = piCoef[uiBlockPos];
-      const TCoeff iSign    = (iLevel < 0 ? -1: 1);
-
-      const Int64  tmpLevel = (Int64)abs(iLevel) * (enableScalingLists ? piQuantCoeff[uiBlockPos] : defaultQuantisationCoefficient);
 
 #if ADAPTIVE_QP_SELECTION
-      if( m_bUseAdaptQpSelect )
-      {
-        piArlCCoef[uiBlockPos] = (TCoeff)((tmpLevel + iAddC ) >> iQBitsC);
-      }
+    m_fpQuant( piCoef, piQCoef, m_bUseAdaptQpSelect ? piArlCCoef : NULL, deltaU, uiAbsSum, enableScalingLists ? piQuantCoeff : NULL, defaultQuantisationCoefficient,
+               uiWidth*uiHeight, iQBits, iAdd, iQBitsC, iAddC, entropyCodingMinimum, entropyCodingMaximum );
+#else
+    m_fpQuant( piCoef, piQCoef, NULL, deltaU, uiAbsSum, enableScalingLists ? piQuantCoeff : NULL, defaultQuantisationCoefficient,
+               uiWidth*uiHeight, iQBits, iAdd, 0, 0, entropyCodingMinimum, entropyCodingMaximum );
 #endif
 
-      const TCoeff quantisedMagnitude = TCoeff((tmpLevel + iAdd ) >> iQBits);
-      deltaU[uiBlockPos] = (TCoeff)((tmpLevel - (quantisedMagnitude<<iQBits) )>> qBits8);
-
-      uiAbsSum += quantisedMagnitude;
-      const TCoeff quantisedCoefficient = quantisedMagnitude * iSign;
-
-      piQCoef[uiBlockPos] = Clip3<TCoeff>( entropyCodingMinimum, entropyCodingMaximum, quantisedCoefficient );
-    } // for n
-
     if( pcCU->getSlice()->getPPS()->getSignDataHidingEnabledFlag() )
     {
       if(uiAbsSum >= 2) //this prevents TUs with only one coefficient of value 1 from being tested
@@ -1359,6 +1383,72 @@ Void TComTrQuant::xDeQuant(       TComTU        &rTu,
 
     Int *piDequantCoef = getDequantCoeff(scalingListType,QP_rem,uiLog2TrSize-2);
 
+    m_fpDeQuant( piQCoef, piCoef, piDequantCoef, 0, numSamplesInBlock, rightShift, inputMinimum, inputMaximum, transformMinimum, transformMaximum );
+  }
+  else
+  {
+    const Int scale     =  g_invQuantScales[QP_rem];
+    const Int scaleBits =     (IQUANT_SHIFT + 1)   ;
+
+    //from the dequantisation equation:
+    //iCoeffQ                         = Intermediate_Int((Int64(clipQCoef) * scale + iAdd) >> rightShift);
+    //(sizeof(Intermediate_Int) * 8)  =                    inputBitDepth   + scaleBits      - rightShift
+    const UInt             targetInputBitDepth = std::min<UInt>((maxLog2TrDynamicRange + 1), (((sizeof(Intermediate_Int) * 8) + rightShift) - scaleBits));
+    const Intermediate_Int inputMinimum        = -(1 << (targetInputBitDepth - 1));
+    const Intermediate_Int inputMaximum        =  (1 << (targetInputBitDepth - 1)) - 1;
+
+    m_fpDeQuant( piQCoef, piCoef, NULL, scale, numSamplesInBlock, rightShift, inputMinimum, inputMaximum, transformMinimum, transformMaximum );
+  }
+}
+
+/** Quantise a block of coefficients (the core loop of xQuant without RDOQ)
+ *  \param piCoef                          input transform coefficients
+ *  \param piQCoef                         output quantised coefficients
+ *  \param piArlCCoef                      output coefficients for adaptive QP selection, or NULL
+ *  \param deltaU                          output rounding errors for sign bit hiding
+ *  \param uiAbsSum                        sum of the quantised magnitudes is added to this
+ *  \param piQuantCoeff                    scaling list quantisation coefficients, or NULL for a flat scaling list
+ *  \param defaultQuantisationCoefficient  quantisation coefficient used without scaling list
+ */
+Void TComTrQuant::xQuantCore( const TCoeff *piCoef, TCoeff *piQCoef, TCoeff *piArlCCoef, TCoeff *deltaU, TCoeff &uiAbsSum, const Int *piQuantCoeff, const Int defaultQuantisationCoefficient,
+                              const Int numSamples, const Int iQBits, const Int iAdd, const Int iQBitsC, const Int iAddC, const TCoeff entropyCodingMinimum, const TCoeff entropyCodingMaximum )
+{
+  const Int qBits8 = iQBits - 8;
+
+  for( Int uiBlockPos = 0; uiBlockPos < numSamples; uiBlockPos++ )
+  {
+    const TCoeff iLevel   = piCoef[uiBlockPos];
+    const TCoeff iSign    = (iLevel < 0 ? -1: 1);
+
+    const Int64  tmpLevel = (Int64)abs(iLevel) * (piQuantCoeff != NULL ? piQuantCoeff[uiBlockPos] : defaultQuantisationCoefficient);
+
+    if( piArlCCoef != NULL )
+    {
+      piArlCCoef[uiBlockPos] = (TCoeff)((tmpLevel + iAddC ) >> iQBitsC);
+    }
+
+    const TCoeff quantisedMagnitude = TCoeff((tmpLevel + iAdd ) >> iQBits);
+    deltaU[uiBlockPos] = (TCoeff)((tmpLevel - (quantisedMagnitude<<iQBits) )>> qBits8);
+
+    uiAbsSum += quantisedMagnitude;
+    const TCoeff quantisedCoefficient = quantisedMagnitude * iSign;
+
+    piQCoef[uiBlockPos] = Clip3<TCoeff>( entropyCodingMinimum, entropyCodingMaximum, quantisedCoefficient );
+  } // for n
+}
+
+/** Dequantise a block of coefficients (the core loops of xDeQuant)
+ *  \param piQCoef        input quantised coefficients
+ *  \param piCoef         output coefficients
+ *  \param piDequantCoef  scaling list dequantisation coefficients, or NULL for a flat scaling list
+ *  \param scale          dequantisation coefficient used without scaling list
+ *  \param rightShift     right shift applied after scaling (left shift if negative)
+ */
+Void TComTrQuant::xDeQuantCore( const TCoeff *piQCoef, TCoeff *piCoef, const Int *piDequantCoef, const Int scale, const Int numSamplesInBlock, const Int rightShift,
+                                const Intermediate_Int inputMinimum, const Intermediate_Int inputMaximum, const TCoeff transformMinimum, const TCoeff transformMaximum )
+{
+  if(piDequantCoef != NULL)
+  {
     if(rightShift > 0)
     {
       const Intermediate_Int iAdd = 1 << (rightShift - 1);
@@ -1386,16 +1476,6 @@ Void TComTrQuant::xDeQuant(       TComTU        &rTu,
   }
   else
   {
-    const Int scale     =  g_invQuantScales[QP_rem];
-    const Int scaleBits =     (IQUANT_SHIFT + 1)   ;
-
-    //from the dequantisation equation:
-    //iCoeffQ                         = Intermediate_Int((Int64(clipQCoef) * scale + iAdd) >> rightShift);
-    //(sizeof(Intermediate_Int) * 8)  =                    inputBitDepth   + scaleBits      - rightShift
-    const UInt             targetInputBitDepth = std::min<UInt>((maxLog2TrDynamicRange + 1), (((sizeof(Intermediate_Int) * 8) + rightShift) - scaleBits));
-    const Intermediate_Int inputMinimum        = -(1 << (targetInputBitDepth - 1));
-    const Intermediate_Int inputMaximum        =  (1 << (targetInputBitDepth - 1)) - 1;
-
     if (rightShift > 0)
     {
       const Intermediate_Int iAdd = 1 << (rightShift - 1);
@@ -1960,7 +2040,7 @@ Void TComTrQuant::xT( const Int channelBitDepth, Bool useDST, Pel* piBlkResi, UI
     }
   }
 
-  xTrMxN( channelBitDepth, block, coeff, iWidth, iHeight, useDST, maxLog2TrDynamicRange );
+  m_fpTrMxN( channelBitDepth, block, coeff, iWidth, iHeight, useDST, maxLog2TrDynamicRange );
 
   memcpy(psCoeff, coeff, (iWidth * iHeight * sizeof(TCoeff)));
 }
@@ -1990,7 +2070,7 @@ Void TComTrQuant::xIT( const Int channelBitDepth, Bool useDST, TCoeff* plCoef, P
 
   memcpy(coeff, plCoef, (iWidth * iHeight * sizeof(TCoeff)));
 
-  xITrMxN( channelBitDepth, coeff, block, iWidth, iHeight, useDST, maxLog2TrDynamicRange );
+  m_fpITrMxN( channelBitDepth, coeff, block, iWidth, iHeight, useDST, maxLog2TrDynamicRange );
 
   for (Int y = 0; y < iHeight; y++)
   {
@@ -2112,6 +2192,8 @@ Void TComTrQuant::xITransformSkip( TCoeff* plCoef, Pel* pResidual, UInt uiStride
  * \param uiAbsSum reference to absolute sum of quantized transform coefficient
  * \param compID colour component ID
  * \param cQP reference to quantization parameters
+ * \param useZeroCGFastPath skip the level decisions of coefficient groups quantised to zero (false only for verification)
+ * \param pdBestCost if not NULL, receives the RD cost of the chosen last position
 
  * Rate distortion optimized quantization for entropy
  * coding engines using probability models like CABAC
@@ -2124,7 +2206,9 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
 #endif
                                                             TCoeff       &uiAbsSum,
                                                       const ComponentID   compID,
-                                                      const QpParam      &cQP  )
+                                                      const QpParam      &cQP,
+                                                      const Bool          useZeroCGFastPath,
+                                                            Double      * pdBestCost )
 {
   const TComRectangle  & rect             = rTu.getRect(compID);
   const UInt             uiWidth          = rect.width;
@@ -2234,12 +2318,16 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
 
     const Int patternSigCtx = TComTrQuant::calcPatternSigCtx(uiSigCoeffGroupFlag, uiCGPosX, uiCGPosY, codingParameters.widthInGroups, codingParameters.heightInGroups);
 
+    //===== quantization of the whole coefficient group =====
+    Intermediate_Int cgLevelDouble [ 1 << MLS_CG_SIZE ];
+    UInt             cgMaxAbsLevel [ 1 << MLS_CG_SIZE ];
+    Double           cgErrorScale  [ 1 << MLS_CG_SIZE ];
+    UInt             uiCGMaxAbsLevel = 0;
+
     for (Int iScanPosinCG = uiCGSize-1; iScanPosinCG >= 0; iScanPosinCG--)
     {
       iScanPos = iCGScanPos*uiCGSize + iScanPosinCG;
-      //===== quantization =====
       UInt    uiBlkPos          = codingParameters.scan[iScanPos];
-      // set coeff
 
       const Int    quantisationCoefficient = (enableScalingLists) ? piQCoef   [uiBlkPos] : defaultQuantisationCoefficient;
       const Double errorScale              = (enableScalingLists) ? pdErrScale[uiBlkPos] : defaultErrorScale;
@@ -2261,110 +2349,166 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
       d64BlockUncodedCost      += pdCostCoeff0[ iScanPos ];
       piDstCoeff[ uiBlkPos ]    = uiMaxAbsLevel;
 
-      if ( uiMaxAbsLevel > 0 && iLastScanPos < 0 )
-      {
-        iLastScanPos            = iScanPos;
-        uiCtxSet                = getContextSetIndex(compID, (iScanPos >> MLS_CG_SIZE), 0);
-        iCGLastScanPos          = iCGScanPos;
-      }
+      cgLevelDouble[ iScanPosinCG ] = lLevelDouble;
+      cgMaxAbsLevel[ iScanPosinCG ] = uiMaxAbsLevel;
+      cgErrorScale [ iScanPosinCG ] = errorScale;
+      uiCGMaxAbsLevel              |= uiMaxAbsLevel;
+    }
 
-      if ( iLastScanPos >= 0 )
+    if ( uiCGMaxAbsLevel == 0 && useZeroCGFastPath )
+    {
+      //===== all-zero coefficient group: only the significance flags contribute to the rate =====
+      for (Int iScanPosinCG = uiCGSize-1; iScanPosinCG >= 0; iScanPosinCG--)
       {
-        //===== coefficient level estimation =====
-        UInt  uiLevel;
-        UInt  uiOneCtx         = (NUM_ONE_FLAG_CTX_PER_SET * uiCtxSet) + c1;
-        UInt  uiAbsCtx         = (NUM_ABS_FLAG_CTX_PER_SET * uiCtxSet) + c2;
+        iScanPos = iCGScanPos*uiCGSize + iScanPosinCG;
 
-        if( iScanPos == iLastScanPos )
+        if ( iLastScanPos >= 0 )
         {
-          uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ],
-                                                  lLevelDouble, uiMaxAbsLevel, significanceMapContextOffset, uiOneCtx, uiAbsCtx, uiGoRiceParam,
-                                                  c1Idx, c2Idx, iQBits, errorScale, 1, extendedPrecision, maxLog2TrDynamicRange
-                                                  );
+          const UInt   uiBlkPos  = codingParameters.scan[iScanPos];
+          const UShort uiCtxSig  = significanceMapContextOffset + getSigCtxInc( patternSigCtx, codingParameters, iScanPos, uiLog2BlockWidth, uiLog2BlockHeight, channelType );
+          const UInt   uiOneCtx  = (NUM_ONE_FLAG_CTX_PER_SET * uiCtxSet) + c1;
+
+          pdCostSig  [ iScanPos ]  = xGetRateSigCoef( 0, uiCtxSig );
+          pdCostCoeff[ iScanPos ]  = pdCostCoeff0[ iScanPos ] + pdCostSig[ iScanPos ];
+          sigRateDelta[ uiBlkPos ] = m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 1 ] - m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 0 ];
+          deltaU      [ uiBlkPos ] = TCoeff(cgLevelDouble[ iScanPosinCG ] >> (iQBits-8));
+          rateIncUp   [ uiBlkPos ] = m_pcEstBitsSbac->m_greaterOneBits[ uiOneCtx ][ 0 ];
+          d64BaseCost             += pdCostCoeff[ iScanPos ];
+
+          if( ( iScanPos % uiCGSize == 0 ) && ( iScanPos > 0 ) )
+          {
+            uiCtxSet          = getContextSetIndex(compID, ((iScanPos - 1) >> MLS_CG_SIZE), (c1 == 0));
+            c1                = 1;
+            c2                = 0;
+            c1Idx             = 0;
+            c2Idx             = 0;
+            uiGoRiceParam     = initialGolombRiceParameter;
+          }
         }
         else
         {
-          UShort uiCtxSig      = significanceMapContextOffset + getSigCtxInc( patternSigCtx, codingParameters, iScanPos, uiLog2BlockWidth, uiLog2BlockHeight, channelType );
-
-          uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ],
-                                                  lLevelDouble, uiMaxAbsLevel, uiCtxSig, uiOneCtx, uiAbsCtx, uiGoRiceParam,
-                                                  c1Idx, c2Idx, iQBits, errorScale, 0, extendedPrecision, maxLog2TrDynamicRange
-                                                  );
-
-          sigRateDelta[ uiBlkPos ] = m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 1 ] - m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 0 ];
+          d64BaseCost    += pdCostCoeff0[ iScanPos ];
         }
+        rdStats.d64SigCost += pdCostSig[ iScanPos ];
+      }
+      rdStats.d64SigCost_0 = pdCostSig[ iCGScanPos*uiCGSize ];
+    }
+    else
+    {
+      for (Int iScanPosinCG = uiCGSize-1; iScanPosinCG >= 0; iScanPosinCG--)
+      {
+        iScanPos = iCGScanPos*uiCGSize + iScanPosinCG;
+        UInt    uiBlkPos          = codingParameters.scan[iScanPos];
 
-        deltaU[ uiBlkPos ]        = TCoeff((lLevelDouble - (Intermediate_Int(uiLevel) << iQBits)) >> (iQBits-8));
+        const Intermediate_Int lLevelDouble  = cgLevelDouble[ iScanPosinCG ];
+        const UInt             uiMaxAbsLevel = cgMaxAbsLevel[ iScanPosinCG ];
+        const Double           errorScale    = cgErrorScale [ iScanPosinCG ];
 
-        if( uiLevel > 0 )
+        if ( uiMaxAbsLevel > 0 && iLastScanPos < 0 )
         {
-          Int rateNow = xGetICRate( uiLevel, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange );
-          rateIncUp   [ uiBlkPos ] = xGetICRate( uiLevel+1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange ) - rateNow;
-          rateIncDown [ uiBlkPos ] = xGetICRate( uiLevel-1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange ) - rateNow;
-        }
-        else // uiLevel == 0
-        {
-          rateIncUp   [ uiBlkPos ] = m_pcEstBitsSbac->m_greaterOneBits[ uiOneCtx ][ 0 ];
+          iLastScanPos            = iScanPos;
+          uiCtxSet                = getContextSetIndex(compID, (iScanPos >> MLS_CG_SIZE), 0);
+          iCGLastScanPos          = iCGScanPos;
         }
-        piDstCoeff[ uiBlkPos ] = uiLevel;
-        d64BaseCost           += pdCostCoeff [ iScanPos ];
 
-        baseLevel = (c1Idx < C1FLAG_NUMBER) ? (2 + (c2Idx < C2FLAG_NUMBER)) : 1;
-        if( uiLevel >= baseLevel )
+        if ( iLastScanPos >= 0 )
         {
-          if (uiLevel > 3*(1<<uiGoRiceParam))
+          //===== coefficient level estimation =====
+          UInt  uiLevel;
+          UInt  uiOneCtx         = (NUM_ONE_FLAG_CTX_PER_SET * uiCtxSet) + c1;
+          UInt  uiAbsCtx         = (NUM_ABS_FLAG_CTX_PER_SET * uiCtxSet) + c2;
+
+          if( iScanPos == iLastScanPos )
           {
-            uiGoRiceParam = bUseGolombRiceParameterAdaptation ? (uiGoRiceParam + 1) : (std::min<UInt>((uiGoRiceParam + 1), 4));
+            uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ],
+                                                    lLevelDouble, uiMaxAbsLevel, significanceMapContextOffset, uiOneCtx, uiAbsCtx, uiGoRiceParam,
+                                                    c1Idx, c2Idx, iQBits, errorScale, 1, extendedPrecision, maxLog2TrDynamicRange
+                                                    );
           }
-        }
-        if ( uiLevel >= 1)
-        {
-          c1Idx ++;
-        }
+          else
+          {
+            UShort uiCtxSig      = significanceMapContextOffset + getSigCtxInc( patternSigCtx, codingParameters, iScanPos, uiLog2BlockWidth, uiLog2BlockHeight, channelType );
 
-        //===== update bin model =====
-        if( uiLevel > 1 )
-        {
-          c1 = 0;
-          c2 += (c2 < 2);
-          c2Idx ++;
+            uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ],
+                                                    lLevelDouble, uiMaxAbsLevel, uiCtxSig, uiOneCtx, uiAbsCtx, uiGoRiceParam,
+                                                    c1Idx, c2Idx, iQBits, errorScale, 0, extendedPrecision, maxLog2TrDynamicRange
+                                                    );
+
+            sigRateDelta[ uiBlkPos ] = m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 1 ] - m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 0 ];
+          }
+
+          deltaU[ uiBlkPos ]        = TCoeff((lLevelDouble - (Intermediate_Int(uiLevel) << iQBits)) >> (iQBits-8));
+
+          if( uiLevel > 0 )
+          {
+            Int rateNow = xGetICRate( uiLevel, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange );
+            rateIncUp   [ uiBlkPos ] = xGetICRate( uiLevel+1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange ) - rateNow;
+            rateIncDown [ uiBlkPos ] = xGetICRate( uiLevel-1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange ) - rateNow;
+          }
+          else // uiLevel == 0
+          {
+            rateIncUp   [ uiBlkPos ] = m_pcEstBitsSbac->m_greaterOneBits[ uiOneCtx ][ 0 ];
+          }
+          piDstCoeff[ uiBlkPos ] = uiLevel;
+          d64BaseCost           += pdCostCoeff [ iScanPos ];
+
+          baseLevel = (c1Idx < C1FLAG_NUMBER) ? (2 + (c2Idx < C2FLAG_NUMBER)) : 1;
+          if( uiLevel >= baseLevel )
+          {
+            if (uiLevel > 3*(1<<uiGoRiceParam))
+            {
+              uiGoRiceParam = bUseGolombRiceParameterAdaptation ? (uiGoRiceParam + 1) : (std::min<UInt>((uiGoRiceParam + 1), 4));
+            }
+          }
+          if ( uiLevel >= 1)
+          {
+            c1Idx ++;
+          }
+
+          //===== update bin model =====
+          if( uiLevel > 1 )
+          {
+            c1 = 0;
+            c2 += (c2 < 2);
+            c2Idx ++;
+          }
+          else if( (c1 < 3) && (c1 > 0) && uiLevel)
+          {
+            c1++;
+          }
+
+          //===== context set update =====
+          if( ( iScanPos % uiCGSize == 0 ) && ( iScanPos > 0 ) )
+          {
+            uiCtxSet          = getContextSetIndex(compID, ((iScanPos - 1) >> MLS_CG_SIZE), (c1 == 0)); //(iScanPos - 1) because we do this **before** entering the final group
+            c1                = 1;
+            c2                = 0;
+            c1Idx             = 0;
+            c2Idx             = 0;
+            uiGoRiceParam     = initialGolombRiceParameter;
+          }
         }
-        else if( (c1 < 3) && (c1 > 0) && uiLevel)
+        else
         {
-          c1++;
+          d64BaseCost    += pdCostCoeff0[ iScanPos ];
         }
-
-        //===== context set update =====
-        if( ( iScanPos % uiCGSize == 0 ) && ( iScanPos > 0 ) )
+        rdStats.d64SigCost += pdCostSig[ iScanPos ];
+        if (iScanPosinCG == 0 )
         {
-          uiCtxSet          = getContextSetIndex(compID, ((iScanPos - 1) >> MLS_CG_SIZE), (c1 == 0)); //(iScanPos - 1) because we do this **before** entering the final group
-          c1                = 1;
-          c2                = 0;
-          c1Idx             = 0;
-          c2Idx             = 0;
-          uiGoRiceParam     = initialGolombRiceParameter;
+          rdStats.d64SigCost_0 = pdCostSig[ iScanPos ];
         }
-      }
-      else
-      {
-        d64BaseCost    += pdCostCoeff0[ iScanPos ];
-      }
-      rdStats.d64SigCost += pdCostSig[ iScanPos ];
-      if (iScanPosinCG == 0 )
-      {
-        rdStats.d64SigCost_0 = pdCostSig[ iScanPos ];
-      }
-      if (piDstCoeff[ uiBlkPos ] )
-      {
-        uiSigCoeffGroupFlag[ uiCGBlkPos ] = 1;
-        rdStats.d64CodedLevelandDist += pdCostCoeff[ iScanPos ] - pdCostSig[ iScanPos ];
-        rdStats.d64UncodedDist += pdCostCoeff0[ iScanPos ];
-        if ( iScanPosinCG != 0 )
+        if (piDstCoeff[ uiBlkPos ] )
         {
-          rdStats.iNNZbeforePos0++;
+          uiSigCoeffGroupFlag[ uiCGBlkPos ] = 1;
+          rdStats.d64CodedLevelandDist += pdCostCoeff[ iScanPos ] - pdCostSig[ iScanPos ];
+          rdStats.d64UncodedDist += pdCostCoeff0[ iScanPos ];
+          if ( iScanPosinCG != 0 )
+          {
+            rdStats.iNNZbeforePos0++;
+          }
         }
-      }
-    } //end for (iScanPosinCG)
+      } //end for (iScanPosinCG)
+    }
 
     if (iCGLastScanPos >= 0)
     {
@@ -2439,6 +2583,10 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   //===== estimate last position =====
   if ( iLastScanPos < 0 )
   {
+    if ( pdBestCost != NULL )
+    {
+      *pdBestCost = d64BlockUncodedCost;
+    }
     return;
   }
 
@@ -2511,6 +2659,10 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
     } // end if (uiSigCoeffGroupFlag[ uiCGBlkPos ])
   } // end for
 
+  if ( pdBestCost != NULL )
+  {
+    *pdBestCost = d64BestCost;
+  }
 
   for ( Int scanPos = 0; scanPos < iBestLastIdxP1; scanPos++ )
   {
@@ -2660,6 +2812,113 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   }
 }
 
+/** RDOQ of a single TU, as in the quantisation of the TU.
+ * \param rTu reference to transform data
+ * \param plSrcCoeff pointer to input buffer
+ * \param piDstCoeff reference to quantized transform coefficient
+ * \param piArlDstCoeff reference to adaptive QP selection levels
+ * \param uiAbsSum reference to absolute sum of quantized transform coefficient
+ * \param compID colour component ID
+ * \param cQP reference to quantization parameters
+ * \param useZeroCGFastPath skip the level decisions of coefficient groups quantised to zero
+ * \param rdBestCost receives the RD cost of the chosen last position
+ */
+Void TComTrQuant::rateDistOptQuant                  (       TComTU       &rTu,
+                                                            TCoeff      * plSrcCoeff,
+                                                            TCoeff      * piDstCoeff,
+#if ADAPTIVE_QP_SELECTION
+                                                            TCoeff      * piArlDstCoeff,
+#endif
+                                                            TCoeff       &uiAbsSum,
+                                                      const ComponentID   compID,
+                                                      const QpParam      &cQP,
+                                                      const Bool          useZeroCGFastPath,
+                                                            Double       &rdBestCost )
+{
+#if ADAPTIVE_QP_SELECTION
+  xRateDistOptQuant( rTu, plSrcCoeff, piDstCoeff, piArlDstCoeff, uiAbsSum, compID, cQP, useZeroCGFastPath, &rdBestCost );
+#else
+  xRateDistOptQuant( rTu, plSrcCoeff, piDstCoeff, uiAbsSum, compID, cQP, useZeroCGFastPath, &rdBestCost );
+#endif
+}
+
+#if DEBUG_RDOQ_DUMP_TUS
+/** Append the input of an RDOQ call to the file named by the environment variable RDOQ_DUMP_FILE (default
+ *  rdoq_tus.bin), for the RDOQReplay tool.
+ * \param rTu reference to transform data
+ * \param plSrcCoeff pointer to input buffer
+ * \param compID colour component ID
+ * \param cQP reference to quantization parameters
+ */
+Void TComTrQuant::xDumpRateDistOptQuantInput        (       TComTU       &rTu,
+                                                      const TCoeff      * plSrcCoeff,
+                                                      const ComponentID   compID,
+                                                      const QpParam      &cQP ) const
+{
+  static std::mutex dumpMutex;
+  static FILE*      dumpFile = NULL;
+
+  const TComDataCU    *pcCU         = rTu.getCU();
+  const TComSPS       *sps          = pcCU->getSlice()->getSPS();
+  const TComRectangle &rect         = rTu.getRect(compID);
+  const UInt           uiAbsPartIdx = rTu.GetAbsPartIdxTU(compID);
+
+  RDOQDumpRecord record;
+  memset( &record, 0, sizeof(record) );
+  record.chromaFormat             = sps->getChromaFormatIdc();
+  for (UInt ch = 0; ch < MAX_NUM_CHANNEL_TYPE; ch++)
+  {
+    record.bitDepths[ch]          = sps->getBitDepth(ChannelType(ch));
+  }
+  record.maxCUSize                = sps->getMaxCUWidth();
+  record.extendedPrecision        = sps->getSpsRangeExtension().getExtendedPrecisionProcessingFlag();
+  record.persistentRiceAdaptation = sps->getSpsRangeExtension().getPersistentRiceAdaptationEnabledFlag();
+  record.transformSkipContext     = sps->getSpsRangeExtension().getTransformSkipContextEnabledFlag();
+  record.signDataHiding           = pcCU->getSlice()->getPPS()->getSignDataHidingEnabledFlag();
+  record.scalingList              = m_scalingListEnabledFlag;
+#if ADAPTIVE_QP_SELECTION
+  record.adaptQpSelect            = m_bUseAdaptQpSelect;
+#endif
+  record.cuDepth                  = rTu.getCUDepth();
+  record.trDepth                  = rTu.GetTransformDepthRel();
+  record.splitMode                = rTu.GetSplitMode();
+  record.section                  = rTu.GetSectionNumber();
+  record.compID                   = compID;
+  record.width                    = rect.width;
+  record.height                   = rect.height;
+  record.predMode                 = pcCU->getPredictionMode(uiAbsPartIdx);
+  record.transquantBypass         = pcCU->getCUTransquantBypass(uiAbsPartIdx);
+  record.transformSkip            = pcCU->getTransformSkip(uiAbsPartIdx, compID);
+  record.intraDir[CHANNEL_TYPE_LUMA]   = pcCU->getIntraDir(CHANNEL_TYPE_LUMA, uiAbsPartIdx);
+  record.intraDir[CHANNEL_TYPE_CHROMA] = pcCU->getIntraDir(CHANNEL_TYPE_CHROMA, uiAbsPartIdx);
+  if (isChroma(compID) && record.intraDir[CHANNEL_TYPE_CHROMA] == DM_CHROMA_IDX)
+  {
+    // the replayed CU has a single luma mode: take the one the chroma mode is derived from
+    const UInt partsPerMinCU = 1<<(2*(sps->getMaxTotalCUDepth() - sps->getLog2DiffMaxMinCodingBlockSize()));
+    record.intraDir[CHANNEL_TYPE_LUMA] = pcCU->getIntraDir(CHANNEL_TYPE_LUMA, getChromasCorrespondingPULumaIdx(uiAbsPartIdx, sps->getChromaFormatIdc(), partsPerMinCU));
+  }
+  record.qp                       = cQP.Qp;
+  record.qpPer                    = cQP.per;
+  record.qpRem                    = cQP.rem;
+  record.lambda                   = m_dLambda;
+  record.estBits                  = *m_pcEstBitsSbac;
+
+  std::lock_guard<std::mutex> lock( dumpMutex );
+  if (dumpFile == NULL)
+  {
+    const TChar* fileName = getenv("RDOQ_DUMP_FILE");
+    dumpFile = fopen( fileName != NULL ? fileName : "rdoq_tus.bin", "wb" );
+    if (dumpFile == NULL)
+    {
+      return;
+    }
+  }
+  fwrite( &record, sizeof(record), 1, dumpFile );
+  fwrite( plSrcCoeff, sizeof(TCoeff), rect.width * rect.height, dumpFile );
+  fflush( dumpFile );
+}
+#endif
+
 
 /** Pattern decision for context derivation process of significant_coeff_flag
  * \param sigCoeffGroupFlag pointer to prior coded significant coeff group
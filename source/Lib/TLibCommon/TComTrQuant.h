@@ -76,6 +76,36 @@ typedef struct
 // Class definition
 // ====================================================================================================================
 
+/// input of an RDOQ call: written for each TU when DEBUG_RDOQ_DUMP_TUS is enabled, and replayed by the RDOQReplay tool
+struct RDOQDumpRecord
+{
+  Int               chromaFormat;
+  Int               bitDepths[MAX_NUM_CHANNEL_TYPE];
+  Int               maxCUSize;
+  Int               extendedPrecision;          ///< SPS range extension flags
+  Int               persistentRiceAdaptation;
+  Int               transformSkipContext;
+  Int               signDataHiding;             ///< PPS flag
+  Int               scalingList;                ///< scaling lists in use (the replay only supports flat quantisation)
+  Int               adaptQpSelect;
+  Int               cuDepth;                    ///< position of the TU: depth of the CU, depth of the TU in the CU, split of the TU
+  Int               trDepth;
+  Int               splitMode;
+  Int               section;
+  Int               compID;
+  Int               width;
+  Int               height;
+  Int               predMode;                   ///< CU data at the TU
+  Int               transquantBypass;
+  Int               transformSkip;
+  Int               intraDir[MAX_NUM_CHANNEL_TYPE];
+  Int               qp;
+  Int               qpPer;
+  Int               qpRem;
+  Double            lambda;
+  estBitsSbacStruct estBits;
+};                                              ///< followed by the width*height coefficients of the TU
+
 /// QP struct
 struct QpParam
 {
@@ -142,6 +172,19 @@ public:
 
   Void applyForwardRDPCM( TComTU& rTu, const ComponentID compID, Pel* pcResidual, const UInt uiStride, const QpParam& cQP, TCoeff* pcCoeff, TCoeff &uiAbsSum, const RDPCMMode mode );
 
+  // RDOQ of a single TU, to compare the all-zero coefficient group fast path with the general level decisions
+  Void rateDistOptQuant(       TComTU       &rTu,
+                               TCoeff      * plSrcCoeff,
+                               TCoeff      * piDstCoeff,
+#if ADAPTIVE_QP_SELECTION
+                               TCoeff      * piArlDstCoeff,
+#endif
+                               TCoeff       &uiAbsSum,
+                         const ComponentID   compID,
+                         const QpParam      &cQP,
+                         const Bool          useZeroCGFastPath,
+                               Double       &rdBestCost );
+
   // Misc functions
 
 #if RDOQ_CHROMA_LAMBDA
@@ -151,6 +194,9 @@ public:
   Void setLambda(Double dLambda) { m_dLambda = dLambda;}
 #endif
   Void setRDOQOffset( UInt uiRDOQOffset ) { m_uiRDOQOffset = uiRDOQOffset; }
+  Void setUseRDOQ( Bool useRDOQ, Bool useRDOQTS ) { m_useRDOQ = useRDOQ; m_useRDOQTS = useRDOQTS; }
+  Bool getUseRDOQ  () const { return m_useRDOQ;   }
+  Bool getUseRDOQTS() const { return m_useRDOQTS; }
 
   estBitsSbacStruct* m_pcEstBitsSbac;
 
@@ -230,6 +276,43 @@ protected:
   Double    m_errScaleNoScalingList[SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of quantization matrix coefficient 4x4
 
 private:
+  typedef Void (*FpTrMxN)( Int bitDepth, TCoeff *src, TCoeff *dst, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange );
+
+  typedef Void (*FpQuant)  ( const TCoeff *piCoef, TCoeff *piQCoef, TCoeff *piArlCCoef, TCoeff *deltaU, TCoeff &uiAbsSum, const Int *piQuantCoeff, const Int defaultQuantisationCoefficient,
+                              const Int numSamples, const Int iQBits, const Int iAdd, const Int iQBitsC, const Int iAddC, const TCoeff entropyCodingMinimum, const TCoeff entropyCodingMaximum );
+  typedef Void (*FpDeQuant)( const TCoeff *piQCoef, TCoeff *piCoef, const Int *piDequantCoef, const Int scale, const Int numSamplesInBlock, const Int rightShift,
+                              const Intermediate_Int inputMinimum, const Intermediate_Int inputMaximum, const TCoeff transformMinimum, const TCoeff transformMaximum );
+
+  FpTrMxN   m_fpTrMxN;   ///< 2D forward transform (xTrMxN or a SIMD version)
+  FpTrMxN   m_fpITrMxN;  ///< 2D inverse transform (xITrMxN or a SIMD version)
+  FpQuant   m_fpQuant;   ///< quantisation without RDOQ (xQuantCore or a SIMD version)
+  FpDeQuant m_fpDeQuant; ///< dequantisation (xDeQuantCore or a SIMD version)
+
+  static Void xQuantCore  ( const TCoeff *piCoef, TCoeff *piQCoef, TCoeff *piArlCCoef, TCoeff *deltaU, TCoeff &uiAbsSum, const Int *piQuantCoeff, const Int defaultQuantisationCoefficient,
+                            const Int numSamples, const Int iQBits, const Int iAdd, const Int iQBitsC, const Int iAddC, const TCoeff entropyCodingMinimum, const TCoeff entropyCodingMaximum );
+  static Void xDeQuantCore( const TCoeff *piQCoef, TCoeff *piCoef, const Int *piDequantCoef, const Int scale, const Int numSamplesInBlock, const Int rightShift,
+                            const Intermediate_Int inputMinimum, const Intermediate_Int inputMaximum, const TCoeff transformMinimum, const TCoeff transformMaximum );
+
+  // SIMD kernels (x86/TComTrQuantX86.h)
+#if ENABLE_SIMD_OPT_TRANSFORM
+  template<X86_VEXT vext>
+  static Void xTrMxN_SIMD ( Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange );
+  template<X86_VEXT vext>
+  static Void xITrMxN_SIMD( Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange );
+#endif
+#if ENABLE_SIMD_OPT_QUANT
+  template<X86_VEXT vext>
+  static Void xQuantCore_SIMD  ( const TCoeff *piCoef, TCoeff *piQCoef, TCoeff *piArlCCoef, TCoeff *deltaU, TCoeff &uiAbsSum, const Int *piQuantCoeff, const Int defaultQuantisationCoefficient,
+                                 const Int numSamples, const Int iQBits, const Int iAdd, const Int iQBitsC, const Int iAddC, const TCoeff entropyCodingMinimum, const TCoeff entropyCodingMaximum );
+  template<X86_VEXT vext>
+  static Void xDeQuantCore_SIMD( const TCoeff *piQCoef, TCoeff *piCoef, const Int *piDequantCoef, const Int scale, const Int numSamplesInBlock, const Int rightShift,
+                                 const Intermediate_Int inputMinimum, const Intermediate_Int inputMaximum, const TCoeff transformMinimum, const TCoeff transformMaximum );
+#endif
+#if ENABLE_SIMD_OPT_TRANSFORM || ENABLE_SIMD_OPT_QUANT
+  template<X86_VEXT vext> Void xInitTrQuantX86();
+  Void initTrQuantX86();
+#endif
+
   // forward Transform
   Void xT   ( const Int channelBitDepth, Bool useDST, Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, Int iWidth, Int iHeight, const Int maxLog2TrDynamicRange );
 
@@ -264,7 +347,16 @@ private:
 #endif
                                            TCoeff       &uiAbsSum,
                                      const ComponentID   compID,
-                                     const QpParam      &cQP );
+                                     const QpParam      &cQP,
+                                     const Bool          useZeroCGFastPath = true,
+                                           Double      * pdBestCost        = NULL );
+
+#if DEBUG_RDOQ_DUMP_TUS
+  Void           xDumpRateDistOptQuantInput(       TComTU       &rTu,
+                                             const TCoeff      * plSrcCoeff,
+                                             const ComponentID   compID,
+                                             const QpParam      &cQP ) const;
+#endif
 
 __inline UInt              xGetCodedLevel  ( Double&          rd64CodedCost,
                                              Double&          rd64CodedCost0,
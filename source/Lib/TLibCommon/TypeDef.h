@@ -66,6 +66,7 @@
 #define DEBUG_CABAC_BINS                                  0 ///< When enabled, prints out each bin as it is coded during final encode and decode
 #define DEBUG_INTRA_SEARCH_COSTS                          0 ///< When enabled, prints out the cost for each mode during encoder search
 #define DEBUG_TRANSFORM_AND_QUANTISE                      0 ///< When enabled, prints out each TU as it passes through the transform-quantise-dequantise-inverseTransform process
+#define DEBUG_RDOQ_DUMP_TUS                               0 ///< When enabled, appends the input of each RDOQ call to the file named by RDOQ_DUMP_FILE (default rdoq_tus.bin), for the RDOQReplay tool
 
 #define ENVIRONMENT_VARIABLE_DEBUG_AND_TEST               0 ///< When enabled, allows control of debug modifications via environment variables
 #define PRINT_MACRO_VALUES                                1 ///< When enabled, the encoder prints out a list of the non-environment-variable controlled macros and their values on startup
@@ -128,6 +129,11 @@
 
 #define FAST_BIT_EST                                      1 ///< G763: Table-based bit estimation for CABAC
 
+// This can be enabled by the makefile
+#ifndef FAST_CABAC_DECODER
+#define FAST_CABAC_DECODER                                1 ///< 1 (default) = TDecBinCABAC decodes from a 64-bit window refilled directly from the substream FIFO, with branchless bin decoding and CLZ renormalisation, 0 = original byte-wise engine. Bit-exact either way.
+#endif
+
 #define HHI_RQT_INTRA_SPEEDUP                             1 ///< tests one best mode with full rqt
 #define HHI_RQT_INTRA_SPEEDUP_MOD                         0 ///< tests two best modes with full rqt
 
@@ -156,6 +162,24 @@
 #define VECTOR_CODING__DISTORTION_CALCULATIONS            0 ///< enable vector coding for distortion calculations   0 (default if SSE not possible) disable SSE vector coding. Should not affect RD costs/decisions. Code back-ported from JEM2.0.
 #endif
 
+// This can be enabled by the makefile
+#ifndef ENABLE_SIMD_OPT
+#if defined __SSE2__ || defined __AVX2__ || defined __AVX__ || defined _M_AMD64 || defined _M_X64
+#define ENABLE_SIMD_OPT                                   1 ///< 1 (default if x86) = select SSE4.1/AVX2 kernels from x86/ at runtime according to the CPU, 0 = C code only. Does not affect RD costs/decisions.
+#else
+#define ENABLE_SIMD_OPT                                   0 ///< 0 (default if not x86) = C code only
+#endif
+#endif
+
+#if ENABLE_SIMD_OPT
+#define ENABLE_SIMD_OPT_DIST                              1 ///< SIMD SAD/SSE/Hadamard distortion kernels for TComRdCost
+#define ENABLE_SIMD_OPT_MCIF                              1 ///< SIMD interpolation filter kernels for TComInterpolationFilter
+#define ENABLE_SIMD_OPT_TRANSFORM                         ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 ) ///< SIMD forward/inverse transforms for TComTrQuant (32-bit TCoeff only)
+#define ENABLE_SIMD_OPT_QUANT                             ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 ) ///< SIMD quantisation/dequantisation for TComTrQuant (32-bit TCoeff only)
+#define ENABLE_SIMD_OPT_INTRA                             ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 ) ///< SIMD angular/planar intra prediction and DC filtering for TComPrediction (16-bit Pel only)
+#define ENABLE_SIMD_OPT_MCTF                              ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 ) ///< SIMD motion error for the motion-compensated temporal pre-filter TEncTemporalFilter (16-bit Pel only)
+#endif
+
 // ====================================================================================================================
 // Derived macros
 // ====================================================================================================================
@@ -274,6 +298,18 @@ typedef       UInt            Distortion;        ///< distortion measurement
 // Enumeration
 // ====================================================================================================================
 
+#if ENABLE_SIMD_OPT
+/// x86 vector instruction set extensions, ordered so that each level implies the ones before it
+enum X86_VEXT
+{
+  SCALAR = 0,
+  SSE41,
+  SSE42,
+  AVX,
+  AVX2
+};
+#endif
+
 enum RDPCMMode
 {
   RDPCM_OFF             = 0,
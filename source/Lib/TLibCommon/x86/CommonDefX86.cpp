@@ -0,0 +1,133 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     CommonDefX86.cpp
+    \brief    x86 vector extension detection
+*/
+
+#include "CommonDefX86.h"
+
+#if ENABLE_SIMD_OPT
+
+#ifndef _MSC_VER
+#include <cpuid.h>
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+static Void xCpuid( Int regs[4], Int leaf, Int subLeaf )
+{
+#ifdef _MSC_VER
+  __cpuidex( regs, leaf, subLeaf );
+#else
+  UInt a, b, c, d;
+  __cpuid_count( leaf, subLeaf, a, b, c, d );
+  regs[0] = Int( a );
+  regs[1] = Int( b );
+  regs[2] = Int( c );
+  regs[3] = Int( d );
+#endif
+}
+
+static UInt64 xGetXcr0()
+{
+#ifdef _MSC_VER
+  return _xgetbv( 0 );
+#else
+  UInt eax, edx;
+  __asm__ volatile( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+  return ( UInt64( edx ) << 32 ) | eax;
+#endif
+}
+
+static X86_VEXT xDetectX86Extension()
+{
+  Int regs[4];
+
+  xCpuid( regs, 0, 0 );
+  const Int maxLeaf = regs[0];
+  if( maxLeaf < 1 )
+  {
+    return SCALAR;
+  }
+
+  xCpuid( regs, 1, 0 );
+  const UInt features = UInt( regs[2] );
+  if( ( features & ( 1u << 19 ) ) == 0 )
+  {
+    return SCALAR;
+  }
+  if( ( features & ( 1u << 20 ) ) == 0 )
+  {
+    return SSE41;
+  }
+  // AVX also needs the OS to save the YMM registers on context switches (OSXSAVE and XCR0 bits 1 and 2)
+  if( ( features & ( 1u << 27 ) ) == 0 || ( features & ( 1u << 28 ) ) == 0 || ( xGetXcr0() & 0x6 ) != 0x6 )
+  {
+    return SSE42;
+  }
+  if( maxLeaf < 7 )
+  {
+    return AVX;
+  }
+
+  xCpuid( regs, 7, 0 );
+  if( ( UInt( regs[1] ) & ( 1u << 5 ) ) == 0 )
+  {
+    return AVX;
+  }
+  return AVX2;
+}
+
+X86_VEXT getX86Extension()
+{
+  static const X86_VEXT vext = xDetectX86Extension();
+  return vext;
+}
+
+const TChar* getX86ExtensionName( X86_VEXT vext )
+{
+  switch( vext )
+  {
+    case SSE41: return "SSE4.1";
+    case SSE42: return "SSE4.2";
+    case AVX:   return "AVX";
+    case AVX2:  return "AVX2";
+    default:    return "none";
+  }
+}
+
+//! \}
+
+#endif // ENABLE_SIMD_OPT
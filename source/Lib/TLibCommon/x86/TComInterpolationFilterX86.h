@@ -0,0 +1,365 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComInterpolationFilterX86.h
+    \brief    SIMD interpolation filter kernels for TComInterpolationFilter
+
+    Included by one translation unit per vector extension (x86/sse41, x86/avx2), each compiled with the
+    matching instruction set. The kernels produce exactly the output of TComInterpolationFilter::filter()
+    and filterCopy(). With Pel = Short the filter sums are formed by _mm_madd_epi16 on interleaved pairs
+    of taps, which is exact in 32 bits, and the results of the intermediate stages fit 16 bits for all
+    supported bit depths. With RExt__HIGH_BIT_DEPTH_SUPPORT (Pel = Int) the kernels work on 32-bit lanes.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComInterpolationFilter.h"
+
+#include <string.h>
+
+#if ENABLE_SIMD_OPT_MCIF
+#ifdef SIMDX86
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Helpers
+// ====================================================================================================================
+
+/// filter<> for the columns [col, width) that are not a multiple of the vector width
+template<Int N, Bool isLast>
+static inline Void xFilterColumnsC( Pel const *src, Int cStride, Pel *dst, Int col, Int width, TFilterCoeff const *coeff, Int offset, Int shift, Pel maxVal )
+{
+  for( ; col < width; col++ )
+  {
+    Int sum = 0;
+    for( Int k = 0; k < N; k++ )
+    {
+      sum += src[col + k * cStride] * coeff[k];
+    }
+
+    Pel val = ( sum + offset ) >> shift;
+    if( isLast )
+    {
+      val = ( val < 0 ) ? 0 : val;
+      val = ( val > maxVal ) ? maxVal : val;
+    }
+    dst[col] = val;
+  }
+}
+
+// ====================================================================================================================
+// Kernels
+// ====================================================================================================================
+
+template<X86_VEXT vext, Int N, Bool isVertical, Bool isFirst, Bool isLast>
+Void TComInterpolationFilter::xFilter_SIMD( Int bitDepth, Pel const *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff )
+{
+  // shift and offset as derived in filter()
+  const Int cStride  = ( isVertical ) ? srcStride : 1;
+  const Int headRoom = std::max<Int>( 2, ( IF_INTERNAL_PREC - bitDepth ) );
+  Int       shift    = IF_FILTER_PREC;
+  Int       offset;
+  Pel       maxVal;
+
+  if( isLast )
+  {
+    shift += ( isFirst ) ? 0 : headRoom;
+    offset = 1 << ( shift - 1 );
+    offset += ( isFirst ) ? 0 : IF_INTERNAL_OFFS << IF_FILTER_PREC;
+    maxVal = ( 1 << bitDepth ) - 1;
+  }
+  else
+  {
+    shift -= ( isFirst ) ? headRoom : 0;
+    offset = ( isFirst ) ? -IF_INTERNAL_OFFS << shift : 0;
+    maxVal = 0;
+  }
+
+  src -= ( N / 2 - 1 ) * cStride;
+
+  const __m128i vshift  = _mm_cvtsi32_si128( shift );
+  const __m128i voffset = _mm_set1_epi32( offset );
+  const __m128i vzero   = _mm_setzero_si128();
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+  const __m128i vmax = _mm_set1_epi32( maxVal );
+  __m128i       vcoeff[N];
+  for( Int k = 0; k < N; k++ )
+  {
+    vcoeff[k] = _mm_set1_epi32( coeff[k] );
+  }
+#ifdef USE_AVX2
+  const __m256i vmax256    = _mm256_set1_epi32( maxVal );
+  const __m256i voffset256 = _mm256_set1_epi32( offset );
+  __m256i       vcoeff256[N];
+  for( Int k = 0; k < N; k++ )
+  {
+    vcoeff256[k] = _mm256_set1_epi32( coeff[k] );
+  }
+#endif
+
+  for( Int row = 0; row < height; row++ )
+  {
+    Int col = 0;
+#ifdef USE_AVX2
+    for( ; col + 8 <= width; col += 8 )
+    {
+      __m256i vsum = voffset256;
+      for( Int k = 0; k < N; k++ )
+      {
+        const __m256i vsrc = _mm256_loadu_si256( ( const __m256i* ) &src[col + k * cStride] );
+        vsum = _mm256_add_epi32( vsum, _mm256_mullo_epi32( vsrc, vcoeff256[k] ) );
+      }
+      vsum = _mm256_sra_epi32( vsum, vshift );
+      if( isLast )
+      {
+        vsum = _mm256_min_epi32( _mm256_max_epi32( vsum, _mm256_setzero_si256() ), vmax256 );
+      }
+      _mm256_storeu_si256( ( __m256i* ) &dst[col], vsum );
+    }
+#endif
+    for( ; col + 4 <= width; col += 4 )
+    {
+      __m128i vsum = voffset;
+      for( Int k = 0; k < N; k++ )
+      {
+        const __m128i vsrc = _mm_loadu_si128( ( const __m128i* ) &src[col + k * cStride] );
+        vsum = _mm_add_epi32( vsum, _mm_mullo_epi32( vsrc, vcoeff[k] ) );
+      }
+      vsum = _mm_sra_epi32( vsum, vshift );
+      if( isLast )
+      {
+        vsum = _mm_min_epi32( _mm_max_epi32( vsum, vzero ), vmax );
+      }
+      _mm_storeu_si128( ( __m128i* ) &dst[col], vsum );
+    }
+    xFilterColumnsC<N, isLast>( src, cStride, dst, col, width, coeff, offset, shift, maxVal );
+
+    src += srcStride;
+    dst += dstStride;
+  }
+#else
+  // pairs of taps, applied with _mm_madd_epi16 to pairs of interleaved samples
+  const __m128i vmax = _mm_set1_epi16( maxVal );
+  __m128i       vcoeff[N / 2];
+  for( Int k = 0; k < N; k += 2 )
+  {
+    vcoeff[k >> 1] = _mm_set1_epi32( Int( ( UInt( UShort( coeff[k + 1] ) ) << 16 ) | UShort( coeff[k] ) ) );
+  }
+#ifdef USE_AVX2
+  const __m256i vmax256    = _mm256_set1_epi16( maxVal );
+  const __m256i voffset256 = _mm256_set1_epi32( offset );
+  __m256i       vcoeff256[N / 2];
+  for( Int k = 0; k < N / 2; k++ )
+  {
+    vcoeff256[k] = _mm256_broadcastsi128_si256( vcoeff[k] );
+  }
+#endif
+
+  for( Int row = 0; row < height; row++ )
+  {
+    Int col = 0;
+#ifdef USE_AVX2
+    for( ; col + 16 <= width; col += 16 )
+    {
+      __m256i vsumLo = voffset256;
+      __m256i vsumHi = voffset256;
+      for( Int k = 0; k < N; k += 2 )
+      {
+        const __m256i vsrc0 = _mm256_loadu_si256( ( const __m256i* ) &src[col +   k       * cStride] );
+        const __m256i vsrc1 = _mm256_loadu_si256( ( const __m256i* ) &src[col + ( k + 1 ) * cStride] );
+        vsumLo = _mm256_add_epi32( vsumLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( vsrc0, vsrc1 ), vcoeff256[k >> 1] ) );
+        vsumHi = _mm256_add_epi32( vsumHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( vsrc0, vsrc1 ), vcoeff256[k >> 1] ) );
+      }
+      // the in-lane unpack and pack restore the sample order
+      __m256i vres = _mm256_packs_epi32( _mm256_sra_epi32( vsumLo, vshift ), _mm256_sra_epi32( vsumHi, vshift ) );
+      if( isLast )
+      {
+        vres = _mm256_min_epi16( _mm256_max_epi16( vres, _mm256_setzero_si256() ), vmax256 );
+      }
+      _mm256_storeu_si256( ( __m256i* ) &dst[col], vres );
+    }
+#endif
+    for( ; col + 8 <= width; col += 8 )
+    {
+      __m128i vsumLo = voffset;
+      __m128i vsumHi = voffset;
+      for( Int k = 0; k < N; k += 2 )
+      {
+        const __m128i vsrc0 = _mm_loadu_si128( ( const __m128i* ) &src[col +   k       * cStride] );
+        const __m128i vsrc1 = _mm_loadu_si128( ( const __m128i* ) &src[col + ( k + 1 ) * cStride] );
+        vsumLo = _mm_add_epi32( vsumLo, _mm_madd_epi16( _mm_unpacklo_epi16( vsrc0, vsrc1 ), vcoeff[k >> 1] ) );
+        vsumHi = _mm_add_epi32( vsumHi, _mm_madd_epi16( _mm_unpackhi_epi16( vsrc0, vsrc1 ), vcoeff[k >> 1] ) );
+      }
+      __m128i vres = _mm_packs_epi32( _mm_sra_epi32( vsumLo, vshift ), _mm_sra_epi32( vsumHi, vshift ) );
+      if( isLast )
+      {
+        vres = _mm_min_epi16( _mm_max_epi16( vres, vzero ), vmax );
+      }
+      _mm_storeu_si128( ( __m128i* ) &dst[col], vres );
+    }
+    if( col + 4 <= width )
+    {
+      __m128i vsum = voffset;
+      for( Int k = 0; k < N; k += 2 )
+      {
+        const __m128i vsrc0 = _mm_loadl_epi64( ( const __m128i* ) &src[col +   k       * cStride] );
+        const __m128i vsrc1 = _mm_loadl_epi64( ( const __m128i* ) &src[col + ( k + 1 ) * cStride] );
+        vsum = _mm_add_epi32( vsum, _mm_madd_epi16( _mm_unpacklo_epi16( vsrc0, vsrc1 ), vcoeff[k >> 1] ) );
+      }
+      vsum = _mm_sra_epi32( vsum, vshift );
+      __m128i vres = _mm_packs_epi32( vsum, vsum );
+      if( isLast )
+      {
+        vres = _mm_min_epi16( _mm_max_epi16( vres, vzero ), vmax );
+      }
+      _mm_storel_epi64( ( __m128i* ) &dst[col], vres );
+      col += 4;
+    }
+    xFilterColumnsC<N, isLast>( src, cStride, dst, col, width, coeff, offset, shift, maxVal );
+
+    src += srcStride;
+    dst += dstStride;
+  }
+#endif
+}
+
+template<X86_VEXT vext>
+Void TComInterpolationFilter::xFilterCopy_SIMD( Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast )
+{
+  if( isFirst == isLast )
+  {
+    for( Int row = 0; row < height; row++ )
+    {
+      ::memcpy( dst, src, width * sizeof( Pel ) );
+      src += srcStride;
+      dst += dstStride;
+    }
+    return;
+  }
+
+  const Int     shift  = std::max<Int>( 2, ( IF_INTERNAL_PREC - bitDepth ) );
+  const __m128i vshift = _mm_cvtsi32_si128( shift );
+  const Int     vecWidth = width & ~( ( RExt__HIGH_BIT_DEPTH_SUPPORT ? 4 : 8 ) - 1 );
+
+  if( isFirst )
+  {
+    // dst = ( src << shift ) - IF_INTERNAL_OFFS, wrapping to the width of Pel as in filterCopy()
+    for( Int row = 0; row < height; row++ )
+    {
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+      const __m128i voffs = _mm_set1_epi32( IF_INTERNAL_OFFS );
+      for( Int col = 0; col < vecWidth; col += 4 )
+      {
+        const __m128i vsrc = _mm_loadu_si128( ( const __m128i* ) &src[col] );
+        _mm_storeu_si128( ( __m128i* ) &dst[col], _mm_sub_epi32( _mm_sll_epi32( vsrc, vshift ), voffs ) );
+      }
+#else
+      const __m128i voffs = _mm_set1_epi16( IF_INTERNAL_OFFS );
+      for( Int col = 0; col < vecWidth; col += 8 )
+      {
+        const __m128i vsrc = _mm_loadu_si128( ( const __m128i* ) &src[col] );
+        _mm_storeu_si128( ( __m128i* ) &dst[col], _mm_sub_epi16( _mm_sll_epi16( vsrc, vshift ), voffs ) );
+      }
+#endif
+      src += srcStride;
+      dst += dstStride;
+    }
+  }
+  else
+  {
+    // dst = Clip( ( src + IF_INTERNAL_OFFS + round ) >> shift ), computed in 32 bits as in filterCopy()
+    const __m128i voffs = _mm_set1_epi32( IF_INTERNAL_OFFS + ( 1 << ( shift - 1 ) ) );
+    const __m128i vzero = _mm_setzero_si128();
+    for( Int row = 0; row < height; row++ )
+    {
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+      const __m128i vmax = _mm_set1_epi32( ( 1 << bitDepth ) - 1 );
+      for( Int col = 0; col < vecWidth; col += 4 )
+      {
+        const __m128i vsrc = _mm_loadu_si128( ( const __m128i* ) &src[col] );
+        const __m128i vres = _mm_sra_epi32( _mm_add_epi32( vsrc, voffs ), vshift );
+        _mm_storeu_si128( ( __m128i* ) &dst[col], _mm_min_epi32( _mm_max_epi32( vres, vzero ), vmax ) );
+      }
+#else
+      const __m128i vmax = _mm_set1_epi16( ( 1 << bitDepth ) - 1 );
+      for( Int col = 0; col < vecWidth; col += 8 )
+      {
+        const __m128i vsrc = _mm_loadu_si128( ( const __m128i* ) &src[col] );
+        const __m128i vlo  = _mm_sra_epi32( _mm_add_epi32( _mm_cvtepi16_epi32( vsrc ),                      voffs ), vshift );
+        const __m128i vhi  = _mm_sra_epi32( _mm_add_epi32( _mm_cvtepi16_epi32( _mm_srli_si128( vsrc, 8 ) ), voffs ), vshift );
+        _mm_storeu_si128( ( __m128i* ) &dst[col], _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vlo, vhi ), vzero ), vmax ) );
+      }
+#endif
+      src += srcStride;
+      dst += dstStride;
+    }
+  }
+
+  if( vecWidth < width )
+  {
+    filterCopy( bitDepth, src - height * srcStride + vecWidth, srcStride, dst - height * dstStride + vecWidth, dstStride, width - vecWidth, height, isFirst, isLast );
+  }
+}
+
+// ====================================================================================================================
+// Registration
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TComInterpolationFilter::xInitInterpolationFilterX86()
+{
+  m_filterHor[0][0]    = xFilter_SIMD<vext, NTAPS_CHROMA, false, true,  false>;
+  m_filterHor[0][1]    = xFilter_SIMD<vext, NTAPS_CHROMA, false, true,  true >;
+  m_filterHor[1][0]    = xFilter_SIMD<vext, NTAPS_LUMA,   false, true,  false>;
+  m_filterHor[1][1]    = xFilter_SIMD<vext, NTAPS_LUMA,   false, true,  true >;
+
+  m_filterVer[0][0][0] = xFilter_SIMD<vext, NTAPS_CHROMA, true,  false, false>;
+  m_filterVer[0][0][1] = xFilter_SIMD<vext, NTAPS_CHROMA, true,  false, true >;
+  m_filterVer[0][1][0] = xFilter_SIMD<vext, NTAPS_CHROMA, true,  true,  false>;
+  m_filterVer[0][1][1] = xFilter_SIMD<vext, NTAPS_CHROMA, true,  true,  true >;
+  m_filterVer[1][0][0] = xFilter_SIMD<vext, NTAPS_LUMA,   true,  false, false>;
+  m_filterVer[1][0][1] = xFilter_SIMD<vext, NTAPS_LUMA,   true,  false, true >;
+  m_filterVer[1][1][0] = xFilter_SIMD<vext, NTAPS_LUMA,   true,  true,  false>;
+  m_filterVer[1][1][1] = xFilter_SIMD<vext, NTAPS_LUMA,   true,  true,  true >;
+
+  m_filterCopy         = xFilterCopy_SIMD<vext>;
+}
+
+template Void TComInterpolationFilter::xInitInterpolationFilterX86<SIMDX86>();
+
+//! \}
+
+#endif // SIMDX86
+#endif // ENABLE_SIMD_OPT_MCIF
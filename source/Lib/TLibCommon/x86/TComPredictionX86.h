@@ -0,0 +1,357 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComPredictionX86.h
+    \brief    SIMD intra prediction kernels for TComPrediction
+
+    Included by one translation unit per vector extension (x86/sse41, x86/avx2), each compiled with the
+    matching instruction set. The kernels produce exactly the output of the C functions in TComPrediction.cpp.
+    The angular interpolation ((32-f)*a + f*b + 16) >> 5 is formed by _mm_madd_epi16 on interleaved pairs of
+    neighbouring reference samples, which is exact in 32 bits; there is one kernel per block width so that the
+    rows of 4x4 and 8x8 blocks are handled by single 64-bit and 128-bit operations. Planar prediction and DC
+    filtering are computed on 32-bit lanes as in the C code.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComPrediction.h"
+#include "../TComRom.h"
+
+#if ENABLE_SIMD_OPT_INTRA
+#ifdef SIMDX86
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Helpers
+// ====================================================================================================================
+
+/// ((32-f)*a[x] + f*a[x+1] + 16) >> 5 for 8 samples, with vcoeff holding the pairs (32-f, f)
+static inline __m128i xIntraInterp8( const Pel *a, const __m128i &vcoeff, const __m128i &vround )
+{
+  const __m128i v0 = _mm_loadu_si128( ( const __m128i* ) a );
+  const __m128i v1 = _mm_loadu_si128( ( const __m128i* ) ( a + 1 ) );
+  __m128i lo = _mm_madd_epi16( _mm_unpacklo_epi16( v0, v1 ), vcoeff );
+  __m128i hi = _mm_madd_epi16( _mm_unpackhi_epi16( v0, v1 ), vcoeff );
+  lo = _mm_srai_epi32( _mm_add_epi32( lo, vround ), 5 );
+  hi = _mm_srai_epi32( _mm_add_epi32( hi, vround ), 5 );
+  return _mm_packs_epi32( lo, hi );
+}
+
+#ifdef USE_AVX2
+/// ((32-f)*a[x] + f*a[x+1] + 16) >> 5 for 16 samples; the in-lane unpack and pack keep the sample order
+static inline __m256i xIntraInterp16( const Pel *a, const __m256i &vcoeff, const __m256i &vround )
+{
+  const __m256i v0 = _mm256_loadu_si256( ( const __m256i* ) a );
+  const __m256i v1 = _mm256_loadu_si256( ( const __m256i* ) ( a + 1 ) );
+  __m256i lo = _mm256_madd_epi16( _mm256_unpacklo_epi16( v0, v1 ), vcoeff );
+  __m256i hi = _mm256_madd_epi16( _mm256_unpackhi_epi16( v0, v1 ), vcoeff );
+  lo = _mm256_srai_epi32( _mm256_add_epi32( lo, vround ), 5 );
+  hi = _mm256_srai_epi32( _mm256_add_epi32( hi, vround ), 5 );
+  return _mm256_packs_epi32( lo, hi );
+}
+#endif
+
+/// transpose of a 4x4 block
+static inline Void xTranspose4x4( const Pel *src, Int srcStride, Pel *dst, Int dstStride )
+{
+  const __m128i r0 = _mm_loadl_epi64( ( const __m128i* ) ( src                 ) );
+  const __m128i r1 = _mm_loadl_epi64( ( const __m128i* ) ( src +     srcStride ) );
+  const __m128i r2 = _mm_loadl_epi64( ( const __m128i* ) ( src + 2 * srcStride ) );
+  const __m128i r3 = _mm_loadl_epi64( ( const __m128i* ) ( src + 3 * srcStride ) );
+
+  const __m128i t0 = _mm_unpacklo_epi16( r0, r1 );
+  const __m128i t1 = _mm_unpacklo_epi16( r2, r3 );
+  const __m128i c01 = _mm_unpacklo_epi32( t0, t1 );
+  const __m128i c23 = _mm_unpackhi_epi32( t0, t1 );
+
+  _mm_storel_epi64( ( __m128i* ) ( dst                 ), c01 );
+  _mm_storel_epi64( ( __m128i* ) ( dst +     dstStride ), _mm_unpackhi_epi64( c01, c01 ) );
+  _mm_storel_epi64( ( __m128i* ) ( dst + 2 * dstStride ), c23 );
+  _mm_storel_epi64( ( __m128i* ) ( dst + 3 * dstStride ), _mm_unpackhi_epi64( c23, c23 ) );
+}
+
+/// transpose of an 8x8 block
+static inline Void xTranspose8x8( const Pel *src, Int srcStride, Pel *dst, Int dstStride )
+{
+  __m128i r[8];
+  for( Int i = 0; i < 8; i++ )
+  {
+    r[i] = _mm_loadu_si128( ( const __m128i* ) ( src + i * srcStride ) );
+  }
+
+  const __m128i t0 = _mm_unpacklo_epi16( r[0], r[1] );
+  const __m128i t1 = _mm_unpackhi_epi16( r[0], r[1] );
+  const __m128i t2 = _mm_unpacklo_epi16( r[2], r[3] );
+  const __m128i t3 = _mm_unpackhi_epi16( r[2], r[3] );
+  const __m128i t4 = _mm_unpacklo_epi16( r[4], r[5] );
+  const __m128i t5 = _mm_unpackhi_epi16( r[4], r[5] );
+  const __m128i t6 = _mm_unpacklo_epi16( r[6], r[7] );
+  const __m128i t7 = _mm_unpackhi_epi16( r[6], r[7] );
+
+  const __m128i u0 = _mm_unpacklo_epi32( t0, t2 );
+  const __m128i u1 = _mm_unpackhi_epi32( t0, t2 );
+  const __m128i u2 = _mm_unpacklo_epi32( t1, t3 );
+  const __m128i u3 = _mm_unpackhi_epi32( t1, t3 );
+  const __m128i u4 = _mm_unpacklo_epi32( t4, t6 );
+  const __m128i u5 = _mm_unpackhi_epi32( t4, t6 );
+  const __m128i u6 = _mm_unpacklo_epi32( t5, t7 );
+  const __m128i u7 = _mm_unpackhi_epi32( t5, t7 );
+
+  _mm_storeu_si128( ( __m128i* ) ( dst                 ), _mm_unpacklo_epi64( u0, u4 ) );
+  _mm_storeu_si128( ( __m128i* ) ( dst +     dstStride ), _mm_unpackhi_epi64( u0, u4 ) );
+  _mm_storeu_si128( ( __m128i* ) ( dst + 2 * dstStride ), _mm_unpacklo_epi64( u1, u5 ) );
+  _mm_storeu_si128( ( __m128i* ) ( dst + 3 * dstStride ), _mm_unpackhi_epi64( u1, u5 ) );
+  _mm_storeu_si128( ( __m128i* ) ( dst + 4 * dstStride ), _mm_unpacklo_epi64( u2, u6 ) );
+  _mm_storeu_si128( ( __m128i* ) ( dst + 5 * dstStride ), _mm_unpackhi_epi64( u2, u6 ) );
+  _mm_storeu_si128( ( __m128i* ) ( dst + 6 * dstStride ), _mm_unpacklo_epi64( u3, u7 ) );
+  _mm_storeu_si128( ( __m128i* ) ( dst + 7 * dstStride ), _mm_unpackhi_epi64( u3, u7 ) );
+}
+
+// ====================================================================================================================
+// Kernels
+// ====================================================================================================================
+
+template<X86_VEXT vext, Int W>
+Void TComPrediction::xPredIntraAngRows_SIMD( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle )
+{
+  assert( width == W );
+
+  const __m128i vround = _mm_set1_epi32( 16 );
+#ifdef USE_AVX2
+  const __m256i vround256 = _mm256_set1_epi32( 16 );
+#endif
+
+  for( Int y = 0, deltaPos = intraPredAngle; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const Int  deltaInt   = deltaPos >> 5;
+    const Int  deltaFract = deltaPos & ( 32 - 1 );
+    const Pel *pRM        = refMain + deltaInt + 1;
+
+    if( deltaFract )
+    {
+      const Int coeffPair = ( deltaFract << 16 ) | ( 32 - deltaFract );
+
+      if( W == 4 )
+      {
+        const __m128i vcoeff = _mm_set1_epi32( coeffPair );
+        const __m128i v0     = _mm_loadl_epi64( ( const __m128i* ) pRM );
+        const __m128i v1     = _mm_loadl_epi64( ( const __m128i* ) ( pRM + 1 ) );
+        __m128i       sum    = _mm_madd_epi16( _mm_unpacklo_epi16( v0, v1 ), vcoeff );
+        sum = _mm_srai_epi32( _mm_add_epi32( sum, vround ), 5 );
+        _mm_storel_epi64( ( __m128i* ) pDst, _mm_packs_epi32( sum, sum ) );
+      }
+#ifdef USE_AVX2
+      else if( W >= 16 )
+      {
+        const __m256i vcoeff = _mm256_set1_epi32( coeffPair );
+        for( Int x = 0; x < W; x += 16 )
+        {
+          _mm256_storeu_si256( ( __m256i* ) ( pDst + x ), xIntraInterp16( pRM + x, vcoeff, vround256 ) );
+        }
+      }
+#endif
+      else
+      {
+        const __m128i vcoeff = _mm_set1_epi32( coeffPair );
+        for( Int x = 0; x < W; x += 8 )
+        {
+          _mm_storeu_si128( ( __m128i* ) ( pDst + x ), xIntraInterp8( pRM + x, vcoeff, vround ) );
+        }
+      }
+    }
+    else
+    {
+      // pure vertical/horizontal and diagonal modes, and integer positions of the other modes
+      if( W == 4 )
+      {
+        _mm_storel_epi64( ( __m128i* ) pDst, _mm_loadl_epi64( ( const __m128i* ) pRM ) );
+      }
+#ifdef USE_AVX2
+      else if( W >= 16 )
+      {
+        for( Int x = 0; x < W; x += 16 )
+        {
+          _mm256_storeu_si256( ( __m256i* ) ( pDst + x ), _mm256_loadu_si256( ( const __m256i* ) ( pRM + x ) ) );
+        }
+      }
+#endif
+      else
+      {
+        for( Int x = 0; x < W; x += 8 )
+        {
+          _mm_storeu_si128( ( __m128i* ) ( pDst + x ), _mm_loadu_si128( ( const __m128i* ) ( pRM + x ) ) );
+        }
+      }
+    }
+  }
+}
+
+template<X86_VEXT vext>
+Void TComPrediction::xTransposeBlock_SIMD( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
+  if( ( ( width | height ) & 7 ) == 0 )
+  {
+    for( Int y = 0; y < height; y += 8 )
+    {
+      for( Int x = 0; x < width; x += 8 )
+      {
+        xTranspose8x8( pSrc + y * srcStride + x, srcStride, pDst + x * dstStride + y, dstStride );
+      }
+    }
+  }
+  else if( ( ( width | height ) & 3 ) == 0 )
+  {
+    for( Int y = 0; y < height; y += 4 )
+    {
+      for( Int x = 0; x < width; x += 4 )
+      {
+        xTranspose4x4( pSrc + y * srcStride + x, srcStride, pDst + x * dstStride + y, dstStride );
+      }
+    }
+  }
+  else
+  {
+    xTransposeBlock( pSrc, srcStride, pDst, dstStride, width, height );
+  }
+}
+
+template<X86_VEXT vext>
+Void TComPrediction::xPredIntraPlanar_SIMD( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height )
+{
+  assert( width <= height );
+
+  if( width & 3 )
+  {
+    xPredIntraPlanar( pSrc, srcStride, rpDst, dstStride, width, height );
+    return;
+  }
+
+  // same intermediate values as xPredIntraPlanar(): topRow[x] accumulates bottomRow[x] once per row and
+  // the horizontal term grows by rightColumn[y] per column, i.e. by (x+1)*rightColumn[y] at column x
+  Int topRow   [MAX_CU_SIZE];
+  Int bottomRow[MAX_CU_SIZE];
+  const UInt shift1Dhor = g_aucConvertToBit[ width ] + 2;
+  const UInt shift1Dver = g_aucConvertToBit[ height ] + 2;
+  const Int  bottomLeft = pSrc[Int(height)*srcStride-1];
+  const Int  topRight   = pSrc[Int(width)-srcStride];
+
+  const __m128i vbottomLeft = _mm_set1_epi32( bottomLeft );
+  for( Int x = 0; x < Int(width); x += 4 )
+  {
+    const __m128i top = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( pSrc + x - srcStride ) ) );
+    _mm_storeu_si128( ( __m128i* ) ( bottomRow + x ), _mm_sub_epi32( vbottomLeft, top ) );
+    _mm_storeu_si128( ( __m128i* ) ( topRow    + x ), _mm_slli_epi32( top, shift1Dver ) );
+  }
+
+  const __m128i vshift = _mm_cvtsi32_si128( shift1Dhor + 1 );
+  const __m128i vstep  = _mm_setr_epi32( 1, 2, 3, 4 );
+
+  for( Int y = 0; y < Int(height); y++, rpDst += dstStride )
+  {
+    const Int     left        = pSrc[y*srcStride-1];
+    const Int     rightColumn = topRight - left;
+    const __m128i vright      = _mm_set1_epi32( rightColumn );
+    const __m128i vright4     = _mm_set1_epi32( rightColumn * 4 );
+    __m128i       horPred     = _mm_add_epi32( _mm_set1_epi32( ( left << shift1Dhor ) + Int(width) ), _mm_mullo_epi32( vstep, vright ) );
+
+    for( Int x = 0; x < Int(width); x += 4 )
+    {
+      __m128i vertPred = _mm_add_epi32( _mm_loadu_si128( ( const __m128i* ) ( topRow + x ) ), _mm_loadu_si128( ( const __m128i* ) ( bottomRow + x ) ) );
+      _mm_storeu_si128( ( __m128i* ) ( topRow + x ), vertPred );
+
+      const __m128i pred = _mm_sra_epi32( _mm_add_epi32( horPred, vertPred ), vshift );
+      _mm_storel_epi64( ( __m128i* ) ( rpDst + x ), _mm_packs_epi32( pred, pred ) );
+      horPred = _mm_add_epi32( horPred, vright4 );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+Void TComPrediction::xDCPredFiltering_SIMD( const Pel* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, ChannelType channelType )
+{
+  if( isLuma( channelType ) && ( iWidth <= MAXIMUM_INTRA_FILTERED_WIDTH ) && ( iHeight <= MAXIMUM_INTRA_FILTERED_HEIGHT ) )
+  {
+    if( iWidth & 3 )
+    {
+      xDCPredFiltering( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight, channelType );
+      return;
+    }
+
+    //top-left
+    const Pel topLeft = ( Pel ) ( ( pSrc[-iSrcStride] + pSrc[-1] + 2 * pDst[0] + 2 ) >> 2 );
+
+    //top row (vertical filter), computed from x = 0 and then overwritten by the top-left value
+    const __m128i vround = _mm_set1_epi32( 2 );
+    for( Int x = 0; x < iWidth; x += 4 )
+    {
+      const __m128i above = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( pSrc + x - iSrcStride ) ) );
+      const __m128i pred  = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( pDst + x ) ) );
+      __m128i       sum   = _mm_add_epi32( _mm_add_epi32( above, vround ), _mm_add_epi32( pred, _mm_slli_epi32( pred, 1 ) ) );
+      sum = _mm_srai_epi32( sum, 2 );
+      _mm_storel_epi64( ( __m128i* ) ( pDst + x ), _mm_packs_epi32( sum, sum ) );
+    }
+    pDst[0] = topLeft;
+
+    //left column (horizontal filter)
+    for( Int y = 1; y < iHeight; y++ )
+    {
+      pDst[y*iDstStride] = ( Pel ) ( ( pSrc[y*iSrcStride-1] + 3 * pDst[y*iDstStride] + 2 ) >> 2 );
+    }
+  }
+}
+
+// ====================================================================================================================
+// Registration
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TComPrediction::xInitPredictionX86()
+{
+  m_fpPredIntraAngRows[0] = xPredIntraAngRows_SIMD<vext,  4>;
+  m_fpPredIntraAngRows[1] = xPredIntraAngRows_SIMD<vext,  8>;
+  m_fpPredIntraAngRows[2] = xPredIntraAngRows_SIMD<vext, 16>;
+  m_fpPredIntraAngRows[3] = xPredIntraAngRows_SIMD<vext, 32>;
+  m_fpPredIntraAngRows[4] = xPredIntraAngRows_SIMD<vext, 64>;
+
+  m_fpTransposeBlock      = xTransposeBlock_SIMD<vext>;
+  m_fpPredIntraPlanar     = xPredIntraPlanar_SIMD<vext>;
+  m_fpDCPredFiltering     = xDCPredFiltering_SIMD<vext>;
+}
+
+template Void TComPrediction::xInitPredictionX86<SIMDX86>();
+
+//! \}
+
+#endif // SIMDX86
+#endif // ENABLE_SIMD_OPT_INTRA
@@ -0,0 +1,621 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComRdCostX86.h
+    \brief    SIMD distortion kernels (SAD, SSE, Hadamard) for TComRdCost
+
+    Included by one translation unit per vector extension (x86/sse41, x86/avx2), each compiled with the
+    matching instruction set. The kernels return exactly the values of the C functions in TComRdCost.cpp:
+    Pel is Short for builds without RExt__HIGH_BIT_DEPTH_SUPPORT, where the encoder limits the internal bit
+    depth to 12, so sample differences fit 16-bit lanes and squared differences fit 32-bit lanes. With
+    RExt__HIGH_BIT_DEPTH_SUPPORT, Pel is Int and squared differences are accumulated in 64-bit lanes.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComRdCost.h"
+
+#if ENABLE_SIMD_OPT_DIST
+#ifdef SIMDX86
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Helpers
+// ====================================================================================================================
+
+static inline UInt64 xHorizontalSum64( const __m128i vsum64 )
+{
+  UInt64 sum[2];
+  _mm_storeu_si128( ( __m128i* ) sum, vsum64 );
+  return sum[0] + sum[1];
+}
+
+static inline UInt xHorizontalSum32( const __m128i vsum32 )
+{
+  __m128i vsum = _mm_add_epi32( vsum32, _mm_shuffle_epi32( vsum32, 0x4e ) );
+  vsum = _mm_add_epi32( vsum, _mm_shuffle_epi32( vsum, 0xb1 ) );
+  return UInt( _mm_cvtsi128_si32( vsum ) );
+}
+
+/// adds four unsigned 32-bit lanes to two 64-bit lanes
+static inline __m128i xAccumulate32To64( const __m128i vsum64, const __m128i vsum32 )
+{
+  const __m128i vzero = _mm_setzero_si128();
+  return _mm_add_epi64( _mm_add_epi64( vsum64, _mm_unpacklo_epi32( vsum32, vzero ) ), _mm_unpackhi_epi32( vsum32, vzero ) );
+}
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+/// adds the squares of four signed 32-bit lanes to two 64-bit lanes
+static inline __m128i xAccumulateSquares64( const __m128i vsum64, const __m128i vdiff )
+{
+  const __m128i vodd = _mm_srli_epi64( vdiff, 32 );
+  return _mm_add_epi64( _mm_add_epi64( vsum64, _mm_mul_epi32( vdiff, vdiff ) ), _mm_mul_epi32( vodd, vodd ) );
+}
+#endif
+
+/// SAD of one row, as four 32-bit partial sums. iWidth == 0 takes the width from iCols.
+template<X86_VEXT vext, Int iWidth>
+static inline __m128i xSADRow( const Pel* piOrg, const Pel* piCur, const Int iCols )
+{
+  const Int iNumCols = iWidth > 0 ? iWidth : iCols;
+  __m128i   vsum32   = _mm_setzero_si128();
+  Int       n        = 0;
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+#ifdef USE_AVX2
+  if( vext >= AVX2 && iNumCols >= 8 )
+  {
+    __m256i vsum256 = _mm256_setzero_si256();
+    for( ; n + 8 <= iNumCols; n += 8 )
+    {
+      const __m256i vorg = _mm256_loadu_si256( ( const __m256i* ) &piOrg[n] );
+      const __m256i vcur = _mm256_loadu_si256( ( const __m256i* ) &piCur[n] );
+      vsum256 = _mm256_add_epi32( vsum256, _mm256_abs_epi32( _mm256_sub_epi32( vorg, vcur ) ) );
+    }
+    vsum32 = _mm_add_epi32( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) );
+  }
+#endif
+  for( ; n + 4 <= iNumCols; n += 4 )
+  {
+    const __m128i vorg = _mm_loadu_si128( ( const __m128i* ) &piOrg[n] );
+    const __m128i vcur = _mm_loadu_si128( ( const __m128i* ) &piCur[n] );
+    vsum32 = _mm_add_epi32( vsum32, _mm_abs_epi32( _mm_sub_epi32( vorg, vcur ) ) );
+  }
+#else
+  const __m128i vone = _mm_set1_epi16( 1 );
+#ifdef USE_AVX2
+  if( vext >= AVX2 && iNumCols >= 16 )
+  {
+    const __m256i vone256 = _mm256_set1_epi16( 1 );
+    __m256i       vsum256 = _mm256_setzero_si256();
+    for( ; n + 16 <= iNumCols; n += 16 )
+    {
+      const __m256i vorg = _mm256_loadu_si256( ( const __m256i* ) &piOrg[n] );
+      const __m256i vcur = _mm256_loadu_si256( ( const __m256i* ) &piCur[n] );
+      vsum256 = _mm256_add_epi32( vsum256, _mm256_madd_epi16( _mm256_abs_epi16( _mm256_sub_epi16( vorg, vcur ) ), vone256 ) );
+    }
+    vsum32 = _mm_add_epi32( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) );
+  }
+#endif
+  for( ; n + 8 <= iNumCols; n += 8 )
+  {
+    const __m128i vorg = _mm_loadu_si128( ( const __m128i* ) &piOrg[n] );
+    const __m128i vcur = _mm_loadu_si128( ( const __m128i* ) &piCur[n] );
+    vsum32 = _mm_add_epi32( vsum32, _mm_madd_epi16( _mm_abs_epi16( _mm_sub_epi16( vorg, vcur ) ), vone ) );
+  }
+  if( n + 4 <= iNumCols )
+  {
+    const __m128i vorg = _mm_loadl_epi64( ( const __m128i* ) &piOrg[n] );
+    const __m128i vcur = _mm_loadl_epi64( ( const __m128i* ) &piCur[n] );
+    vsum32 = _mm_add_epi32( vsum32, _mm_madd_epi16( _mm_abs_epi16( _mm_sub_epi16( vorg, vcur ) ), vone ) );
+    n += 4;
+  }
+#endif
+
+  if( iWidth == 0 && n < iNumCols )
+  {
+    Int iTail = 0;
+    for( ; n < iNumCols; n++ )
+    {
+      iTail += abs( piOrg[n] - piCur[n] );
+    }
+    vsum32 = _mm_add_epi32( vsum32, _mm_cvtsi32_si128( iTail ) );
+  }
+
+  return vsum32;
+}
+
+/// SSE of one row, as two 64-bit partial sums. iWidth == 0 takes the width from iCols.
+template<X86_VEXT vext, Int iWidth>
+static inline __m128i xSSERow( const Pel* piOrg, const Pel* piCur, const Int iCols )
+{
+  const Int iNumCols = iWidth > 0 ? iWidth : iCols;
+  Int       n        = 0;
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+  __m128i vsum64 = _mm_setzero_si128();
+#ifdef USE_AVX2
+  if( vext >= AVX2 && iNumCols >= 8 )
+  {
+    __m256i vsum256 = _mm256_setzero_si256();
+    for( ; n + 8 <= iNumCols; n += 8 )
+    {
+      const __m256i vdiff = _mm256_sub_epi32( _mm256_loadu_si256( ( const __m256i* ) &piOrg[n] ), _mm256_loadu_si256( ( const __m256i* ) &piCur[n] ) );
+      const __m256i vodd  = _mm256_srli_epi64( vdiff, 32 );
+      vsum256 = _mm256_add_epi64( vsum256, _mm256_mul_epi32( vdiff, vdiff ) );
+      vsum256 = _mm256_add_epi64( vsum256, _mm256_mul_epi32( vodd, vodd ) );
+    }
+    vsum64 = _mm_add_epi64( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) );
+  }
+#endif
+  for( ; n + 4 <= iNumCols; n += 4 )
+  {
+    const __m128i vdiff = _mm_sub_epi32( _mm_loadu_si128( ( const __m128i* ) &piOrg[n] ), _mm_loadu_si128( ( const __m128i* ) &piCur[n] ) );
+    vsum64 = xAccumulateSquares64( vsum64, vdiff );
+  }
+#else
+  // each 32-bit lane collects at most iNumCols / 8 sums of two squared 12-bit differences
+  assert( iNumCols <= 1024 );
+  __m128i vsum32 = _mm_setzero_si128();
+#ifdef USE_AVX2
+  if( vext >= AVX2 && iNumCols >= 16 )
+  {
+    __m256i vsum256 = _mm256_setzero_si256();
+    for( ; n + 16 <= iNumCols; n += 16 )
+    {
+      const __m256i vdiff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* ) &piOrg[n] ), _mm256_loadu_si256( ( const __m256i* ) &piCur[n] ) );
+      vsum256 = _mm256_add_epi32( vsum256, _mm256_madd_epi16( vdiff, vdiff ) );
+    }
+    vsum32 = _mm_add_epi32( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) );
+  }
+#endif
+  for( ; n + 8 <= iNumCols; n += 8 )
+  {
+    const __m128i vdiff = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* ) &piOrg[n] ), _mm_loadu_si128( ( const __m128i* ) &piCur[n] ) );
+    vsum32 = _mm_add_epi32( vsum32, _mm_madd_epi16( vdiff, vdiff ) );
+  }
+  if( n + 4 <= iNumCols )
+  {
+    const __m128i vdiff = _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* ) &piOrg[n] ), _mm_loadl_epi64( ( const __m128i* ) &piCur[n] ) );
+    vsum32 = _mm_add_epi32( vsum32, _mm_madd_epi16( vdiff, vdiff ) );
+    n += 4;
+  }
+  __m128i vsum64 = xAccumulate32To64( _mm_setzero_si128(), vsum32 );
+#endif
+
+  if( iWidth == 0 && n < iNumCols )
+  {
+    UInt64 uiTail = 0;
+    for( ; n < iNumCols; n++ )
+    {
+      const Intermediate_Int iTemp = piOrg[n] - piCur[n];
+      uiTail += Distortion( iTemp * iTemp );
+    }
+    vsum64 = _mm_add_epi64( vsum64, _mm_set_epi32( 0, 0, Int( uiTail >> 32 ), Int( uiTail ) ) );
+  }
+
+  return vsum64;
+}
+
+/// difference of four samples as 32-bit lanes
+static inline __m128i xLoadDiff4( const Pel* piOrg, const Pel* piCur )
+{
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+  return _mm_sub_epi32( _mm_loadu_si128( ( const __m128i* ) piOrg ), _mm_loadu_si128( ( const __m128i* ) piCur ) );
+#else
+  return _mm_cvtepi16_epi32( _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* ) piOrg ), _mm_loadl_epi64( ( const __m128i* ) piCur ) ) );
+#endif
+}
+
+static inline Void xTranspose4x4( const __m128i* pIn, __m128i* pOut )
+{
+  const __m128i t0 = _mm_unpacklo_epi32( pIn[0], pIn[1] );
+  const __m128i t1 = _mm_unpackhi_epi32( pIn[0], pIn[1] );
+  const __m128i t2 = _mm_unpacklo_epi32( pIn[2], pIn[3] );
+  const __m128i t3 = _mm_unpackhi_epi32( pIn[2], pIn[3] );
+  pOut[0] = _mm_unpacklo_epi64( t0, t2 );
+  pOut[1] = _mm_unpackhi_epi64( t0, t2 );
+  pOut[2] = _mm_unpacklo_epi64( t1, t3 );
+  pOut[3] = _mm_unpackhi_epi64( t1, t3 );
+}
+
+/// 4-point Hadamard butterfly across four registers (output order is irrelevant for the SATD)
+static inline Void xHadamard4( __m128i* v )
+{
+  const __m128i s0 = _mm_add_epi32( v[0], v[1] );
+  const __m128i s1 = _mm_sub_epi32( v[0], v[1] );
+  const __m128i s2 = _mm_add_epi32( v[2], v[3] );
+  const __m128i s3 = _mm_sub_epi32( v[2], v[3] );
+  v[0] = _mm_add_epi32( s0, s2 );
+  v[1] = _mm_add_epi32( s1, s3 );
+  v[2] = _mm_sub_epi32( s0, s2 );
+  v[3] = _mm_sub_epi32( s1, s3 );
+}
+
+static inline __m128i xAdd32( const __m128i a, const __m128i b ) { return _mm_add_epi32( a, b ); }
+static inline __m128i xSub32( const __m128i a, const __m128i b ) { return _mm_sub_epi32( a, b ); }
+#ifdef USE_AVX2
+static inline __m256i xAdd32( const __m256i a, const __m256i b ) { return _mm256_add_epi32( a, b ); }
+static inline __m256i xSub32( const __m256i a, const __m256i b ) { return _mm256_sub_epi32( a, b ); }
+#endif
+
+/// 8-point Hadamard butterfly across eight registers (output order is irrelevant for the SATD)
+template<typename T>
+static inline Void xHadamard8( T* v )
+{
+  T a[8];
+  for( Int i = 0; i < 4; i++ )
+  {
+    a[i    ] = xAdd32( v[i], v[i + 4] );
+    a[i + 4] = xSub32( v[i], v[i + 4] );
+  }
+  for( Int i = 0; i < 8; i += 4 )
+  {
+    v[i    ] = xAdd32( a[i    ], a[i + 2] );
+    v[i + 1] = xAdd32( a[i + 1], a[i + 3] );
+    v[i + 2] = xSub32( a[i    ], a[i + 2] );
+    v[i + 3] = xSub32( a[i + 1], a[i + 3] );
+  }
+  for( Int i = 0; i < 8; i += 2 )
+  {
+    a[i    ] = xAdd32( v[i], v[i + 1] );
+    a[i + 1] = xSub32( v[i], v[i + 1] );
+  }
+  for( Int i = 0; i < 8; i++ )
+  {
+    v[i] = a[i];
+  }
+}
+
+static inline Distortion xCalcHADs4x4_SIMD( const Pel* piOrg, const Pel* piCur, const Int iStrideOrg, const Int iStrideCur )
+{
+  __m128i m[4], t[4];
+
+  for( Int k = 0; k < 4; k++ )
+  {
+    m[k] = xLoadDiff4( piOrg + k * iStrideOrg, piCur + k * iStrideCur );
+  }
+
+  xHadamard4( m );
+  xTranspose4x4( m, t );
+  xHadamard4( t );
+
+  const __m128i vsum = _mm_add_epi32( _mm_add_epi32( _mm_abs_epi32( t[0] ), _mm_abs_epi32( t[1] ) ),
+                                      _mm_add_epi32( _mm_abs_epi32( t[2] ), _mm_abs_epi32( t[3] ) ) );
+  const Distortion satd = xHorizontalSum32( vsum );
+
+  return ( satd + 1 ) >> 1;
+}
+
+template<X86_VEXT vext>
+static inline Distortion xCalcHADs8x8_SIMD( const Pel* piOrg, const Pel* piCur, const Int iStrideOrg, const Int iStrideCur )
+{
+  __m128i vsum;
+
+#ifdef USE_AVX2
+  if( vext >= AVX2 )
+  {
+    __m256i m[8];
+    for( Int k = 0; k < 8; k++ )
+    {
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+      m[k] = _mm256_sub_epi32( _mm256_loadu_si256( ( const __m256i* ) ( piOrg + k * iStrideOrg ) ), _mm256_loadu_si256( ( const __m256i* ) ( piCur + k * iStrideCur ) ) );
+#else
+      m[k] = _mm256_cvtepi16_epi32( _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* ) ( piOrg + k * iStrideOrg ) ), _mm_loadu_si128( ( const __m128i* ) ( piCur + k * iStrideCur ) ) ) );
+#endif
+    }
+
+    xHadamard8( m );
+
+    // transpose 8x8
+    __m256i t[8];
+    for( Int k = 0; k < 8; k += 2 )
+    {
+      t[k    ] = _mm256_unpacklo_epi32( m[k], m[k + 1] );
+      t[k + 1] = _mm256_unpackhi_epi32( m[k], m[k + 1] );
+    }
+    for( Int k = 0; k < 8; k += 4 )
+    {
+      m[k    ] = _mm256_unpacklo_epi64( t[k    ], t[k + 2] );
+      m[k + 1] = _mm256_unpackhi_epi64( t[k    ], t[k + 2] );
+      m[k + 2] = _mm256_unpacklo_epi64( t[k + 1], t[k + 3] );
+      m[k + 3] = _mm256_unpackhi_epi64( t[k + 1], t[k + 3] );
+    }
+    for( Int k = 0; k < 4; k++ )
+    {
+      t[k    ] = _mm256_permute2x128_si256( m[k], m[k + 4], 0x20 );
+      t[k + 4] = _mm256_permute2x128_si256( m[k], m[k + 4], 0x31 );
+    }
+
+    xHadamard8( t );
+
+    __m256i vsum256 = _mm256_abs_epi32( t[0] );
+    for( Int k = 1; k < 8; k++ )
+    {
+      vsum256 = _mm256_add_epi32( vsum256, _mm256_abs_epi32( t[k] ) );
+    }
+    vsum = _mm_add_epi32( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) );
+  }
+  else
+#endif
+  {
+    // m[h][r] holds columns 4h..4h+3 of row r
+    __m128i m[2][8], t[2][8];
+    for( Int k = 0; k < 8; k++ )
+    {
+      m[0][k] = xLoadDiff4( piOrg + k * iStrideOrg,     piCur + k * iStrideCur     );
+      m[1][k] = xLoadDiff4( piOrg + k * iStrideOrg + 4, piCur + k * iStrideCur + 4 );
+    }
+
+    xHadamard8( m[0] );
+    xHadamard8( m[1] );
+
+    // t[k][c] holds rows 4k..4k+3 of column c
+    for( Int h = 0; h < 2; h++ )
+    {
+      for( Int k = 0; k < 2; k++ )
+      {
+        xTranspose4x4( &m[h][4 * k], &t[k][4 * h] );
+      }
+    }
+
+    xHadamard8( t[0] );
+    xHadamard8( t[1] );
+
+    vsum = _mm_setzero_si128();
+    for( Int k = 0; k < 8; k++ )
+    {
+      vsum = _mm_add_epi32( vsum, _mm_add_epi32( _mm_abs_epi32( t[0][k] ), _mm_abs_epi32( t[1][k] ) ) );
+    }
+  }
+
+  const Distortion sad = xHorizontalSum32( vsum );
+
+  return ( sad + 2 ) >> 2;
+}
+
+// ====================================================================================================================
+// Distortion functions
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Distortion TComRdCost::xGetSAD_SIMD( DistParam* pcDtParam )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    return xGetSAD( pcDtParam );
+  }
+  const Pel* piOrg           = pcDtParam->pOrg;
+  const Pel* piCur           = pcDtParam->pCur;
+  const Int  iCols           = pcDtParam->iCols;
+  const Int  iStrideCur      = pcDtParam->iStrideCur;
+  const Int  iStrideOrg      = pcDtParam->iStrideOrg;
+  const UInt distortionShift = DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 );
+
+  // same early exit as xGetSAD, which has none in its JEM vector path
+#if VECTOR_CODING__DISTORTION_CALCULATIONS && ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 )
+  const Bool bEarlyExit = pcDtParam->bitDepth > 10 && pcDtParam->m_maximumDistortionForEarlyExit != std::numeric_limits<Distortion>::max();
+#else
+  const Bool bEarlyExit = pcDtParam->m_maximumDistortionForEarlyExit != std::numeric_limits<Distortion>::max();
+#endif
+
+  Distortion uiSum = 0;
+
+  if( bEarlyExit )
+  {
+    for( Int iRows = pcDtParam->iRows; iRows != 0; iRows-- )
+    {
+      uiSum += xHorizontalSum32( xSADRow<vext, 0>( piOrg, piCur, iCols ) );
+      if( pcDtParam->m_maximumDistortionForEarlyExit < ( uiSum >> distortionShift ) )
+      {
+        return ( uiSum >> distortionShift );
+      }
+      piOrg += iStrideOrg;
+      piCur += iStrideCur;
+    }
+  }
+  else
+  {
+    __m128i vsum64 = _mm_setzero_si128();
+    for( Int iRows = pcDtParam->iRows; iRows != 0; iRows-- )
+    {
+      vsum64 = xAccumulate32To64( vsum64, xSADRow<vext, 0>( piOrg, piCur, iCols ) );
+      piOrg += iStrideOrg;
+      piCur += iStrideCur;
+    }
+    uiSum = xHorizontalSum64( vsum64 );
+  }
+
+  return ( uiSum >> distortionShift );
+}
+
+/// SAD of a block of fixed width iWidth, or of any multiple of 16 for iWidth == 0, on every (1 << iSubShift)-th row
+template<X86_VEXT vext, Int iWidth, FpDistFunc fpDistFuncC>
+Distortion TComRdCost::xGetSADN_SIMD( DistParam* pcDtParam )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    return fpDistFuncC( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = pcDtParam->iCols;
+  const Int  iSubShift  = pcDtParam->iSubShift;
+  const Int  iSubStep   = ( 1 << iSubShift );
+  const Int  iStrideCur = pcDtParam->iStrideCur * iSubStep;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg * iSubStep;
+
+  __m128i vsum64 = _mm_setzero_si128();
+  for( Int iRows = pcDtParam->iRows; iRows != 0; iRows -= iSubStep )
+  {
+    vsum64 = xAccumulate32To64( vsum64, xSADRow<vext, iWidth>( piOrg, piCur, iCols ) );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  Distortion uiSum = xHorizontalSum64( vsum64 );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
+}
+
+/// SSE of a block of fixed width iWidth, or of any width for iWidth == 0
+template<X86_VEXT vext, Int iWidth, FpDistFunc fpDistFuncC>
+Distortion TComRdCost::xGetSSE_SIMD( DistParam* pcDtParam )
+{
+  // xGetSSE* drop the low bits of each squared difference, which cannot be done on sums
+  if( pcDtParam->bApplyWeight || DISTORTION_PRECISION_ADJUSTMENT( ( pcDtParam->bitDepth - 8 ) << 1 ) != 0 )
+  {
+    return fpDistFuncC( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = pcDtParam->iCols;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+
+  __m128i vsum64 = _mm_setzero_si128();
+  for( Int iRows = pcDtParam->iRows; iRows != 0; iRows-- )
+  {
+    vsum64 = _mm_add_epi64( vsum64, xSSERow<vext, iWidth>( piOrg, piCur, iCols ) );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorizontalSum64( vsum64 );
+}
+
+template<X86_VEXT vext>
+Distortion TComRdCost::xGetHADs_SIMD( DistParam* pcDtParam )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    return xGetHADs( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iRows      = pcDtParam->iRows;
+  const Int  iCols      = pcDtParam->iCols;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+
+  Distortion uiSum = 0;
+
+  if( ( iRows % 8 == 0 ) && ( iCols % 8 == 0 ) )
+  {
+    assert( pcDtParam->iStep == 1 );
+    for( Int y = 0; y < iRows; y += 8 )
+    {
+      for( Int x = 0; x < iCols; x += 8 )
+      {
+        uiSum += xCalcHADs8x8_SIMD<vext>( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg << 3;
+      piCur += iStrideCur << 3;
+    }
+  }
+  else if( ( iRows % 4 == 0 ) && ( iCols % 4 == 0 ) )
+  {
+    assert( pcDtParam->iStep == 1 );
+    for( Int y = 0; y < iRows; y += 4 )
+    {
+      for( Int x = 0; x < iCols; x += 4 )
+      {
+        uiSum += xCalcHADs4x4_SIMD( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg << 2;
+      piCur += iStrideCur << 2;
+    }
+  }
+  else
+  {
+    return xGetHADs( pcDtParam );
+  }
+
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
+}
+
+// ====================================================================================================================
+// Registration
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TComRdCost::xInitRdCostX86()
+{
+  m_afpDistortFunc[DF_SSE    ] = xGetSSE_SIMD <vext,  0, xGetSSE   >;
+  m_afpDistortFunc[DF_SSE4   ] = xGetSSE_SIMD <vext,  4, xGetSSE4  >;
+  m_afpDistortFunc[DF_SSE8   ] = xGetSSE_SIMD <vext,  8, xGetSSE8  >;
+  m_afpDistortFunc[DF_SSE16  ] = xGetSSE_SIMD <vext, 16, xGetSSE16 >;
+  m_afpDistortFunc[DF_SSE32  ] = xGetSSE_SIMD <vext, 32, xGetSSE32 >;
+  m_afpDistortFunc[DF_SSE64  ] = xGetSSE_SIMD <vext, 64, xGetSSE64 >;
+  m_afpDistortFunc[DF_SSE16N ] = xGetSSE_SIMD <vext,  0, xGetSSE16N>;
+
+  m_afpDistortFunc[DF_SAD    ] = xGetSAD_SIMD <vext>;
+  m_afpDistortFunc[DF_SAD4   ] = xGetSADN_SIMD<vext,  4, xGetSAD4  >;
+  m_afpDistortFunc[DF_SAD8   ] = xGetSADN_SIMD<vext,  8, xGetSAD8  >;
+  m_afpDistortFunc[DF_SAD16  ] = xGetSADN_SIMD<vext, 16, xGetSAD16 >;
+  m_afpDistortFunc[DF_SAD32  ] = xGetSADN_SIMD<vext, 32, xGetSAD32 >;
+  m_afpDistortFunc[DF_SAD64  ] = xGetSADN_SIMD<vext, 64, xGetSAD64 >;
+  m_afpDistortFunc[DF_SAD16N ] = xGetSADN_SIMD<vext,  0, xGetSAD16N>;
+
+  m_afpDistortFunc[DF_SADS   ] = m_afpDistortFunc[DF_SAD   ];
+  m_afpDistortFunc[DF_SADS4  ] = m_afpDistortFunc[DF_SAD4  ];
+  m_afpDistortFunc[DF_SADS8  ] = m_afpDistortFunc[DF_SAD8  ];
+  m_afpDistortFunc[DF_SADS16 ] = m_afpDistortFunc[DF_SAD16 ];
+  m_afpDistortFunc[DF_SADS32 ] = m_afpDistortFunc[DF_SAD32 ];
+  m_afpDistortFunc[DF_SADS64 ] = m_afpDistortFunc[DF_SAD64 ];
+  m_afpDistortFunc[DF_SADS16N] = m_afpDistortFunc[DF_SAD16N];
+
+  m_afpDistortFunc[DF_SAD12  ] = xGetSADN_SIMD<vext, 12, xGetSAD12 >;
+  m_afpDistortFunc[DF_SAD24  ] = xGetSADN_SIMD<vext, 24, xGetSAD24 >;
+  m_afpDistortFunc[DF_SAD48  ] = xGetSADN_SIMD<vext, 48, xGetSAD48 >;
+
+  m_afpDistortFunc[DF_SADS12 ] = m_afpDistortFunc[DF_SAD12 ];
+  m_afpDistortFunc[DF_SADS24 ] = m_afpDistortFunc[DF_SAD24 ];
+  m_afpDistortFunc[DF_SADS48 ] = m_afpDistortFunc[DF_SAD48 ];
+
+  m_afpDistortFunc[DF_HADS   ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS4  ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS8  ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS16 ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS32 ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS64 ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS16N] = xGetHADs_SIMD<vext>;
+}
+
+template Void TComRdCost::xInitRdCostX86<SIMDX86>();
+
+//! \}
+
+#endif // SIMDX86
+#endif // ENABLE_SIMD_OPT_DIST
@@ -0,0 +1,564 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComTrQuantX86.h
+    \brief    SIMD transforms and quantisers for TComTrQuant
+
+    Included by one translation unit per vector extension (x86/sse41, x86/avx2), each compiled with the
+    matching instruction set.
+
+    Transforms: each 1D stage processes 4 (SSE4.1) or 8 (AVX2) lines at once, using the same
+    even/odd decomposition, matrix entries, rounding and clipping as partialButterfly*() and
+    fastForwardDst()/fastInverseDst(), on 32-bit lanes as in the C code. The blocks are transposed between
+    the stages so that the lines are contiguous in memory.
+
+    Quantisation: the products of the magnitudes and the quantisation coefficients are formed on 64 bits
+    (_mm_mul_epu32 on the even and odd lanes), as the Int64 tmpLevel of the C code. Dequantisation is done on
+    32-bit lanes as in the C code.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComTrQuant.h"
+#include "../TComRom.h"
+
+#include <limits>
+
+#if ENABLE_SIMD_OPT_TRANSFORM || ENABLE_SIMD_OPT_QUANT
+#ifdef SIMDX86
+
+//! \ingroup TLibCommon
+//! \{
+
+#if ENABLE_SIMD_OPT_TRANSFORM
+// ====================================================================================================================
+// Vector helpers
+// ====================================================================================================================
+
+template<Int N> struct TrSize {};
+
+static inline Void    xTrLoad ( __m128i &v, const TCoeff *p )                 { v = _mm_loadu_si128( ( const __m128i* ) p ); }
+static inline Void    xTrStore( TCoeff *p, const __m128i &v )                 { _mm_storeu_si128( ( __m128i* ) p, v ); }
+static inline __m128i xTrAdd  ( const __m128i &a, const __m128i &b )          { return _mm_add_epi32( a, b ); }
+static inline __m128i xTrSub  ( const __m128i &a, const __m128i &b )          { return _mm_sub_epi32( a, b ); }
+static inline __m128i xTrMul  ( const __m128i &a, const Int c )               { return _mm_mullo_epi32( a, _mm_set1_epi32( c ) ); }
+static inline __m128i xTrRound( const __m128i &a, const Int add, const Int shift )
+{
+  return _mm_sra_epi32( _mm_add_epi32( a, _mm_set1_epi32( add ) ), _mm_cvtsi32_si128( shift ) );
+}
+static inline __m128i xTrClip ( const __m128i &a, const TCoeff minVal, const TCoeff maxVal )
+{
+  return _mm_min_epi32( _mm_max_epi32( a, _mm_set1_epi32( minVal ) ), _mm_set1_epi32( maxVal ) );
+}
+
+#ifdef USE_AVX2
+static inline Void    xTrLoad ( __m256i &v, const TCoeff *p )                 { v = _mm256_loadu_si256( ( const __m256i* ) p ); }
+static inline Void    xTrStore( TCoeff *p, const __m256i &v )                 { _mm256_storeu_si256( ( __m256i* ) p, v ); }
+static inline __m256i xTrAdd  ( const __m256i &a, const __m256i &b )          { return _mm256_add_epi32( a, b ); }
+static inline __m256i xTrSub  ( const __m256i &a, const __m256i &b )          { return _mm256_sub_epi32( a, b ); }
+static inline __m256i xTrMul  ( const __m256i &a, const Int c )               { return _mm256_mullo_epi32( a, _mm256_set1_epi32( c ) ); }
+static inline __m256i xTrRound( const __m256i &a, const Int add, const Int shift )
+{
+  return _mm256_sra_epi32( _mm256_add_epi32( a, _mm256_set1_epi32( add ) ), _mm_cvtsi32_si128( shift ) );
+}
+static inline __m256i xTrClip ( const __m256i &a, const TCoeff minVal, const TCoeff maxVal )
+{
+  return _mm256_min_epi32( _mm256_max_epi32( a, _mm256_set1_epi32( minVal ) ), _mm256_set1_epi32( maxVal ) );
+}
+#endif
+
+/// dst[c][r] = src[r][c] for a rows x cols block, both multiples of 4 and at least 4.
+/// The loops run at least once, so that the compiler can see that dst is written before it is read.
+static inline Void xTranspose( const TCoeff *src, TCoeff *dst, const Int rows, const Int cols )
+{
+  assert( rows >= 4 && cols >= 4 );
+  Int r = 0;
+  do
+  {
+    Int c = 0;
+    do
+    {
+      const __m128i r0 = _mm_loadu_si128( ( const __m128i* ) &src[( r + 0 ) * cols + c] );
+      const __m128i r1 = _mm_loadu_si128( ( const __m128i* ) &src[( r + 1 ) * cols + c] );
+      const __m128i r2 = _mm_loadu_si128( ( const __m128i* ) &src[( r + 2 ) * cols + c] );
+      const __m128i r3 = _mm_loadu_si128( ( const __m128i* ) &src[( r + 3 ) * cols + c] );
+      const __m128i t0 = _mm_unpacklo_epi32( r0, r1 );
+      const __m128i t1 = _mm_unpacklo_epi32( r2, r3 );
+      const __m128i t2 = _mm_unpackhi_epi32( r0, r1 );
+      const __m128i t3 = _mm_unpackhi_epi32( r2, r3 );
+      _mm_storeu_si128( ( __m128i* ) &dst[( c + 0 ) * rows + r], _mm_unpacklo_epi64( t0, t1 ) );
+      _mm_storeu_si128( ( __m128i* ) &dst[( c + 1 ) * rows + r], _mm_unpackhi_epi64( t0, t1 ) );
+      _mm_storeu_si128( ( __m128i* ) &dst[( c + 2 ) * rows + r], _mm_unpacklo_epi64( t2, t3 ) );
+      _mm_storeu_si128( ( __m128i* ) &dst[( c + 3 ) * rows + r], _mm_unpackhi_epi64( t2, t3 ) );
+      c += 4;
+    }
+    while( c < cols );
+    r += 4;
+  }
+  while( r < rows );
+}
+
+// ====================================================================================================================
+// 1D butterflies on vectors of lines
+// ====================================================================================================================
+
+/** Forward butterfly of size N: y[k] = sum_n T[k * rowStep][n] * x[n], as in partialButterflyN()
+ *  \param mat      top-level transform matrix (matSize x matSize)
+ *  \param rowStep  row spacing of the size-N matrix inside mat
+ */
+template<typename V>
+static inline Void xFwdButterfly( const V *x, V *y, const TMatrixCoeff *mat, const Int matSize, const Int rowStep, TrSize<4> )
+{
+  const V E0 = xTrAdd( x[0], x[3] );
+  const V O0 = xTrSub( x[0], x[3] );
+  const V E1 = xTrAdd( x[1], x[2] );
+  const V O1 = xTrSub( x[1], x[2] );
+
+  const TMatrixCoeff *m0 = mat;
+  const TMatrixCoeff *m1 = mat +     rowStep * matSize;
+  const TMatrixCoeff *m2 = mat + 2 * rowStep * matSize;
+  const TMatrixCoeff *m3 = mat + 3 * rowStep * matSize;
+
+  y[0] = xTrAdd( xTrMul( E0, m0[0] ), xTrMul( E1, m0[1] ) );
+  y[2] = xTrAdd( xTrMul( E0, m2[0] ), xTrMul( E1, m2[1] ) );
+  y[1] = xTrAdd( xTrMul( O0, m1[0] ), xTrMul( O1, m1[1] ) );
+  y[3] = xTrAdd( xTrMul( O0, m3[0] ), xTrMul( O1, m3[1] ) );
+}
+
+template<typename V, Int N>
+static inline Void xFwdButterfly( const V *x, V *y, const TMatrixCoeff *mat, const Int matSize, const Int rowStep, TrSize<N> )
+{
+  V E[N / 2], O[N / 2], EE[N / 2];
+
+  for( Int k = 0; k < N / 2; k++ )
+  {
+    E[k] = xTrAdd( x[k], x[N - 1 - k] );
+    O[k] = xTrSub( x[k], x[N - 1 - k] );
+  }
+
+  xFwdButterfly( E, EE, mat, matSize, 2 * rowStep, TrSize<N / 2>() );
+
+  for( Int k = 0; k < N / 2; k++ )
+  {
+    const TMatrixCoeff *m = mat + ( 2 * k + 1 ) * rowStep * matSize;
+
+    V sum = xTrMul( O[0], m[0] );
+    for( Int n = 1; n < N / 2; n++ )
+    {
+      sum = xTrAdd( sum, xTrMul( O[n], m[n] ) );
+    }
+    y[2 * k    ] = EE[k];
+    y[2 * k + 1] = sum;
+  }
+}
+
+/** Inverse butterfly of size N: y[n] = sum_k T[k * rowStep][n] * x[k], as in partialButterflyInverseN()
+ *  \param mat      top-level transform matrix (matSize x matSize)
+ *  \param rowStep  row spacing of the size-N matrix inside mat
+ */
+template<typename V>
+static inline Void xInvButterfly( const V *x, V *y, const TMatrixCoeff *mat, const Int matSize, const Int rowStep, TrSize<4> )
+{
+  const TMatrixCoeff *m0 = mat;
+  const TMatrixCoeff *m1 = mat +     rowStep * matSize;
+  const TMatrixCoeff *m2 = mat + 2 * rowStep * matSize;
+  const TMatrixCoeff *m3 = mat + 3 * rowStep * matSize;
+
+  const V O0 = xTrAdd( xTrMul( x[1], m1[0] ), xTrMul( x[3], m3[0] ) );
+  const V O1 = xTrAdd( xTrMul( x[1], m1[1] ), xTrMul( x[3], m3[1] ) );
+  const V E0 = xTrAdd( xTrMul( x[0], m0[0] ), xTrMul( x[2], m2[0] ) );
+  const V E1 = xTrAdd( xTrMul( x[0], m0[1] ), xTrMul( x[2], m2[1] ) );
+
+  y[0] = xTrAdd( E0, O0 );
+  y[1] = xTrAdd( E1, O1 );
+  y[2] = xTrSub( E1, O1 );
+  y[3] = xTrSub( E0, O0 );
+}
+
+template<typename V, Int N>
+static inline Void xInvButterfly( const V *x, V *y, const TMatrixCoeff *mat, const Int matSize, const Int rowStep, TrSize<N> )
+{
+  V xe[N / 2], E[N / 2], O[N / 2];
+
+  for( Int k = 0; k < N / 2; k++ )
+  {
+    xe[k] = x[2 * k];
+  }
+
+  xInvButterfly( xe, E, mat, matSize, 2 * rowStep, TrSize<N / 2>() );
+
+  for( Int n = 0; n < N / 2; n++ )
+  {
+    O[n] = xTrMul( x[1], mat[rowStep * matSize + n] );
+  }
+  for( Int k = 3; k < N; k += 2 )
+  {
+    const TMatrixCoeff *m = mat + k * rowStep * matSize;
+    for( Int n = 0; n < N / 2; n++ )
+    {
+      O[n] = xTrAdd( O[n], xTrMul( x[k], m[n] ) );
+    }
+  }
+
+  for( Int n = 0; n < N / 2; n++ )
+  {
+    y[n]         = xTrAdd( E[n], O[n] );
+    y[N - 1 - n] = xTrSub( E[n], O[n] );
+  }
+}
+
+/// 4-point DST: y[r] = sum_c M[r][c] * x[c] (forward) or y[c] = sum_r M[r][c] * x[r] (inverse), as in fastForwardDst()/fastInverseDst()
+template<typename V>
+static inline Void xDst4( const V *x, V *y, const TMatrixCoeff mat[4][4], const Bool inverse )
+{
+  for( Int i = 0; i < 4; i++ )
+  {
+    V sum = xTrMul( x[0], inverse ? mat[0][i] : mat[i][0] );
+    for( Int j = 1; j < 4; j++ )
+    {
+      sum = xTrAdd( sum, xTrMul( x[j], inverse ? mat[j][i] : mat[i][j] ) );
+    }
+    y[i] = sum;
+  }
+}
+
+// ====================================================================================================================
+// 1D stages
+// ====================================================================================================================
+
+/** One 1D stage applied to the columns of an N x line block: dst[k][j] = Round( T(src[.][j]) )[k], clipped for
+ *  the inverse transform. Lines are processed sizeof(V) / 4 at a time.
+ */
+template<typename V, Int N, Bool isInverse>
+static inline Void xTrStage( const TCoeff *src, TCoeff *dst, const Int line, const Int shift, const Bool useDST, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+  const TransformDirection dir   = isInverse ? TRANSFORM_INVERSE : TRANSFORM_FORWARD;
+  const TMatrixCoeff      *mat   = ( N == 4 ) ? g_aiT4[dir][0] : ( N == 8 ) ? g_aiT8[dir][0] : ( N == 16 ) ? g_aiT16[dir][0] : g_aiT32[dir][0];
+  const Int                add   = ( shift > 0 ) ? ( 1 << ( shift - 1 ) ) : 0;
+  const Int                lanes = Int( sizeof( V ) / sizeof( TCoeff ) );
+
+  for( Int j = 0; j < line; j += lanes )
+  {
+    V x[N], y[N];
+
+    for( Int k = 0; k < N; k++ )
+    {
+      xTrLoad( x[k], &src[k * line + j] );
+    }
+
+    if( N == 4 && useDST )
+    {
+      xDst4( x, y, g_as_DST_MAT_4[dir], isInverse );
+    }
+    else if( isInverse )
+    {
+      xInvButterfly( x, y, mat, N, 1, TrSize<N>() );
+    }
+    else
+    {
+      xFwdButterfly( x, y, mat, N, 1, TrSize<N>() );
+    }
+
+    for( Int k = 0; k < N; k++ )
+    {
+      const V res = xTrRound( y[k], add, shift );
+      xTrStore( &dst[k * line + j], isInverse ? xTrClip( res, outputMinimum, outputMaximum ) : res );
+    }
+  }
+}
+
+template<Bool isInverse>
+static inline Void xTrStage( const TCoeff *src, TCoeff *dst, const Int N, const Int line, const Int shift, const Bool useDST, const TCoeff outputMinimum = 0, const TCoeff outputMaximum = 0 )
+{
+#ifdef USE_AVX2
+  if( line >= 8 )
+  {
+    switch( N )
+    {
+      case  4: xTrStage<__m256i,  4, isInverse>( src, dst, line, shift, useDST, outputMinimum, outputMaximum ); break;
+      case  8: xTrStage<__m256i,  8, isInverse>( src, dst, line, shift, false,  outputMinimum, outputMaximum ); break;
+      case 16: xTrStage<__m256i, 16, isInverse>( src, dst, line, shift, false,  outputMinimum, outputMaximum ); break;
+      case 32: xTrStage<__m256i, 32, isInverse>( src, dst, line, shift, false,  outputMinimum, outputMaximum ); break;
+      default: assert( 0 ); break;
+    }
+    return;
+  }
+#endif
+  switch( N )
+  {
+    case  4: xTrStage<__m128i,  4, isInverse>( src, dst, line, shift, useDST, outputMinimum, outputMaximum ); break;
+    case  8: xTrStage<__m128i,  8, isInverse>( src, dst, line, shift, false,  outputMinimum, outputMaximum ); break;
+    case 16: xTrStage<__m128i, 16, isInverse>( src, dst, line, shift, false,  outputMinimum, outputMaximum ); break;
+    case 32: xTrStage<__m128i, 32, isInverse>( src, dst, line, shift, false,  outputMinimum, outputMaximum ); break;
+    default: assert( 0 ); break;
+  }
+}
+
+// ====================================================================================================================
+// 2D transforms
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TComTrQuant::xTrMxN_SIMD( Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange )
+{
+  const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_FORWARD];
+
+  const Int shift_1st = ((g_aucConvertToBit[iWidth] + 2) +  bitDepth + TRANSFORM_MATRIX_SHIFT) - maxLog2TrDynamicRange;
+  const Int shift_2nd = (g_aucConvertToBit[iHeight] + 2) + TRANSFORM_MATRIX_SHIFT;
+
+  assert(shift_1st >= 0);
+  assert(shift_2nd >= 0);
+
+  const Bool isDST = useDST && iWidth == 4 && iHeight == 4;
+
+  TCoeff tmp[ MAX_TU_SIZE * MAX_TU_SIZE ];
+  TCoeff tr [ MAX_TU_SIZE * MAX_TU_SIZE ];
+
+  // horizontal: the rows of block become the columns of tr
+  xTranspose( block, tr, iHeight, iWidth );
+  xTrStage<false>( tr, tmp, iWidth, iHeight, shift_1st, isDST );
+
+  // vertical
+  xTranspose( tmp, tr, iWidth, iHeight );
+  xTrStage<false>( tr, coeff, iHeight, iWidth, shift_2nd, isDST );
+}
+
+template<X86_VEXT vext>
+Void TComTrQuant::xITrMxN_SIMD( Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange )
+{
+  const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_INVERSE];
+
+  const Int shift_1st = TRANSFORM_MATRIX_SHIFT + 1; //1 has been added to shift_1st at the expense of shift_2nd
+  const Int shift_2nd = (TRANSFORM_MATRIX_SHIFT + maxLog2TrDynamicRange - 1) - bitDepth;
+  const TCoeff clipMinimum = -(1 << maxLog2TrDynamicRange);
+  const TCoeff clipMaximum =  (1 << maxLog2TrDynamicRange) - 1;
+
+  assert(shift_1st >= 0);
+  assert(shift_2nd >= 0);
+
+  const Bool isDST = useDST && iWidth == 4 && iHeight == 4;
+
+  TCoeff tmp[ MAX_TU_SIZE * MAX_TU_SIZE ];
+  TCoeff tr [ MAX_TU_SIZE * MAX_TU_SIZE ];
+
+  // vertical: the columns of coeff are already contiguous across lines
+  xTrStage<true>( coeff, tmp, iHeight, iWidth, shift_1st, isDST, clipMinimum, clipMaximum );
+
+  // horizontal, clipped to the range of Pel
+  xTranspose( tmp, tr, iHeight, iWidth );
+  xTrStage<true>( tr, tmp, iWidth, iHeight, shift_2nd, isDST, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max() );
+  xTranspose( tmp, block, iWidth, iHeight );
+}
+
+#endif // ENABLE_SIMD_OPT_TRANSFORM
+
+#if ENABLE_SIMD_OPT_QUANT
+// ====================================================================================================================
+// Quantisation
+// ====================================================================================================================
+
+/// sum of the four 32-bit lanes, in lane 0
+static inline __m128i xHorizontalSumTr( const __m128i &v )
+{
+  const __m128i sum = _mm_add_epi32( v, _mm_shuffle_epi32( v, 0x4e ) );
+  return _mm_add_epi32( sum, _mm_shuffle_epi32( sum, 0xb1 ) );
+}
+
+/// low 32 bits of the 64-bit lanes of even and odd, interleaved back into the order of the 32-bit lanes
+static inline __m128i xPackLo64( const __m128i &even, const __m128i &odd )
+{
+  return _mm_blend_epi16( even, _mm_slli_epi64( odd, 32 ), 0xCC );
+}
+
+#ifdef USE_AVX2
+static inline __m256i xPackLo64( const __m256i &even, const __m256i &odd )
+{
+  return _mm256_blend_epi16( even, _mm256_slli_epi64( odd, 32 ), 0xCC );
+}
+#endif
+
+template<X86_VEXT vext>
+Void TComTrQuant::xQuantCore_SIMD( const TCoeff *piCoef, TCoeff *piQCoef, TCoeff *piArlCCoef, TCoeff *deltaU, TCoeff &uiAbsSum, const Int *piQuantCoeff, const Int defaultQuantisationCoefficient,
+                                   const Int numSamples, const Int iQBits, const Int iAdd, const Int iQBitsC, const Int iAddC, const TCoeff entropyCodingMinimum, const TCoeff entropyCodingMaximum )
+{
+  const __m128i vQBits  = _mm_cvtsi32_si128( iQBits );
+  const __m128i vQBits8 = _mm_cvtsi32_si128( iQBits - 8 );
+  const __m128i vQBitsC = _mm_cvtsi32_si128( iQBitsC );
+  Int n = 0;
+
+#ifdef USE_AVX2
+  {
+    const __m256i vAdd   = _mm256_set1_epi64x( iAdd );
+    const __m256i vAddC  = _mm256_set1_epi64x( iAddC );
+    const __m256i vScale = _mm256_set1_epi32( defaultQuantisationCoefficient );
+    const __m256i vMin   = _mm256_set1_epi32( entropyCodingMinimum );
+    const __m256i vMax   = _mm256_set1_epi32( entropyCodingMaximum );
+    __m256i       vSum   = _mm256_setzero_si256();
+
+    for( ; n + 8 <= numSamples; n += 8 )
+    {
+      const __m256i vLevel = _mm256_loadu_si256( ( const __m256i* ) &piCoef[n] );
+      const __m256i vAbs   = _mm256_abs_epi32( vLevel );
+      const __m256i vQ     = ( piQuantCoeff != NULL ) ? _mm256_loadu_si256( ( const __m256i* ) &piQuantCoeff[n] ) : vScale;
+      const __m256i vTmpE  = _mm256_mul_epu32( vAbs, vQ );
+      const __m256i vTmpO  = _mm256_mul_epu32( _mm256_srli_epi64( vAbs, 32 ), _mm256_srli_epi64( vQ, 32 ) );
+
+      if( piArlCCoef != NULL )
+      {
+        _mm256_storeu_si256( ( __m256i* ) &piArlCCoef[n], xPackLo64( _mm256_srl_epi64( _mm256_add_epi64( vTmpE, vAddC ), vQBitsC ),
+                                                                     _mm256_srl_epi64( _mm256_add_epi64( vTmpO, vAddC ), vQBitsC ) ) );
+      }
+
+      const __m256i vMag   = xPackLo64( _mm256_srl_epi64( _mm256_add_epi64( vTmpE, vAdd ), vQBits ),
+                                        _mm256_srl_epi64( _mm256_add_epi64( vTmpO, vAdd ), vQBits ) );
+
+      // deltaU = ( tmpLevel - ( magnitude << iQBits ) ) >> qBits8, the shift of the magnitude being done on 32 bits as in the C code
+      const __m256i vRec   = _mm256_sll_epi32( vMag, vQBits );
+      const __m256i vRecE  = _mm256_cvtepi32_epi64( _mm256_castsi256_si128( _mm256_permute4x64_epi64( _mm256_shuffle_epi32( vRec, 0x08 ), 0x08 ) ) );
+      const __m256i vRecO  = _mm256_cvtepi32_epi64( _mm256_castsi256_si128( _mm256_permute4x64_epi64( _mm256_shuffle_epi32( vRec, 0x0d ), 0x08 ) ) );
+      _mm256_storeu_si256( ( __m256i* ) &deltaU[n], xPackLo64( _mm256_srl_epi64( _mm256_sub_epi64( vTmpE, vRecE ), vQBits8 ),
+                                                               _mm256_srl_epi64( _mm256_sub_epi64( vTmpO, vRecO ), vQBits8 ) ) );
+
+      vSum = _mm256_add_epi32( vSum, vMag );
+      _mm256_storeu_si256( ( __m256i* ) &piQCoef[n], _mm256_min_epi32( _mm256_max_epi32( _mm256_sign_epi32( vMag, vLevel ), vMin ), vMax ) );
+    }
+
+    uiAbsSum += _mm_cvtsi128_si32( xHorizontalSumTr( _mm_add_epi32( _mm256_castsi256_si128( vSum ), _mm256_extracti128_si256( vSum, 1 ) ) ) );
+  }
+#endif
+
+  const __m128i vAdd   = _mm_set1_epi64x( iAdd );
+  const __m128i vAddC  = _mm_set1_epi64x( iAddC );
+  const __m128i vScale = _mm_set1_epi32( defaultQuantisationCoefficient );
+  const __m128i vMin   = _mm_set1_epi32( entropyCodingMinimum );
+  const __m128i vMax   = _mm_set1_epi32( entropyCodingMaximum );
+  __m128i       vSum   = _mm_setzero_si128();
+
+  for( ; n < numSamples; n += 4 )
+  {
+    const __m128i vLevel = _mm_loadu_si128( ( const __m128i* ) &piCoef[n] );
+    const __m128i vAbs   = _mm_abs_epi32( vLevel );
+    const __m128i vQ     = ( piQuantCoeff != NULL ) ? _mm_loadu_si128( ( const __m128i* ) &piQuantCoeff[n] ) : vScale;
+    const __m128i vTmpE  = _mm_mul_epu32( vAbs, vQ );
+    const __m128i vTmpO  = _mm_mul_epu32( _mm_srli_epi64( vAbs, 32 ), _mm_srli_epi64( vQ, 32 ) );
+
+    if( piArlCCoef != NULL )
+    {
+      _mm_storeu_si128( ( __m128i* ) &piArlCCoef[n], xPackLo64( _mm_srl_epi64( _mm_add_epi64( vTmpE, vAddC ), vQBitsC ),
+                                                                _mm_srl_epi64( _mm_add_epi64( vTmpO, vAddC ), vQBitsC ) ) );
+    }
+
+    const __m128i vMag   = xPackLo64( _mm_srl_epi64( _mm_add_epi64( vTmpE, vAdd ), vQBits ),
+                                      _mm_srl_epi64( _mm_add_epi64( vTmpO, vAdd ), vQBits ) );
+
+    const __m128i vRec   = _mm_sll_epi32( vMag, vQBits );
+    const __m128i vRecE  = _mm_cvtepi32_epi64( _mm_shuffle_epi32( vRec, 0x08 ) );
+    const __m128i vRecO  = _mm_cvtepi32_epi64( _mm_shuffle_epi32( vRec, 0x0d ) );
+    _mm_storeu_si128( ( __m128i* ) &deltaU[n], xPackLo64( _mm_srl_epi64( _mm_sub_epi64( vTmpE, vRecE ), vQBits8 ),
+                                                          _mm_srl_epi64( _mm_sub_epi64( vTmpO, vRecO ), vQBits8 ) ) );
+
+    vSum = _mm_add_epi32( vSum, vMag );
+    _mm_storeu_si128( ( __m128i* ) &piQCoef[n], _mm_min_epi32( _mm_max_epi32( _mm_sign_epi32( vMag, vLevel ), vMin ), vMax ) );
+  }
+
+  uiAbsSum += _mm_cvtsi128_si32( xHorizontalSumTr( vSum ) );
+}
+
+template<X86_VEXT vext>
+Void TComTrQuant::xDeQuantCore_SIMD( const TCoeff *piQCoef, TCoeff *piCoef, const Int *piDequantCoef, const Int scale, const Int numSamplesInBlock, const Int rightShift,
+                                     const Intermediate_Int inputMinimum, const Intermediate_Int inputMaximum, const TCoeff transformMinimum, const TCoeff transformMaximum )
+{
+  const Int     iAdd   = ( rightShift > 0 ) ? ( 1 << ( rightShift - 1 ) ) : 0;
+  const __m128i vShift = _mm_cvtsi32_si128( ( rightShift > 0 ) ? rightShift : -rightShift );
+  Int n = 0;
+
+#ifdef USE_AVX2
+  {
+    const __m256i vInMin  = _mm256_set1_epi32( inputMinimum );
+    const __m256i vInMax  = _mm256_set1_epi32( inputMaximum );
+    const __m256i vOutMin = _mm256_set1_epi32( transformMinimum );
+    const __m256i vOutMax = _mm256_set1_epi32( transformMaximum );
+    const __m256i vScale  = _mm256_set1_epi32( scale );
+    const __m256i vAdd    = _mm256_set1_epi32( iAdd );
+
+    for( ; n + 8 <= numSamplesInBlock; n += 8 )
+    {
+      const __m256i vClip  = _mm256_min_epi32( _mm256_max_epi32( _mm256_loadu_si256( ( const __m256i* ) &piQCoef[n] ), vInMin ), vInMax );
+      const __m256i vScl   = ( piDequantCoef != NULL ) ? _mm256_loadu_si256( ( const __m256i* ) &piDequantCoef[n] ) : vScale;
+      const __m256i vProd  = _mm256_mullo_epi32( vClip, vScl );
+      const __m256i vCoeff = ( rightShift > 0 ) ? _mm256_sra_epi32( _mm256_add_epi32( vProd, vAdd ), vShift ) : _mm256_sll_epi32( vProd, vShift );
+      _mm256_storeu_si256( ( __m256i* ) &piCoef[n], _mm256_min_epi32( _mm256_max_epi32( vCoeff, vOutMin ), vOutMax ) );
+    }
+  }
+#endif
+
+  const __m128i vInMin  = _mm_set1_epi32( inputMinimum );
+  const __m128i vInMax  = _mm_set1_epi32( inputMaximum );
+  const __m128i vOutMin = _mm_set1_epi32( transformMinimum );
+  const __m128i vOutMax = _mm_set1_epi32( transformMaximum );
+  const __m128i vScale  = _mm_set1_epi32( scale );
+  const __m128i vAdd    = _mm_set1_epi32( iAdd );
+
+  for( ; n < numSamplesInBlock; n += 4 )
+  {
+    const __m128i vClip  = _mm_min_epi32( _mm_max_epi32( _mm_loadu_si128( ( const __m128i* ) &piQCoef[n] ), vInMin ), vInMax );
+    const __m128i vScl   = ( piDequantCoef != NULL ) ? _mm_loadu_si128( ( const __m128i* ) &piDequantCoef[n] ) : vScale;
+    const __m128i vProd  = _mm_mullo_epi32( vClip, vScl );
+    const __m128i vCoeff = ( rightShift > 0 ) ? _mm_sra_epi32( _mm_add_epi32( vProd, vAdd ), vShift ) : _mm_sll_epi32( vProd, vShift );
+    _mm_storeu_si128( ( __m128i* ) &piCoef[n], _mm_min_epi32( _mm_max_epi32( vCoeff, vOutMin ), vOutMax ) );
+  }
+}
+#endif // ENABLE_SIMD_OPT_QUANT
+
+// ====================================================================================================================
+// Registration
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TComTrQuant::xInitTrQuantX86()
+{
+#if ENABLE_SIMD_OPT_TRANSFORM
+  m_fpTrMxN   = xTrMxN_SIMD<vext>;
+  m_fpITrMxN  = xITrMxN_SIMD<vext>;
+#endif
+#if ENABLE_SIMD_OPT_QUANT
+  m_fpQuant   = xQuantCore_SIMD<vext>;
+  m_fpDeQuant = xDeQuantCore_SIMD<vext>;
+#endif
+}
+
+template Void TComTrQuant::xInitTrQuantX86<SIMDX86>();
+
+//! \}
+
+#endif // SIMDX86
+#endif // ENABLE_SIMD_OPT_TRANSFORM || ENABLE_SIMD_OPT_QUANT
@@ -40,6 +40,9 @@
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
 #include "TLibCommon/TComCodingStatistics.h"
 #endif
+#if FAST_CABAC_DECODER && defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 //! \ingroup TLibDecoder
 //! \{
@@ -65,6 +68,335 @@ TDecBinCABAC::uninit()
   m_pcTComBitstream = 0;
 }
 
+#if FAST_CABAC_DECODER
+static inline Int xNumLeadingZeros( UInt x )
+{
+#if defined(__GNUC__)
+  return __builtin_clz( x );
+#elif defined(_MSC_VER)
+  unsigned long idx;
+  _BitScanReverse( &idx, x );
+  return 31 - Int( idx );
+#else
+  Int n = 0;
+  while( !( x & 0x80000000 ) )
+  {
+    x <<= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+static inline UInt64 xReadBigEndian64( const UChar *p )
+{
+  UInt64 word = 0;
+  for( Int i = 0; i < 8; i++ )
+  {
+    word = ( word << 8 ) | p[i];
+  }
+  return word;
+}
+
+Void
+TDecBinCABAC::start()
+{
+  assert( m_pcTComBitstream->getNumBitsUntilByteAligned() == 0 );
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(STATS__CABAC_INITIALISATION, 512, 510, 0);
+#endif
+  std::vector<uint8_t> &fifo = m_pcTComBitstream->getFifo();
+  m_pucFifo  = fifo.empty() ? NULL : &fifo[0];
+  m_fifoSize = UInt( fifo.size() );
+  m_fifoIdx  = m_pcTComBitstream->getByteLocation();
+  assert( m_fifoIdx + 2 <= m_fifoSize );
+
+  m_uiRange       = 510;
+  m_uiValue       = 0;
+  m_bitsAvailable = -9;
+  xRefill();
+}
+
+Void
+TDecBinCABAC::finish()
+{
+  UInt lastByte;
+
+  m_pcTComBitstream->peekPreviousByte( lastByte );
+  // Check for proper stop/alignment pattern
+  assert( ((lastByte << (7 - (m_bitsAvailable & 7))) & 0xff) == 0x80 );
+}
+
+/**
+ - Copy CABAC state.
+ .
+ \param pcTDecBinIf The source CABAC engine.
+ */
+Void
+TDecBinCABAC::copyState( const TDecBinIf* pcTDecBinIf )
+{
+  const TDecBinCABAC* pcTDecBinCABAC = pcTDecBinIf->getTDecBinCABAC();
+  m_uiRange      = pcTDecBinCABAC->m_uiRange;
+  m_uiValue      = pcTDecBinCABAC->m_uiValue;
+  m_bitsAvailable= pcTDecBinCABAC->m_bitsAvailable;
+  m_pucFifo      = pcTDecBinCABAC->m_pucFifo;
+  m_fifoSize     = pcTDecBinCABAC->m_fifoSize;
+  m_fifoIdx      = pcTDecBinCABAC->m_fifoIdx;
+}
+
+/** Load as many whole bytes from the substream FIFO as fit below the look-ahead bits.
+ * Bytes past the end of the substream are loaded as zeros; a conforming substream terminates before they reach the offset.
+ */
+Void
+TDecBinCABAC::xRefill()
+{
+  const Int numBytes = ( 54 - m_bitsAvailable ) >> 3;
+
+  if( m_fifoIdx + 8 <= m_fifoSize )
+  {
+    const UInt64 word = xReadBigEndian64( m_pucFifo + m_fifoIdx );
+    m_uiValue |= ( word >> ( 64 - 8 * numBytes ) ) << ( 54 - m_bitsAvailable - 8 * numBytes );
+  }
+  else
+  {
+    for( Int i = 0; i < numBytes; i++ )
+    {
+      const UInt64 byte = ( m_fifoIdx + i < m_fifoSize ) ? m_pucFifo[ m_fifoIdx + i ] : 0;
+      m_uiValue |= byte << ( 46 - m_bitsAvailable - 8 * i );
+    }
+  }
+
+  m_fifoIdx       += numBytes;
+  m_bitsAvailable += 8 * numBytes;
+  m_pcTComBitstream->setByteLocation( std::min( m_fifoIdx, m_fifoSize ) );
+}
+
+/** Move the substream read position back to the byte the offset has reached, i.e. give back whole look-ahead bytes.
+ * Required before the substream is read directly (PCM samples, trailing bits).
+ */
+Void
+TDecBinCABAC::xSyncBitstream()
+{
+  m_pcTComBitstream->setByteLocation( m_fifoIdx - ( m_bitsAvailable >> 3 ) );
+}
+
+
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
+#endif
+{
+#if DEBUG_CABAC_BINS
+  const UInt startingRange = m_uiRange;
+#endif
+
+  if( m_bitsAvailable < 8 )
+  {
+    xRefill();
+  }
+
+  const UInt   uiState     = rcCtxModel.getPackedState();
+  const UInt   uiLPS       = TComCABACTables::sm_aucLPSTable[ uiState >> 1 ][ ( m_uiRange >> 6 ) & 3 ];
+  const UInt   uiMPSRange  = m_uiRange - uiLPS;
+  const UInt64 scaledRange = UInt64( uiMPSRange ) << 54;
+  const UInt   isLPS       = ( m_uiValue >= scaledRange ) ? 1 : 0;
+
+  m_uiValue -= scaledRange & ( UInt64( 0 ) - isLPS );
+  m_uiRange  = isLPS ? uiLPS : uiMPSRange;
+  ruiBin     = ( uiState & 1 ) ^ isLPS;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(whichStat, uiMPSRange+uiLPS, m_uiRange, Int(ruiBin));
+#endif
+  rcCtxModel.updateState( isLPS != 0 );
+
+  const Int numBits = xNumLeadingZeros( m_uiRange ) - 23;
+  m_uiRange       <<= numBits;
+  m_uiValue       <<= numBits;
+  m_bitsAvailable  -= numBits;
+
+#if DEBUG_CABAC_BINS
+  if ((g_debugCounter + debugCabacBinWindow) >= debugCabacBinTargetLine)
+  {
+    std::cout << g_debugCounter << ": coding bin value " << ruiBin << ", range = [" << startingRange << "->" << m_uiRange << "]\n";
+  }
+
+  if (g_debugCounter >= debugCabacBinTargetLine)
+  {
+    UChar breakPointThis;
+    breakPointThis = 7;
+  }
+  if (g_debugCounter >= (debugCabacBinTargetLine + debugCabacBinWindow))
+  {
+    exit(0);
+  }
+  g_debugCounter++;
+#endif
+}
+
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBinEP( UInt& ruiBin, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBinEP( UInt& ruiBin )
+#endif
+{
+  if (m_uiRange == 256)
+  {
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    decodeAlignedBinsEP(ruiBin, 1, whichStat);
+#else
+    decodeAlignedBinsEP(ruiBin, 1);
+#endif
+    return;
+  }
+
+  if( m_bitsAvailable < 8 )
+  {
+    xRefill();
+  }
+
+  m_uiValue += m_uiValue;
+  m_bitsAvailable--;
+
+  const UInt64 scaledRange = UInt64( m_uiRange ) << 54;
+  ruiBin     = ( m_uiValue >= scaledRange ) ? 1 : 0;
+  m_uiValue -= scaledRange & ( UInt64( 0 ) - ruiBin );
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, 1, Int(ruiBin));
+#endif
+}
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
+#endif
+{
+  if (m_uiRange == 256)
+  {
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    decodeAlignedBinsEP(ruiBin, numBins, whichStat);
+#else
+    decodeAlignedBinsEP(ruiBin, numBins);
+#endif
+    return;
+  }
+
+  UInt bins = 0;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  Int origNumBins=numBins;
+#endif
+  const UInt64 scaledRange = UInt64( m_uiRange ) << 54;
+  while ( numBins > 0 )
+  {
+    if( m_bitsAvailable < 8 )
+    {
+      xRefill();
+    }
+
+    // every look-ahead bit can be consumed before the next refill
+    const Int numChunkBins = std::min( numBins, m_bitsAvailable );
+    for ( Int i = 0; i < numChunkBins; i++ )
+    {
+      m_uiValue += m_uiValue;
+      const UInt bin = ( m_uiValue >= scaledRange ) ? 1 : 0;
+      m_uiValue -= scaledRange & ( UInt64( 0 ) - bin );
+      bins = ( bins << 1 ) | bin;
+    }
+    m_bitsAvailable -= numChunkBins;
+    numBins         -= numChunkBins;
+  }
+
+  ruiBin = bins;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, origNumBins, Int(ruiBin));
+#endif
+}
+
+Void TDecBinCABAC::align()
+{
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(STATS__CABAC_EP_BIT_ALIGNMENT, m_uiRange, 256, 0);
+#endif
+  m_uiRange = 256;
+}
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeAlignedBinsEP( UInt& ruiBins, Int numBins, const class TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeAlignedBinsEP( UInt& ruiBins, Int numBins )
+#endif
+{
+  Int binsRemaining = numBins;
+  ruiBins = 0;
+
+  assert(m_uiRange == 256); //aligned decode only works when range = 256
+
+  while (binsRemaining > 0)
+  {
+    if( m_bitsAvailable < 8 )
+    {
+      xRefill();
+    }
+
+    const UInt binsToRead = std::min<UInt>(binsRemaining, 8);
+    const UInt binMask    = (1 << binsToRead) - 1;
+
+    //As in the byte-wise engine, the MSB of the offset (bit 62) is known to be 0 because range is 256,
+    //so the required bins are simply the <binsToRead> bits below it, and "subtracting" the symbol range
+    //for a 1 bin amounts to clearing them.
+    const UInt newBins = UInt(m_uiValue >> (62 - binsToRead)) & binMask;
+
+    ruiBins   = (ruiBins   << binsToRead) | newBins;
+    m_uiValue = (m_uiValue << binsToRead) & ((UInt64(1) << 62) - 1);
+
+    binsRemaining   -= binsToRead;
+    m_bitsAvailable -= binsToRead;
+  }
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, numBins, Int(ruiBins));
+#endif
+}
+
+Void
+TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
+{
+  if( m_bitsAvailable < 8 )
+  {
+    xRefill();
+  }
+
+  m_uiRange -= 2;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << 54;
+  if( m_uiValue >= scaledRange )
+  {
+    ruiBin = 1;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, 2, ruiBin);
+    TComCodingStatistics::IncrementStatisticEP(STATS__BYTE_ALIGNMENT_BITS, (m_bitsAvailable & 7) + 1, 0);
+#endif
+    // PCM samples or the end of the substream follow: hand the byte position back to the bitstream
+    xSyncBitstream();
+  }
+  else
+  {
+    ruiBin = 0;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, m_uiRange, ruiBin);
+#endif
+    if ( m_uiRange < 256 )
+    {
+      m_uiRange += m_uiRange;
+      m_uiValue += m_uiValue;
+      m_bitsAvailable--;
+    }
+  }
+}
+
+#else
 Void
 TDecBinCABAC::start()
 {
@@ -367,6 +699,8 @@ TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
   }
 }
 
+#endif
+
 /** Read a PCM code.
  * \param uiLength code bit-depth
  * \param ruiCode pointer to PCM code value
@@ -79,10 +79,23 @@ public:
   const TDecBinCABAC* getTDecBinCABAC() const { return this; }
 
 private:
+#if FAST_CABAC_DECODER
+  Void  xRefill           ();
+  Void  xSyncBitstream    ();
+
+  TComInputBitstream* m_pcTComBitstream;
+  UInt                m_uiRange;
+  UInt64              m_uiValue;        ///< 9-bit offset in bits 62..54, followed by m_bitsAvailable look-ahead bits
+  Int                 m_bitsAvailable;  ///< number of look-ahead bits below the offset
+  const UChar*        m_pucFifo;        ///< byte FIFO of the current substream
+  UInt                m_fifoSize;
+  UInt                m_fifoIdx;        ///< next byte to load into the window (may run past m_fifoSize, zeros are loaded there)
+#else
   TComInputBitstream* m_pcTComBitstream;
   UInt                m_uiRange;
   UInt                m_uiValue;
   Int                 m_bitsNeeded;
+#endif
 };
 
 //! \}
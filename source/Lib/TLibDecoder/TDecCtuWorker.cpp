@@ -0,0 +1,86 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TDecCtuWorker.cpp
+    \brief    set of CTU parsing and reconstruction tools owned by one worker thread
+*/
+
+#include "TDecCtuWorker.h"
+#include "TDecConformance.h"
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TDecCtuWorker::TDecCtuWorker()
+{
+  m_cSbacDecoder.init( &m_cBinCABAC );
+  m_cEntropyDecoder.setEntropyDecoder( &m_cSbacDecoder );
+}
+
+TDecCtuWorker::~TDecCtuWorker()
+{
+}
+
+/** The tools are set up in the same way as the main tools of the decoder.
+ * \param sps                   active SPS
+ * \param pDecConformanceCheck  conformance checker of the decoder
+ */
+Void TDecCtuWorker::create( const TComSPS &sps, TDecConformanceCheck* pDecConformanceCheck )
+{
+  m_cPrediction.initTempBuff( sps.getChromaFormatIdc() );
+#if MCTS_ENC_CHECK
+  m_cEntropyDecoder.init( &m_cPrediction, pDecConformanceCheck );
+#else
+  m_cEntropyDecoder.init( &m_cPrediction );
+#endif
+
+  m_cCuDecoder.create ( sps.getMaxTotalCUDepth(), sps.getMaxCUWidth(), sps.getMaxCUHeight(), sps.getChromaFormatIdc() );
+#if MCTS_ENC_CHECK
+  m_cCuDecoder.init   ( &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction, pDecConformanceCheck );
+#else
+  m_cCuDecoder.init   ( &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction );
+#endif
+  m_cTrQuant.init     ( sps.getMaxTrSize() );
+}
+
+Void TDecCtuWorker::destroy()
+{
+  m_cCuDecoder.destroy();
+}
+
+//! \}
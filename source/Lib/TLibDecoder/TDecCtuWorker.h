@@ -0,0 +1,87 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TDecCtuWorker.h
+    \brief    set of CTU parsing and reconstruction tools owned by one worker thread (header)
+*/
+
+#ifndef __TDECCTUWORKER__
+#define __TDECCTUWORKER__
+
+// Include files
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComPrediction.h"
+#include "TDecCu.h"
+#include "TDecEntropy.h"
+#include "TDecSbac.h"
+#include "TDecBinCoderCABAC.h"
+
+//! \ingroup TLibDecoder
+//! \{
+
+class TDecConformanceCheck;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the CTU parsing and reconstruction tools, so that several CTU rows can be decoded concurrently
+class TDecCtuWorker
+{
+private:
+  TDecCu                  m_cCuDecoder;                   ///< CU decoder
+  TComTrQuant             m_cTrQuant;                     ///< transform & quantization class
+  TComPrediction          m_cPrediction;                  ///< prediction class
+  TDecEntropy             m_cEntropyDecoder;              ///< entropy decoder
+  TDecSbac                m_cSbacDecoder;                 ///< SBAC decoder reading the substream of a CTU row
+  TDecBinCABAC            m_cBinCABAC;                    ///< bin decoder CABAC reading the substream of a CTU row
+
+public:
+  TDecCtuWorker();
+  virtual ~TDecCtuWorker();
+
+  /// create the buffers of the tools for the active SPS (see TDecTop::xActivateParameterSets)
+  Void  create              ( const TComSPS &sps, TDecConformanceCheck* pDecConformanceCheck );
+  Void  destroy             ();
+
+  TDecCu*                 getCuDecoder          () { return &m_cCuDecoder;        }
+  TComTrQuant*            getTrQuant            () { return &m_cTrQuant;          }
+  TDecEntropy*            getEntropyDecoder     () { return &m_cEntropyDecoder;   }
+  TDecSbac*               getSbacDecoder        () { return &m_cSbacDecoder;      }
+};
+
+//! \}
+
+#endif // __TDECCTUWORKER__
@@ -142,13 +142,26 @@ Void TDecGop::filterPicture(TComPic* pcPic)
   // deblocking filter
   Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
   m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
-  m_pcLoopFilter->loopFilterPic( pcPic );
-
-  if( pcSlice->getSPS()->getUseSAO() )
+  if( m_pcSliceDecoder->getCtuRowLoopFilterEnabled() )
+  {
+    // the slice decoder filters each CTU row once the row below has been reconstructed: filter the rows left, e.g. all
+    // of them when the picture has several tiles
+    m_pcSliceDecoder->finishCtuRowLoopFilter( pcPic );
+    if( pcSlice->getSPS()->getUseSAO() )
+    {
+      m_pcSAO->PCMLFDisableProcess(pcPic);
+    }
+  }
+  else
   {
-    m_pcSAO->reconstructBlkSAOParams(pcPic, pcPic->getPicSym()->getSAOBlkParam());
-    m_pcSAO->SAOProcess(pcPic);
-    m_pcSAO->PCMLFDisableProcess(pcPic);
+    m_pcLoopFilter->loopFilterPic( pcPic );
+
+    if( pcSlice->getSPS()->getUseSAO() )
+    {
+      m_pcSAO->reconstructBlkSAOParams(pcPic, pcPic->getPicSym()->getSAOBlkParam());
+      m_pcSAO->SAOProcess(pcPic);
+      m_pcSAO->PCMLFDisableProcess(pcPic);
+    }
   }
 
   pcPic->compressMotion();
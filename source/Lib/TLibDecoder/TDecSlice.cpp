@@ -46,6 +46,11 @@
 //////////////////////////////////////////////////////////////////////
 
 TDecSlice::TDecSlice()
+ : m_pcThreadPool(NULL)
+ , m_pcLoopFilter(NULL)
+ , m_pcSAO(NULL)
+ , m_ctuRowLoopFilterEnabled(false)
+ , m_numFilteredCtuRows(0)
 {
 }
 
@@ -59,13 +64,26 @@ Void TDecSlice::create()
 
 Void TDecSlice::destroy()
 {
+  for (UInt rowIdx = 0; rowIdx < m_parallelCtuRowSyncStates.size(); rowIdx++)
+  {
+    delete m_parallelCtuRowSyncStates[rowIdx];
+  }
+  m_parallelCtuRowSyncStates.clear();
 }
 
-Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder, TDecConformanceCheck *pDecConformanceCheck)
+Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder, TDecConformanceCheck *pDecConformanceCheck, TComLoopFilter* pcLoopFilter, TComSampleAdaptiveOffset* pcSAO)
 {
   m_pcEntropyDecoder     = pcEntropyDecoder;
   m_pcCuDecoder          = pcCuDecoder;
   m_pDecConformanceCheck = pDecConformanceCheck;
+  m_pcLoopFilter         = pcLoopFilter;
+  m_pcSAO                = pcSAO;
+}
+
+Void TDecSlice::setCtuWorkers( TComThreadPool* pcThreadPool, const std::vector<TDecCtuWorker*> &ctuWorkers )
+{
+  m_pcThreadPool = pcThreadPool;
+  m_ctuWorkers   = ctuWorkers;
 }
 
 Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcPic, TDecSbac* pcSbacDecoder)
@@ -80,14 +98,25 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
   const Bool depSliceSegmentsEnabled = pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag();
   const Bool wavefrontsEnabled       = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
 
-  m_pcEntropyDecoder->setEntropyDecoder ( pcSbacDecoder  );
-  m_pcEntropyDecoder->setBitstream      ( ppcSubstreams[0] );
-  m_pcEntropyDecoder->resetEntropy      (pcSlice);
-
   // decoder doesn't need prediction & residual frame buffer
   pcPic->setPicYuvPred( 0 );
   pcPic->setPicYuvResi( 0 );
 
+  if (startCtuTsAddr == 0)
+  {
+    m_numFilteredCtuRows = 0;
+  }
+
+  if (xUseParallelCtuRows(pcPic, pcSlice))
+  {
+    xDecompressSliceParallel(ppcSubstreams, pcPic);
+    return;
+  }
+
+  m_pcEntropyDecoder->setEntropyDecoder ( pcSbacDecoder  );
+  m_pcEntropyDecoder->setBitstream      ( ppcSubstreams[0] );
+  m_pcEntropyDecoder->resetEntropy      (pcSlice);
+
 #if ENC_DEC_TRACE
   g_bJustDoIt = g_bEncDecTraceEnable;
 #endif
@@ -104,7 +133,6 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
   // This calculates the common offset for all substreams in this slice.
   const UInt subStreamOffset=pcPic->getSubstreamForCtuAddr(startCtuRsAddr, true, pcSlice);
 
-
   if (depSliceSegmentsEnabled)
   {
     // modify initial contexts with previous slice segment if this is a dependent slice.
@@ -121,6 +149,20 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
     }
   }
 
+  // the CTUs are parsed by this thread, and each CTU row is reconstructed by a worker thread once it has been parsed
+  const Bool pipelinedReconstruction = xUsePipelinedReconstruction(pcPic);
+  const Bool ctuRowLoopFilter        = xUseCtuRowLoopFilter(pcPic);
+  if (pipelinedReconstruction)
+  {
+    const UInt startCtuYPosInCtus = startCtuRsAddr / frameWidthInCtus;
+    m_reconstructedCtuRowProgress.init( pcPic->getPicSym()->getFrameHeightInCtus() );
+    for (UInt ctuYPosInCtus = 0; ctuYPosInCtus < startCtuYPosInCtus; ctuYPosInCtus++)
+    {
+      m_reconstructedCtuRowProgress.setProgress( ctuYPosInCtus, frameWidthInCtus );
+    }
+    m_reconstructedCtuRowProgress.setProgress( startCtuYPosInCtus, startCtuRsAddr % frameWidthInCtus );
+  }
+
   // for every CTU in the slice segment...
 
   Bool isLastCtuOfSliceSegment = false;
@@ -176,39 +218,7 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
 
     if ( pcSlice->getSPS()->getUseSAO() )
     {
-      SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
-      Bool bIsSAOSliceEnabled = false;
-      Bool sliceEnabled[MAX_NUM_COMPONENT];
-      for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
-      {
-        ComponentID compId=ComponentID(comp);
-        sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
-        if (sliceEnabled[compId])
-        {
-          bIsSAOSliceEnabled=true;
-        }
-        saoblkParam[compId].modeIdc = SAO_MODE_OFF;
-      }
-      if (bIsSAOSliceEnabled)
-      {
-        Bool leftMergeAvail = false;
-        Bool aboveMergeAvail= false;
-
-        //merge left condition
-        Int rx = (ctuRsAddr % frameWidthInCtus);
-        if(rx > 0)
-        {
-          leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
-        }
-        //merge up condition
-        Int ry = (ctuRsAddr / frameWidthInCtus);
-        if(ry > 0)
-        {
-          aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
-        }
-
-        pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail, pcSlice->getSPS()->getBitDepths());
-      }
+      xParseSAOBlkParam( pcPic, pcSlice, ctuRsAddr, pcSbacDecoder );
     }
 
     m_pcCuDecoder->decodeCtu     ( pCtu, isLastCtuOfSliceSegment );
@@ -221,7 +231,31 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
     }
 #endif
 
-    m_pcCuDecoder->decompressCtu ( pCtu );
+    if (pipelinedReconstruction)
+    {
+      if (ctuXPosInCtus + 1 == frameWidthInCtus || isLastCtuOfSliceSegment)
+      {
+        const UInt rowStartCtuRsAddr = std::max<UInt>( ctuRsAddr - ctuXPosInCtus, startCtuRsAddr );
+        const UInt boundingCtuRsAddr = ctuRsAddr + 1;
+        m_pcThreadPool->addJob( [this, pcPic, rowStartCtuRsAddr, boundingCtuRsAddr]( Int threadIdx ) { xReconstructCtuRow( pcPic, rowStartCtuRsAddr, boundingCtuRsAddr, threadIdx ); } );
+      }
+      if (ctuRowLoopFilter && ctuXPosInCtus + 1 == frameWidthInCtus)
+      {
+        m_pcThreadPool->addJob( [this, pcPic, ctuYPosInCtus, frameWidthInCtus]( Int )
+        {
+          m_reconstructedCtuRowProgress.waitForProgress( ctuYPosInCtus, frameWidthInCtus );
+          xFilterCtuRows( pcPic, ctuYPosInCtus + 1 );
+        } );
+      }
+    }
+    else
+    {
+      m_pcCuDecoder->decompressCtu ( pCtu );
+      if (ctuRowLoopFilter && ctuXPosInCtus + 1 == frameWidthInCtus)
+      {
+        xFilterCtuRows( pcPic, ctuYPosInCtus + 1 );
+      }
+    }
 
 #if ENC_DEC_TRACE
     g_bJustDoIt = g_bEncDecTraceDisable;
@@ -262,6 +296,11 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
 
   assert(isLastCtuOfSliceSegment == true);
 
+  if (pipelinedReconstruction)
+  {
+    m_pcThreadPool->waitForJobs();
+  }
+
 
   if( depSliceSegmentsEnabled )
   {
@@ -270,4 +309,330 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
 
 }
 
+/** Parses the SAO parameters of a CTU.
+ * \param pcPic          picture being decoded
+ * \param pcSlice        slice holding the CTU
+ * \param ctuRsAddr      raster scan address of the CTU
+ * \param pcSbacDecoder  SBAC decoder reading the substream of the CTU
+ */
+Void TDecSlice::xParseSAOBlkParam( TComPic* pcPic, const TComSlice* pcSlice, UInt ctuRsAddr, TDecSbac* pcSbacDecoder )
+{
+  const UInt frameWidthInCtus = pcPic->getPicSym()->getFrameWidthInCtus();
+  SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
+  Bool bIsSAOSliceEnabled = false;
+  Bool sliceEnabled[MAX_NUM_COMPONENT];
+  for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
+  {
+    ComponentID compId=ComponentID(comp);
+    sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
+    if (sliceEnabled[compId])
+    {
+      bIsSAOSliceEnabled=true;
+    }
+    saoblkParam[compId].modeIdc = SAO_MODE_OFF;
+  }
+  if (bIsSAOSliceEnabled)
+  {
+    Bool leftMergeAvail = false;
+    Bool aboveMergeAvail= false;
+
+    //merge left condition
+    Int rx = (ctuRsAddr % frameWidthInCtus);
+    if(rx > 0)
+    {
+      leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
+    }
+    //merge up condition
+    Int ry = (ctuRsAddr / frameWidthInCtus);
+    if(ry > 0)
+    {
+      aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
+    }
+
+    pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail, pcSlice->getSPS()->getBitDepths());
+  }
+}
+
+/** Checks whether the CTU rows of the slice-segment can be decoded concurrently: one row per substream
+ *  of a wavefront slice-segment, in a picture with a single tile.
+ */
+Bool TDecSlice::xUseParallelCtuRows( TComPic* pcPic, TComSlice* pcSlice ) const
+{
+#if ENC_DEC_TRACE || RExt__DECODER_DEBUG_BIT_STATISTICS
+  return false;
+#else
+  if ( m_ctuWorkers.empty() || !pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() || pcSlice->getNumberOfSubstreamSizes() == 0 )
+  {
+    return false;
+  }
+  if ( pcPic->getPicSym()->getNumTiles() != 1 || TDecConformanceCheck::doChecking() )
+  {
+    return false;
+  }
+#if MCTS_ENC_CHECK
+  if ( m_pDecConformanceCheck && m_pDecConformanceCheck->getTMctsCheck() )
+  {
+    return false;
+  }
+#endif
+  return true;
+#endif
+}
+
+/** Checks whether the CTUs of the slice-segment can be reconstructed by worker threads while they are parsed.
+ *  The CTU rows are reconstructed in raster scan order, which requires a single tile.
+ */
+Bool TDecSlice::xUsePipelinedReconstruction( TComPic* pcPic ) const
+{
+#if ENC_DEC_TRACE || RExt__DECODER_DEBUG_BIT_STATISTICS
+  return false;
+#else
+  return !m_ctuWorkers.empty() && pcPic->getPicSym()->getNumTiles() == 1;
+#endif
+}
+
+/** Reconstructs a parsed CTU row, or the part of it in the current slice-segment, with the tools of a worker thread.
+ *  The reconstruction of a CTU waits for the CTU above-right to be reconstructed.
+ * \param pcPic              picture being decoded
+ * \param startCtuRsAddr     first CTU to reconstruct
+ * \param boundingCtuRsAddr  CTU following the last CTU to reconstruct, in the same row
+ * \param threadIdx          thread reconstructing the row
+ */
+Void TDecSlice::xReconstructCtuRow( TComPic* pcPic, UInt startCtuRsAddr, UInt boundingCtuRsAddr, Int threadIdx )
+{
+  TDecCu*    pcCuDecoder      = m_ctuWorkers[threadIdx]->getCuDecoder();
+  const UInt frameWidthInCtus = pcPic->getPicSym()->getFrameWidthInCtus();
+  const UInt ctuYPosInCtus    = startCtuRsAddr / frameWidthInCtus;
+
+  for (UInt ctuRsAddr = startCtuRsAddr; ctuRsAddr < boundingCtuRsAddr; ctuRsAddr++)
+  {
+    const UInt ctuXPosInCtus = ctuRsAddr % frameWidthInCtus;
+    if (ctuYPosInCtus > 0)
+    {
+      m_reconstructedCtuRowProgress.waitForProgress( ctuYPosInCtus - 1, std::min( ctuXPosInCtus + 2, frameWidthInCtus ) );
+    }
+    pcCuDecoder->decompressCtu( pcPic->getCtu( ctuRsAddr ) );
+    m_reconstructedCtuRowProgress.setProgress( ctuYPosInCtus, ctuXPosInCtus + 1 );
+  }
+  m_reconstructedCtuRowProgress.setProgress( ctuYPosInCtus, frameWidthInCtus );
+}
+
+/** Checks whether the CTU rows are filtered while the picture is decoded. The rows are completed in raster scan order,
+ *  which requires a single tile; otherwise, all the rows are filtered once the picture has been decoded.
+ */
+Bool TDecSlice::xUseCtuRowLoopFilter( TComPic* pcPic ) const
+{
+  return m_ctuRowLoopFilterEnabled && pcPic->getPicSym()->getNumTiles() == 1;
+}
+
+/** Deblocks, in top to bottom order, the CTU rows not deblocked yet whose row below has been reconstructed, and applies
+ *  SAO to the rows whose deblocking is complete. A row is not deblocked before the row below it has been reconstructed,
+ *  as the intra prediction of that row reads the unfiltered samples of its last line. The result is identical to the
+ *  picture-level filtering, see TComLoopFilter::loopFilterCtuRow and TComSampleAdaptiveOffset::SAOProcessCtuRow.
+ * \param pcPic                    picture being decoded
+ * \param numReconstructedCtuRows  number of CTU rows of the picture completely reconstructed
+ */
+Void TDecSlice::xFilterCtuRows( TComPic* pcPic, UInt numReconstructedCtuRows )
+{
+  std::lock_guard<std::mutex> lock( m_ctuRowLoopFilterMutex );
+
+  const UInt frameHeightInCtus = pcPic->getPicSym()->getFrameHeightInCtus();
+  const Bool useSAO            = pcPic->getSlice(0)->getSPS()->getUseSAO();
+  const UInt numCtuRowsToFilter = numReconstructedCtuRows == frameHeightInCtus ? frameHeightInCtus : std::max<Int>( Int(numReconstructedCtuRows) - 1, 0 );
+
+  m_pcLoopFilter->setCfg( pcPic->getSlice(0)->getPPS()->getLoopFilterAcrossTilesEnabledFlag() );
+  for ( ; m_numFilteredCtuRows < numCtuRowsToFilter; m_numFilteredCtuRows++)
+  {
+    const UInt ctuRowIdx = m_numFilteredCtuRows;
+    m_pcLoopFilter->loopFilterCtuRow( pcPic, ctuRowIdx );
+    if (useSAO)
+    {
+      m_pcSAO->reconstructBlkSAOParamsCtuRow( pcPic, pcPic->getPicSym()->getSAOBlkParam(), ctuRowIdx );
+      if (ctuRowIdx > 0)
+      {
+        m_pcSAO->SAOProcessCtuRow( pcPic, ctuRowIdx - 1 );
+      }
+      if (ctuRowIdx + 1 == frameHeightInCtus)
+      {
+        m_pcSAO->SAOProcessCtuRow( pcPic, ctuRowIdx );
+      }
+    }
+  }
+}
+
+Void TDecSlice::finishCtuRowLoopFilter( TComPic* pcPic )
+{
+  xFilterCtuRows( pcPic, pcPic->getPicSym()->getFrameHeightInCtus() );
+  m_numFilteredCtuRows = 0;
+}
+
+/** Decodes the CTU rows (one substream each) of a wavefront slice-segment concurrently.
+ *  The decoding of a CTU waits for the CTU above-right to be decoded, and each row starts from the contexts
+ *  stored after the second CTU of the row above, as in serial decoding.
+ * \param ppcSubstreams  substreams of the slice-segment
+ * \param pcPic          picture being decoded
+ */
+Void TDecSlice::xDecompressSliceParallel( TComInputBitstream** ppcSubstreams, TComPic* pcPic )
+{
+  TComSlice* pcSlice                 = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const UInt startCtuTsAddr          = pcSlice->getSliceSegmentCurStartCtuTsAddr();
+  const UInt numCtusInFrame          = pcPic->getNumberOfCtusInFrame();
+  const UInt frameWidthInCtus        = pcPic->getPicSym()->getFrameWidthInCtus();
+  const UInt numRows                 = pcSlice->getNumberOfSubstreamSizes() + 1;
+
+  // with a single tile, tile scan and raster scan orders are the same
+  m_parallelCtuRows.resize( numRows );
+  for (UInt rowIdx = 0; rowIdx < numRows; rowIdx++)
+  {
+    ParallelCtuRow &row = m_parallelCtuRows[rowIdx];
+    row.startCtuTsAddr          = rowIdx == 0 ? startCtuTsAddr : (startCtuTsAddr / frameWidthInCtus + rowIdx) * frameWidthInCtus;
+    row.boundingCtuTsAddr       = std::min( (startCtuTsAddr / frameWidthInCtus + rowIdx + 1) * frameWidthInCtus, numCtusInFrame );
+    row.storesSyncState         = false;
+    row.isLastCtuOfSliceSegment = false;
+    row.threadIdx               = 0;
+  }
+  while (m_parallelCtuRowSyncStates.size() < numRows)
+  {
+    m_parallelCtuRowSyncStates.push_back( new TDecSbac );
+  }
+  m_parallelCtuRowProgress.init( numRows );
+  m_parallelCtuRowProgress.setProgress( 0, startCtuTsAddr % frameWidthInCtus );
+
+  const Bool ctuRowLoopFilter = xUseCtuRowLoopFilter(pcPic);
+  for (UInt rowIdx = 0; rowIdx < numRows; rowIdx++)
+  {
+    m_pcThreadPool->addJob( [this, ppcSubstreams, pcPic, rowIdx]( Int threadIdx ) { xDecompressParallelCtuRow( ppcSubstreams, pcPic, rowIdx, threadIdx ); } );
+    if (ctuRowLoopFilter)
+    {
+      m_pcThreadPool->addJob( [this, pcPic, rowIdx, frameWidthInCtus]( Int )
+      {
+        m_parallelCtuRowProgress.waitForProgress( rowIdx, frameWidthInCtus );
+        // the slice-segment may end before the end of its last row
+        const UInt boundingCtuTsAddr = m_parallelCtuRows[rowIdx].boundingCtuTsAddr;
+        if (boundingCtuTsAddr % frameWidthInCtus == 0)
+        {
+          xFilterCtuRows( pcPic, boundingCtuTsAddr / frameWidthInCtus );
+        }
+      } );
+    }
+  }
+  m_pcThreadPool->waitForJobs();
+
+  // keep the states used by the following slice-segments
+  for (Int rowIdx = numRows - 1; rowIdx >= 0; rowIdx--)
+  {
+    if (m_parallelCtuRows[rowIdx].storesSyncState)
+    {
+      m_entropyCodingSyncContextState.loadContexts( m_parallelCtuRowSyncStates[rowIdx] );
+      break;
+    }
+  }
+
+  const ParallelCtuRow &lastRow = m_parallelCtuRows.back();
+  assert( lastRow.isLastCtuOfSliceSegment );
+  if(!pcSlice->getDependentSliceSegmentFlag())
+  {
+    pcSlice->setSliceCurEndCtuTsAddr( lastRow.boundingCtuTsAddr );
+  }
+  pcSlice->setSliceSegmentCurEndCtuTsAddr( lastRow.boundingCtuTsAddr );
+
+  if( pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    m_lastSliceSegmentEndContextState.loadContexts( m_ctuWorkers[lastRow.threadIdx]->getSbacDecoder() );//ctx end of dep.slice
+  }
+}
+
+/** Decodes a CTU row of a wavefront slice-segment with the tools of a worker thread.
+ * \param ppcSubstreams  substreams of the slice-segment
+ * \param pcPic          picture being decoded
+ * \param rowIdx         index of the row (and of its substream) in the slice-segment
+ * \param threadIdx      thread decoding the row
+ */
+Void TDecSlice::xDecompressParallelCtuRow( TComInputBitstream** ppcSubstreams, TComPic* pcPic, UInt rowIdx, Int threadIdx )
+{
+  TComSlice*        pcSlice          = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  TDecCtuWorker*    pcWorker         = m_ctuWorkers[threadIdx];
+  TDecEntropy*      pcEntropyDecoder = pcWorker->getEntropyDecoder();
+  TDecSbac*         pcSbacDecoder    = pcWorker->getSbacDecoder();
+  TDecCu*           pcCuDecoder      = pcWorker->getCuDecoder();
+  ParallelCtuRow   &row              = m_parallelCtuRows[rowIdx];
+  const UInt        frameWidthInCtus = pcPic->getPicSym()->getFrameWidthInCtus();
+
+  row.threadIdx = threadIdx;
+
+  pcEntropyDecoder->setBitstream( ppcSubstreams[rowIdx] );
+  pcEntropyDecoder->resetEntropy( pcSlice );
+
+  if (rowIdx == 0 && pcSlice->getDependentSliceSegmentFlag() && row.startCtuTsAddr != 0 && frameWidthInCtus >= 2)
+  {
+    // modify initial contexts with previous slice segment if this is a dependent slice.
+    pcSbacDecoder->loadContexts( &m_lastSliceSegmentEndContextState );
+  }
+
+  for( UInt ctuTsAddr = row.startCtuTsAddr; ctuTsAddr < row.boundingCtuTsAddr; ctuTsAddr++ )
+  {
+    const UInt ctuRsAddr     = ctuTsAddr;
+    const UInt ctuXPosInCtus = ctuRsAddr % frameWidthInCtus;
+    if (rowIdx > 0)
+    {
+      m_parallelCtuRowProgress.waitForProgress( rowIdx - 1, std::min( ctuXPosInCtus + 2, frameWidthInCtus ) );
+    }
+
+    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+    pCtu->initCtu( pcPic, ctuRsAddr );
+
+    if (ctuXPosInCtus == 0 && ctuRsAddr != 0)
+    {
+      // Synchronize cabac probabilities with upper-right CTU if it's available and at the start of a line.
+      if ( frameWidthInCtus > 1 && pCtu->CUIsFromSameSliceAndTile( pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 ) ) )
+      {
+        // Top-right is available: use the state stored by the row above, or by an earlier slice-segment.
+        const Bool aboveRowStoresSyncState = rowIdx > 0 && m_parallelCtuRows[rowIdx - 1].storesSyncState;
+        pcSbacDecoder->loadContexts( aboveRowStoresSyncState ? m_parallelCtuRowSyncStates[rowIdx - 1] : &m_entropyCodingSyncContextState );
+      }
+    }
+
+    if ( pcSlice->getSPS()->getUseSAO() )
+    {
+      xParseSAOBlkParam( pcPic, pcSlice, ctuRsAddr, pcSbacDecoder );
+    }
+
+    Bool isLastCtuOfSliceSegment = false;
+    pcCuDecoder->decodeCtu     ( pCtu, isLastCtuOfSliceSegment );
+    pcCuDecoder->decompressCtu ( pCtu );
+
+    //Store probabilities of second CTU in line into buffer
+    if ( ctuXPosInCtus == 1 )
+    {
+      m_parallelCtuRowSyncStates[rowIdx]->loadContexts( pcSbacDecoder );
+      row.storesSyncState = true;
+    }
+
+    if (isLastCtuOfSliceSegment)
+    {
+#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
+      pcSbacDecoder->parseRemainingBytes(false);
+#endif
+      row.isLastCtuOfSliceSegment = true;
+      row.boundingCtuTsAddr       = ctuTsAddr + 1;
+      m_parallelCtuRowProgress.setProgress( rowIdx, ctuXPosInCtus + 1 );
+      break;
+    }
+    else if ( ctuXPosInCtus + 1 == frameWidthInCtus )
+    {
+      // The sub-stream should be terminated after this CTU (end of wavefront-CTU-row).
+      UInt binVal;
+      pcSbacDecoder->parseTerminatingBit( binVal );
+      assert( binVal );
+#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
+      pcSbacDecoder->parseRemainingBytes(true);
+#endif
+    }
+    m_parallelCtuRowProgress.setProgress( rowIdx, ctuXPosInCtus + 1 );
+  }
+
+  // release the row below, even if the slice-segment ended early
+  m_parallelCtuRowProgress.setProgress( rowIdx, frameWidthInCtus );
+}
+
 //! \}
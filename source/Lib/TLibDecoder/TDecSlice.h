@@ -45,10 +45,14 @@
 #include "TLibCommon/CommonDef.h"
 #include "TLibCommon/TComBitStream.h"
 #include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComThreadPool.h"
+#include "TLibCommon/TComLoopFilter.h"
+#include "TLibCommon/TComSampleAdaptiveOffset.h"
 #include "TDecEntropy.h"
 #include "TDecCu.h"
 #include "TDecSbac.h"
 #include "TDecBinCoderCABAC.h"
+#include "TDecCtuWorker.h"
 
 //! \ingroup TLibDecoder
 //! \{
@@ -70,15 +74,55 @@ private:
 
   TDecSbac        m_lastSliceSegmentEndContextState;    ///< context storage for state at the end of the previous slice-segment (used for dependent slices only).
   TDecSbac        m_entropyCodingSyncContextState;      ///< context storate for state of contexts at the wavefront/WPP/entropy-coding-sync second CTU of tile-row
+
+  // parallel decoding of wavefront CTU rows
+  struct ParallelCtuRow
+  {
+    UInt                  startCtuTsAddr;                       ///< first CTU of the row in the slice-segment
+    UInt                  boundingCtuTsAddr;                    ///< CTU following the last CTU of the row
+    Bool                  storesSyncState;                      ///< the row contains the second CTU of the tile-row
+    Bool                  isLastCtuOfSliceSegment;              ///< the end of the slice-segment was parsed in the row
+    Int                   threadIdx;                            ///< thread that decoded the row
+  };
+  TComThreadPool*             m_pcThreadPool;                   ///< threads decoding CTU rows concurrently
+  std::vector<TDecCtuWorker*> m_ctuWorkers;                     ///< CTU parsing and reconstruction tools, one set per thread
+  std::vector<ParallelCtuRow> m_parallelCtuRows;                ///< rows decoded concurrently in the current slice-segment
+  std::vector<TDecSbac*>  m_parallelCtuRowSyncStates;           ///< context storage for the wavefront state stored by each row
+  TComCtuRowProgress      m_parallelCtuRowProgress;             ///< horizontal position following the last decoded CTU of each row
+  TComCtuRowProgress      m_reconstructedCtuRowProgress;        ///< horizontal position following the last reconstructed CTU of each row of the picture
+
+  // in-loop filtering of the CTU rows while the picture is decoded
+  TComLoopFilter*           m_pcLoopFilter;
+  TComSampleAdaptiveOffset* m_pcSAO;
+  Bool                    m_ctuRowLoopFilterEnabled;            ///< deblock and apply SAO to each CTU row once the row below it has been reconstructed
+  UInt                    m_numFilteredCtuRows;                 ///< number of CTU rows of the picture deblocked so far
+  std::mutex              m_ctuRowLoopFilterMutex;              ///< serialises the filtering of the rows, which may be requested by several threads
+
+  Void  xParseSAOBlkParam         ( TComPic* pcPic, const TComSlice* pcSlice, UInt ctuRsAddr, TDecSbac* pcSbacDecoder );
+  Bool  xUseParallelCtuRows       ( TComPic* pcPic, TComSlice* pcSlice ) const;
+  Void  xDecompressSliceParallel  ( TComInputBitstream** ppcSubstreams, TComPic* pcPic );
+  Void  xDecompressParallelCtuRow ( TComInputBitstream** ppcSubstreams, TComPic* pcPic, UInt rowIdx, Int threadIdx );
+  Bool  xUsePipelinedReconstruction ( TComPic* pcPic ) const;
+  Void  xReconstructCtuRow        ( TComPic* pcPic, UInt startCtuRsAddr, UInt boundingCtuRsAddr, Int threadIdx );
+  Bool  xUseCtuRowLoopFilter      ( TComPic* pcPic ) const;
+  Void  xFilterCtuRows            ( TComPic* pcPic, UInt numReconstructedCtuRows );
+
 public:
   TDecSlice();
   virtual ~TDecSlice();
 
-  Void  init              ( TDecEntropy* pcEntropyDecoder, TDecCu* pcMbDecoder, TDecConformanceCheck *pDecConformanceCheck );
+  Void  init              ( TDecEntropy* pcEntropyDecoder, TDecCu* pcMbDecoder, TDecConformanceCheck *pDecConformanceCheck, TComLoopFilter* pcLoopFilter, TComSampleAdaptiveOffset* pcSAO );
+  /// set the threads and tools decoding the CTU rows of wavefront slice-segments concurrently (no workers: serial decoding)
+  Void  setCtuWorkers     ( TComThreadPool* pcThreadPool, const std::vector<TDecCtuWorker*> &ctuWorkers );
   Void  create            ();
   Void  destroy           ();
 
   Void  decompressSlice   ( TComInputBitstream** ppcSubstreams,   TComPic* pcPic, TDecSbac* pcSbacDecoder );
+
+  Void  setCtuRowLoopFilterEnabled ( Bool enabled ) { m_ctuRowLoopFilterEnabled = enabled; }
+  Bool  getCtuRowLoopFilterEnabled () const         { return m_ctuRowLoopFilterEnabled; }
+  /// filter the CTU rows of the picture not filtered while it was decoded, once all its slices have been decoded
+  Void  finishCtuRowLoopFilter     ( TComPic* pcPic );
 };
 
 //! \}
@@ -63,6 +63,7 @@ TDecTop::TDecTop()
   , m_seiReader()
   , m_cLoopFilter()
   , m_cSAO()
+  , m_numCtuThreads(1)
   , m_pcPic(NULL)
   , m_prevPOC(MAX_INT)
   , m_prevTid0POC(0)
@@ -119,6 +120,15 @@ Void TDecTop::create()
   m_cGopDecoder.create();
   m_apcSlicePilot = new TComSlice;
   m_uiSliceIdx = 0;
+
+  if ( m_numCtuThreads > 1 )
+  {
+    for ( Int threadIdx = 0; threadIdx < m_numCtuThreads; threadIdx++ )
+    {
+      m_ctuWorkers.push_back( new TDecCtuWorker );
+    }
+    m_cThreadPool.create( m_numCtuThreads );
+  }
 }
 
 Void TDecTop::destroy()
@@ -129,6 +139,14 @@ Void TDecTop::destroy()
   m_apcSlicePilot = NULL;
 
   m_cSliceDecoder.destroy();
+
+  m_cThreadPool.destroy();
+  // the buffers of the workers are destroyed with those of the CU decoder, in executeLoopFilters
+  for ( UInt threadIdx = 0; threadIdx < m_ctuWorkers.size(); threadIdx++ )
+  {
+    delete m_ctuWorkers[threadIdx];
+  }
+  m_ctuWorkers.clear();
 }
 
 Void TDecTop::init()
@@ -136,7 +154,8 @@ Void TDecTop::init()
   // initialize ROM
   initROM();
   m_cGopDecoder.init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cSAO);
-  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder, &m_conformanceCheck );
+  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder, &m_conformanceCheck, &m_cLoopFilter, &m_cSAO );
+  m_cSliceDecoder.setCtuWorkers( &m_cThreadPool, m_ctuWorkers );
 #if MCTS_ENC_CHECK
   m_cEntropyDecoder.init(&m_cPrediction, &m_conformanceCheck );
 #else
@@ -255,6 +274,10 @@ Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
   poc                 = pcPic->getSlice(m_uiSliceIdx-1)->getPOC();
   rpcListPic          = &m_cListPic;
   m_cCuDecoder.destroy();
+  for ( UInt threadIdx = 0; threadIdx < m_ctuWorkers.size(); threadIdx++ )
+  {
+    m_ctuWorkers[threadIdx]->destroy();
+  }
   m_bFirstSliceInPicture  = true;
 
   return;
@@ -384,8 +407,8 @@ Void TDecTop::xActivateParameterSets()
     sps=pSlice->getSPS();
 
     // Initialise the various objects for the new set of settings
-    m_cSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxTotalCUDepth(), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_LUMA), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_CHROMA) );
-    m_cLoopFilter.create( sps->getMaxTotalCUDepth() );
+    m_cSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxTotalCUDepth(), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_LUMA), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_CHROMA), &m_cThreadPool );
+    m_cLoopFilter.create( sps->getMaxTotalCUDepth(), &m_cThreadPool );
     m_cPrediction.initTempBuff(sps->getChromaFormatIdc());
 
 
@@ -423,6 +446,10 @@ Void TDecTop::xActivateParameterSets()
       m_cCuDecoder.init(&m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction);
   #endif
       m_cTrQuant.init     ( sps->getMaxTrSize() );
+      for ( UInt threadIdx = 0; threadIdx < m_ctuWorkers.size(); threadIdx++ )
+      {
+        m_ctuWorkers[threadIdx]->create( *sps, &m_conformanceCheck );
+      }
 
       m_cSliceDecoder.create();
     }
@@ -779,6 +806,11 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     }
     m_cTrQuant.setScalingListDec(scalingList);
     m_cTrQuant.setUseScalingList(true);
+    for ( UInt threadIdx = 0; threadIdx < m_ctuWorkers.size(); threadIdx++ )
+    {
+      m_ctuWorkers[threadIdx]->getTrQuant()->setScalingListDec(scalingList);
+      m_ctuWorkers[threadIdx]->getTrQuant()->setUseScalingList(true);
+    }
   }
   else
   {
@@ -789,6 +821,11 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     };
     m_cTrQuant.setFlatScalingList(maxLog2TrDynamicRange, pcSlice->getSPS()->getBitDepths());
     m_cTrQuant.setUseScalingList(false);
+    for ( UInt threadIdx = 0; threadIdx < m_ctuWorkers.size(); threadIdx++ )
+    {
+      m_ctuWorkers[threadIdx]->getTrQuant()->setFlatScalingList(maxLog2TrDynamicRange, pcSlice->getSPS()->getBitDepths());
+      m_ctuWorkers[threadIdx]->getTrQuant()->setUseScalingList(false);
+    }
   }
 
   //  Decode a picture
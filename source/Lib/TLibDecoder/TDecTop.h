@@ -45,6 +45,7 @@
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComPrediction.h"
 #include "TLibCommon/SEI.h"
+#include "TLibCommon/TComThreadPool.h"
 
 #include "TDecGop.h"
 #include "TDecEntropy.h"
@@ -52,6 +53,7 @@
 #include "TDecCAVLC.h"
 #include "SEIread.h"
 #include "TDecConformance.h"
+#include "TDecCtuWorker.h"
 
 class InputNALUnit;
 
@@ -93,6 +95,10 @@ private:
   TComSampleAdaptiveOffset m_cSAO;
   TDecConformanceCheck    m_conformanceCheck;
 
+  Int                     m_numCtuThreads;                ///< number of threads decoding CTU rows concurrently
+  TComThreadPool          m_cThreadPool;                  ///< threads decoding CTU rows concurrently
+  std::vector<TDecCtuWorker*> m_ctuWorkers;               ///< CTU parsing and reconstruction tools, one set per thread
+
   Bool isSkipPictureForBLA(Int& iPOCLastDisplay);
   Bool isRandomAccessSkipPicture(Int& iSkipFrame,  Int& iPOCLastDisplay);
   TComPic*                m_pcPic;
@@ -135,6 +141,8 @@ public:
   Void  destroy ();
 
   Void setDecodedPictureHashSEIEnabled(Int enabled) { m_cGopDecoder.setDecodedPictureHashSEIEnabled(enabled); }
+  Void setNumCtuThreads(Int numCtuThreads) { m_numCtuThreads = numCtuThreads; } ///< to be called before create()
+  Void setCtuRowLoopFilterEnabled(Bool enabled) { m_cSliceDecoder.setCtuRowLoopFilterEnabled(enabled); }
 #if MCTS_ENC_CHECK
   Void setTMctsCheckEnabled(Bool enabled) { m_tmctsCheckEnabled = enabled; }
 
@@ -48,18 +48,44 @@
 
 TEncBinCABACCounter::TEncBinCABACCounter()
 {
+  // keep the arithmetic coder registers valid in case a full coder copies its state from this one
+  TEncBinCABAC::start();
 }
 
 TEncBinCABACCounter::~TEncBinCABACCounter()
 {
 }
 
+Void TEncBinCABACCounter::start()
+{
+  m_fracBits = 0;
+}
+
 Void TEncBinCABACCounter::finish()
 {
   m_pcTComBitIf->write(0, UInt(m_fracBits >> 15) );
   m_fracBits &= 32767;
 }
 
+/**
+ * \brief Copy the bit estimation state, which is the fractional bit count only
+ *
+ * \param pcTEncBinIf source coder
+ */
+Void TEncBinCABACCounter::copyState( const TEncBinIf* pcTEncBinIf )
+{
+  m_fracBits = pcTEncBinIf->getTEncBinCABAC()->getFracBits();
+}
+
+Void TEncBinCABACCounter::resetBits()
+{
+  if ( m_binCountIncrement )
+  {
+    m_uiBinsCoded = 0;
+  }
+  m_fracBits &= 32767;
+}
+
 UInt TEncBinCABACCounter::getNumWrittenBits()
 {
   return m_pcTComBitIf->getNumberOfWrittenBits() + UInt( m_fracBits >> 15 );
@@ -78,8 +104,7 @@ Void TEncBinCABACCounter::encodeBin( UInt binValue, ContextModel &rcCtxModel )
 #endif
 
   m_uiBinsCoded += m_binCountIncrement;
-  m_fracBits += rcCtxModel.getEntropyBits( binValue );
-  rcCtxModel.update( binValue );
+  m_fracBits += rcCtxModel.updateAndGetEntropyBits( binValue );
 
 #if DEBUG_ENCODER_SEARCH_BINS
   if ((g_debugCounter + debugEncoderSearchBinWindow) >= debugEncoderSearchBinTargetLine)
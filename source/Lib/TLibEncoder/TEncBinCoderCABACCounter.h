@@ -47,13 +47,19 @@
 //! \{
 
 
+/// Bit estimation coder for RDO: only the fractional bit count and the context states are maintained,
+/// the arithmetic coder registers (low, range and buffered bytes) of TEncBinCABAC are left untouched.
 class TEncBinCABACCounter : public TEncBinCABAC
 {
 public:
   TEncBinCABACCounter ();
   virtual ~TEncBinCABACCounter();
 
+  Void  start             ();
   Void  finish            ();
+  Void  copyState         ( const TEncBinIf* pcTEncBinIf );
+
+  Void  resetBits         ();
   UInt  getNumWrittenBits ();
 
   Void  encodeBin         ( UInt  binValue,  ContextModel& rcCtxModel );
@@ -228,6 +228,9 @@ protected:
   Bool      m_bFastMEAssumingSmootherMVEnabled;
   Int       m_minSearchWindow;
   Bool      m_bRestrictMESampling;
+  Bool      m_useHierarchicalME;
+  Int       m_hierarchicalMESearchRange;
+  Int       m_subpelPlanes;
 
   //====== Quality control ========
   Int       m_iMaxDeltaQP;                      //  Max. absolute delta QP (1:default)
@@ -260,6 +263,14 @@ protected:
   UInt      m_rdPenalty;
   FastInterSearchMode m_fastInterSearchMode;
   Bool      m_bUseEarlyCU;
+  Bool      m_useFastSplitDecision;
+  UInt      m_fastSplitSkipSplitVar;
+  UInt      m_fastSplitSkipNonSplitVar;
+  Double    m_fastSplitCostRatio;
+  Bool      m_disableNxNPartitions;
+  std::vector<UInt> m_temporalLayerMaxCUDepth;
+  UInt      m_fastUDINumModes;
+  Int       m_rdoqMaxTemporalLayer;
   Bool      m_useFastDecisionForMerge;
   Bool      m_bUseCbfFastMode;
   Bool      m_useEarlySkipDetection;
@@ -314,6 +325,8 @@ protected:
   std::vector<Int> m_tileRowHeight;
 
   Bool      m_entropyCodingSyncEnabledFlag;
+  Int       m_numCtuThreads;                                  ///< number of threads compressing CTU rows/tiles of a slice concurrently
+  Int       m_numFrameThreads;                                ///< number of pictures of a GOP compressed concurrently
 
   HashType  m_decodedPictureHashSEIType;
   Bool      m_bufferingPeriodSEIEnabled;
@@ -662,6 +675,9 @@ public:
   Void      setFastMEAssumingSmootherMVEnabled ( Bool b )    { m_bFastMEAssumingSmootherMVEnabled = b; }
   Void      setMinSearchWindow              ( Int   i )      { m_minSearchWindow = i; }
   Void      setRestrictMESampling           ( Bool  b )      { m_bRestrictMESampling = b; }
+  Void      setUseHierarchicalME            ( Bool  b )      { m_useHierarchicalME = b; }
+  Void      setHierarchicalMESearchRange    ( Int   i )      { m_hierarchicalMESearchRange = i; }
+  Void      setSubpelPlanes                 ( Int   i )      { m_subpelPlanes = i; }
 
   //====== Quality control ========
   Void      setMaxDeltaQP                   ( Int   i )      { m_iMaxDeltaQP = i; }
@@ -764,10 +780,14 @@ public:
   Bool      getDisableIntraPUsInInterSlices    () const { return m_bDisableIntraPUsInInterSlices; }
   MESearchMethod getMotionEstimationSearchMethod ( ) const { return m_motionEstimationSearchMethod; }
   Int       getSearchRange                     () const { return m_iSearchRange; }
+  Int       getBipredSearchRange               () const { return m_bipredSearchRange; }
   Bool      getClipForBiPredMeEnabled          () const { return m_bClipForBiPredMeEnabled; }
   Bool      getFastMEAssumingSmootherMVEnabled () const { return m_bFastMEAssumingSmootherMVEnabled; }
   Int       getMinSearchWindow                 () const { return m_minSearchWindow; }
   Bool      getRestrictMESampling              () const { return m_bRestrictMESampling; }
+  Bool      getUseHierarchicalME               () const { return m_useHierarchicalME; }
+  Int       getHierarchicalMESearchRange       () const { return m_hierarchicalMESearchRange; }
+  Int       getSubpelPlanes                    () const { return m_subpelPlanes; }
 
   //==== Quality control ========
   Int       getMaxDeltaQP                   () const { return  m_iMaxDeltaQP; }
@@ -785,6 +805,14 @@ public:
   Void      setRDpenalty                    ( UInt  u )     { m_rdPenalty  = u; }
   Void      setFastInterSearchMode          ( FastInterSearchMode m ) { m_fastInterSearchMode = m; }
   Void      setUseEarlyCU                   ( Bool  b )     { m_bUseEarlyCU = b; }
+  Void      setUseFastSplitDecision         ( Bool  b )     { m_useFastSplitDecision = b; }
+  Void      setFastSplitSkipSplitVar        ( UInt  u )     { m_fastSplitSkipSplitVar = u; }
+  Void      setFastSplitSkipNonSplitVar     ( UInt  u )     { m_fastSplitSkipNonSplitVar = u; }
+  Void      setFastSplitCostRatio           ( Double d )    { m_fastSplitCostRatio = d; }
+  Void      setDisableNxNPartitions         ( Bool  b )     { m_disableNxNPartitions = b; }
+  Void      setTemporalLayerMaxCUDepth      ( const std::vector<UInt> &depths ) { m_temporalLayerMaxCUDepth = depths; }
+  Void      setFastUDINumModes              ( UInt  u )     { m_fastUDINumModes = u; }
+  Void      setRDOQMaxTemporalLayer         ( Int   i )     { m_rdoqMaxTemporalLayer = i; }
   Void      setUseFastDecisionForMerge      ( Bool  b )     { m_useFastDecisionForMerge = b; }
   Void      setUseCbfFastMode               ( Bool  b )     { m_bUseCbfFastMode = b; }
   Void      setUseEarlySkipDetection        ( Bool  b )     { m_useEarlySkipDetection = b; }
@@ -810,6 +838,14 @@ public:
   Int       getRDpenalty                    ()      { return m_rdPenalty;  }
   FastInterSearchMode getFastInterSearchMode() const{ return m_fastInterSearchMode;  }
   Bool      getUseEarlyCU                   ()      { return m_bUseEarlyCU; }
+  Bool      getUseFastSplitDecision         () const { return m_useFastSplitDecision; }
+  UInt      getFastSplitSkipSplitVar        () const { return m_fastSplitSkipSplitVar; }
+  UInt      getFastSplitSkipNonSplitVar     () const { return m_fastSplitSkipNonSplitVar; }
+  Double    getFastSplitCostRatio           () const { return m_fastSplitCostRatio; }
+  Bool      getDisableNxNPartitions         () const { return m_disableNxNPartitions; }
+  const std::vector<UInt>& getTemporalLayerMaxCUDepth() const { return m_temporalLayerMaxCUDepth; }
+  UInt      getFastUDINumModes              () const { return m_fastUDINumModes; }
+  Int       getRDOQMaxTemporalLayer         () const { return m_rdoqMaxTemporalLayer; }
   Bool      getUseFastDecisionForMerge      ()      { return m_useFastDecisionForMerge; }
   Bool      getUseCbfFastMode               ()      { return m_bUseCbfFastMode; }
   Bool      getUseEarlySkipDetection        ()      { return m_useEarlySkipDetection; }
@@ -895,6 +931,10 @@ public:
   Void  xCheckGSParameters();
   Void  setEntropyCodingSyncEnabledFlag(Bool b)                      { m_entropyCodingSyncEnabledFlag = b; }
   Bool  getEntropyCodingSyncEnabledFlag() const                      { return m_entropyCodingSyncEnabledFlag; }
+  Void  setNumCtuThreads(Int i)                                      { m_numCtuThreads = i; }
+  Int   getNumCtuThreads() const                                     { return m_numCtuThreads; }
+  Void  setNumFrameThreads(Int i)                                    { m_numFrameThreads = i; }
+  Int   getNumFrameThreads() const                                   { return m_numFrameThreads; }
   Void  setDecodedPictureHashSEIType(HashType m)                     { m_decodedPictureHashSEIType = m; }
   HashType getDecodedPictureHashSEIType() const                      { return m_decodedPictureHashSEIType; }
   Void  setBufferingPeriodSEIEnabled(Bool b)                         { m_bufferingPeriodSEIEnabled = b; }
@@ -0,0 +1,197 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncCtuWorker.cpp
+    \brief    set of CTU compression and encoding tools owned by one worker thread
+*/
+
+#include "TEncCtuWorker.h"
+#include "TEncTop.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncCtuWorker::TEncCtuWorker()
+ : m_maxTotalCUDepth(0)
+ , m_maxCUWidth(0)
+ , m_maxCUHeight(0)
+ , m_pppcRDSbacCoder(NULL)
+ , m_pppcBinCoderCABAC(NULL)
+{
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+  m_cSbacCoder.init( &m_cBinCoderCABAC );
+}
+
+TEncCtuWorker::~TEncCtuWorker()
+{
+}
+
+Void TEncCtuWorker::create( UInt maxTotalCUDepth, UInt maxCUWidth, UInt maxCUHeight, ChromaFormat chromaFormat )
+{
+  m_maxTotalCUDepth = maxTotalCUDepth;
+  m_maxCUWidth      = maxCUWidth;
+  m_maxCUHeight     = maxCUHeight;
+
+  m_cCuEncoder.create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, chromaFormat );
+
+  m_pppcRDSbacCoder = new TEncSbac** [m_maxTotalCUDepth+1];
+#if FAST_BIT_EST
+  m_pppcBinCoderCABAC = new TEncBinCABACCounter** [m_maxTotalCUDepth+1];
+#else
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [m_maxTotalCUDepth+1];
+#endif
+
+  for ( UInt iDepth = 0; iDepth < m_maxTotalCUDepth+1; iDepth++ )
+  {
+    m_pppcRDSbacCoder[iDepth] = new TEncSbac* [CI_NUM];
+#if FAST_BIT_EST
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABACCounter* [CI_NUM];
+#else
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABAC* [CI_NUM];
+#endif
+
+    for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+    {
+      m_pppcRDSbacCoder[iDepth][iCIIdx] = new TEncSbac;
+#if FAST_BIT_EST
+      m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABACCounter;
+#else
+      m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABAC;
+#endif
+      m_pppcRDSbacCoder   [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC [iDepth][iCIIdx] );
+    }
+  }
+}
+
+Void TEncCtuWorker::destroy()
+{
+  m_cCuEncoder.destroy();
+  m_cSearch.destroy();
+
+  if (m_pppcRDSbacCoder != NULL)
+  {
+    for ( UInt iDepth = 0; iDepth < m_maxTotalCUDepth+1; iDepth++ )
+    {
+      for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+      {
+        delete m_pppcRDSbacCoder[iDepth][iCIIdx];
+        delete m_pppcBinCoderCABAC[iDepth][iCIIdx];
+      }
+      delete [] m_pppcRDSbacCoder[iDepth];
+      delete [] m_pppcBinCoderCABAC[iDepth];
+    }
+    delete [] m_pppcRDSbacCoder;
+    delete [] m_pppcBinCoderCABAC;
+    m_pppcRDSbacCoder   = NULL;
+    m_pppcBinCoderCABAC = NULL;
+  }
+}
+
+/** The tools are initialised in the same way as the main tools of the encoder (see TEncTop::init),
+ *  so that a CTU compressed by a worker results in the same decisions.
+ * \param pcEncTop  pointer of encoder class
+ * \param sps       SPS holding the scaling lists used by the encoder
+ */
+Void TEncCtuWorker::init( TEncTop* pcEncTop, const TComSPS &sps )
+{
+  m_cRdCost.setCostMode( pcEncTop->getCostMode() );
+
+#if ADAPTIVE_QP_SELECTION
+  if (pcEncTop->getUseAdaptQpSelect())
+  {
+    m_cTrQuant.initSliceQpDelta();
+  }
+#endif
+
+  const Int maxLog2TrDynamicRange[MAX_NUM_CHANNEL_TYPE] =
+  {
+      sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_LUMA),
+      sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_CHROMA)
+  };
+  if (pcEncTop->getUseScalingListId() == SCALING_LIST_OFF)
+  {
+    m_cTrQuant.setFlatScalingList(maxLog2TrDynamicRange, sps.getBitDepths());
+    m_cTrQuant.setUseScalingList(false);
+  }
+  else
+  {
+    m_cTrQuant.setScalingList(const_cast<TComScalingList*>(&sps.getScalingList()), maxLog2TrDynamicRange, sps.getBitDepths());
+    m_cTrQuant.setUseScalingList(true);
+  }
+
+  m_cTrQuant.init( 1 << pcEncTop->getQuadtreeTULog2MaxSize(),
+                   pcEncTop->getUseRDOQ(),
+                   pcEncTop->getUseRDOQTS(),
+                   pcEncTop->getUseSelectiveRDOQ(),
+                   true
+                  ,pcEncTop->getUseTransformSkipFast()
+#if ADAPTIVE_QP_SELECTION
+                  ,pcEncTop->getUseAdaptQpSelect()
+#endif
+                  );
+
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getMotionEstimationSearchMethod(),
+                  m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth, &m_cEntropyCoder, &m_cRdCost, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cRdCost, &m_cEntropyCoder, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder, pcEncTop->getRateCtrl() );
+  m_cCuEncoder.setSliceEncoder( pcEncTop->getSliceEncoder() );
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/**
+ \param pcSlice       slice to be compressed, holding the lambdas set up for it
+ \param pcRdCost      RD cost class of the encoder, holding the lambdas and distortion weights set up for the slice
+ \param pcTrQuant     transform & quantization class of the encoder, holding the RDOQ usage set up for the slice
+ \param bFastDeltaQP  fast delta QP mode of the slice
+ */
+Void TEncCtuWorker::initSlice( const TComSlice* pcSlice, const TComRdCost* pcRdCost, const TComTrQuant* pcTrQuant, Bool bFastDeltaQP )
+{
+  m_cRdCost = *pcRdCost;
+  m_cTrQuant.setUseRDOQ( pcTrQuant->getUseRDOQ(), pcTrQuant->getUseRDOQTS() );
+#if RDOQ_CHROMA_LAMBDA
+  m_cTrQuant.setLambdas( pcSlice->getLambdas() );
+#else
+  m_cTrQuant.setLambda( pcSlice->getLambdas()[0] );
+#endif
+  m_cCuEncoder.setFastDeltaQp( bFastDeltaQP );
+}
+
+//! \}
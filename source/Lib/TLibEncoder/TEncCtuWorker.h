@@ -0,0 +1,110 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncCtuWorker.h
+    \brief    set of CTU compression and encoding tools owned by one worker thread (header)
+*/
+
+#ifndef __TENCCTUWORKER__
+#define __TENCCTUWORKER__
+
+// Include files
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TEncCu.h"
+#include "TEncSearch.h"
+#include "TEncEntropy.h"
+#include "TEncSbac.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+class TEncTop;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the CTU compression and encoding tools, so that several CTUs can be processed concurrently
+class TEncCtuWorker
+{
+private:
+  TEncCu                  m_cCuEncoder;                   ///< CU encoder
+  TEncSearch              m_cSearch;                      ///< encoder search class
+  TComTrQuant             m_cTrQuant;                     ///< transform & quantization class
+  TComRdCost              m_cRdCost;                      ///< RD cost computation class
+  TEncEntropy             m_cEntropyCoder;                ///< entropy encoder
+  TEncSbac                m_cSbacCoder;                   ///< SBAC encoder writing the substream of a tile
+  TEncBinCABAC            m_cBinCoderCABAC;               ///< bin coder CABAC writing the substream of a tile
+
+  UInt                    m_maxTotalCUDepth;
+  UInt                    m_maxCUWidth;
+  UInt                    m_maxCUHeight;
+  TEncSbac***             m_pppcRDSbacCoder;              ///< temporal storage for RD computation
+  TEncSbac                m_cRDGoOnSbacCoder;             ///< going on SBAC model for RD stage
+#if FAST_BIT_EST
+  TEncBinCABACCounter***  m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+#else
+  TEncBinCABAC***         m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
+  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+#endif
+
+public:
+  TEncCtuWorker();
+  virtual ~TEncCtuWorker();
+
+  Void  create              ( UInt maxTotalCUDepth, UInt maxCUWidth, UInt maxCUHeight, ChromaFormat chromaFormat );
+  Void  destroy             ();
+  /// initialise the tools with the encoder configuration and the scaling lists of the SPS
+  Void  init                ( TEncTop* pcEncTop, const TComSPS &sps );
+
+  /// copy the slice-level state (lambdas, distortion weights, RDOQ usage, delta QP mode) set up on the main tools of the encoder
+  Void  initSlice           ( const TComSlice* pcSlice, const TComRdCost* pcRdCost, const TComTrQuant* pcTrQuant, Bool bFastDeltaQP );
+
+  TEncCu*                 getCuEncoder          () { return &m_cCuEncoder;        }
+  TEncSearch*             getPredSearch         () { return &m_cSearch;           }
+  TComTrQuant*            getTrQuant            () { return &m_cTrQuant;          }
+  TComRdCost*             getRdCost             () { return &m_cRdCost;           }
+  TEncEntropy*            getEntropyCoder       () { return &m_cEntropyCoder;     }
+  TEncSbac*               getSbacCoder          () { return &m_cSbacCoder;        }
+  TEncBinCABAC*           getBinCABAC           () { return &m_cBinCoderCABAC;    }
+  TEncSbac***             getRDSbacCoder        () { return m_pppcRDSbacCoder;    }
+  TEncSbac*               getRDGoOnSbacCoder    () { return &m_cRDGoOnSbacCoder;  }
+};
+
+//! \}
+
+#endif // __TENCCTUWORKER__
@@ -205,18 +205,36 @@ Void TEncCu::destroy()
  */
 Void TEncCu::init( TEncTop* pcEncTop )
 {
-  m_pcEncCfg           = pcEncTop;
-  m_pcPredSearch       = pcEncTop->getPredSearch();
-  m_pcTrQuant          = pcEncTop->getTrQuant();
-  m_pcRdCost           = pcEncTop->getRdCost();
+  init( pcEncTop, pcEncTop->getPredSearch(), pcEncTop->getTrQuant(), pcEncTop->getRdCost(),
+        pcEncTop->getEntropyCoder(), pcEncTop->getRDSbacCoder(), pcEncTop->getRDGoOnSbacCoder(), pcEncTop->getRateCtrl() );
 
-  m_pcEntropyCoder     = pcEncTop->getEntropyCoder();
   m_pcBinCABAC         = pcEncTop->getBinCABAC();
+}
+
+/** \param    pcEncCfg           encoder configuration
+    \param    pcPredSearch       encoder search class
+    \param    pcTrQuant          transform & quantization class
+    \param    pcRdCost           RD cost computation class
+    \param    pcEntropyCoder     entropy encoder used for the trial encodings
+    \param    pppcRDSbacCoder    storage for SBAC-based RD optimization
+    \param    pcRDGoOnSbacCoder  go-on SBAC encoder
+    \param    pcRateCtrl         rate control manager
+ */
+Void TEncCu::init( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost,
+                   TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl )
+{
+  m_pcEncCfg           = pcEncCfg;
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
+  m_pcRdCost           = pcRdCost;
 
-  m_pppcRDSbacCoder    = pcEncTop->getRDSbacCoder();
-  m_pcRDGoOnSbacCoder  = pcEncTop->getRDGoOnSbacCoder();
+  m_pcEntropyCoder     = pcEntropyCoder;
+  m_pcBinCABAC         = NULL;
 
-  m_pcRateCtrl         = pcEncTop->getRateCtrl();
+  m_pppcRDSbacCoder    = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder  = pcRDGoOnSbacCoder;
+
+  m_pcRateCtrl         = pcRateCtrl;
   m_lumaQPOffset       = 0;
   initLumaDeltaQpLUT();
 #if JVET_V0078
@@ -656,7 +674,30 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 
   const Bool bBoundary = !( uiRPelX < sps.getPicWidthInLumaSamples() && uiBPelY < sps.getPicHeightInLumaSamples() );
 
-  if ( !bBoundary )
+  // the deepest CU depth searched may be limited per temporal layer (boundary CUs are always split)
+  const std::vector<UInt> &temporalLayerMaxCUDepth = m_pcEncCfg->getTemporalLayerMaxCUDepth();
+  const UInt uiMaxSplitDepth = temporalLayerMaxCUDepth.empty() ? MAX_UINT
+                             : temporalLayerMaxCUDepth[std::min<UInt>(pcSlice->getTLayer(), UInt(temporalLayerMaxCUDepth.size())-1)];
+
+  // fast split decision: only act when at least two of the left, above and co-located depths agree
+  const Bool bSplitAllowed = uiDepth < sps.getLog2DiffMaxMinCodingBlockSize() && uiDepth < uiMaxSplitDepth
+                          && (!getFastDeltaQp() || uiWidth > fastDeltaQPCuMaxSize);
+  Bool bFastSplitDecision  = m_pcEncCfg->getUseFastSplitDecision() && !bBoundary;
+  UInt uiNumAvail = 0, uiNumDeeper = 0, uiNumNotDeeper = 0;
+  UInt uiVariance = 0;
+  if ( bFastSplitDecision )
+  {
+    xGetNeighbourDepthHints( rpcBestCU, uiDepth, uiNumAvail, uiNumDeeper, uiNumNotDeeper );
+    bFastSplitDecision = uiNumAvail >= 2 && ( uiNumDeeper == 0 || uiNumNotDeeper == 0 );
+    if ( bFastSplitDecision )
+    {
+      uiVariance = xGetLumaVariance( m_ppcOrigYuv[uiDepth], uiWidth, rpcBestCU->getHeight(0), sps.getBitDepth(CHANNEL_TYPE_LUMA) );
+    }
+  }
+  // textured CU whose neighbours are all split further: go straight to the split
+  const Bool bSkipNonSplit = bFastSplitDecision && bSplitAllowed && uiNumNotDeeper == 0 && uiVariance >= m_pcEncCfg->getFastSplitSkipNonSplitVar();
+
+  if ( !bBoundary && !bSkipNonSplit )
   {
     for (Int iQP=iMinQP; iQP<=iMaxQP; iQP++)
     {
@@ -745,7 +786,7 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 
           if(!( (rpcBestCU->getWidth(0)==8) && (rpcBestCU->getHeight(0)==8) ))
           {
-            if( uiDepth == sps.getLog2DiffMaxMinCodingBlockSize() && doNotBlockPu)
+            if( uiDepth == sps.getLog2DiffMaxMinCodingBlockSize() && doNotBlockPu && !m_pcEncCfg->getDisableNxNPartitions() )
             {
               xCheckRDCostInter( rpcBestCU, rpcTempCU, SIZE_NxN DEBUG_STRING_PASS_INTO(sDebug)   );
               rpcTempCU->initEstData( uiDepth, iQP, bIsLosslessMode );
@@ -905,7 +946,7 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 #endif 
           xCheckRDCostIntra( rpcBestCU, rpcTempCU, SIZE_2Nx2N DEBUG_STRING_PASS_INTO(sDebug) );
           rpcTempCU->initEstData( uiDepth, iQP, bIsLosslessMode );
-          if( uiDepth == sps.getLog2DiffMaxMinCodingBlockSize() )
+          if( uiDepth == sps.getLog2DiffMaxMinCodingBlockSize() && !m_pcEncCfg->getDisableNxNPartitions() )
           {
             if( rpcTempCU->getWidth(0) > ( 1 << sps.getQuadtreeTULog2MinSize() ) )
             {
@@ -948,6 +989,8 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
     }
   }
 
+  m_bestNonSplitCost[uiDepth] = rpcBestCU->getTotalCost();
+
   // copy original YUV samples to PCM buffer
   if( rpcBestCU->getTotalCost()!=MAX_DOUBLE && rpcBestCU->isLosslessCoded(0) && (rpcBestCU->getIPCMFlag(0) == false))
   {
@@ -999,9 +1042,18 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
     iMaxQP = iMinQP; // If all TUs are forced into using transquant bypass, do not loop here.
   }
 
-  const Bool bSubBranch = bBoundary || !( m_pcEncCfg->getUseEarlyCU() && rpcBestCU->getTotalCost()!=MAX_DOUBLE && rpcBestCU->isSkipped(0) );
+  // flat or cheap CU whose neighbours are not split any deeper: do not split further
+  Bool bSkipSplit = false;
+  if ( bFastSplitDecision && uiNumDeeper == 0 && rpcBestCU->getTotalCost()!=MAX_DOUBLE )
+  {
+    const Double dParentCost = uiDepth > 0 ? m_bestNonSplitCost[uiDepth-1] : MAX_DOUBLE;
+    bSkipSplit = uiVariance <= m_pcEncCfg->getFastSplitSkipSplitVar()
+              || ( dParentCost != MAX_DOUBLE && rpcBestCU->getTotalCost() < m_pcEncCfg->getFastSplitCostRatio() * dParentCost / 4 );
+  }
+
+  const Bool bSubBranch = bBoundary || !( ( m_pcEncCfg->getUseEarlyCU() && rpcBestCU->getTotalCost()!=MAX_DOUBLE && rpcBestCU->isSkipped(0) ) || bSkipSplit );
 
-  if( bSubBranch && uiDepth < sps.getLog2DiffMaxMinCodingBlockSize() && (!getFastDeltaQp() || uiWidth > fastDeltaQPCuMaxSize || bBoundary))
+  if( bSubBranch && uiDepth < sps.getLog2DiffMaxMinCodingBlockSize() && (bSplitAllowed || bBoundary))
   {
     // further split
     Double splitTotalCost = 0;
@@ -1904,6 +1956,110 @@ Void TEncCu::xCopyYuv2Tmp( UInt uiPartUnitIdx, UInt uiNextDepth )
   m_ppcPredYuvBest[uiNextDepth]->copyToPartYuv( m_ppcPredYuvBest[uiCurrDepth], uiPartUnitIdx);
 }
 
+/** Collect the split hints given by the left, above and co-located CUs
+ * \param pcCU            pointer to current CU
+ * \param uiDepth         depth of the current CU
+ * \param ruiNumAvail     returns the number of available neighbours
+ * \param ruiNumDeeper    returns the number of neighbours that are (partly) coded at a larger depth
+ * \param ruiNumNotDeeper returns the number of neighbours that are (partly) coded at the same or a smaller depth
+ */
+Void TEncCu::xGetNeighbourDepthHints( TComDataCU* pcCU, const UInt uiDepth, UInt& ruiNumAvail, UInt& ruiNumDeeper, UInt& ruiNumNotDeeper ) const
+{
+  ruiNumAvail     = 0;
+  ruiNumDeeper    = 0;
+  ruiNumNotDeeper = 0;
+
+  const UInt uiAbsPartIdx = pcCU->getZorderIdxInCtu();
+  UInt uiNbPartIdx;
+  const TComDataCU* pcNbCU;
+
+  pcNbCU = pcCU->getPULeft( uiNbPartIdx, uiAbsPartIdx );
+  if ( pcNbCU )
+  {
+    ruiNumAvail++;
+    ( pcNbCU->getDepth( uiNbPartIdx ) > uiDepth ? ruiNumDeeper : ruiNumNotDeeper )++;
+  }
+
+  pcNbCU = pcCU->getPUAbove( uiNbPartIdx, uiAbsPartIdx );
+  if ( pcNbCU )
+  {
+    ruiNumAvail++;
+    ( pcNbCU->getDepth( uiNbPartIdx ) > uiDepth ? ruiNumDeeper : ruiNumNotDeeper )++;
+  }
+
+  const TComSlice* pcSlice = pcCU->getSlice();
+  if ( pcSlice->isIntra() )
+  {
+    return;
+  }
+
+  const TComPic* pcColPic = pcSlice->getRefPic( RefPicList( pcSlice->isInterB() ? 1-pcSlice->getColFromL0Flag() : 0 ), pcSlice->getColRefIdx() );
+  if ( pcColPic == NULL )
+  {
+    return;
+  }
+#if REDUCED_ENCODER_MEMORY
+  if ( !pcColPic->getPicSym()->hasDPBPerCtuData() )
+  {
+    return;
+  }
+  const TComPicSym::DPBPerCtuData* const pcColCtu = &( pcColPic->getPicSym()->getDPBPerCtuData( pcCU->getCtuRsAddr() ) );
+#else
+  const TComDataCU* const pcColCtu = pcColPic->getCtu( pcCU->getCtuRsAddr() );
+#endif
+
+  UInt uiMinDepth = MAX_UINT;
+  UInt uiMaxDepth = 0;
+  for ( UInt uiPartIdx = uiAbsPartIdx; uiPartIdx < uiAbsPartIdx + pcCU->getTotalNumPart(); uiPartIdx++ )
+  {
+    const UInt uiColDepth = pcColCtu->getDepth( uiPartIdx );
+    uiMinDepth = std::min( uiMinDepth, uiColDepth );
+    uiMaxDepth = std::max( uiMaxDepth, uiColDepth );
+  }
+
+  ruiNumAvail++;
+  if ( uiMaxDepth > uiDepth )
+  {
+    ruiNumDeeper++;
+  }
+  if ( uiMinDepth <= uiDepth )
+  {
+    ruiNumNotDeeper++;
+  }
+}
+
+/** Compute the variance of the luma samples of a block, scaled to an 8-bit sample range
+ * \param pcYuv    pointer to the samples
+ * \param uiWidth  block width
+ * \param uiHeight block height
+ * \param bitDepth luma bit depth of the samples
+ * \returns variance
+ */
+UInt TEncCu::xGetLumaVariance( const TComYuv* pcYuv, const UInt uiWidth, const UInt uiHeight, const Int bitDepth ) const
+{
+  const Pel* pSrc    = pcYuv->getAddr( COMPONENT_Y );
+  const Int  iStride = pcYuv->getStride( COMPONENT_Y );
+  UInt64 uiSum   = 0;
+  UInt64 uiSumSq = 0;
+
+  for ( UInt y = 0; y < uiHeight; y++ )
+  {
+    for ( UInt x = 0; x < uiWidth; x++ )
+    {
+      const UInt64 uiVal = UInt64( pSrc[x] );
+      uiSum   += uiVal;
+      uiSumSq += uiVal * uiVal;
+    }
+    pSrc += iStride;
+  }
+
+  const UInt64 uiNumPel   = UInt64( uiWidth ) * uiHeight;
+  const UInt64 uiVariance = ( uiSumSq - uiSum * uiSum / uiNumPel ) / uiNumPel;
+  const Int    iShift     = 2 * ( bitDepth - 8 );
+
+  return UInt( iShift >= 0 ? uiVariance >> iShift : uiVariance << -iShift );
+}
+
 /** Function for filling the PCM buffer of a CU using its original sample array
  * \param pCU pointer to current CU
  * \param pOrgYuv pointer to original sample array
@@ -92,6 +92,7 @@ private:
 #if JVET_Y0077_BIM
   Int                     m_BimQPoffset;
 #endif
+  Double                  m_bestNonSplitCost[MAX_CU_DEPTH+1]; ///< best unsplit RD cost of the CU currently being compressed at each depth
 
   //  Access channel
   TEncCfg*                m_pcEncCfg;
@@ -110,6 +111,9 @@ private:
 public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
+  /// initialise with a separate set of tools (used to compress several CTUs concurrently)
+  Void  init                ( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost,
+                              TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl );
 
   Void       setSliceEncoder( TEncSlice* pSliceEncoder ) { m_pcSliceEncoder = pSliceEncoder; }
   TEncSlice* getSliceEncoder() { return m_pcSliceEncoder; }
@@ -191,6 +195,9 @@ protected:
 #endif
 
   Void  xFillPCMBuffer     ( TComDataCU* pCU, TComYuv* pOrgYuv );
+
+  Void  xGetNeighbourDepthHints( TComDataCU* pcCU, const UInt uiDepth, UInt& ruiNumAvail, UInt& ruiNumDeeper, UInt& ruiNumNotDeeper ) const;
+  UInt  xGetLumaVariance   ( const TComYuv* pcYuv, const UInt uiWidth, const UInt uiHeight, const Int bitDepth ) const;
 };
 
 //! \}
@@ -84,6 +84,7 @@ TEncGOP::TEncGOP()
   m_pcCfg               = NULL;
   m_pcSliceEncoder      = NULL;
   m_pcListPic           = NULL;
+  m_pcFrameThreadPool   = NULL;
 
   m_pcEntropyCoder      = NULL;
   m_pcCavlcCoder        = NULL;
@@ -145,6 +146,14 @@ Void TEncGOP::init ( TEncTop* pcTEncTop )
   m_lastBPSEI          = 0;
   m_totalCoded         = 0;
 
+  m_pcFrameThreadPool    = pcTEncTop->getFrameThreadPool();
+  m_frameSliceEncoders.clear();
+  for ( Int i = 0; i < pcTEncTop->getNumFrameSliceEncoders(); i++ )
+  {
+    m_frameSliceEncoders.push_back( pcTEncTop->getFrameSliceEncoder(i) );
+  }
+  xInitGOPEntryReferences();
+
 }
 
 #if MCTS_EXTRACTION
@@ -1225,440 +1234,70 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     m_pcCfg->setEncodedFlag(iGOPid, false);
   }
 
-  for ( Int iGOPid=0; iGOPid < m_iGopSize; iGOPid++ )
+  // release the interpolated planes of the pictures no longer used for reference; no picture is being compressed here
+  if ( m_pcCfg->getSubpelPlanes() > 0 )
   {
-    if (m_pcCfg->getEfficientFieldIRAPEnabled())
-    {
-      iGOPid=effFieldIRAPMap.adjustGOPid(iGOPid);
-    }
-
-    //-- For time output for each slice
-    clock_t iBeforeTime = clock();
-
-
-    /////////////////////////////////////////////////////////////////////////////////////////////////// Initial to start encoding
-    Int iTimeOffset;
-    Int pocCurr;
-
-    if(iPOCLast == 0) //case first frame or first top field
-    {
-      pocCurr=0;
-      iTimeOffset = 1;
-    }
-    else if(iPOCLast == 1 && isField) //case first bottom field, just like the first frame, the poc computation is not right anymore, we set the right value
+    for ( TComList<TComPic*>::iterator it = rcListPic.begin(); it != rcListPic.end(); it++ )
     {
-      pocCurr = 1;
-      iTimeOffset = 1;
-    }
-    else
-    {
-      pocCurr = iPOCLast - iNumPicRcvd + m_pcCfg->getGOPEntry(iGOPid).m_POC - ((isField && m_iGopSize>1) ? 1:0);
-      iTimeOffset = m_pcCfg->getGOPEntry(iGOPid).m_POC;
-    }
-
-    if(pocCurr>=m_pcCfg->getFramesToBeEncoded())
-    {
-      if (m_pcCfg->getEfficientFieldIRAPEnabled())
+      TEncPic* pcEncPic = dynamic_cast<TEncPic*>( *it );
+      if ( pcEncPic != NULL && !pcEncPic->getSlice(0)->isReferenced() )
       {
-        iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
+        pcEncPic->releaseSubpelPlanes();
       }
-      continue;
-    }
-
-    if( getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_W_RADL || getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_N_LP )
-    {
-      m_iLastIDR = pocCurr;
     }
-    // start a new access unit: create an entry in the list of output access units
-    accessUnitsInGOP.push_back(AccessUnit());
-    AccessUnit& accessUnit = accessUnitsInGOP.back();
-    xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, pocCurr, isField );
-
-#if REDUCED_ENCODER_MEMORY
-#if SHUTTER_INTERVAL_SEI_PROCESSING
-    pcPic->prepareForReconstruction( m_pcCfg->getShutterFilterFlag() );
-#else
-    pcPic->prepareForReconstruction();
-#endif
-
-#endif
-    //  Slice data initialization
-    pcPic->clearSliceBuffer();
-    pcPic->allocateNewSlice();
-    m_pcSliceEncoder->setSliceIdx(0);
-    pcPic->setCurrSliceIdx(0);
-
-    m_pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
-
-    pcSlice->setLastIDR(m_iLastIDR);
-    pcSlice->setSliceIdx(0);
-    //set default slice level flag to the same as SPS level flag
-    pcSlice->setLFCrossSliceBoundaryFlag(  pcSlice->getPPS()->getLoopFilterAcrossSlicesEnabledFlag()  );
+  }
 
-    if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='P')
-    {
-      pcSlice->setSliceType(P_SLICE);
-    }
-    if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='I')
-    {
-      pcSlice->setSliceType(I_SLICE);
-    }
-    
-    // Set the nal unit type
-    pcSlice->setNalUnitType(getNalUnitType(pocCurr, m_iLastIDR, isField));
-    if(pcSlice->getTemporalLayerNonReferenceFlag())
-    {
-      if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_TRAIL_R &&
-          !(m_iGopSize == 1 && pcSlice->getSliceType() == I_SLICE))
-        // Add this condition to avoid POC issues with encoder_intra_main.cfg configuration (see #1127 in bug tracker)
-      {
-        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TRAIL_N);
-      }
-      if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RADL_R)
-      {
-        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RADL_N);
-      }
-      if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RASL_R)
-      {
-        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RASL_N);
-      }
-    }
+  // state of the pictures of the GOP, and whether pictures that do not reference each other are compressed concurrently
+  std::vector<GOPPicture> gopPictures(m_iGopSize);
+  const Bool bCompressPicturesParallel = xUseParallelPictureCompression( iPOCLast, isField );
 
+  for ( Int iGOPid=0; iGOPid < m_iGopSize; iGOPid++ )
+  {
     if (m_pcCfg->getEfficientFieldIRAPEnabled())
     {
-      if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
-      {
-        m_associatedIRAPType = pcSlice->getNalUnitType();
-        m_associatedIRAPPOC = pocCurr;
-      }
-      pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
-      pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
-    }
-    // Do decoding refresh marking if any
-    pcSlice->decodingRefreshMarking(m_pocCRA, m_bRefreshPending, rcListPic, m_pcCfg->getEfficientFieldIRAPEnabled());
-    m_pcEncTop->selectReferencePictureSet(pcSlice, pocCurr, iGOPid);
-    if (!m_pcCfg->getEfficientFieldIRAPEnabled())
-    {
-      if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
-        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
-      {
-        m_associatedIRAPType = pcSlice->getNalUnitType();
-        m_associatedIRAPPOC = pocCurr;
-      }
-      pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
-      pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
-    }
-
-    if ((pcSlice->checkThatAllRefPicsAreAvailable(rcListPic, pcSlice->getRPS(), false, m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3) != 0) || (pcSlice->isIRAP()) 
-      || (m_pcCfg->getEfficientFieldIRAPEnabled() && isField && pcSlice->getAssociatedIRAPType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getAssociatedIRAPType() <= NAL_UNIT_CODED_SLICE_CRA && pcSlice->getAssociatedIRAPPOC() == pcSlice->getPOC()+1)
-      )
-    {
-      pcSlice->createExplicitReferencePictureSetFromReference(rcListPic, pcSlice->getRPS(), pcSlice->isIRAP(), m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3, m_pcCfg->getEfficientFieldIRAPEnabled());
-    }
-
-    pcSlice->applyReferencePictureSet(rcListPic, pcSlice->getRPS());
-
-    if(pcSlice->getTLayer() > 0 
-      &&  !( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_N     // Check if not a leading picture
-          || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_R
-          || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_N
-          || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_R )
-        )
-    {
-      if(pcSlice->isTemporalLayerSwitchingPoint(rcListPic) || pcSlice->getSPS()->getTemporalIdNestingFlag())
-      {
-        if(pcSlice->getTemporalLayerNonReferenceFlag())
-        {
-          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_N);
-        }
-        else
-        {
-          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_R);
-        }
-      }
-      else if(pcSlice->isStepwiseTemporalLayerSwitchingPointCandidate(rcListPic))
-      {
-        Bool isSTSA=true;
-        for(Int ii=iGOPid+1;(ii<m_pcCfg->getGOPSize() && isSTSA==true);ii++)
-        {
-          Int lTid= m_pcCfg->getGOPEntry(ii).m_temporalId;
-          if(lTid==pcSlice->getTLayer())
-          {
-            const TComReferencePictureSet* nRPS = pcSlice->getSPS()->getRPSList()->getReferencePictureSet(ii);
-            for(Int jj=0;jj<nRPS->getNumberOfPictures();jj++)
-            {
-              if(nRPS->getUsed(jj))
-              {
-                Int tPoc=m_pcCfg->getGOPEntry(ii).m_POC+nRPS->getDeltaPOC(jj);
-                Int kk=0;
-                for(kk=0;kk<m_pcCfg->getGOPSize();kk++)
-                {
-                  if(m_pcCfg->getGOPEntry(kk).m_POC==tPoc)
-                  {
-                    break;
-                  }
-                }
-                Int tTid=m_pcCfg->getGOPEntry(kk).m_temporalId;
-                if(tTid >= pcSlice->getTLayer())
-                {
-                  isSTSA=false;
-                  break;
-                }
-              }
-            }
-          }
-        }
-        if(isSTSA==true)
-        {
-          if(pcSlice->getTemporalLayerNonReferenceFlag())
-          {
-            pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_N);
-          }
-          else
-          {
-            pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_R);
-          }
-        }
-      }
-    }
-    arrangeLongtermPicturesInRPS(pcSlice, rcListPic);
-    TComRefPicListModification* refPicListModification = pcSlice->getRefPicListModification();
-    refPicListModification->setRefPicListModificationFlagL0(0);
-    refPicListModification->setRefPicListModificationFlagL1(0);
-    pcSlice->setNumRefIdx(REF_PIC_LIST_0,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
-    pcSlice->setNumRefIdx(REF_PIC_LIST_1,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
-
-    //  Set reference list
-    pcSlice->setRefPicList ( rcListPic );
-
-    //  Slice info. refinement
-    if ( (pcSlice->getSliceType() == B_SLICE) && (pcSlice->getNumRefIdx(REF_PIC_LIST_1) == 0) )
-    {
-      pcSlice->setSliceType ( P_SLICE );
-    }
-
-
-    if (pcSlice->getPOC() > m_RASPOCforResetEncoder && m_pcCfg->getResetEncoderStateAfterIRAP())
-    {
-      // need to reset encoder decisions.
-      m_pcSliceEncoder->resetEncoderDecisions();
-
-      if (pcSlice->getSPS()->getUseSAO())
-      {
-        m_pcSAO->resetEncoderDecisions();
-      }
-      m_RASPOCforResetEncoder=MAX_INT;
-    }
-    if (pcSlice->isIRAP())
-    {
-      m_RASPOCforResetEncoder = pcSlice->getPOC();
+      iGOPid=effFieldIRAPMap.adjustGOPid(iGOPid);
     }
 
-    pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
-#if MCTS_EXTRACTION
-    SliceType  encCABACTableIdx = pcSlice->getEncCABACTableIdx();
-    Bool encCabacInitFlag = (pcSlice->getSliceType() != encCABACTableIdx && encCABACTableIdx != I_SLICE) ? true : false;
-    pcSlice->setCabacInitFlag(encCabacInitFlag);
-#endif
-
-    if (pcSlice->getSliceType() == B_SLICE)
+    GOPPicture &gopPicture = gopPictures[iGOPid];
+    if ( !gopPicture.isSetUp )
     {
-      const UInt uiColFromL0 = calculateCollocatedFromL0Flag(pcSlice);
-      pcSlice->setColFromL0Flag(uiColFromL0);
-      Bool bLowDelay = true;
-      Int  iCurrPOC  = pcSlice->getPOC();
-      Int iRefIdx = 0;
-
-      for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_0) && bLowDelay; iRefIdx++)
-      {
-        if ( pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx)->getPOC() > iCurrPOC )
-        {
-          bLowDelay = false;
-        }
-      }
-      for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_1) && bLowDelay; iRefIdx++)
+      if ( !xInitPicture( gopPicture, m_pcSliceEncoder, iGOPid, iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut, accessUnitsInGOP, isField ) )
       {
-        if ( pcSlice->getRefPic(REF_PIC_LIST_1, iRefIdx)->getPOC() > iCurrPOC )
+        if (m_pcCfg->getEfficientFieldIRAPEnabled())
         {
-          bLowDelay = false;
+          iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
         }
+        continue;
       }
 
-      pcSlice->setCheckLDC(bLowDelay);
-    }
-    else
-    {
-      pcSlice->setCheckLDC(true);
-    }
-
-
-    //-------------------------------------------------------------
-    pcSlice->setRefPOCList();
-
-    pcSlice->setList1IdxToList0Idx();
-
-    if (m_pcEncTop->getTMVPModeId() == 2)
-    {
-      if (iGOPid == 0) // first picture in SOP (i.e. forward B)
+      if ( bCompressPicturesParallel )
       {
-        pcSlice->setEnableTMVPFlag(0);
+        // set up the following pictures that do not reference this one, and compress them all concurrently
+        xInitIndependentPictures( gopPictures, iGOPid, iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut, accessUnitsInGOP );
+        xCompressPicturesParallel( gopPictures, iGOPid );
       }
       else
       {
-        // Note: pcSlice->getColFromL0Flag() is assumed to be always 0 and getcolRefIdx() is always 0.
-        pcSlice->setEnableTMVPFlag(1);
-      }
-    }
-    else if (m_pcEncTop->getTMVPModeId() == 1)
-    {
-      pcSlice->setEnableTMVPFlag(1);
-    }
-    else
-    {
-      pcSlice->setEnableTMVPFlag(0);
-    }
-    
-    // set adaptive search range for non-intra-slices
-    if (m_pcCfg->getUseASR() && pcSlice->getSliceType()!=I_SLICE)
-    {
-      m_pcSliceEncoder->setSearchRange(pcSlice);
-    }
-
-    Bool bGPBcheck=false;
-    if ( pcSlice->getSliceType() == B_SLICE)
-    {
-      if ( pcSlice->getNumRefIdx(RefPicList( 0 ) ) == pcSlice->getNumRefIdx(RefPicList( 1 ) ) )
-      {
-        bGPBcheck=true;
-        Int i;
-        for ( i=0; i < pcSlice->getNumRefIdx(RefPicList( 1 ) ); i++ )
-        {
-          if ( pcSlice->getRefPOC(RefPicList(1), i) != pcSlice->getRefPOC(RefPicList(0), i) )
-          {
-            bGPBcheck=false;
-            break;
-          }
-        }
+        xCompressPicture( gopPicture );
       }
     }
-    if(bGPBcheck)
-    {
-      pcSlice->setMvdL1ZeroFlag(true);
-    }
-    else
+    else if ( !gopPicture.isCompressed || gopPicture.pcPic->getSlice(0)->getEncCABACTableIdx() != m_pcSliceEncoder->getEncCABACTableIdx() )
     {
-      pcSlice->setMvdL1ZeroFlag(false);
+      // the picture was set up before the earlier pictures of its group were written. It is compressed now if it references
+      // one of them, or again if the CABAC table chosen by writing them differs from the one used to compress it.
+      xSetEncCABACTableIdx( gopPicture.pcPic->getSlice(0) );
+      xCompressPicture( gopPicture );
     }
 
-
-    Double lambda            = 0.0;
+    pcPic          = gopPicture.pcPic;
+    pcPicYuvRecOut = gopPicture.pcPicYuvRecOut;
+    AccessUnit& accessUnit = *gopPicture.accessUnit;
+    const UInt uiNumSliceSegments = gopPicture.numSliceSegments;
     Int actualHeadBits       = 0;
     Int actualTotalBits      = 0;
-    Int estimatedBits        = 0;
     Int tmpBitsBeforeWriting = 0;
-    if ( m_pcCfg->getUseRateCtrl() ) // TODO: does this work with multiple slices and slice-segments?
-    {
-      Int frameLevel = m_pcRateCtrl->getRCSeq()->getGOPID2Level( iGOPid );
-      if ( pcPic->getSlice(0)->getSliceType() == I_SLICE )
-      {
-        frameLevel = 0;
-      }
-      m_pcRateCtrl->initRCPic( frameLevel );
-      estimatedBits = m_pcRateCtrl->getRCPic()->getTargetBits();
-
-      if (m_pcRateCtrl->getCpbSaturationEnabled() && frameLevel != 0)
-      {
-        Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
-
-        // prevent overflow
-        if (estimatedCpbFullness - estimatedBits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
-        {
-          estimatedBits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
-        }
-
-        estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
-        // prevent underflow
-        if (estimatedCpbFullness - estimatedBits < m_pcRateCtrl->getRCPic()->getLowerBound())
-        {
-          estimatedBits = max(200, estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound());
-        }
-
-        m_pcRateCtrl->getRCPic()->setTargetBits(estimatedBits);
-      }
 
-      Int sliceQP = m_pcCfg->getInitialQP();
-      if ( ( pcSlice->getPOC() == 0 && m_pcCfg->getInitialQP() > 0 ) || ( frameLevel == 0 && m_pcCfg->getForceIntraQP() ) ) // QP is specified
-      {
-        Int    NumberBFrames = ( m_pcCfg->getGOPSize() - 1 );
-        Double dLambda_scale = 1.0 - Clip3( 0.0, 0.5, 0.05*(Double)NumberBFrames );
-        Double dQPFactor     = 0.57*dLambda_scale;
-        Int    SHIFT_QP      = 12;
-        Int    bitdepth_luma_qp_scale = 0;
-        Double qp_temp = (Double) sliceQP + bitdepth_luma_qp_scale - SHIFT_QP;
-        lambda = dQPFactor*pow( 2.0, qp_temp/3.0 );
-      }
-      else if ( frameLevel == 0 )   // intra case, but use the model
-      {
-        m_pcSliceEncoder->calCostSliceI(pcPic); // TODO: This only analyses the first slice segment - what about the others?
-
-        if ( m_pcCfg->getIntraPeriod() != 1 )   // do not refine allocated bits for all intra case
-        {
-          Int bits = m_pcRateCtrl->getRCSeq()->getLeftAverageBits();
-          bits = m_pcRateCtrl->getRCPic()->getRefineBitsForIntra( bits );
-
-          if (m_pcRateCtrl->getCpbSaturationEnabled() )
-          {
-            Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
-
-            // prevent overflow
-            if (estimatedCpbFullness - bits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
-            {
-              bits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
-            }
-
-            estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
-            // prevent underflow
-            if (estimatedCpbFullness - bits < m_pcRateCtrl->getRCPic()->getLowerBound())
-            {
-              bits = estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound();
-            }
-          }
-
-          if ( bits < 200 )
-          {
-            bits = 200;
-          }
-          m_pcRateCtrl->getRCPic()->setTargetBits( bits );
-        }
-
-        list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
-        m_pcRateCtrl->getRCPic()->getLCUInitTargetBits();
-        lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
-        sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
-      }
-      else    // normal case
-      {
-        list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
-        lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
-        sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
-      }
-
-      sliceQP = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, sliceQP );
-      m_pcRateCtrl->getRCPic()->setPicEstQP( sliceQP );
-
-      m_pcSliceEncoder->resetQP( pcPic, sliceQP, lambda );
-    }
-
-    UInt uiNumSliceSegments = 1;
+    pcSlice = pcPic->getSlice(0);
 
     // Allocate some coders, now the number of tiles are known.
     const Int numSubstreamsColumns = (pcSlice->getPPS()->getNumTileColumnsMinus1() + 1);
@@ -1666,49 +1305,6 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     const Int numSubstreams        = numSubstreamRows * numSubstreamsColumns;
     std::vector<TComOutputBitstream> substreamsOut(numSubstreams);
 
-    // now compress (trial encode) the various slice segments (slices, and dependent slices)
-    {
-      const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
-      pcSlice->setSliceCurStartCtuTsAddr( 0 );
-      pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
-
-      for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
-      {
-        m_pcSliceEncoder->precompressSlice( pcPic );
-        m_pcSliceEncoder->compressSlice   ( pcPic, false, false );
-
-        const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
-        if (curSliceSegmentEnd < numberOfCtusInFrame)
-        {
-          const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
-          const UInt sliceBits=pcSlice->getSliceBits();
-          pcPic->allocateNewSlice();
-          // prepare for next slice
-          pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
-          m_pcSliceEncoder->setSliceIdx             ( uiNumSliceSegments   );
-          pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
-          assert(pcSlice->getPPS()!=0);
-          pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
-          pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
-          if (bNextSegmentIsDependentSlice)
-          {
-            pcSlice->setSliceBits(sliceBits);
-          }
-          else
-          {
-            pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
-            pcSlice->setSliceBits(0);
-          }
-          pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
-          pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
-          // TODO: optimise cabac_init during compress slice to improve multi-slice operation
-          // pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
-          uiNumSliceSegments ++;
-        }
-        nextCtuTsAddr = curSliceSegmentEnd;
-      }
-    }
-
     duData.clear();
     pcSlice = pcPic->getSlice(0);
 
@@ -1844,12 +1440,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         }
       }
 
-      pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
-#if MCTS_EXTRACTION
-      encCABACTableIdx = pcSlice->getEncCABACTableIdx();
-      encCabacInitFlag = (pcSlice->getSliceType() != encCABACTableIdx && encCABACTableIdx != I_SLICE) ? true : false;
-      pcSlice->setCabacInitFlag(encCabacInitFlag);
-#endif
+      xSetEncCABACTableIdx(pcSlice);
       tmpBitsBeforeWriting = m_pcEntropyCoder->getNumberOfWrittenBits();
       m_pcEntropyCoder->encodeSliceHeader(pcSlice);
       actualHeadBits += ( m_pcEntropyCoder->getNumberOfWrittenBits() - tmpBitsBeforeWriting );
@@ -1921,7 +1512,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     pcPic->compressMotion();
 
     //-- For time output for each slice
-    Double dEncTime = (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
+    Double dEncTime = (Double)(clock()-gopPicture.beforeTime) / CLOCKS_PER_SEC;
 
     std::string digestStr;
     if (m_pcCfg->getDecodedPictureHashSEIType()!=HASHTYPE_NONE)
@@ -1955,7 +1546,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       Double avgLambda = m_pcRateCtrl->getRCPic()->calAverageLambda();
       if ( avgLambda < 0.0 )
       {
-        avgLambda = lambda;
+        avgLambda = gopPicture.lambda;
       }
 
       m_pcRateCtrl->getRCPic()->updateAfterPicture( actualHeadBits, actualTotalBits, avgQP, avgLambda, pcSlice->getSliceType());
@@ -1968,7 +1559,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       }
       else    // for intra picture, the estimated bits are used to update the current status in the GOP
       {
-        m_pcRateCtrl->getRCGOP()->updateAfterPicture( estimatedBits );
+        m_pcRateCtrl->getRCGOP()->updateAfterPicture( gopPicture.estimatedBits );
       }
       if (m_pcRateCtrl->getCpbSaturationEnabled())
       {
@@ -2015,6 +1606,686 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   assert ( (m_iNumPicCoded == iNumPicRcvd) );
 }
 
+/** Sets up a picture of the GOP: picture buffer, slice header, reference picture set and lists, QP and lambda.
+ * \param gopPicture      state of the picture, filled in
+ * \param pcSliceEncoder  slice encoder setting up, and later compressing, the picture
+ * \returns false if the picture is beyond the end of the sequence
+ */
+Bool TEncGOP::xInitPicture( GOPPicture &gopPicture, TEncSlice* pcSliceEncoder, const Int iGOPid, const Int iPOCLast, const Int iNumPicRcvd,
+                            TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP, const Bool isField )
+{
+  //-- For time output for each slice
+  clock_t iBeforeTime = clock();
+
+  TComPic*        pcPic = NULL;
+  TComPicYuv*     pcPicYuvRecOut;
+  TComSlice*      pcSlice;
+
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////// Initial to start encoding
+  Int iTimeOffset;
+  Int pocCurr;
+
+  if(iPOCLast == 0) //case first frame or first top field
+  {
+    pocCurr=0;
+    iTimeOffset = 1;
+  }
+  else if(iPOCLast == 1 && isField) //case first bottom field, just like the first frame, the poc computation is not right anymore, we set the right value
+  {
+    pocCurr = 1;
+    iTimeOffset = 1;
+  }
+  else
+  {
+    pocCurr = iPOCLast - iNumPicRcvd + m_pcCfg->getGOPEntry(iGOPid).m_POC - ((isField && m_iGopSize>1) ? 1:0);
+    iTimeOffset = m_pcCfg->getGOPEntry(iGOPid).m_POC;
+  }
+
+  if(pocCurr>=m_pcCfg->getFramesToBeEncoded())
+  {
+    return false;
+  }
+
+  if( getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_W_RADL || getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_N_LP )
+  {
+    m_iLastIDR = pocCurr;
+  }
+  // start a new access unit: create an entry in the list of output access units
+  accessUnitsInGOP.push_back(AccessUnit());
+  xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, pocCurr, isField );
+
+#if REDUCED_ENCODER_MEMORY
+#if SHUTTER_INTERVAL_SEI_PROCESSING
+  pcPic->prepareForReconstruction( m_pcCfg->getShutterFilterFlag() );
+#else
+  pcPic->prepareForReconstruction();
+#endif
+
+#endif
+  //  Slice data initialization
+  pcPic->clearSliceBuffer();
+  pcPic->allocateNewSlice();
+  pcSliceEncoder->setSliceIdx(0);
+  pcPic->setCurrSliceIdx(0);
+
+  pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
+
+  pcSlice->setLastIDR(m_iLastIDR);
+  pcSlice->setSliceIdx(0);
+  //set default slice level flag to the same as SPS level flag
+  pcSlice->setLFCrossSliceBoundaryFlag(  pcSlice->getPPS()->getLoopFilterAcrossSlicesEnabledFlag()  );
+
+  if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='P')
+  {
+    pcSlice->setSliceType(P_SLICE);
+  }
+  if(pcSlice->getSliceType()==B_SLICE&&m_pcCfg->getGOPEntry(iGOPid).m_sliceType=='I')
+  {
+    pcSlice->setSliceType(I_SLICE);
+  }
+  
+  // Set the nal unit type
+  pcSlice->setNalUnitType(getNalUnitType(pocCurr, m_iLastIDR, isField));
+  if(pcSlice->getTemporalLayerNonReferenceFlag())
+  {
+    if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_TRAIL_R &&
+        !(m_iGopSize == 1 && pcSlice->getSliceType() == I_SLICE))
+      // Add this condition to avoid POC issues with encoder_intra_main.cfg configuration (see #1127 in bug tracker)
+    {
+      pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TRAIL_N);
+    }
+    if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RADL_R)
+    {
+      pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RADL_N);
+    }
+    if(pcSlice->getNalUnitType()==NAL_UNIT_CODED_SLICE_RASL_R)
+    {
+      pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_RASL_N);
+    }
+  }
+
+  if (m_pcCfg->getEfficientFieldIRAPEnabled())
+  {
+    if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
+    {
+      m_associatedIRAPType = pcSlice->getNalUnitType();
+      m_associatedIRAPPOC = pocCurr;
+    }
+    pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
+    pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
+  }
+  // Do decoding refresh marking if any
+  pcSlice->decodingRefreshMarking(m_pocCRA, m_bRefreshPending, rcListPic, m_pcCfg->getEfficientFieldIRAPEnabled());
+  m_pcEncTop->selectReferencePictureSet(pcSlice, pocCurr, iGOPid);
+  if (!m_pcCfg->getEfficientFieldIRAPEnabled())
+  {
+    if ( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_BLA_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_N_LP
+      || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA )  // IRAP picture
+    {
+      m_associatedIRAPType = pcSlice->getNalUnitType();
+      m_associatedIRAPPOC = pocCurr;
+    }
+    pcSlice->setAssociatedIRAPType(m_associatedIRAPType);
+    pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
+  }
+
+  if ((pcSlice->checkThatAllRefPicsAreAvailable(rcListPic, pcSlice->getRPS(), false, m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3) != 0) || (pcSlice->isIRAP()) 
+    || (m_pcCfg->getEfficientFieldIRAPEnabled() && isField && pcSlice->getAssociatedIRAPType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getAssociatedIRAPType() <= NAL_UNIT_CODED_SLICE_CRA && pcSlice->getAssociatedIRAPPOC() == pcSlice->getPOC()+1)
+    )
+  {
+    pcSlice->createExplicitReferencePictureSetFromReference(rcListPic, pcSlice->getRPS(), pcSlice->isIRAP(), m_iLastRecoveryPicPOC, m_pcCfg->getDecodingRefreshType() == 3, m_pcCfg->getEfficientFieldIRAPEnabled());
+  }
+
+  pcSlice->applyReferencePictureSet(rcListPic, pcSlice->getRPS());
+
+  if(pcSlice->getTLayer() > 0 
+    &&  !( pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_N     // Check if not a leading picture
+        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RADL_R
+        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_N
+        || pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_RASL_R )
+      )
+  {
+    if(pcSlice->isTemporalLayerSwitchingPoint(rcListPic) || pcSlice->getSPS()->getTemporalIdNestingFlag())
+    {
+      if(pcSlice->getTemporalLayerNonReferenceFlag())
+      {
+        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_N);
+      }
+      else
+      {
+        pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_TSA_R);
+      }
+    }
+    else if(pcSlice->isStepwiseTemporalLayerSwitchingPointCandidate(rcListPic))
+    {
+      Bool isSTSA=true;
+      for(Int ii=iGOPid+1;(ii<m_pcCfg->getGOPSize() && isSTSA==true);ii++)
+      {
+        Int lTid= m_pcCfg->getGOPEntry(ii).m_temporalId;
+        if(lTid==pcSlice->getTLayer())
+        {
+          const TComReferencePictureSet* nRPS = pcSlice->getSPS()->getRPSList()->getReferencePictureSet(ii);
+          for(Int jj=0;jj<nRPS->getNumberOfPictures();jj++)
+          {
+            if(nRPS->getUsed(jj))
+            {
+              Int tPoc=m_pcCfg->getGOPEntry(ii).m_POC+nRPS->getDeltaPOC(jj);
+              Int kk=0;
+              for(kk=0;kk<m_pcCfg->getGOPSize();kk++)
+              {
+                if(m_pcCfg->getGOPEntry(kk).m_POC==tPoc)
+                {
+                  break;
+                }
+              }
+              Int tTid=m_pcCfg->getGOPEntry(kk).m_temporalId;
+              if(tTid >= pcSlice->getTLayer())
+              {
+                isSTSA=false;
+                break;
+              }
+            }
+          }
+        }
+      }
+      if(isSTSA==true)
+      {
+        if(pcSlice->getTemporalLayerNonReferenceFlag())
+        {
+          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_N);
+        }
+        else
+        {
+          pcSlice->setNalUnitType(NAL_UNIT_CODED_SLICE_STSA_R);
+        }
+      }
+    }
+  }
+  arrangeLongtermPicturesInRPS(pcSlice, rcListPic);
+  TComRefPicListModification* refPicListModification = pcSlice->getRefPicListModification();
+  refPicListModification->setRefPicListModificationFlagL0(0);
+  refPicListModification->setRefPicListModificationFlagL1(0);
+  pcSlice->setNumRefIdx(REF_PIC_LIST_0,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
+  pcSlice->setNumRefIdx(REF_PIC_LIST_1,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
+
+  //  Set reference list
+  pcSlice->setRefPicList ( rcListPic );
+
+  //  Slice info. refinement
+  if ( (pcSlice->getSliceType() == B_SLICE) && (pcSlice->getNumRefIdx(REF_PIC_LIST_1) == 0) )
+  {
+    pcSlice->setSliceType ( P_SLICE );
+  }
+
+
+  if (pcSlice->getPOC() > m_RASPOCforResetEncoder && m_pcCfg->getResetEncoderStateAfterIRAP())
+  {
+    // need to reset encoder decisions.
+    m_pcSliceEncoder->resetEncoderDecisions();
+
+    if (pcSlice->getSPS()->getUseSAO())
+    {
+      m_pcSAO->resetEncoderDecisions();
+    }
+    m_RASPOCforResetEncoder=MAX_INT;
+  }
+  if (pcSlice->isIRAP())
+  {
+    m_RASPOCforResetEncoder = pcSlice->getPOC();
+  }
+
+  xSetEncCABACTableIdx(pcSlice);
+
+  if (pcSlice->getSliceType() == B_SLICE)
+  {
+    const UInt uiColFromL0 = calculateCollocatedFromL0Flag(pcSlice);
+    pcSlice->setColFromL0Flag(uiColFromL0);
+    Bool bLowDelay = true;
+    Int  iCurrPOC  = pcSlice->getPOC();
+    Int iRefIdx = 0;
+
+    for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_0) && bLowDelay; iRefIdx++)
+    {
+      if ( pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx)->getPOC() > iCurrPOC )
+      {
+        bLowDelay = false;
+      }
+    }
+    for (iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(REF_PIC_LIST_1) && bLowDelay; iRefIdx++)
+    {
+      if ( pcSlice->getRefPic(REF_PIC_LIST_1, iRefIdx)->getPOC() > iCurrPOC )
+      {
+        bLowDelay = false;
+      }
+    }
+
+    pcSlice->setCheckLDC(bLowDelay);
+  }
+  else
+  {
+    pcSlice->setCheckLDC(true);
+  }
+
+
+  //-------------------------------------------------------------
+  pcSlice->setRefPOCList();
+
+  pcSlice->setList1IdxToList0Idx();
+
+  if (m_pcEncTop->getTMVPModeId() == 2)
+  {
+    if (iGOPid == 0) // first picture in SOP (i.e. forward B)
+    {
+      pcSlice->setEnableTMVPFlag(0);
+    }
+    else
+    {
+      // Note: pcSlice->getColFromL0Flag() is assumed to be always 0 and getcolRefIdx() is always 0.
+      pcSlice->setEnableTMVPFlag(1);
+    }
+  }
+  else if (m_pcEncTop->getTMVPModeId() == 1)
+  {
+    pcSlice->setEnableTMVPFlag(1);
+  }
+  else
+  {
+    pcSlice->setEnableTMVPFlag(0);
+  }
+  
+  // set adaptive search range for non-intra-slices
+  if (m_pcCfg->getUseASR() && pcSlice->getSliceType()!=I_SLICE)
+  {
+    pcSliceEncoder->setSearchRange(pcSlice);
+  }
+
+  Bool bGPBcheck=false;
+  if ( pcSlice->getSliceType() == B_SLICE)
+  {
+    if ( pcSlice->getNumRefIdx(RefPicList( 0 ) ) == pcSlice->getNumRefIdx(RefPicList( 1 ) ) )
+    {
+      bGPBcheck=true;
+      Int i;
+      for ( i=0; i < pcSlice->getNumRefIdx(RefPicList( 1 ) ); i++ )
+      {
+        if ( pcSlice->getRefPOC(RefPicList(1), i) != pcSlice->getRefPOC(RefPicList(0), i) )
+        {
+          bGPBcheck=false;
+          break;
+        }
+      }
+    }
+  }
+  if(bGPBcheck)
+  {
+    pcSlice->setMvdL1ZeroFlag(true);
+  }
+  else
+  {
+    pcSlice->setMvdL1ZeroFlag(false);
+  }
+
+
+  Double lambda            = 0.0;
+  Int estimatedBits        = 0;
+  if ( m_pcCfg->getUseRateCtrl() ) // TODO: does this work with multiple slices and slice-segments?
+  {
+    Int frameLevel = m_pcRateCtrl->getRCSeq()->getGOPID2Level( iGOPid );
+    if ( pcPic->getSlice(0)->getSliceType() == I_SLICE )
+    {
+      frameLevel = 0;
+    }
+    m_pcRateCtrl->initRCPic( frameLevel );
+    estimatedBits = m_pcRateCtrl->getRCPic()->getTargetBits();
+
+    if (m_pcRateCtrl->getCpbSaturationEnabled() && frameLevel != 0)
+    {
+      Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
+
+      // prevent overflow
+      if (estimatedCpbFullness - estimatedBits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
+      {
+        estimatedBits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
+      }
+
+      estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
+      // prevent underflow
+      if (estimatedCpbFullness - estimatedBits < m_pcRateCtrl->getRCPic()->getLowerBound())
+      {
+        estimatedBits = max(200, estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound());
+      }
+
+      m_pcRateCtrl->getRCPic()->setTargetBits(estimatedBits);
+    }
+
+    Int sliceQP = m_pcCfg->getInitialQP();
+    if ( ( pcSlice->getPOC() == 0 && m_pcCfg->getInitialQP() > 0 ) || ( frameLevel == 0 && m_pcCfg->getForceIntraQP() ) ) // QP is specified
+    {
+      Int    NumberBFrames = ( m_pcCfg->getGOPSize() - 1 );
+      Double dLambda_scale = 1.0 - Clip3( 0.0, 0.5, 0.05*(Double)NumberBFrames );
+      Double dQPFactor     = 0.57*dLambda_scale;
+      Int    SHIFT_QP      = 12;
+      Int    bitdepth_luma_qp_scale = 0;
+      Double qp_temp = (Double) sliceQP + bitdepth_luma_qp_scale - SHIFT_QP;
+      lambda = dQPFactor*pow( 2.0, qp_temp/3.0 );
+    }
+    else if ( frameLevel == 0 )   // intra case, but use the model
+    {
+      pcSliceEncoder->calCostSliceI(pcPic); // TODO: This only analyses the first slice segment - what about the others?
+
+      if ( m_pcCfg->getIntraPeriod() != 1 )   // do not refine allocated bits for all intra case
+      {
+        Int bits = m_pcRateCtrl->getRCSeq()->getLeftAverageBits();
+        bits = m_pcRateCtrl->getRCPic()->getRefineBitsForIntra( bits );
+
+        if (m_pcRateCtrl->getCpbSaturationEnabled() )
+        {
+          Int estimatedCpbFullness = m_pcRateCtrl->getCpbState() + m_pcRateCtrl->getBufferingRate();
+
+          // prevent overflow
+          if (estimatedCpbFullness - bits > (Int)(m_pcRateCtrl->getCpbSize()*0.9f))
+          {
+            bits = estimatedCpbFullness - (Int)(m_pcRateCtrl->getCpbSize()*0.9f);
+          }
+
+          estimatedCpbFullness -= m_pcRateCtrl->getBufferingRate();
+          // prevent underflow
+          if (estimatedCpbFullness - bits < m_pcRateCtrl->getRCPic()->getLowerBound())
+          {
+            bits = estimatedCpbFullness - m_pcRateCtrl->getRCPic()->getLowerBound();
+          }
+        }
+
+        if ( bits < 200 )
+        {
+          bits = 200;
+        }
+        m_pcRateCtrl->getRCPic()->setTargetBits( bits );
+      }
+
+      list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
+      m_pcRateCtrl->getRCPic()->getLCUInitTargetBits();
+      lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
+      sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
+    }
+    else    // normal case
+    {
+      list<TEncRCPic*> listPreviousPicture = m_pcRateCtrl->getPicList();
+      lambda  = m_pcRateCtrl->getRCPic()->estimatePicLambda( listPreviousPicture, pcSlice->getSliceType());
+      sliceQP = m_pcRateCtrl->getRCPic()->estimatePicQP( lambda, listPreviousPicture );
+    }
+
+    sliceQP = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, sliceQP );
+    m_pcRateCtrl->getRCPic()->setPicEstQP( sliceQP );
+
+    pcSliceEncoder->resetQP( pcPic, sliceQP, lambda );
+  }
+
+  gopPicture.pcPic          = pcPic;
+  gopPicture.pcPicYuvRecOut = pcPicYuvRecOut;
+  gopPicture.pcSliceEncoder = pcSliceEncoder;
+  gopPicture.accessUnit     = &accessUnitsInGOP.back();
+  gopPicture.beforeTime     = iBeforeTime;
+  gopPicture.lambda         = lambda;
+  gopPicture.estimatedBits  = estimatedBits;
+  return true;
+}
+
+/** Compresses (trial encodes) the slice segments of a picture set up by xInitPicture.
+ * \param gopPicture  state of the picture
+ */
+Void TEncGOP::xCompressPicture( GOPPicture &gopPicture )
+{
+  TEncSlice* pcSliceEncoder = gopPicture.pcSliceEncoder;
+  TComPic*   pcPic          = gopPicture.pcPic;
+  TComSlice* pcSlice        = pcPic->getSlice(0);
+  UInt uiNumSliceSegments = 1;
+
+  pcSliceEncoder->setSliceIdx(0);
+  pcPic->setCurrSliceIdx(0);
+
+  // interpolated planes of the reference pictures, used by the fractional motion search
+  if ( m_pcCfg->getSubpelPlanes() > 0 )
+  {
+    for ( Int list = 0; list < NUM_REF_PIC_LIST_01; list++ )
+    {
+      for ( Int refIdx = 0; refIdx < pcSlice->getNumRefIdx( RefPicList( list ) ); refIdx++ )
+      {
+        TEncPic* pcRefPic = dynamic_cast<TEncPic*>( pcSlice->getRefPic( RefPicList( list ), refIdx ) );
+        if ( pcRefPic != NULL )
+        {
+          pcRefPic->prepareSubpelPlanes( m_pcCfg->getSubpelPlanes() > 1 );
+        }
+      }
+    }
+  }
+
+  // coarse motion vectors from the subsampled original pictures, used as start candidates of the motion search
+  if ( m_pcCfg->getUseHierarchicalME() )
+  {
+    m_pcEncTop->getHierarchicalME()->estimate( dynamic_cast<TEncPic*>( pcPic ), pcSlice );
+  }
+
+  // now compress (trial encode) the various slice segments (slices, and dependent slices)
+  {
+    const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
+    pcSlice->setSliceCurStartCtuTsAddr( 0 );
+    pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
+
+    for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
+    {
+      pcSliceEncoder->precompressSlice( pcPic );
+      pcSliceEncoder->compressSlice   ( pcPic, false, false );
+
+      const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
+      if (curSliceSegmentEnd < numberOfCtusInFrame)
+      {
+        const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
+        const UInt sliceBits=pcSlice->getSliceBits();
+        pcPic->allocateNewSlice();
+        // prepare for next slice
+        pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
+        pcSliceEncoder->setSliceIdx             ( uiNumSliceSegments   );
+        pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
+        assert(pcSlice->getPPS()!=0);
+        pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
+        pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
+        if (bNextSegmentIsDependentSlice)
+        {
+          pcSlice->setSliceBits(sliceBits);
+        }
+        else
+        {
+          pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
+          pcSlice->setSliceBits(0);
+        }
+        pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
+        pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
+        // TODO: optimise cabac_init during compress slice to improve multi-slice operation
+        // pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
+        uiNumSliceSegments ++;
+      }
+      nextCtuTsAddr = curSliceSegmentEnd;
+    }
+  }
+
+  gopPicture.numSliceSegments = uiNumSliceSegments;
+  gopPicture.isCompressed     = true;
+}
+
+/** Sets the CABAC initialisation table of a slice to the one chosen when writing the previous slice.
+ */
+Void TEncGOP::xSetEncCABACTableIdx( TComSlice* pcSlice )
+{
+  pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
+#if MCTS_EXTRACTION
+  SliceType  encCABACTableIdx = pcSlice->getEncCABACTableIdx();
+  Bool encCabacInitFlag = (pcSlice->getSliceType() != encCABACTableIdx && encCABACTableIdx != I_SLICE) ? true : false;
+  pcSlice->setCabacInitFlag(encCabacInitFlag);
+#endif
+}
+
+/** Builds the reference dependencies between the entries of the GOP: for each entry, the entries whose
+ *  pictures are used for reference by its reference picture set.
+ */
+Void TEncGOP::xInitGOPEntryReferences()
+{
+  const Int gopSize = m_pcCfg->getGOPSize();
+  m_gopEntryReferences.assign( gopSize, std::vector<Int>() );
+  for ( Int iGOPid = 0; iGOPid < gopSize; iGOPid++ )
+  {
+    const GOPEntry &entry = m_pcCfg->getGOPEntry( iGOPid );
+    for ( Int refIdx = 0; refIdx < entry.m_numRefPics; refIdx++ )
+    {
+      if ( !entry.m_usedByCurrPic[refIdx] )
+      {
+        continue;
+      }
+      const Int refPOC = entry.m_POC + entry.m_referencePics[refIdx];
+      for ( Int refGOPid = 0; refGOPid < gopSize; refGOPid++ )
+      {
+        if ( m_pcCfg->getGOPEntry( refGOPid ).m_POC == refPOC )
+        {
+          m_gopEntryReferences[iGOPid].push_back( refGOPid );
+        }
+      }
+    }
+  }
+}
+
+/** Checks whether pictures of the GOP that do not reference each other can be compressed concurrently,
+ *  resulting in the same bitstream as compressing them one after the other.
+ */
+Bool TEncGOP::xUseParallelPictureCompression( const Int iPOCLast, const Bool isField ) const
+{
+#if ENC_DEC_TRACE
+  return false;
+#else
+  // the efficient field IRAP coding order only applies to field coding
+  if ( m_frameSliceEncoders.empty() || iPOCLast == 0 || isField )
+  {
+    return false;
+  }
+  // the QP and lambda of each picture depend on the bits of the previous pictures
+  if ( m_pcCfg->getUseRateCtrl() )
+  {
+    return false;
+  }
+  // a picture is compressed again when its CABAC table has changed; this is only supported for a single slice segment
+  if ( m_pcCfg->getSliceMode() != NO_SLICES || m_pcCfg->getSliceSegmentMode() != NO_SLICES )
+  {
+    return false;
+  }
+  // the slice QP and weighted prediction parameters are chosen while compressing
+  if ( m_pcCfg->getDeltaQpRD() > 0 || m_pcCfg->getUseWP() || m_pcCfg->getWPBiPred() )
+  {
+    return false;
+  }
+#if ADAPTIVE_QP_SELECTION
+  // the ARL statistics of a picture are used by the next one
+  if ( m_pcCfg->getUseAdaptQpSelect() )
+  {
+    return false;
+  }
+#endif
+  // the lambda of the slice is updated for each CU
+  if ( m_pcCfg->getLumaLevelToDeltaQPMapping().isEnabled() )
+  {
+    return false;
+  }
+#if JVET_V0078
+  if ( m_pcCfg->getSmoothQPReductionEnable() )
+  {
+    return false;
+  }
+#endif
+#if JVET_Y0077_BIM
+  if ( m_pcCfg->getBIM() )
+  {
+    return false;
+  }
+#endif
+  return true;
+#endif
+}
+
+/** Sets up the pictures following gopPictures[firstGOPid] in coding order that do not reference it or each other,
+ *  according to the reference dependencies of the GOP entries, so that they are compressed concurrently with it.
+ *  A picture whose reference lists turn out to include a picture of the group is set up, but compressed after the
+ *  group has been written.
+ */
+Void TEncGOP::xInitIndependentPictures( std::vector<GOPPicture> &gopPictures, const Int firstGOPid, const Int iPOCLast, const Int iNumPicRcvd,
+                                        TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP )
+{
+  Int numPictures = 1;
+  for ( Int iGOPid = firstGOPid + 1; iGOPid < m_iGopSize && numPictures <= Int(m_frameSliceEncoders.size()); iGOPid++ )
+  {
+    Bool bIndependent = true;
+    for ( UInt i = 0; i < m_gopEntryReferences[iGOPid].size(); i++ )
+    {
+      const Int refGOPid = m_gopEntryReferences[iGOPid][i];
+      bIndependent &= ( refGOPid < firstGOPid || refGOPid >= iGOPid );
+    }
+    const Int pocCurr = iPOCLast - iNumPicRcvd + m_pcCfg->getGOPEntry(iGOPid).m_POC;
+    if ( !bIndependent || pocCurr >= m_pcCfg->getFramesToBeEncoded() )
+    {
+      break;
+    }
+    // IRAP pictures and pictures resetting the encoder decisions change the state used to write the earlier pictures
+    const NalUnitType nalUnitType = getNalUnitType( pocCurr, m_iLastIDR, false );
+    if ( ( nalUnitType >= NAL_UNIT_CODED_SLICE_BLA_W_LP && nalUnitType <= NAL_UNIT_RESERVED_IRAP_VCL23 ) ||
+         ( pocCurr > m_RASPOCforResetEncoder && m_pcCfg->getResetEncoderStateAfterIRAP() ) )
+    {
+      break;
+    }
+
+    GOPPicture &gopPicture = gopPictures[iGOPid];
+    xInitPicture( gopPicture, m_frameSliceEncoders[numPictures-1], iGOPid, iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut, accessUnitsInGOP, false );
+    gopPicture.isSetUp = true;
+
+    // the reference picture set may differ from the one of the GOP entry
+    const TComSlice* pcSlice = gopPicture.pcPic->getSlice(0);
+    for ( Int list = 0; list < NUM_REF_PIC_LIST_01; list++ )
+    {
+      for ( Int refIdx = 0; refIdx < pcSlice->getNumRefIdx( RefPicList(list) ); refIdx++ )
+      {
+        for ( Int groupGOPid = firstGOPid; groupGOPid < iGOPid; groupGOPid++ )
+        {
+          bIndependent &= ( pcSlice->getRefPOC( RefPicList(list), refIdx ) != gopPictures[groupGOPid].pcPic->getPOC() );
+        }
+      }
+    }
+    if ( !bIndependent )
+    {
+      break;
+    }
+    gopPicture.isIndependent = true;
+    numPictures++;
+  }
+}
+
+/** Compresses gopPictures[firstGOPid] and the pictures set up with it by xInitIndependentPictures concurrently.
+ */
+Void TEncGOP::xCompressPicturesParallel( std::vector<GOPPicture> &gopPictures, const Int firstGOPid )
+{
+  for ( Int iGOPid = firstGOPid + 1; iGOPid < m_iGopSize && gopPictures[iGOPid].isIndependent; iGOPid++ )
+  {
+    m_pcFrameThreadPool->addJob( [this, &gopPictures, iGOPid]( Int ) { xCompressPicture( gopPictures[iGOPid] ); } );
+  }
+  xCompressPicture( gopPictures[firstGOPid] );
+  m_pcFrameThreadPool->waitForJobs();
+}
+
 Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const TEncAnalyze::OutputLogControl &outputLogCtrl, const BitDepths &bitDepths)
 {
   assert (uiNumAllPicCoded == m_gcAnalyzeAll.getNumPic());
@@ -41,6 +41,7 @@
 #include <list>
 
 #include <stdlib.h>
+#include <time.h>
 
 #include "TLibCommon/TComList.h"
 #include "TLibCommon/TComPic.h"
@@ -84,6 +85,36 @@ class TEncGOP
     Int accumNalsDU;
   };
 
+  /// state of a picture of the GOP between its set-up, compression and writing
+  class GOPPicture
+  {
+  public:
+    GOPPicture()
+    :pcPic(NULL)
+    ,pcPicYuvRecOut(NULL)
+    ,pcSliceEncoder(NULL)
+    ,accessUnit(NULL)
+    ,beforeTime(0)
+    ,lambda(0.0)
+    ,estimatedBits(0)
+    ,numSliceSegments(1)
+    ,isSetUp(false)
+    ,isIndependent(false)
+    ,isCompressed(false) {};
+
+    TComPic*     pcPic;
+    TComPicYuv*  pcPicYuvRecOut;
+    TEncSlice*   pcSliceEncoder;    ///< slice encoder compressing the picture
+    AccessUnit*  accessUnit;
+    clock_t      beforeTime;        ///< start of the encoding of the picture
+    Double       lambda;            ///< lambda chosen by rate control
+    Int          estimatedBits;     ///< bits estimated by rate control
+    UInt         numSliceSegments;
+    Bool         isSetUp;           ///< set up while setting up an earlier picture of the GOP
+    Bool         isIndependent;     ///< compressed concurrently with an earlier picture of the GOP
+    Bool         isCompressed;
+  };
+
 private:
 
   TEncAnalyze             m_gcAnalyzeAll;
@@ -119,6 +150,10 @@ private:
   TEncSlice*              m_pcSliceEncoder;
   TComList<TComPic*>*     m_pcListPic;
 
+  TComThreadPool*                  m_pcFrameThreadPool;     ///< pool compressing pictures of the GOP concurrently
+  std::vector<TEncSlice*>          m_frameSliceEncoders;    ///< slice encoders of the pictures compressed on the pool
+  std::vector< std::vector<Int> >  m_gopEntryReferences;    ///< GOP entries referenced by each GOP entry
+
   TEncEntropy*            m_pcEntropyCoder;
   TEncCavlc*              m_pcCavlcCoder;
   TEncSbac*               m_pcSbacCoder;
@@ -191,6 +226,16 @@ protected:
   Void  xInitGOP          ( Int iPOCLast, Int iNumPicRcvd, Bool isField );
   Void  xGetBuffer        ( TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, Int pocCurr, Bool isField );
 
+  Bool  xInitPicture      ( GOPPicture &gopPicture, TEncSlice* pcSliceEncoder, const Int iGOPid, const Int iPOCLast, const Int iNumPicRcvd,
+                            TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP, const Bool isField );
+  Void  xCompressPicture  ( GOPPicture &gopPicture );
+  Void  xSetEncCABACTableIdx ( TComSlice* pcSlice );
+  Void  xInitGOPEntryReferences ();
+  Bool  xUseParallelPictureCompression ( const Int iPOCLast, const Bool isField ) const;
+  Void  xInitIndependentPictures  ( std::vector<GOPPicture> &gopPictures, const Int firstGOPid, const Int iPOCLast, const Int iNumPicRcvd,
+                                    TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP );
+  Void  xCompressPicturesParallel ( std::vector<GOPPicture> &gopPictures, const Int firstGOPid );
+
   Void  xCalculateAddPSNRs         ( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, TComPic* pcPic, const AccessUnit&accessUnit, TComList<TComPic*> &rcListPic, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y );
   Void  xCalculateAddPSNR          ( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit&, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y );
   Void  xCalculateInterlacedAddPSNR( TComPic* pcPicOrgFirstField, TComPic* pcPicOrgSecondField,
@@ -0,0 +1,284 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncHierarchicalME.cpp
+    \brief    hierarchical motion search on subsampled original pictures
+*/
+
+#include <algorithm>
+#include <limits>
+
+#include "TEncHierarchicalME.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+static const Int s_subBlockSize = HIERARCHICAL_ME_BLOCK_SIZE >> 1; ///< block size in both subsampled levels (8x8 and 16x16 at full resolution)
+static const Int s_padding      = 16;                              ///< margin of the subsampled pictures is s_padding + 16
+static const Int s_refineRange  = 2;                               ///< search range around the candidates from the 1/4 resolution level
+
+/** Constructor
+ */
+TEncHierarchicalME::TEncHierarchicalME()
+: m_iSearchRange(0)
+{
+}
+
+/** Destructor
+ */
+TEncHierarchicalME::~TEncHierarchicalME()
+{
+}
+
+/** Initialize the hierarchical motion search
+ * \param iSearchRange  search range of the coarse motion search, in full-resolution samples
+ */
+Void TEncHierarchicalME::init( Int iSearchRange )
+{
+  m_iSearchRange = iSearchRange;
+}
+
+/** Build the 1/2 and 1/4 resolution luma pyramid of the original picture, and clear its coarse motion vectors.
+ *  This is done once, when the picture is received, so that the pyramid is available when it is used as a reference.
+ * \param pcPic  picture to be analyzed
+ */
+Void TEncHierarchicalME::buildPyramid( TEncPic* pcPic ) const
+{
+  xSubsampleLuma( *pcPic->getPicYuvOrg(), *pcPic->getPicYuvOrgSub(0) );
+  xSubsampleLuma( *pcPic->getPicYuvOrgSub(0), *pcPic->getPicYuvOrgSub(1) );
+  pcPic->clearHierarchicalMvs( 0 );
+}
+
+/** Estimate a coarse motion vector for each 8x8 block of the picture and each reference picture of the slice.
+ *  A full search with 4x4 blocks on the 1/4 resolution pictures is refined with 4x4 blocks on the 1/2 resolution
+ *  pictures, starting from the vectors of the co-located and neighbouring blocks of the 1/4 resolution level.
+ * \param pcPic    picture to be encoded
+ * \param pcSlice  slice holding the reference picture lists
+ */
+Void TEncHierarchicalME::estimate( TEncPic* pcPic, const TComSlice* pcSlice ) const
+{
+  const TComSPS &sps     = *pcSlice->getSPS();
+  const UInt uiStride    = ( sps.getPicWidthInLumaSamples()  + HIERARCHICAL_ME_BLOCK_SIZE - 1 ) / HIERARCHICAL_ME_BLOCK_SIZE;
+  const UInt uiNumRows   = ( sps.getPicHeightInLumaSamples() + HIERARCHICAL_ME_BLOCK_SIZE - 1 ) / HIERARCHICAL_ME_BLOCK_SIZE;
+  const UInt uiParentStride  = ( uiStride  + 1 ) >> 1;
+  const UInt uiParentNumRows = ( uiNumRows + 1 ) >> 1;
+
+  pcPic->clearHierarchicalMvs( uiStride );
+  if ( pcSlice->isIntra() )
+  {
+    return;
+  }
+
+  std::vector<TComMv> parentMvs;
+  for ( Int list = 0; list < ( pcSlice->isInterB() ? NUM_REF_PIC_LIST_01 : 1 ); list++ )
+  {
+    const RefPicList eRefPicList = RefPicList( list );
+    for ( Int refIdx = 0; refIdx < pcSlice->getNumRefIdx( eRefPicList ); refIdx++ )
+    {
+      const TEncPic* pcRefPic = dynamic_cast<const TEncPic*>( pcSlice->getRefPic( eRefPicList, refIdx ) );
+      if ( pcRefPic == NULL || pcRefPic->getPicYuvOrgSub(1)->getAddr( COMPONENT_Y ) == NULL )
+      {
+        continue;
+      }
+      std::vector<TComMv> &mvs = pcPic->getHierarchicalMvs( eRefPicList, refIdx );
+
+      // a picture present in both lists (low-delay B) is only searched once
+      if ( list == REF_PIC_LIST_1 )
+      {
+        for ( Int refIdxL0 = 0; refIdxL0 < pcSlice->getNumRefIdx( REF_PIC_LIST_0 ) && mvs.empty(); refIdxL0++ )
+        {
+          if ( pcSlice->getRefPic( REF_PIC_LIST_0, refIdxL0 ) == pcSlice->getRefPic( REF_PIC_LIST_1, refIdx ) )
+          {
+            mvs = pcPic->getHierarchicalMvs( REF_PIC_LIST_0, refIdxL0 );
+          }
+        }
+        if ( !mvs.empty() )
+        {
+          continue;
+        }
+      }
+
+      xEstimateLevel( *pcPic->getPicYuvOrgSub(1), *pcRefPic->getPicYuvOrgSub(1), NULL, 0,
+                      parentMvs, uiParentStride, uiParentNumRows, ( m_iSearchRange + 3 ) >> 2 );
+      xEstimateLevel( *pcPic->getPicYuvOrgSub(0), *pcRefPic->getPicYuvOrgSub(0), &parentMvs, uiParentStride,
+                      mvs, uiStride, uiNumRows, s_refineRange );
+
+      // from 1/2 resolution samples to full-resolution quarter samples
+      for ( UInt i = 0; i < mvs.size(); i++ )
+      {
+        mvs[i] <<= 3;
+      }
+    }
+  }
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Subsample the luma of a picture by 2 in both directions, creating the output picture when needed
+ */
+Void TEncHierarchicalME::xSubsampleLuma( const TComPicYuv& rcInput, TComPicYuv& rcOutput ) const
+{
+  const Int iNewWidth  = rcInput.getWidth ( COMPONENT_Y ) >> 1;
+  const Int iNewHeight = rcInput.getHeight( COMPONENT_Y ) >> 1;
+  if ( rcOutput.getAddr( COMPONENT_Y ) == NULL )
+  {
+    rcOutput.createWithoutCUInfo( iNewWidth, iNewHeight, CHROMA_400, true, s_padding, s_padding );
+  }
+
+  const Pel* piSrc      = rcInput.getAddr  ( COMPONENT_Y );
+  const Int  iSrcStride = rcInput.getStride( COMPONENT_Y );
+        Pel* piDst      = rcOutput.getAddr  ( COMPONENT_Y );
+  const Int  iDstStride = rcOutput.getStride( COMPONENT_Y );
+
+  for ( Int y = 0; y < iNewHeight; y++, piSrc += 2 * iSrcStride, piDst += iDstStride )
+  {
+    const Pel* piRow      = piSrc;
+    const Pel* piRowBelow = piSrc + iSrcStride;
+    for ( Int x = 0; x < iNewWidth; x++, piRow += 2, piRowBelow += 2 )
+    {
+      piDst[x] = ( piRow[0] + piRow[1] + piRowBelow[0] + piRowBelow[1] + 2 ) >> 2;
+    }
+  }
+  rcOutput.extendPicBorder();
+}
+
+/** Estimate the motion of the 4x4 blocks of one level of the pyramid.
+ *  Without parent vectors, a full search around the zero vector is used; otherwise the doubled vectors of the parent
+ *  block and of its eight neighbours are tested, and the search is made around the best of them.
+ * \param rcOrg           subsampled original picture
+ * \param rcRef           subsampled reference picture, at the same level
+ * \param pcParentMvs     vectors of the level with half the resolution, or NULL
+ * \param uiParentStride  number of blocks in a row of the level with half the resolution
+ * \param rcMvs           returns the vector of each block, in samples of this level
+ * \param uiStride        number of blocks in a row
+ * \param uiNumRows       number of rows of blocks
+ * \param iRange          search range, in samples of this level
+ */
+Void TEncHierarchicalME::xEstimateLevel( const TComPicYuv& rcOrg, const TComPicYuv& rcRef, const std::vector<TComMv>* pcParentMvs,
+                                         UInt uiParentStride, std::vector<TComMv>& rcMvs, UInt uiStride, UInt uiNumRows, Int iRange ) const
+{
+  const Pel* piOrgOrigin = rcOrg.getAddr  ( COMPONENT_Y );
+  const Int  iOrgStride  = rcOrg.getStride( COMPONENT_Y );
+  const Pel* piRefOrigin = rcRef.getAddr  ( COMPONENT_Y );
+  const Int  iRefStride  = rcRef.getStride( COMPONENT_Y );
+  const Int  iWidth      = rcRef.getWidth ( COMPONENT_Y );
+  const Int  iHeight     = rcRef.getHeight( COMPONENT_Y );
+  const Int  iMarginX    = rcRef.getMarginX( COMPONENT_Y );
+  const Int  iMarginY    = rcRef.getMarginY( COMPONENT_Y );
+  const UInt uiParentNumRows = pcParentMvs == NULL ? 0 : UInt( pcParentMvs->size() ) / uiParentStride;
+
+  rcMvs.assign( uiStride * uiNumRows, TComMv() );
+
+  for ( UInt uiBlkY = 0; uiBlkY < uiNumRows; uiBlkY++ )
+  {
+    for ( UInt uiBlkX = 0; uiBlkX < uiStride; uiBlkX++ )
+    {
+      const Int  iPosX = uiBlkX * s_subBlockSize;
+      const Int  iPosY = uiBlkY * s_subBlockSize;
+      const Pel* piOrg = piOrgOrigin + iPosY * iOrgStride + iPosX;
+      const Pel* piRef = piRefOrigin + iPosY * iRefStride + iPosX;
+
+      // the reference block stays within the padded reference picture
+      const Int iMinX = -iMarginX - iPosX;
+      const Int iMaxX = iWidth  + iMarginX - s_subBlockSize - iPosX;
+      const Int iMinY = -iMarginY - iPosY;
+      const Int iMaxY = iHeight + iMarginY - s_subBlockSize - iPosY;
+
+      Int        iBestX    = 0;
+      Int        iBestY    = 0;
+      Distortion uiBestSad = xGetSAD( piOrg, iOrgStride, piRef, iRefStride, std::numeric_limits<Distortion>::max() );
+
+      if ( pcParentMvs != NULL )
+      {
+        for ( Int py = -1; py <= 1; py++ )
+        {
+          const Int iParentY = Int( uiBlkY >> 1 ) + py;
+          for ( Int px = -1; px <= 1; px++ )
+          {
+            const Int iParentX = Int( uiBlkX >> 1 ) + px;
+            if ( iParentX < 0 || iParentX >= Int( uiParentStride ) || iParentY < 0 || iParentY >= Int( uiParentNumRows ) )
+            {
+              continue;
+            }
+            const TComMv &rcParentMv = (*pcParentMvs)[iParentY * uiParentStride + iParentX];
+            const Int iCandX = Clip3( iMinX, iMaxX, 2 * rcParentMv.getHor() );
+            const Int iCandY = Clip3( iMinY, iMaxY, 2 * rcParentMv.getVer() );
+            const Distortion uiSad = xGetSAD( piOrg, iOrgStride, piRef + iCandY * iRefStride + iCandX, iRefStride, uiBestSad );
+            if ( uiSad < uiBestSad )
+            {
+              uiBestSad = uiSad;
+              iBestX    = iCandX;
+              iBestY    = iCandY;
+            }
+          }
+        }
+      }
+
+      const Int iCenterX = iBestX;
+      const Int iCenterY = iBestY;
+      for ( Int iDy = std::max( iMinY, iCenterY - iRange ); iDy <= std::min( iMaxY, iCenterY + iRange ); iDy++ )
+      {
+        for ( Int iDx = std::max( iMinX, iCenterX - iRange ); iDx <= std::min( iMaxX, iCenterX + iRange ); iDx++ )
+        {
+          const Distortion uiSad = xGetSAD( piOrg, iOrgStride, piRef + iDy * iRefStride + iDx, iRefStride, uiBestSad );
+          if ( uiSad < uiBestSad )
+          {
+            uiBestSad = uiSad;
+            iBestX    = iDx;
+            iBestY    = iDy;
+          }
+        }
+      }
+      rcMvs[uiBlkY * uiStride + uiBlkX] = TComMv( iBestX, iBestY );
+    }
+  }
+}
+
+/** Calculate the SAD of a 4x4 block, stopping early once it reaches uiBestSad
+ */
+Distortion TEncHierarchicalME::xGetSAD( const Pel* piOrg, Int iOrgStride, const Pel* piRef, Int iRefStride, Distortion uiBestSad ) const
+{
+  Distortion uiSad = 0;
+  for ( Int y = 0; y < s_subBlockSize && uiSad < uiBestSad; y++, piOrg += iOrgStride, piRef += iRefStride )
+  {
+    for ( Int x = 0; x < s_subBlockSize; x++ )
+    {
+      uiSad += abs( piOrg[x] - piRef[x] );
+    }
+  }
+  return uiSad;
+}
+
+//! \}
@@ -0,0 +1,77 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncHierarchicalME.h
+    \brief    hierarchical motion search on subsampled original pictures (header)
+*/
+
+#ifndef __TENCHIERARCHICALME__
+#define __TENCHIERARCHICALME__
+
+#include "TEncPic.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// hierarchical motion search class, providing coarse motion vectors used as start candidates of the integer motion search
+class TEncHierarchicalME
+{
+private:
+  Int   m_iSearchRange;                                 ///< search range of the coarse motion search, in full-resolution samples
+
+public:
+  TEncHierarchicalME();
+  virtual ~TEncHierarchicalME();
+
+  Void  init            ( Int iSearchRange );
+
+  /// build the 1/2 and 1/4 resolution luma pyramid of the original picture
+  Void  buildPyramid    ( TEncPic* pcPic ) const;
+
+  /// estimate a coarse MV per 8x8 block for each reference picture of the slice, from the pyramids of the original pictures
+  Void  estimate        ( TEncPic* pcPic, const TComSlice* pcSlice ) const;
+
+private:
+  Void  xSubsampleLuma  ( const TComPicYuv& rcInput, TComPicYuv& rcOutput ) const;
+  Void  xEstimateLevel  ( const TComPicYuv& rcOrg, const TComPicYuv& rcRef, const std::vector<TComMv>* pcParentMvs,
+                          UInt uiParentStride, std::vector<TComMv>& rcMvs, UInt uiStride, UInt uiNumRows, Int iRange ) const;
+  Distortion xGetSAD    ( const Pel* piOrg, Int iOrgStride, const Pel* piRef, Int iRefStride, Distortion uiBestSad ) const;
+};
+
+//! \}
+
+#endif // __TENCHIERARCHICALME__
@@ -35,7 +35,10 @@
     \brief    class of picture which includes side information for encoder
 */
 
+#include <algorithm>
+
 #include "TEncPic.h"
+#include "TLibCommon/TComInterpolationFilter.h"
 
 //! \ingroup TLibEncoder
 //! \{
@@ -105,6 +108,8 @@ Void TEncPicQPAdaptationLayer::destroy()
 TEncPic::TEncPic()
 : m_acAQLayer(NULL)
 , m_uiMaxAQDepth(0)
+, m_uiHierarchicalMvStride(0)
+, m_iSubpelPlanesPOC(MAX_INT)
 {
 }
 
@@ -165,7 +170,139 @@ Void TEncPic::destroy()
     delete[] m_acAQLayer;
     m_acAQLayer = NULL;
   }
+  for (Int level = 0; level < NUM_HIERARCHICAL_ME_LEVELS; level++)
+  {
+    m_acPicYuvOrgSub[level].destroy();
+  }
+  clearHierarchicalMvs( 0 );
+  releaseSubpelPlanes();
   TComPic::destroy();
 }
+
+/** Clear the coarse motion vectors of the hierarchical motion search
+ * \param uiStride  number of 8x8 blocks in a row of the picture
+ */
+Void TEncPic::clearHierarchicalMvs( UInt uiStride )
+{
+  m_uiHierarchicalMvStride = uiStride;
+  for (Int list = 0; list < NUM_REF_PIC_LIST_01; list++)
+  {
+    for (Int refIdx = 0; refIdx < MAX_NUM_REF; refIdx++)
+    {
+      m_acHierarchicalMvs[list][refIdx].clear();
+    }
+  }
+}
+
+/** Get the coarse motion vector of the hierarchical motion search covering a luma sample position
+ * \param eRefPicList  reference picture list
+ * \param iRefIdx      reference index
+ * \param iPosX        horizontal luma sample position
+ * \param iPosY        vertical luma sample position
+ * \param rcMv         returns the motion vector, in quarter-sample units
+ * \retval             false when no motion vector was estimated for the reference picture
+ */
+Bool TEncPic::getHierarchicalMv( RefPicList eRefPicList, Int iRefIdx, Int iPosX, Int iPosY, TComMv& rcMv ) const
+{
+  const std::vector<TComMv> &mvs = m_acHierarchicalMvs[eRefPicList][iRefIdx];
+  if (mvs.empty())
+  {
+    return false;
+  }
+  const UInt uiNumRows = UInt(mvs.size()) / m_uiHierarchicalMvStride;
+  const UInt uiBlkX    = std::min<UInt>( iPosX / HIERARCHICAL_ME_BLOCK_SIZE, m_uiHierarchicalMvStride - 1 );
+  const UInt uiBlkY    = std::min<UInt>( iPosY / HIERARCHICAL_ME_BLOCK_SIZE, uiNumRows - 1 );
+  rcMv = mvs[uiBlkY * m_uiHierarchicalMvStride + uiBlkX];
+  return true;
+}
+
+/** Interpolate the reconstructed luma at the sub-sample phases used by the fractional motion search, unless already
+ *  done for the current reconstruction. The planes have the margins of the reconstruction, and cover the area that the
+ *  clipped motion vectors can reach. Can be called concurrently by the pictures referencing this one.
+ * \param bQuarterSamplePlanes  false: the three half-sample phases only, true: all fifteen sub-sample phases
+ */
+Void TEncPic::prepareSubpelPlanes( Bool bQuarterSamplePlanes )
+{
+  std::lock_guard<std::mutex> lock( m_subpelPlanesMutex );
+
+  const TComPicYuv* pcPicYuvRec = getPicYuvRec();
+  const Int         iStep       = bQuarterSamplePlanes ? 1 : 2;
+  if ( m_iSubpelPlanesPOC == getPOC() && ( !bQuarterSamplePlanes || m_acPicYuvSubpel[1][1].getAddr( COMPONENT_Y ) != NULL ) )
+  {
+    return;
+  }
+  getPicYuvRec()->extendPicBorder();
+
+  const TComSPS&     sps        = getPicSym()->getSPS();
+  const ChromaFormat chFmt      = sps.getChromaFormatIdc();
+  const Int          iBitDepth  = sps.getBitDepth( CHANNEL_TYPE_LUMA );
+  const Int          iWidth     = pcPicYuvRec->getWidth  ( COMPONENT_Y );
+  const Int          iHeight    = pcPicYuvRec->getHeight ( COMPONENT_Y );
+  const Int          iMarginX   = pcPicYuvRec->getMarginX( COMPONENT_Y );
+  const Int          iMarginY   = pcPicYuvRec->getMarginY( COMPONENT_Y );
+  const Int          iStride    = pcPicYuvRec->getStride ( COMPONENT_Y );
+  const Int          iHalfTaps  = NTAPS_LUMA >> 1;
+
+  // samples whose filter taps stay inside the margins
+  const Int iStartX = iHalfTaps - 1 - iMarginX;
+  const Int iEndX   = iWidth + iMarginX - iHalfTaps;
+  const Int iStartY = iHalfTaps - 1 - iMarginY;
+  const Int iEndY   = iHeight + iMarginY - iHalfTaps;
+
+  TComInterpolationFilter cFilter;
+  std::vector<Pel>        cTmp( iStride * pcPicYuvRec->getTotalHeight( COMPONENT_Y ) );
+  Pel* const              piTmpOrigin = &cTmp[0] + iMarginY * iStride + iMarginX;
+  Pel*                    piRecOrigin = getPicYuvRec()->getAddr( COMPONENT_Y );
+
+  for ( Int iFracX = 0; iFracX < 4; iFracX += iStep )
+  {
+    // intermediate horizontally filtered samples, with the rows needed by the vertical filter
+    cFilter.filterHor( COMPONENT_Y, piRecOrigin + ( iStartY - iHalfTaps + 1 ) * iStride + iStartX, iStride,
+                       piTmpOrigin + ( iStartY - iHalfTaps + 1 ) * iStride + iStartX, iStride,
+                       iEndX - iStartX, iEndY - iStartY + NTAPS_LUMA - 1, iFracX, false, chFmt, iBitDepth );
+
+    for ( Int iFracY = 0; iFracY < 4; iFracY += iStep )
+    {
+      if ( iFracX == 0 && iFracY == 0 )
+      {
+        continue;
+      }
+      TComPicYuv& rcPlane = m_acPicYuvSubpel[iFracY][iFracX];
+      if ( rcPlane.getAddr( COMPONENT_Y ) == NULL )
+      {
+        rcPlane.createWithoutCUInfo( iWidth, iHeight, CHROMA_400, true, sps.getMaxCUWidth(), sps.getMaxCUHeight() );
+      }
+      cFilter.filterVer( COMPONENT_Y, piTmpOrigin + iStartY * iStride + iStartX, iStride,
+                         rcPlane.getAddr( COMPONENT_Y ) + iStartY * iStride + iStartX, iStride,
+                         iEndX - iStartX, iEndY - iStartY, iFracY, false, true, chFmt, iBitDepth );
+    }
+  }
+  m_iSubpelPlanesPOC = getPOC();
+}
+
+/** Release the interpolated planes, when the picture is no longer used for reference
+ */
+Void TEncPic::releaseSubpelPlanes()
+{
+  for ( Int iFracY = 0; iFracY < 4; iFracY++ )
+  {
+    for ( Int iFracX = 0; iFracX < 4; iFracX++ )
+    {
+      m_acPicYuvSubpel[iFracY][iFracX].destroy();
+    }
+  }
+  m_iSubpelPlanesPOC = MAX_INT;
+}
+
+/** Get an interpolated plane of the current reconstruction
+ * \param iFracY  vertical quarter-sample phase
+ * \param iFracX  horizontal quarter-sample phase
+ * \retval        NULL if the phase was not interpolated
+ */
+const TComPicYuv* TEncPic::getPicYuvSubpel( Int iFracY, Int iFracX ) const
+{
+  const TComPicYuv* pcPlane = &m_acPicYuvSubpel[iFracY][iFracX];
+  return ( m_iSubpelPlanesPOC == getPOC() && pcPlane->getAddr( COMPONENT_Y ) != NULL ) ? pcPlane : NULL;
+}
 //! \}
 
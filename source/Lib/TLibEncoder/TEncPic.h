@@ -38,8 +38,12 @@
 #ifndef __TENCPIC__
 #define __TENCPIC__
 
+#include <vector>
+#include <mutex>
+
 #include "TLibCommon/CommonDef.h"
 #include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComMv.h"
 
 //! \ingroup TLibEncoder
 //! \{
@@ -91,12 +95,18 @@ public:
   Void                   setAvgActivity( Double d )  { m_dAvgActivity = d; }
 };
 
-/// Picture class including local image characteristics information for QP adaptation
+/// Picture class including local image characteristics information for QP adaptation and hierarchical motion search
 class TEncPic : public TComPic
 {
 private:
   TEncPicQPAdaptationLayer* m_acAQLayer;
   UInt                      m_uiMaxAQDepth;
+  TComPicYuv                m_acPicYuvOrgSub[NUM_HIERARCHICAL_ME_LEVELS];                ///< original luma subsampled by 2 and by 4
+  UInt                      m_uiHierarchicalMvStride;                                    ///< number of 8x8 blocks in a row of the picture
+  std::vector<TComMv>       m_acHierarchicalMvs[NUM_REF_PIC_LIST_01][MAX_NUM_REF];       ///< coarse integer MV of each 8x8 block, per reference picture
+  TComPicYuv                m_acPicYuvSubpel[4][4];                                      ///< reconstructed luma interpolated at each [vertical][horizontal] quarter-sample phase, [0][0] unused
+  Int                       m_iSubpelPlanesPOC;                                          ///< POC of the reconstruction the planes were interpolated from, MAX_INT if none
+  std::mutex                m_subpelPlanesMutex;
 
 public:
   TEncPic();
@@ -119,6 +129,18 @@ public:
 
   TEncPicQPAdaptationLayer* getAQLayer( UInt uiDepth )  { return &m_acAQLayer[uiDepth]; }
   UInt                      getMaxAQDepth()             { return m_uiMaxAQDepth;        }
+
+  TComPicYuv*               getPicYuvOrgSub( Int iLevel )       { return &m_acPicYuvOrgSub[iLevel]; }
+  const TComPicYuv*         getPicYuvOrgSub( Int iLevel ) const { return &m_acPicYuvOrgSub[iLevel]; }
+
+  Void                      clearHierarchicalMvs( UInt uiStride );
+  std::vector<TComMv>&      getHierarchicalMvs( RefPicList eRefPicList, Int iRefIdx ) { return m_acHierarchicalMvs[eRefPicList][iRefIdx]; }
+  UInt                      getHierarchicalMvStride() const                          { return m_uiHierarchicalMvStride;                }
+  Bool                      getHierarchicalMv( RefPicList eRefPicList, Int iRefIdx, Int iPosX, Int iPosY, TComMv& rcMv ) const;
+
+  Void                      prepareSubpelPlanes( Bool bQuarterSamplePlanes );
+  Void                      releaseSubpelPlanes();
+  const TComPicYuv*         getPicYuvSubpel( Int iFracY, Int iFracX ) const;
 };
 
 //! \}
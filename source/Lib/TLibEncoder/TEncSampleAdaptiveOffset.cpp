@@ -283,12 +283,12 @@ Void TEncSampleAdaptiveOffset::addPreDBFStatistics(SAOStatData*** blkStats)
 
 Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Bool isCalculatePreDeblockSamples)
 {
-  Bool isLeftAvail,isRightAvail,isAboveAvail,isBelowAvail,isAboveLeftAvail,isAboveRightAvail,isBelowLeftAvail,isBelowRightAvail;
-
   const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
 
-  for(Int ctuRsAddr= 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
+  xForEachCtu( [&](Int ctuRsAddr)
   {
+    Bool isLeftAvail,isRightAvail,isAboveAvail,isBelowAvail,isAboveLeftAvail,isAboveRightAvail,isBelowLeftAvail,isBelowRightAvail;
+
     Int yPos   = (ctuRsAddr / m_numCTUInWidth)*m_maxCUHeight;
     Int xPos   = (ctuRsAddr % m_numCTUInWidth)*m_maxCUWidth;
     Int height = (yPos + m_maxCUHeight > m_picHeight)?(m_picHeight- yPos):m_maxCUHeight;
@@ -325,7 +325,7 @@ Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv
                 );
 
     }
-  }
+  } );
 }
 
 Void TEncSampleAdaptiveOffset::resetEncoderDecisions()
@@ -849,12 +849,20 @@ Void TEncSampleAdaptiveOffset::decideBlkParams(TComPic* pic, Bool* sliceEnabled,
 
     m_pcRDGoOnSbacCoder->load(m_pppcRDSbacCoder[ SAO_CABACSTATE_BLK_NEXT ]);
 
-    //apply reconstructed offsets
+    //reconstruct offsets
     reconParams[ctuRsAddr] = codedParams[ctuRsAddr];
     reconstructBlkSAOParam(reconParams[ctuRsAddr], mergeList);
-    offsetCTU(ctuRsAddr, srcYuv, resYuv, reconParams[ctuRsAddr], pic);
   } //ctuRsAddr
 
+  //apply reconstructed offsets, once the decisions that depend on the neighbouring CTUs have been made
+  if(!allBlksDisabled)
+  {
+    xForEachCtu( [&](Int ctuRsAddr)
+    {
+      offsetCTU(ctuRsAddr, srcYuv, resYuv, reconParams[ctuRsAddr], pic);
+    } );
+  }
+
   if (!allBlksDisabled && (totalCost >= 0) && bTestSAODisableAtPictureLevel) //SAO has not beneficial in this case - disable it
   {
     for(Int ctuRsAddr = 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
@@ -907,24 +915,10 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
                         , Bool isCalculatePreDeblockSamples
                         )
 {
-  if(m_lineBufWidth != m_maxCUWidth)
-  {
-    m_lineBufWidth = m_maxCUWidth;
-
-    if (m_signLineBuf1)
-    {
-      delete[] m_signLineBuf1;
-      m_signLineBuf1 = NULL;
-    }
-    m_signLineBuf1 = new SChar[m_lineBufWidth+1];
-
-    if (m_signLineBuf2)
-    {
-      delete[] m_signLineBuf2;
-      m_signLineBuf2 = NULL;
-    }
-    m_signLineBuf2 = new SChar[m_lineBufWidth+1];
-  }
+  // sign line buffers local to the call, so that CTUs can be processed by several threads
+  assert(m_maxCUWidth <= MAX_CU_SIZE);
+  SChar signLineBuf1[MAX_CU_SIZE+1];
+  SChar signLineBuf2[MAX_CU_SIZE+1];
 
   Int x,y, startX, startY, endX, endY, edgeType, firstLineStartX, firstLineEndX;
   SChar signLeft, signRight, signDown;
@@ -1000,7 +994,7 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
       {
         diff +=2;
         count+=2;
-        SChar *signUpLine = m_signLineBuf1;
+        SChar *signUpLine = signLineBuf1;
 
         startX = (!isCalculatePreDeblockSamples) ? 0
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : width)
@@ -1071,8 +1065,8 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
         count+=2;
         SChar *signUpLine, *signDownLine, *signTmpLine;
 
-        signUpLine  = m_signLineBuf1;
-        signDownLine= m_signLineBuf2;
+        signUpLine  = signLineBuf1;
+        signDownLine= signLineBuf2;
 
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
@@ -1156,7 +1150,7 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
       {
         diff +=2;
         count+=2;
-        SChar *signUpLine = m_signLineBuf1+1;
+        SChar *signUpLine = signLineBuf1+1;
 
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
@@ -39,6 +39,7 @@
 #include "TLibCommon/TComRom.h"
 #include "TLibCommon/TComMotionInfo.h"
 #include "TEncSearch.h"
+#include "TEncPic.h"
 #include "TLibCommon/TComTU.h"
 #include "TLibCommon/Debug.h"
 #include <math.h>
@@ -117,6 +118,7 @@ TEncSearch::TEncSearch()
 , m_pppcRDSbacCoder (NULL)
 , m_pcRDGoOnSbacCoder (NULL)
 , m_pTempPel (NULL)
+, m_pIntraSatdBatch (NULL)
 , m_isInitialized (false)
 {
   for (UInt ch=0; ch<MAX_NUM_COMPONENT; ch++)
@@ -157,6 +159,9 @@ Void TEncSearch::destroy()
     m_pTempPel = NULL;
   }
 
+  delete [] m_pIntraSatdBatch;
+  m_pIntraSatdBatch = NULL;
+
   if ( m_pcEncCfg )
   {
     const UInt uiNumLayersAllocated = m_pcEncCfg->getQuadtreeTULog2MaxSize()-m_pcEncCfg->getQuadtreeTULog2MinSize()+1;
@@ -267,6 +272,7 @@ Void TEncSearch::init(TEncCfg*       pcEncCfg,
   initTempBuff(cform);
 
   m_pTempPel = new Pel[maxCUWidth*maxCUHeight];
+  m_pIntraSatdBatch = new Pel[NUM_INTRA_SATD_BATCH_MODES*maxCUWidth*maxCUHeight];
 
   const UInt uiNumLayersToAllocate = pcEncCfg->getQuadtreeTULog2MaxSize()-pcEncCfg->getQuadtreeTULog2MinSize()+1;
   const UInt uiNumPartitions = 1<<(maxTotalCUDepth<<1);
@@ -419,6 +425,30 @@ __inline Void TEncSearch::xTZSearchHelp( const TComPattern* const pcPatternKey,
   }
 }
 
+/** Returns the cost (distortion and motion vector bits) of a start point of the integer motion search.
+ * \param pcCU          CU being searched
+ * \param pcPatternKey  pattern of the PU
+ * \param piRefY        luma samples of the reference picture at the position of the PU
+ * \param iRefStride    stride of the reference picture
+ * \param cMv           start point, in quarter-sample units
+ * \returns cost as evaluated by the search at the (clipped) integer position of cMv
+ */
+Distortion TEncSearch::xGetStartPointCost( const TComDataCU* const pcCU, const TComPattern* const pcPatternKey, const Pel* const piRefY, const Int iRefStride, TComMv cMv )
+{
+  pcCU->clipMv( cMv );
+#if ME_ENABLE_ROUNDING_OF_MVS
+  cMv.divideByPowerOf2(2);
+#else
+  cMv >>= 2;
+#endif
+  IntTZSearchStruct cStruct;
+  cStruct.iYStride  = iRefStride;
+  cStruct.piRefY    = piRefY;
+  cStruct.uiBestSad = std::numeric_limits<Distortion>::max();
+  xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+  return cStruct.uiBestSad;
+}
+
 __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB )
 {
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
@@ -820,17 +850,24 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
   } // iDist == 1
 }
 
+/** Refine the fractional motion vector around baseRefMv, on the blocks interpolated by xExtDIFUpSamplingH/Q, or on the
+ *  interpolated planes of the reference picture for the phases that have one.
+ * \param ppcSubpelPlanes  NULL, or the 16 [vertical][horizontal] quarter-sample phases of the reference picture, at the
+ *                         position of the integer motion vector, NULL for the phases without a plane
+ * \param iSubpelStride    stride of the planes
+ */
 Distortion TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
                                            TComMv baseRefMv,
                                            Int iFrac, TComMv& rcMvFrac,
-                                           Bool bAllowUseOfHadamard
+                                           Bool bAllowUseOfHadamard,
+                                           const Pel* const* ppcSubpelPlanes, Int iSubpelStride
                                          )
 {
   Distortion  uiDist;
   Distortion  uiDistBest  = std::numeric_limits<Distortion>::max();
   UInt        uiDirecBest = 0;
 
-  Pel*  piRefPos;
+  const Pel*  piRefPos;
   Int iRefStride = m_filteredBlock[0][0].getStride(COMPONENT_Y);
 
   m_pcRdCost->setDistParam( pcPatternKey, m_filteredBlock[0][0].getAddr(COMPONENT_Y), iRefStride, 1, m_cDistParam, m_pcEncCfg->getUseHADME() && bAllowUseOfHadamard );
@@ -869,14 +906,25 @@ Distortion TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
 
     Int horVal = cMvTest.getHor() * iFrac;
     Int verVal = cMvTest.getVer() * iFrac;
-    piRefPos = m_filteredBlock[ verVal & 3 ][ horVal & 3 ].getAddr(COMPONENT_Y);
-    if ( horVal == 2 && ( verVal & 1 ) == 0 )
+    const Pel* piPlane = ppcSubpelPlanes != NULL ? ppcSubpelPlanes[ ( ( verVal & 3 ) << 2 ) + ( horVal & 3 ) ] : NULL;
+    if ( piPlane != NULL )
     {
-      piRefPos += 1;
+      // horVal and verVal are quarter-sample offsets from the integer motion vector
+      piRefPos = piPlane + ( verVal >> 2 ) * iSubpelStride + ( horVal >> 2 );
+      m_cDistParam.iStrideCur = iSubpelStride;
     }
-    if ( ( horVal & 1 ) == 0 && verVal == 2 )
+    else
     {
-      piRefPos += iRefStride;
+      m_cDistParam.iStrideCur = iRefStride;
+      piRefPos = m_filteredBlock[ verVal & 3 ][ horVal & 3 ].getAddr(COMPONENT_Y);
+      if ( horVal == 2 && ( verVal & 1 ) == 0 )
+      {
+        piRefPos += 1;
+      }
+      if ( ( horVal & 1 ) == 0 && verVal == 2 )
+      {
+        piRefPos += iRefStride;
+      }
     }
     cMvTest = pcMvRefine[i];
     cMvTest += rcMvFrac;
@@ -1279,7 +1327,7 @@ Void TEncSearch::xIntraCodingTUBlock(       TComYuv*    pcOrgYuv,
 
   //===== transform and quantization =====
   //--- init rate estimation arrays for RDOQ ---
-  if( useTransformSkip ? m_pcEncCfg->getUseRDOQTS() : m_pcEncCfg->getUseRDOQ() )
+  if( useTransformSkip ? m_pcTrQuant->getUseRDOQTS() : m_pcTrQuant->getUseRDOQ() )
   {
     COEFF_SCAN_TYPE scanType = COEFF_SCAN_TYPE(pcCU->getCoefScanIdx(uiAbsPartIdx, uiWidth, uiHeight, compID));
     m_pcEntropyCoder->estimateBit( m_pcTrQuant->m_pcEstBitsSbac, uiWidth, uiHeight, chType, scanType );
@@ -2267,6 +2315,10 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
     Int numModesAvailable     = 35; //total number of Intra modes
     UInt uiRdModeList[FAST_UDI_MAX_RDMODE_NUM];
     Int numModesForFullRD = m_pcEncCfg->getFastUDIUseMPMEnabled()?g_aucIntraModeNumFast_UseMPM[ uiWidthBit ] : g_aucIntraModeNumFast_NotUseMPM[ uiWidthBit ];
+    if (m_pcEncCfg->getFastUDINumModes() > 0)
+    {
+      numModesForFullRD = std::min<Int>( m_pcEncCfg->getFastUDINumModes(), numModesAvailable );
+    }
 
     // this should always be true
     assert (tuRecurseWithPU.ProcessComponentSection(COMPONENT_Y));
@@ -2287,36 +2339,48 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
       const UInt uiAbsPartIdx=tuRecurseWithPU.GetAbsPartIdxTU();
 
       Pel* piOrg         = pcOrgYuv ->getAddr( COMPONENT_Y, uiAbsPartIdx );
-      Pel* piPred        = pcPredYuv->getAddr( COMPONENT_Y, uiAbsPartIdx );
-      UInt uiStride      = pcPredYuv->getStride( COMPONENT_Y );
+      UInt uiStride      = pcOrgYuv->getStride( COMPONENT_Y );
+      const Int predStride = puRect.width;
+      const Int predSize   = puRect.width * puRect.height;
       DistParam distParam;
       const Bool bUseHadamard=pcCU->getCUTransquantBypass(0) == 0;
-      m_pcRdCost->setDistParam(distParam, sps.getBitDepth(CHANNEL_TYPE_LUMA), piOrg, uiStride, piPred, uiStride, puRect.width, puRect.height, bUseHadamard);
+      m_pcRdCost->setDistParam(distParam, sps.getBitDepth(CHANNEL_TYPE_LUMA), piOrg, uiStride, m_pIntraSatdBatch, predStride, puRect.width, puRect.height, bUseHadamard);
       distParam.bApplyWeight = false;
-      for( Int modeIdx = 0; modeIdx < numModesAvailable; modeIdx++ )
+
+      // NB xModeBitsIntraLuma will not affect the mode for chroma that may have already been pre-estimated.
+      UInt modeBits[NUM_INTRA_MODE];
+      xModeBitsIntraLuma( pcCU, uiPartOffset, uiDepth, modeBits );
+
+      for( Int modeBase = 0; modeBase < numModesAvailable; modeBase += NUM_INTRA_SATD_BATCH_MODES )
       {
-        UInt       uiMode = modeIdx;
-        Distortion uiSad  = 0;
+        const Int numModesInBatch = std::min<Int>( NUM_INTRA_SATD_BATCH_MODES, numModesAvailable - modeBase );
 
-        const Bool bUseFilter=TComPrediction::filteringIntraReferenceSamples(COMPONENT_Y, uiMode, puRect.width, puRect.height, chFmt, sps.getSpsRangeExtension().getIntraSmoothingDisabledFlag());
+        // predict the modes of the batch into consecutive blocks
+        for( Int i = 0; i < numModesInBatch; i++ )
+        {
+          const UInt uiMode    = modeBase + i;
+          const Bool bUseFilter=TComPrediction::filteringIntraReferenceSamples(COMPONENT_Y, uiMode, puRect.width, puRect.height, chFmt, sps.getSpsRangeExtension().getIntraSmoothingDisabledFlag());
 
-        predIntraAng( COMPONENT_Y, uiMode, piOrg, uiStride, piPred, uiStride, tuRecurseWithPU, bUseFilter, TComPrediction::UseDPCMForFirstPassIntraEstimation(tuRecurseWithPU, uiMode) );
+          predIntraAng( COMPONENT_Y, uiMode, piOrg, uiStride, m_pIntraSatdBatch + i * predSize, predStride, tuRecurseWithPU, bUseFilter, TComPrediction::UseDPCMForFirstPassIntraEstimation(tuRecurseWithPU, uiMode) );
+        }
 
         // use hadamard transform here
-        uiSad+=distParam.DistFunc(&distParam);
-
-        UInt   iModeBits = 0;
+        for( Int i = 0; i < numModesInBatch; i++ )
+        {
+          const UInt uiMode = modeBase + i;
+          distParam.pCur    = m_pIntraSatdBatch + i * predSize;
 
-        // NB xModeBitsIntra will not affect the mode for chroma that may have already been pre-estimated.
-        iModeBits+=xModeBitsIntra( pcCU, uiMode, uiPartOffset, uiDepth, CHANNEL_TYPE_LUMA );
+          const Distortion uiSad     = distParam.DistFunc(&distParam);
+          const UInt       iModeBits = modeBits[uiMode];
 
-        Double cost      = (Double)uiSad + (Double)iModeBits * sqrtLambdaForFirstPass;
+          Double cost      = (Double)uiSad + (Double)iModeBits * sqrtLambdaForFirstPass;
 
 #if DEBUG_INTRA_SEARCH_COSTS
-        std::cout << "1st pass mode " << uiMode << " SAD = " << uiSad << ", mode bits = " << iModeBits << ", cost = " << cost << "\n";
+          std::cout << "1st pass mode " << uiMode << " SAD = " << uiSad << ", mode bits = " << iModeBits << ", cost = " << cost << "\n";
 #endif
 
-        CandNum += xUpdateCandList( uiMode, cost, numModesForFullRD, uiRdModeList, CandCostList );
+          CandNum += xUpdateCandList( uiMode, cost, numModesForFullRD, uiRdModeList, CandCostList );
+        }
       }
       (Void)CandNum; // Avoid compiler warning: CandNum is never used
 
@@ -3827,6 +3891,30 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   m_pcRdCost->setCostScale  ( 2 );
 
   setWpScalingDistParam( pcCU, iRefIdxPred, eRefPicList );
+
+  // coarse MV of the hierarchical motion search at the centre of the PU: when it is a better start point than the
+  // predictor, the search window is centred on it, so that the search range may be smaller than the motion
+  TComMv        cHierarchicalMv;
+  const TComMv* pHierarchicalMvPred = 0;
+  if ( !bBi && m_motionEstimationSearchMethod != MESEARCH_FULL && m_pcEncCfg->getUseHierarchicalME() )
+  {
+    const TEncPic* pcEncPic = dynamic_cast<const TEncPic*>( pcCU->getPic() );
+    const Int      iPosX    = pcCU->getCUPelX() + g_auiRasterToPelX[ g_auiZscanToRaster[ uiPartAddr ] ] + ( iRoiWidth  >> 1 );
+    const Int      iPosY    = pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[ uiPartAddr ] ] + ( iRoiHeight >> 1 );
+    if ( pcEncPic != NULL && pcEncPic->getHierarchicalMv( eRefPicList, iRefIdxPred, iPosX, iPosY, cHierarchicalMv ) )
+    {
+      pHierarchicalMvPred = &cHierarchicalMv;
+      if ( xGetStartPointCost( pcCU, &cPattern, piRefY, iRefStride, cHierarchicalMv ) < xGetStartPointCost( pcCU, &cPattern, piRefY, iRefStride, cMvPred ) )
+      {
+#if MCTS_ENC_CHECK
+        xSetSearchRange(pcCU, cHierarchicalMv, iSrchRng, cMvSrchRngLT, cMvSrchRngRB, &cPattern);
+#else
+        xSetSearchRange(pcCU, cHierarchicalMv, iSrchRng, cMvSrchRngLT, cMvSrchRngRB);
+#endif
+      }
+    }
+  }
+
   //  Do integer search
   if ( (m_motionEstimationSearchMethod==MESEARCH_FULL) || bBi )
   {
@@ -3840,7 +3928,7 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
     {
       pIntegerMv2Nx2NPred = &(m_integerMv2Nx2N[eRefPicList][iRefIdxPred]);
     }
-    xPatternSearchFast  ( pcCU, &cPattern, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost, pIntegerMv2Nx2NPred );
+    xPatternSearchFast  ( pcCU, &cPattern, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost, pIntegerMv2Nx2NPred, pHierarchicalMvPred );
     if (pcCU->getPartitionSize(0) == SIZE_2Nx2N)
     {
       m_integerMv2Nx2N[eRefPicList][iRefIdxPred] = rcMv;
@@ -3851,7 +3939,25 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   m_pcRdCost->setCostScale ( 1 );
 
   const Bool bIsLosslessCoded = pcCU->getCUTransquantBypass(uiPartAddr) != 0;
-  xPatternSearchFracDIF( bIsLosslessCoded, &cPattern, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost );
+  // interpolated planes of the reference picture, at the position of the PU
+  const Pel* apcSubpelPlanes[16];
+  const Pel* const* ppcSubpelPlanes = NULL;
+  if ( m_pcEncCfg->getSubpelPlanes() > 0 )
+  {
+    const TEncPic* pcRefEncPic = dynamic_cast<const TEncPic*>( pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred ) );
+    if ( pcRefEncPic != NULL && pcRefEncPic->getPicYuvSubpel( 2, 2 ) != NULL )
+    {
+      const Int iPosOffset = Int( piRefY - pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->getPicYuvRec()->getAddr( COMPONENT_Y ) );
+      for ( Int i = 0; i < 16; i++ )
+      {
+        const TComPicYuv* pcPlane = i == 0 ? NULL : pcRefEncPic->getPicYuvSubpel( i >> 2, i & 3 );
+        apcSubpelPlanes[i] = pcPlane != NULL ? pcPlane->getAddr( COMPONENT_Y ) + iPosOffset : NULL;
+      }
+      apcSubpelPlanes[0] = piRefY;
+      ppcSubpelPlanes    = apcSubpelPlanes;
+    }
+  }
+  xPatternSearchFracDIF( bIsLosslessCoded, &cPattern, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost, ppcSubpelPlanes );
 
   m_pcRdCost->setCostScale( 0 );
   rcMv <<= 2;
@@ -4016,7 +4122,8 @@ Void TEncSearch::xPatternSearchFast( const TComDataCU* const  pcCU,
                                      const TComMv* const      pcMvSrchRngRB,
                                      TComMv&                  rcMv,
                                      Distortion&              ruiSAD,
-                                     const TComMv* const      pIntegerMv2Nx2NPred )
+                                     const TComMv* const      pIntegerMv2Nx2NPred,
+                                     const TComMv* const      pHierarchicalMvPred )
 {
   assert (MD_LEFT < NUM_MV_PREDICTORS);
   pcCU->getMvPredLeft       ( m_acMvPredictors[MD_LEFT] );
@@ -4028,15 +4135,15 @@ Void TEncSearch::xPatternSearchFast( const TComDataCU* const  pcCU,
   switch ( m_motionEstimationSearchMethod )
   {
     case MESEARCH_DIAMOND:
-      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, false );
+      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, pHierarchicalMvPred, false );
       break;
 
     case MESEARCH_SELECTIVE:
-      xTZSearchSelective( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred );
+      xTZSearchSelective( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, pHierarchicalMvPred );
       break;
 
     case MESEARCH_DIAMOND_ENHANCED:
-      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, true );
+      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, pHierarchicalMvPred, true );
       break;
 
     case MESEARCH_FULL: // shouldn't get here.
@@ -4055,6 +4162,7 @@ Void TEncSearch::xTZSearch( const TComDataCU* const pcCU,
                             TComMv&                  rcMv,
                             Distortion&              ruiSAD,
                             const TComMv* const      pIntegerMv2Nx2NPred,
+                            const TComMv* const      pHierarchicalMvPred,
                             const Bool               bExtendedSettings)
 {
   const Bool bUseAdaptiveRaster                      = bExtendedSettings;
@@ -4126,6 +4234,22 @@ Void TEncSearch::xTZSearch( const TComDataCU* const pcCU,
     }
   }
 
+  // test whether the coarse MV of the hierarchical motion search is a better start point
+  if ( pHierarchicalMvPred != 0 )
+  {
+    TComMv cMv = *pHierarchicalMvPred;
+    pcCU->clipMv( cMv );
+#if ME_ENABLE_ROUNDING_OF_MVS
+    cMv.divideByPowerOf2(2);
+#else
+    cMv >>= 2;
+#endif
+    if (cMv.getHor() != cStruct.iBestX || cMv.getVer() != cStruct.iBestY)
+    {
+      xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+    }
+  }
+
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
   Int   iSrchRngHorRight  = pcMvSrchRngRB->getHor();
   Int   iSrchRngVerTop    = pcMvSrchRngLT->getVer();
@@ -4362,7 +4486,8 @@ Void TEncSearch::xTZSearchSelective( const TComDataCU* const   pcCU,
                                      const TComMv* const       pcMvSrchRngRB,
                                      TComMv                   &rcMv,
                                      Distortion               &ruiSAD,
-                                     const TComMv* const       pIntegerMv2Nx2NPred )
+                                     const TComMv* const       pIntegerMv2Nx2NPred,
+                                     const TComMv* const       pHierarchicalMvPred )
 {
   const Bool bTestOtherPredictedMV    = true;
   const Bool bTestZeroVector          = true;
@@ -4431,6 +4556,19 @@ Void TEncSearch::xTZSearchSelective( const TComDataCU* const   pcCU,
     xTZSearchHelp( pcPatternKey, cStruct, 0, 0, 0, 0 );
   }
 
+  // test whether the coarse MV of the hierarchical motion search is a better start point
+  if ( pHierarchicalMvPred != 0 )
+  {
+    TComMv cMv = *pHierarchicalMvPred;
+    pcCU->clipMv( cMv );
+#if ME_ENABLE_ROUNDING_OF_MVS
+    cMv.divideByPowerOf2(2);
+#else
+    cMv >>= 2;
+#endif
+    xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+  }
+
   if ( pIntegerMv2Nx2NPred != 0 )
   {
     TComMv integerMv2Nx2NPred = *pIntegerMv2Nx2NPred;
@@ -4544,7 +4682,8 @@ Void TEncSearch::xPatternSearchFracDIF(
                                        TComMv*      pcMvInt,
                                        TComMv&      rcMvHalf,
                                        TComMv&      rcMvQter,
-                                       Distortion&  ruiCost
+                                       Distortion&  ruiCost,
+                                       const Pel* const* ppcSubpelPlanes
                                       )
 {
   //  Reference pattern initialization (integer scale)
@@ -4565,22 +4704,44 @@ Void TEncSearch::xPatternSearchFracDIF(
   cPatternRoi.setTileBorders(pcPatternKey->getTileLeftTopPelPosX(), pcPatternKey->getTileLeftTopPelPosY(), pcPatternKey->getTileRightBottomPelPosX(), pcPatternKey->getTileRightBottomPelPosY());
 #endif
 
+  // interpolated planes of the reference picture at the integer motion vector: the half-sample phases, and optionally
+  // the quarter-sample phases
+  const Pel*        apcSubpelPlanes[16];
+  const Pel* const* ppcPlanes     = NULL;
+  Bool              bQterPlanes   = false;
+  if ( ppcSubpelPlanes != NULL )
+  {
+    for ( Int i = 0; i < 16; i++ )
+    {
+      apcSubpelPlanes[i] = ppcSubpelPlanes[i] != NULL ? ppcSubpelPlanes[i] + iOffset : NULL;
+    }
+    ppcPlanes   = apcSubpelPlanes;
+    bQterPlanes = apcSubpelPlanes[5] != NULL;
+  }
+
   //  Half-pel refinement
-  xExtDIFUpSamplingH ( &cPatternRoi );
+  if ( !bQterPlanes )
+  {
+    // with the half-sample planes only, the quarter-sample interpolation still needs the intermediate samples
+    xExtDIFUpSamplingH ( &cPatternRoi, ppcPlanes != NULL );
+  }
 
   rcMvHalf = *pcMvInt;   rcMvHalf <<= 1;    // for mv-cost
   TComMv baseRefMv(0, 0);
-  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 2, rcMvHalf, !bIsLosslessCoded );
+  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 2, rcMvHalf, !bIsLosslessCoded, ppcPlanes, iRefStride );
 
   m_pcRdCost->setCostScale( 0 );
 
-  xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf );
+  if ( !bQterPlanes )
+  {
+    xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf );
+  }
   baseRefMv = rcMvHalf;
   baseRefMv <<= 1;
 
   rcMvQter = *pcMvInt;   rcMvQter <<= 1;    // for mv-cost
   rcMvQter += rcMvHalf;  rcMvQter <<= 1;
-  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 1, rcMvQter, !bIsLosslessCoded );
+  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 1, rcMvQter, !bIsLosslessCoded, ppcPlanes, iRefStride );
 }
 
 
@@ -4885,7 +5046,7 @@ Void TEncSearch::xEstimateInterResidualQT( TComYuv    *pcResi,
               pcCU->setTransformSkipPartRange(transformSkipModeId, compID, subTUAbsPartIdx, partIdxesPerSubTU);
               pcCU->setCrossComponentPredictionAlphaPartRange((bUseCrossCPrediction ? preCalcAlpha : 0), compID, subTUAbsPartIdx, partIdxesPerSubTU );
 
-              if ((compID != COMPONENT_Cr) && ((transformSkipModeId == 1) ? m_pcEncCfg->getUseRDOQTS() : m_pcEncCfg->getUseRDOQ()))
+              if ((compID != COMPONENT_Cr) && ((transformSkipModeId == 1) ? m_pcTrQuant->getUseRDOQTS() : m_pcTrQuant->getUseRDOQ()))
               {
                 COEFF_SCAN_TYPE scanType = COEFF_SCAN_TYPE(pcCU->getCoefScanIdx(uiAbsPartIdx, tuCompRect.width, tuCompRect.height, compID));
                 m_pcEntropyCoder->estimateBit(m_pcTrQuant->m_pcEstBitsSbac, tuCompRect.width, tuCompRect.height, toChannelType(compID), scanType);
@@ -5557,6 +5718,33 @@ UInt TEncSearch::xModeBitsIntra( TComDataCU* pcCU, UInt uiMode, UInt uiPartOffse
   return m_pcEntropyCoder->getNumberOfWrittenBits();
 }
 
+/** Luma mode bits of all intra modes of a PU.
+ * The bits of a luma mode only depend on its index in the MPM list, or on it not being an MPM, since
+ * every mode is coded from the same entropy coder state. Hence the entropy coder is only run for the
+ * MPMs and for one other mode, whose bits are shared by all remaining modes.
+ */
+Void TEncSearch::xModeBitsIntraLuma( TComDataCU* pcCU, UInt uiPartOffset, UInt uiDepth, UInt modeBits[NUM_INTRA_MODE] )
+{
+  Int uiPreds[NUM_MOST_PROBABLE_MODES] = {-1, -1, -1};
+  pcCU->getIntraDirPredictor( uiPartOffset, uiPreds, COMPONENT_Y );
+
+  Int nonMpmMode = 0;
+  while( nonMpmMode == uiPreds[0] || nonMpmMode == uiPreds[1] || nonMpmMode == uiPreds[2] )
+  {
+    nonMpmMode++;
+  }
+
+  const UInt uiNonMpmBits = xModeBitsIntra( pcCU, nonMpmMode, uiPartOffset, uiDepth, CHANNEL_TYPE_LUMA );
+  for( Int mode = 0; mode < NUM_INTRA_MODE; mode++ )
+  {
+    modeBits[mode] = uiNonMpmBits;
+  }
+  for( UInt i = 0; i < NUM_MOST_PROBABLE_MODES; i++ )
+  {
+    modeBits[uiPreds[i]] = xModeBitsIntra( pcCU, uiPreds[i], uiPartOffset, uiDepth, CHANNEL_TYPE_LUMA );
+  }
+}
+
 
 
 
@@ -5642,9 +5830,9 @@ Void  TEncSearch::xAddSymbolBitsInter( TComDataCU* pcCU, UInt& ruiBits )
  * \brief Generate half-sample interpolated block
  *
  * \param pattern Reference picture ROI
- * \param biPred    Flag indicating whether block is for biprediction
+ * \param bIntermediateOnly Only generate the horizontally filtered intermediate samples used by xExtDIFUpSamplingQ
  */
-Void TEncSearch::xExtDIFUpSamplingH( TComPattern* pattern )
+Void TEncSearch::xExtDIFUpSamplingH( TComPattern* pattern, Bool bIntermediateOnly )
 {
   Int width      = pattern->getROIYWidth();
   Int height     = pattern->getROIYHeight();
@@ -5662,6 +5850,10 @@ Void TEncSearch::xExtDIFUpSamplingH( TComPattern* pattern )
 
   m_if.filterHor(COMPONENT_Y, srcPtr, srcStride, m_filteredBlockTmp[0].getAddr(COMPONENT_Y), intStride, width+1, height+filterSize, 0, false, chFmt, pattern->getBitDepthY());
   m_if.filterHor(COMPONENT_Y, srcPtr, srcStride, m_filteredBlockTmp[2].getAddr(COMPONENT_Y), intStride, width+1, height+filterSize, 2, false, chFmt, pattern->getBitDepthY());
+  if (bIntermediateOnly)
+  {
+    return;
+  }
 
   intPtr = m_filteredBlockTmp[0].getAddr(COMPONENT_Y) + halfFilterSize * intStride + 1;
   dstPtr = m_filteredBlock[0][0].getAddr(COMPONENT_Y);
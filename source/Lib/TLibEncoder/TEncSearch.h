@@ -63,6 +63,7 @@ class TEncCu;
 static const UInt MAX_NUM_REF_LIST_ADAPT_SR=2;
 static const UInt MAX_IDX_ADAPT_SR=33;
 static const UInt NUM_MV_PREDICTORS=3;
+static const UInt NUM_INTRA_SATD_BATCH_MODES=7; ///< number of intra modes predicted together in the SATD-based mode pre-selection
 
 /// encoder search class
 class TEncSearch : public TComPrediction
@@ -110,6 +111,7 @@ protected:
 
   // Misc.
   Pel*            m_pTempPel;
+  Pel*            m_pIntraSatdBatch;   ///< predictions of NUM_INTRA_SATD_BATCH_MODES intra modes, stored one after the other
 
   // AMVP cost computation
   // UInt            m_auiMVPIdxCost[AMVP_MAX_NUM_CANDS+1][AMVP_MAX_NUM_CANDS];
@@ -142,7 +144,8 @@ protected:
   /// sub-function for motion vector refinement used in fractional-pel accuracy
   Distortion  xPatternRefinement( TComPattern* pcPatternKey,
                                   TComMv baseRefMv,
-                                  Int iFrac, TComMv& rcMvFrac, Bool bAllowUseOfHadamard
+                                  Int iFrac, TComMv& rcMvFrac, Bool bAllowUseOfHadamard,
+                                  const Pel* const* ppcSubpelPlanes = NULL, Int iSubpelStride = 0
                                  );
 
   typedef struct
@@ -159,6 +162,7 @@ protected:
 
   // sub-functions for ME
   __inline Void xTZSearchHelp         ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  Distortion    xGetStartPointCost    ( const TComDataCU* const pcCU, const TComPattern* const pcPatternKey, const Pel* const piRefY, const Int iRefStride, TComMv cMv );
   __inline Void xTZ2PointSearch       ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB );
   __inline Void xTZ8PointSquareSearch ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
   __inline Void xTZ8PointDiamondSearch( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist, const Bool bCheckCornersAtDist1 );
@@ -378,6 +382,7 @@ protected:
                                     TComMv&                  rcMv,
                                     Distortion&              ruiSAD,
                                     const TComMv* const      pIntegerMv2Nx2NPred,
+                                    const TComMv* const      pHierarchicalMvPred,
                                     const Bool               bExtendedSettings
                                     );
 
@@ -389,7 +394,8 @@ protected:
                                     const TComMv* const      pcMvSrchRngRB,
                                     TComMv&                  rcMv,
                                     Distortion&              ruiSAD,
-                                    const TComMv* const      pIntegerMv2Nx2NPred
+                                    const TComMv* const      pIntegerMv2Nx2NPred,
+                                    const TComMv* const      pHierarchicalMvPred
                                     );
 
   Void xSetSearchRange            ( const TComDataCU* const pcCU,
@@ -415,7 +421,8 @@ protected:
                                     const TComMv* const      pcMvSrchRngRB,
                                     TComMv&                  rcMv,
                                     Distortion&              ruiSAD,
-                                    const TComMv* const      pIntegerMv2Nx2NPred
+                                    const TComMv* const      pIntegerMv2Nx2NPred,
+                                    const TComMv* const      pHierarchicalMvPred
                                   );
 
   Void xPatternSearch             ( const TComPattern* const pcPatternKey,
@@ -434,10 +441,11 @@ protected:
                                     TComMv*      pcMvInt,
                                     TComMv&      rcMvHalf,
                                     TComMv&      rcMvQter,
-                                    Distortion&  ruiCost
+                                    Distortion&  ruiCost,
+                                    const Pel* const* ppcSubpelPlanes
                                    );
 
-  Void xExtDIFUpSamplingH( TComPattern* pcPattern );
+  Void xExtDIFUpSamplingH( TComPattern* pcPattern, Bool bIntermediateOnly = false );
   Void xExtDIFUpSamplingQ( TComPattern* pcPatternKey, TComMv halfPelRef );
 
   // -------------------------------------------------------------------------------------------------------------------
@@ -450,6 +458,7 @@ protected:
   Void xSetInterResidualQTData( TComYuv* pcResi, Bool bSpatial, TComTU &rTu  );
 
   UInt  xModeBitsIntra ( TComDataCU* pcCU, UInt uiMode, UInt uiPartOffset, UInt uiDepth, const ChannelType compID );
+  Void  xModeBitsIntraLuma( TComDataCU* pcCU, UInt uiPartOffset, UInt uiDepth, UInt modeBits[NUM_INTRA_MODE] );
   UInt  xUpdateCandList( UInt uiMode, Double uiCost, UInt uiFastCandNum, UInt * CandModeList, Double * CandCostList );
 
   // -------------------------------------------------------------------------------------------------------------------
@@ -48,6 +48,7 @@
 
 TEncSlice::TEncSlice()
  : m_encCABACTableIdx(I_SLICE)
+ , m_pcThreadPool(NULL)
 {
 }
 
@@ -74,6 +75,12 @@ Void TEncSlice::destroy()
   m_vdRdPicLambda.clear();
   m_vdRdPicQp.clear();
   m_viRdPicQp.clear();
+
+  for (UInt unitIdx = 0; unitIdx < m_parallelCtuUnitSyncStates.size(); unitIdx++)
+  {
+    delete m_parallelCtuUnitSyncStates[unitIdx];
+  }
+  m_parallelCtuUnitSyncStates.clear();
 }
 
 Void TEncSlice::init( TEncTop* pcEncTop )
@@ -99,6 +106,38 @@ Void TEncSlice::init( TEncTop* pcEncTop )
   m_vdRdPicQp.resize(    m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_viRdPicQp.resize(    m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_pcRateCtrl        = pcEncTop->getRateCtrl();
+
+  m_pcThreadPool      = pcEncTop->getThreadPool();
+  m_ctuWorkers.clear();
+  for (Int threadIdx = 0; threadIdx < pcEncTop->getNumCtuWorkers(); threadIdx++)
+  {
+    m_ctuWorkers.push_back( pcEncTop->getCtuWorker(threadIdx) );
+  }
+}
+
+/** Initialises a slice encoder compressing pictures concurrently with the slice encoder of the encoder.
+ * It uses the tools of pcTools instead of the main tools of the encoder, and compresses the CTUs of its slices sequentially.
+ * \param pcEncTop  pointer of encoder class
+ * \param pcTools   compression tools used by the slice encoder
+ */
+Void TEncSlice::init( TEncTop* pcEncTop, TEncCtuWorker* pcTools )
+{
+  init( pcEncTop );
+
+  m_pcCuEncoder       = pcTools->getCuEncoder();
+  m_pcPredSearch      = pcTools->getPredSearch();
+
+  m_pcEntropyCoder    = pcTools->getEntropyCoder();
+  m_pcSbacCoder       = pcTools->getSbacCoder();
+  m_pcBinCABAC        = pcTools->getBinCABAC();
+  m_pcTrQuant         = pcTools->getTrQuant();
+
+  m_pcRdCost          = pcTools->getRdCost();
+  m_pppcRDSbacCoder   = pcTools->getRDSbacCoder();
+  m_pcRDGoOnSbacCoder = pcTools->getRDGoOnSbacCoder();
+
+  m_pcThreadPool      = NULL;
+  m_ctuWorkers.clear();
 }
 
 Void TEncSlice::updateLambda(TComSlice* pSlice, Double dQP)
@@ -503,6 +542,10 @@ Void TEncSlice::setSearchRange( TComSlice* pcSlice )
       iRefPOC = pcSlice->getRefPic(e, iRefIdx)->getPOC();
       Int newSearchRange = Clip3(m_pcCfg->getMinSearchWindow(), iMaxSR, (iMaxSR*ADAPT_SR_SCALE*abs(iCurrPOC - iRefPOC)+iOffset)/iGOPSize);
       m_pcPredSearch->setAdaptiveSearchRange(iDir, iRefIdx, newSearchRange);
+      for (UInt threadIdx = 0; threadIdx < m_ctuWorkers.size(); threadIdx++)
+      {
+        m_ctuWorkers[threadIdx]->getPredSearch()->setAdaptiveSearchRange(iDir, iRefIdx, newSearchRange);
+      }
     }
   }
 }
@@ -671,6 +714,10 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
   
   m_pcCuEncoder->setFastDeltaQp(bFastDeltaQP);
 
+  // RDOQ may be restricted to the lower temporal layers
+  const Bool bRDOQAllowed = m_pcCfg->getRDOQMaxTemporalLayer() < 0 || pcSlice->getTLayer() <= UInt(m_pcCfg->getRDOQMaxTemporalLayer());
+  m_pcTrQuant->setUseRDOQ( m_pcCfg->getUseRDOQ() && bRDOQAllowed, m_pcCfg->getUseRDOQTS() && bRDOQAllowed );
+
   //------------------------------------------------------------------------------
   //  Weighted Prediction parameters estimation.
   //------------------------------------------------------------------------------
@@ -730,200 +777,208 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
     }
   }
 
-  // for every CTU in the slice segment (may terminate sooner if there is a byte limit on the slice-segment)
-
-  for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
+  if ( xUseParallelCompression( pcSlice, bCompressEntireSlice ) )
   {
-    const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
-    // initialize CTU encoder
-    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
-    pCtu->initCtu( pcPic, ctuRsAddr );
+    // compress the CTU rows (tiles) concurrently; results are identical to the sequential loop below.
+    xCompressCtusParallel( pcPic, startCtuTsAddr, boundingCtuTsAddr, bFastDeltaQP );
+  }
+  else
+  {
+    // for every CTU in the slice segment (may terminate sooner if there is a byte limit on the slice-segment)
 
-    // update CABAC state
-    const UInt firstCtuRsAddrOfTile = pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
-    const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
-    const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
-    
-    if (ctuRsAddr == firstCtuRsAddrOfTile)
-    {
-      m_pppcRDSbacCoder[0][CI_CURR_BEST]->resetEntropy(pcSlice);
-    }
-    else if ( ctuXPosInCtus == tileXPosInCtus && m_pcCfg->getEntropyCodingSyncEnabledFlag())
+    for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
     {
-      // reset and then update contexts to the state at the end of the top-right CTU (if within current slice and tile).
-      m_pppcRDSbacCoder[0][CI_CURR_BEST]->resetEntropy(pcSlice);
-      // Sync if the Top-Right is available.
-      TComDataCU *pCtuUp = pCtu->getCtuAbove();
-      if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
+      const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+      // initialize CTU encoder
+      TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+      pCtu->initCtu( pcPic, ctuRsAddr );
+
+      // update CABAC state
+      const UInt firstCtuRsAddrOfTile = pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
+      const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
+      const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
+    
+      if (ctuRsAddr == firstCtuRsAddrOfTile)
       {
-        TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
-        if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+        m_pppcRDSbacCoder[0][CI_CURR_BEST]->resetEntropy(pcSlice);
+      }
+      else if ( ctuXPosInCtus == tileXPosInCtus && m_pcCfg->getEntropyCodingSyncEnabledFlag())
+      {
+        // reset and then update contexts to the state at the end of the top-right CTU (if within current slice and tile).
+        m_pppcRDSbacCoder[0][CI_CURR_BEST]->resetEntropy(pcSlice);
+        // Sync if the Top-Right is available.
+        TComDataCU *pCtuUp = pCtu->getCtuAbove();
+        if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
         {
-          // Top-Right is available, we use it.
-          m_pppcRDSbacCoder[0][CI_CURR_BEST]->loadContexts( &m_entropyCodingSyncContextState );
+          TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+          if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+          {
+            // Top-Right is available, we use it.
+            m_pppcRDSbacCoder[0][CI_CURR_BEST]->loadContexts( &m_entropyCodingSyncContextState );
+          }
         }
       }
-    }
 
-    // set go-on entropy coder (used for all trial encodings - the cu encoder and encoder search also have a copy of the same pointer)
-    m_pcEntropyCoder->setEntropyCoder ( m_pcRDGoOnSbacCoder );
-    m_pcEntropyCoder->setBitstream( &tempBitCounter );
-    tempBitCounter.resetBits();
-    m_pcRDGoOnSbacCoder->load( m_pppcRDSbacCoder[0][CI_CURR_BEST] ); // this copy is not strictly necessary here, but indicates that the GoOnSbacCoder
-                                                                     // is reset to a known state before every decision process.
-
-    ((TEncBinCABAC*)m_pcRDGoOnSbacCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+      // set go-on entropy coder (used for all trial encodings - the cu encoder and encoder search also have a copy of the same pointer)
+      m_pcEntropyCoder->setEntropyCoder ( m_pcRDGoOnSbacCoder );
+      m_pcEntropyCoder->setBitstream( &tempBitCounter );
+      tempBitCounter.resetBits();
+      m_pcRDGoOnSbacCoder->load( m_pppcRDSbacCoder[0][CI_CURR_BEST] ); // this copy is not strictly necessary here, but indicates that the GoOnSbacCoder
+                                                                       // is reset to a known state before every decision process.
 
-    Double oldLambda = m_pcRdCost->getLambda();
-    if ( m_pcCfg->getUseRateCtrl() )
-    {
-      Int estQP        = pcSlice->getSliceQp();
-      Double estLambda = -1.0;
-      Double bpp       = -1.0;
+      ((TEncBinCABAC*)m_pcRDGoOnSbacCoder->getEncBinIf())->setBinCountingEnableFlag(true);
 
-      if ( ( pcPic->getSlice( 0 )->getSliceType() == I_SLICE && m_pcCfg->getForceIntraQP() ) || !m_pcCfg->getLCULevelRC() )
-      {
-        estQP = pcSlice->getSliceQp();
-      }
-      else
+      Double oldLambda = m_pcRdCost->getLambda();
+      if ( m_pcCfg->getUseRateCtrl() )
       {
-        bpp = m_pcRateCtrl->getRCPic()->getLCUTargetBpp(pcSlice->getSliceType());
-        if ( pcPic->getSlice( 0 )->getSliceType() == I_SLICE)
+        Int estQP        = pcSlice->getSliceQp();
+        Double estLambda = -1.0;
+        Double bpp       = -1.0;
+
+        if ( ( pcPic->getSlice( 0 )->getSliceType() == I_SLICE && m_pcCfg->getForceIntraQP() ) || !m_pcCfg->getLCULevelRC() )
         {
-          estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambdaAndQP(bpp, pcSlice->getSliceQp(), &estQP);
+          estQP = pcSlice->getSliceQp();
         }
         else
         {
-          estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambda( bpp );
-          estQP     = m_pcRateCtrl->getRCPic()->getLCUEstQP    ( estLambda, pcSlice->getSliceQp() );
-        }
+          bpp = m_pcRateCtrl->getRCPic()->getLCUTargetBpp(pcSlice->getSliceType());
+          if ( pcPic->getSlice( 0 )->getSliceType() == I_SLICE)
+          {
+            estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambdaAndQP(bpp, pcSlice->getSliceQp(), &estQP);
+          }
+          else
+          {
+            estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambda( bpp );
+            estQP     = m_pcRateCtrl->getRCPic()->getLCUEstQP    ( estLambda, pcSlice->getSliceQp() );
+          }
 
-        estQP     = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, estQP );
+          estQP     = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, estQP );
 
-        m_pcRdCost->setLambda(estLambda, pcSlice->getSPS()->getBitDepths());
+          m_pcRdCost->setLambda(estLambda, pcSlice->getSPS()->getBitDepths());
 
-#if RDOQ_CHROMA_LAMBDA
-        // set lambda for RDOQ
-        const Double chromaLambda = estLambda / m_pcRdCost->getChromaWeight();
-        const Double lambdaArray[MAX_NUM_COMPONENT] = { estLambda, chromaLambda, chromaLambda };
-        m_pcTrQuant->setLambdas( lambdaArray );
-#else
-        m_pcTrQuant->setLambda( estLambda );
-#endif
-      }
+  #if RDOQ_CHROMA_LAMBDA
+          // set lambda for RDOQ
+          const Double chromaLambda = estLambda / m_pcRdCost->getChromaWeight();
+          const Double lambdaArray[MAX_NUM_COMPONENT] = { estLambda, chromaLambda, chromaLambda };
+          m_pcTrQuant->setLambdas( lambdaArray );
+  #else
+          m_pcTrQuant->setLambda( estLambda );
+  #endif
+        }
 
-      m_pcRateCtrl->setRCQP( estQP );
-#if ADAPTIVE_QP_SELECTION
-      pCtu->getSlice()->setSliceQpBase( estQP );
-#endif
-    }
+        m_pcRateCtrl->setRCQP( estQP );
+  #if ADAPTIVE_QP_SELECTION
+        pCtu->getSlice()->setSliceQpBase( estQP );
+  #endif
+      }
 
-    // run CTU trial encoder
-    m_pcCuEncoder->compressCtu( pCtu );
+      // run CTU trial encoder
+      m_pcCuEncoder->compressCtu( pCtu );
 
 
-    // All CTU decisions have now been made. Restore entropy coder to an initial stage, ready to make a true encode,
-    // which will result in the state of the contexts being correct. It will also count up the number of bits coded,
-    // which is used if there is a limit of the number of bytes per slice-segment.
+      // All CTU decisions have now been made. Restore entropy coder to an initial stage, ready to make a true encode,
+      // which will result in the state of the contexts being correct. It will also count up the number of bits coded,
+      // which is used if there is a limit of the number of bytes per slice-segment.
 
-    m_pcEntropyCoder->setEntropyCoder ( m_pppcRDSbacCoder[0][CI_CURR_BEST] );
-    m_pcEntropyCoder->setBitstream( &tempBitCounter );
-    pRDSbacCoder->setBinCountingEnableFlag( true );
-    m_pppcRDSbacCoder[0][CI_CURR_BEST]->resetBits();
-    pRDSbacCoder->setBinsCoded( 0 );
+      m_pcEntropyCoder->setEntropyCoder ( m_pppcRDSbacCoder[0][CI_CURR_BEST] );
+      m_pcEntropyCoder->setBitstream( &tempBitCounter );
+      pRDSbacCoder->setBinCountingEnableFlag( true );
+      m_pppcRDSbacCoder[0][CI_CURR_BEST]->resetBits();
+      pRDSbacCoder->setBinsCoded( 0 );
 
-    // encode CTU and calculate the true bit counters.
-    m_pcCuEncoder->encodeCtu( pCtu );
+      // encode CTU and calculate the true bit counters.
+      m_pcCuEncoder->encodeCtu( pCtu );
 
 
-    pRDSbacCoder->setBinCountingEnableFlag( false );
+      pRDSbacCoder->setBinCountingEnableFlag( false );
 
-    const Int numberOfWrittenBits = m_pcEntropyCoder->getNumberOfWrittenBits();
+      const Int numberOfWrittenBits = m_pcEntropyCoder->getNumberOfWrittenBits();
 
-    // Calculate if this CTU puts us over slice bit size.
-    // cannot terminate if current slice/slice-segment would be 0 Ctu in size,
-    const UInt validEndOfSliceCtuTsAddr = ctuTsAddr + (ctuTsAddr == startCtuTsAddr ? 1 : 0);
-    // Set slice end parameter
-    if(pcSlice->getSliceMode()==FIXED_NUMBER_OF_BYTES && pcSlice->getSliceBits()+numberOfWrittenBits > (pcSlice->getSliceArgument()<<3))
-    {
-      pcSlice->setSliceSegmentCurEndCtuTsAddr(validEndOfSliceCtuTsAddr);
-      pcSlice->setSliceCurEndCtuTsAddr(validEndOfSliceCtuTsAddr);
-      boundingCtuTsAddr=validEndOfSliceCtuTsAddr;
-    }
-    else if((!bCompressEntireSlice) && pcSlice->getSliceSegmentMode()==FIXED_NUMBER_OF_BYTES && pcSlice->getSliceSegmentBits()+numberOfWrittenBits > (pcSlice->getSliceSegmentArgument()<<3))
-    {
-      pcSlice->setSliceSegmentCurEndCtuTsAddr(validEndOfSliceCtuTsAddr);
-      boundingCtuTsAddr=validEndOfSliceCtuTsAddr;
-    }
+      // Calculate if this CTU puts us over slice bit size.
+      // cannot terminate if current slice/slice-segment would be 0 Ctu in size,
+      const UInt validEndOfSliceCtuTsAddr = ctuTsAddr + (ctuTsAddr == startCtuTsAddr ? 1 : 0);
+      // Set slice end parameter
+      if(pcSlice->getSliceMode()==FIXED_NUMBER_OF_BYTES && pcSlice->getSliceBits()+numberOfWrittenBits > (pcSlice->getSliceArgument()<<3))
+      {
+        pcSlice->setSliceSegmentCurEndCtuTsAddr(validEndOfSliceCtuTsAddr);
+        pcSlice->setSliceCurEndCtuTsAddr(validEndOfSliceCtuTsAddr);
+        boundingCtuTsAddr=validEndOfSliceCtuTsAddr;
+      }
+      else if((!bCompressEntireSlice) && pcSlice->getSliceSegmentMode()==FIXED_NUMBER_OF_BYTES && pcSlice->getSliceSegmentBits()+numberOfWrittenBits > (pcSlice->getSliceSegmentArgument()<<3))
+      {
+        pcSlice->setSliceSegmentCurEndCtuTsAddr(validEndOfSliceCtuTsAddr);
+        boundingCtuTsAddr=validEndOfSliceCtuTsAddr;
+      }
 
-    if (boundingCtuTsAddr <= ctuTsAddr)
-    {
-      break;
-    }
+      if (boundingCtuTsAddr <= ctuTsAddr)
+      {
+        break;
+      }
 
-    pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
-    pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+      pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
+      pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
 
-    // Store probabilities of second CTU in line into buffer - used only if wavefront-parallel-processing is enabled.
-    if ( ctuXPosInCtus == tileXPosInCtus+1 && m_pcCfg->getEntropyCodingSyncEnabledFlag())
-    {
-      m_entropyCodingSyncContextState.loadContexts(m_pppcRDSbacCoder[0][CI_CURR_BEST]);
-    }
+      // Store probabilities of second CTU in line into buffer - used only if wavefront-parallel-processing is enabled.
+      if ( ctuXPosInCtus == tileXPosInCtus+1 && m_pcCfg->getEntropyCodingSyncEnabledFlag())
+      {
+        m_entropyCodingSyncContextState.loadContexts(m_pppcRDSbacCoder[0][CI_CURR_BEST]);
+      }
 
 
-    if ( m_pcCfg->getUseRateCtrl() )
-    {
-      Int actualQP        = g_RCInvalidQPValue;
-      Double actualLambda = m_pcRdCost->getLambda();
-      Int actualBits      = pCtu->getTotalBits();
-      Int numberOfEffectivePixels    = 0;
-
-#if JVET_M0600_RATE_CTRL
-      Int numberOfSkipPixel = 0;      
-      for (Int idx = 0; idx < pcPic->getNumPartitionsInCtu(); idx++)
+      if ( m_pcCfg->getUseRateCtrl() )
       {
+        Int actualQP        = g_RCInvalidQPValue;
+        Double actualLambda = m_pcRdCost->getLambda();
+        Int actualBits      = pCtu->getTotalBits();
+        Int numberOfEffectivePixels    = 0;
+
+  #if JVET_M0600_RATE_CTRL
+        Int numberOfSkipPixel = 0;      
+        for (Int idx = 0; idx < pcPic->getNumPartitionsInCtu(); idx++)
+        {
         
-        numberOfSkipPixel += 16 * pCtu->isSkipped(idx);
-      }
-#endif
+          numberOfSkipPixel += 16 * pCtu->isSkipped(idx);
+        }
+  #endif
 
-      for ( Int idx = 0; idx < pcPic->getNumPartitionsInCtu(); idx++ )
-      {
-        if ( pCtu->getPredictionMode( idx ) != NUMBER_OF_PREDICTION_MODES && ( !pCtu->isSkipped( idx ) ) )
+        for ( Int idx = 0; idx < pcPic->getNumPartitionsInCtu(); idx++ )
         {
-          numberOfEffectivePixels = numberOfEffectivePixels + 16;
-          break;
+          if ( pCtu->getPredictionMode( idx ) != NUMBER_OF_PREDICTION_MODES && ( !pCtu->isSkipped( idx ) ) )
+          {
+            numberOfEffectivePixels = numberOfEffectivePixels + 16;
+            break;
+          }
         }
-      }
 
-#if JVET_M0600_RATE_CTRL
-      Double skipRatio = (Double)numberOfSkipPixel / m_pcRateCtrl->getRCPic()->getLCU(ctuTsAddr).m_numberOfPixel;
-#endif
+  #if JVET_M0600_RATE_CTRL
+        Double skipRatio = (Double)numberOfSkipPixel / m_pcRateCtrl->getRCPic()->getLCU(ctuTsAddr).m_numberOfPixel;
+  #endif
 
-      if ( numberOfEffectivePixels == 0 )
-      {
-        actualQP = g_RCInvalidQPValue;
-      }
-      else
-      {
-        actualQP = pCtu->getQP( 0 );
+        if ( numberOfEffectivePixels == 0 )
+        {
+          actualQP = g_RCInvalidQPValue;
+        }
+        else
+        {
+          actualQP = pCtu->getQP( 0 );
+        }
+  #if JVET_K0390_RATE_CTRL
+        m_pcRateCtrl->getRCPic()->getLCU(ctuTsAddr).m_actualMSE = (Double)pCtu->getTotalDistortion() / (Double)m_pcRateCtrl->getRCPic()->getLCU(ctuTsAddr).m_numberOfPixel;
+  #endif
+        m_pcRdCost->setLambda(oldLambda, pcSlice->getSPS()->getBitDepths());
+  #if JVET_M0600_RATE_CTRL
+        m_pcRateCtrl->getRCPic()->updateAfterCTU(m_pcRateCtrl->getRCPic()->getLCUCoded(), actualBits, actualQP, actualLambda, skipRatio,
+          pCtu->getSlice()->getSliceType() == I_SLICE ? 0 : m_pcCfg->getLCULevelRC());
+  #else
+        m_pcRateCtrl->getRCPic()->updateAfterCTU( m_pcRateCtrl->getRCPic()->getLCUCoded(), actualBits, actualQP, actualLambda,
+                                                  pCtu->getSlice()->getSliceType() == I_SLICE ? 0 : m_pcCfg->getLCULevelRC() );
+  #endif
       }
-#if JVET_K0390_RATE_CTRL
-      m_pcRateCtrl->getRCPic()->getLCU(ctuTsAddr).m_actualMSE = (Double)pCtu->getTotalDistortion() / (Double)m_pcRateCtrl->getRCPic()->getLCU(ctuTsAddr).m_numberOfPixel;
-#endif
-      m_pcRdCost->setLambda(oldLambda, pcSlice->getSPS()->getBitDepths());
-#if JVET_M0600_RATE_CTRL
-      m_pcRateCtrl->getRCPic()->updateAfterCTU(m_pcRateCtrl->getRCPic()->getLCUCoded(), actualBits, actualQP, actualLambda, skipRatio,
-        pCtu->getSlice()->getSliceType() == I_SLICE ? 0 : m_pcCfg->getLCULevelRC());
-#else
-      m_pcRateCtrl->getRCPic()->updateAfterCTU( m_pcRateCtrl->getRCPic()->getLCUCoded(), actualBits, actualQP, actualLambda,
-                                                pCtu->getSlice()->getSliceType() == I_SLICE ? 0 : m_pcCfg->getLCULevelRC() );
-#endif
-    }
 
-    m_uiPicTotalBits += pCtu->getTotalBits();
-    m_dPicRdCost     += pCtu->getTotalCost();
-    m_uiPicDist      += pCtu->getTotalDistortion();
+      m_uiPicTotalBits += pCtu->getTotalBits();
+      m_dPicRdCost     += pCtu->getTotalCost();
+      m_uiPicDist      += pCtu->getTotalDistortion();
+    }
   }
 
 
@@ -997,120 +1052,93 @@ Void TEncSlice::encodeSlice   ( TComPic* pcPic, TComOutputBitstream* pcSubstream
     }
   }
 
-  // for every CTU in the slice segment...
-
-  for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
+  if ( xUseParallelEncoding( pcSlice ) )
   {
-    const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
-    const TComTile &currentTile = *(pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr)));
-    const UInt firstCtuRsAddrOfTile = currentTile.getFirstCtuRsAddr();
-    const UInt tileXPosInCtus       = firstCtuRsAddrOfTile % frameWidthInCtus;
-    const UInt tileYPosInCtus       = firstCtuRsAddrOfTile / frameWidthInCtus;
-    const UInt ctuXPosInCtus        = ctuRsAddr % frameWidthInCtus;
-    const UInt ctuYPosInCtus        = ctuRsAddr / frameWidthInCtus;
-    const UInt uiSubStrm=pcPic->getSubstreamForCtuAddr(ctuRsAddr, true, pcSlice);
-    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
-
-    m_pcEntropyCoder->setBitstream( &pcSubstreams[uiSubStrm] );
+    // encode the tiles concurrently into their substreams
+    xEncodeTilesParallel( pcPic, pcSubstreams );
+  }
+  else
+  {
+    // for every CTU in the slice segment...
 
-    // set up CABAC contexts' state for this CTU
-    if (ctuRsAddr == firstCtuRsAddrOfTile)
-    {
-      if (ctuTsAddr != startCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
-      {
-        m_pcEntropyCoder->resetEntropy(pcSlice);
-      }
-    }
-    else if (ctuXPosInCtus == tileXPosInCtus && wavefrontsEnabled)
+    for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
     {
-      // Synchronize cabac probabilities with upper-right CTU if it's available and at the start of a line.
-      if (ctuTsAddr != startCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
+      const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+      const TComTile &currentTile = *(pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr)));
+      const UInt firstCtuRsAddrOfTile = currentTile.getFirstCtuRsAddr();
+      const UInt tileXPosInCtus       = firstCtuRsAddrOfTile % frameWidthInCtus;
+      const UInt tileYPosInCtus       = firstCtuRsAddrOfTile / frameWidthInCtus;
+      const UInt ctuXPosInCtus        = ctuRsAddr % frameWidthInCtus;
+      const UInt ctuYPosInCtus        = ctuRsAddr / frameWidthInCtus;
+      const UInt uiSubStrm=pcPic->getSubstreamForCtuAddr(ctuRsAddr, true, pcSlice);
+      TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+
+      m_pcEntropyCoder->setBitstream( &pcSubstreams[uiSubStrm] );
+
+      // set up CABAC contexts' state for this CTU
+      if (ctuRsAddr == firstCtuRsAddrOfTile)
       {
-        m_pcEntropyCoder->resetEntropy(pcSlice);
-      }
-      TComDataCU *pCtuUp = pCtu->getCtuAbove();
-      if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
-      {
-        TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
-        if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+        if (ctuTsAddr != startCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
         {
-          // Top-right is available, so use it.
-          m_pcSbacCoder->loadContexts( &m_entropyCodingSyncContextState );
+          m_pcEntropyCoder->resetEntropy(pcSlice);
         }
       }
-    }
-
-
-    if ( pcSlice->getSPS()->getUseSAO() )
-    {
-      Bool bIsSAOSliceEnabled = false;
-      Bool sliceEnabled[MAX_NUM_COMPONENT];
-      for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
+      else if (ctuXPosInCtus == tileXPosInCtus && wavefrontsEnabled)
       {
-        ComponentID compId=ComponentID(comp);
-        sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
-        if (sliceEnabled[compId])
+        // Synchronize cabac probabilities with upper-right CTU if it's available and at the start of a line.
+        if (ctuTsAddr != startCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
         {
-          bIsSAOSliceEnabled=true;
+          m_pcEntropyCoder->resetEntropy(pcSlice);
         }
-      }
-      if (bIsSAOSliceEnabled)
-      {
-        SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
-
-        Bool leftMergeAvail = false;
-        Bool aboveMergeAvail= false;
-        //merge left condition
-        Int rx = (ctuRsAddr % frameWidthInCtus);
-        if(rx > 0)
+        TComDataCU *pCtuUp = pCtu->getCtuAbove();
+        if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
         {
-          leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
+          TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+          if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+          {
+            // Top-right is available, so use it.
+            m_pcSbacCoder->loadContexts( &m_entropyCodingSyncContextState );
+          }
         }
+      }
 
-        //merge up condition
-        Int ry = (ctuRsAddr / frameWidthInCtus);
-        if(ry > 0)
-        {
-          aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
-        }
 
-        m_pcEntropyCoder->encodeSAOBlkParam(saoblkParam, pcPic->getPicSym()->getSPS().getBitDepths(), sliceEnabled, leftMergeAvail, aboveMergeAvail);
-      }
-    }
+      xEncodeSAOBlkParam( pcPic, pcSlice, ctuRsAddr, m_pcEntropyCoder );
 
-#if ENC_DEC_TRACE
-    g_bJustDoIt = g_bEncDecTraceEnable;
-#endif
-      m_pcCuEncoder->encodeCtu( pCtu );
-#if ENC_DEC_TRACE
-    g_bJustDoIt = g_bEncDecTraceDisable;
-#endif
+  #if ENC_DEC_TRACE
+      g_bJustDoIt = g_bEncDecTraceEnable;
+  #endif
+        m_pcCuEncoder->encodeCtu( pCtu );
+  #if ENC_DEC_TRACE
+      g_bJustDoIt = g_bEncDecTraceDisable;
+  #endif
 
-    //Store probabilities of second CTU in line into buffer
-    if ( ctuXPosInCtus == tileXPosInCtus+1 && wavefrontsEnabled)
-    {
-      m_entropyCodingSyncContextState.loadContexts( m_pcSbacCoder );
-    }
+      //Store probabilities of second CTU in line into buffer
+      if ( ctuXPosInCtus == tileXPosInCtus+1 && wavefrontsEnabled)
+      {
+        m_entropyCodingSyncContextState.loadContexts( m_pcSbacCoder );
+      }
 
-    // terminate the sub-stream, if required (end of slice-segment, end of tile, end of wavefront-CTU-row):
-    if (ctuTsAddr+1 == boundingCtuTsAddr ||
-         (  ctuXPosInCtus + 1 == tileXPosInCtus + currentTile.getTileWidthInCtus() &&
-          ( ctuYPosInCtus + 1 == tileYPosInCtus + currentTile.getTileHeightInCtus() || wavefrontsEnabled)
+      // terminate the sub-stream, if required (end of slice-segment, end of tile, end of wavefront-CTU-row):
+      if (ctuTsAddr+1 == boundingCtuTsAddr ||
+           (  ctuXPosInCtus + 1 == tileXPosInCtus + currentTile.getTileWidthInCtus() &&
+            ( ctuYPosInCtus + 1 == tileYPosInCtus + currentTile.getTileHeightInCtus() || wavefrontsEnabled)
+           )
          )
-       )
-    {
-      m_pcEntropyCoder->encodeTerminatingBit(1);
-      m_pcEntropyCoder->encodeSliceFinish();
-      // Byte-alignment in slice_data() when new tile
-      pcSubstreams[uiSubStrm].writeByteAlignment();
-
-      // write sub-stream size
-      if (ctuTsAddr+1 != boundingCtuTsAddr)
       {
-        pcSlice->addSubstreamSize( (pcSubstreams[uiSubStrm].getNumberOfWrittenBits() >> 3) + pcSubstreams[uiSubStrm].countStartCodeEmulations() );
+        m_pcEntropyCoder->encodeTerminatingBit(1);
+        m_pcEntropyCoder->encodeSliceFinish();
+        // Byte-alignment in slice_data() when new tile
+        pcSubstreams[uiSubStrm].writeByteAlignment();
+
+        // write sub-stream size
+        if (ctuTsAddr+1 != boundingCtuTsAddr)
+        {
+          pcSlice->addSubstreamSize( (pcSubstreams[uiSubStrm].getNumberOfWrittenBits() >> 3) + pcSubstreams[uiSubStrm].countStartCodeEmulations() );
+        }
       }
-    }
-  } // CTU-loop
+    } // CTU-loop
+  }
 
   if( depSliceSegmentsEnabled )
   {
@@ -1265,4 +1293,478 @@ Double TEncSlice::xGetQPValueAccordingToLambda ( Double lambda )
   return 4.2005*log(lambda) + 13.7122;
 }
 
+/** Encodes the SAO parameters of a CTU.
+ * \param pcPic           picture class
+ * \param pcSlice         slice containing the CTU
+ * \param ctuRsAddr       raster scan address of the CTU
+ * \param pcEntropyCoder  entropy encoder writing the substream of the CTU
+ */
+Void TEncSlice::xEncodeSAOBlkParam( TComPic* pcPic, const TComSlice* pcSlice, const UInt ctuRsAddr, TEncEntropy* pcEntropyCoder )
+{
+  const UInt frameWidthInCtus = pcPic->getPicSym()->getFrameWidthInCtus();
+
+  if ( pcSlice->getSPS()->getUseSAO() )
+  {
+    Bool bIsSAOSliceEnabled = false;
+    Bool sliceEnabled[MAX_NUM_COMPONENT];
+    for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
+    {
+      ComponentID compId=ComponentID(comp);
+      sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
+      if (sliceEnabled[compId])
+      {
+        bIsSAOSliceEnabled=true;
+      }
+    }
+    if (bIsSAOSliceEnabled)
+    {
+      SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
+
+      Bool leftMergeAvail = false;
+      Bool aboveMergeAvail= false;
+      //merge left condition
+      Int rx = (ctuRsAddr % frameWidthInCtus);
+      if(rx > 0)
+      {
+        leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
+      }
+
+      //merge up condition
+      Int ry = (ctuRsAddr / frameWidthInCtus);
+      if(ry > 0)
+      {
+        aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
+      }
+
+      pcEntropyCoder->encodeSAOBlkParam(saoblkParam, pcPic->getPicSym()->getSPS().getBitDepths(), sliceEnabled, leftMergeAvail, aboveMergeAvail);
+    }
+  }
+}
+
+/** Determines whether the tiles of the slice-segment can be encoded concurrently.
+ * \param pcSlice  slice to be encoded
+ * \returns true if the tiles can be encoded concurrently
+ */
+Bool TEncSlice::xUseParallelEncoding( const TComSlice* pcSlice ) const
+{
+#if ENC_DEC_TRACE
+  // the trace follows the order of the syntax elements
+  return false;
+#else
+  const Bool tilesEnabled = pcSlice->getPPS()->getNumTileColumnsMinus1() > 0 || pcSlice->getPPS()->getNumTileRowsMinus1() > 0;
+  // with wavefronts, each CTU row depends on the context state of the row above
+  return !m_ctuWorkers.empty() && tilesEnabled && !pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
+#endif
+}
+
+/** Encodes the tiles of the slice-segment into their substreams using the threads of the encoder.
+ * The substreams of the tiles are independent; their sizes are recorded in the order of the tiles and the
+ * final context state is taken from the last tile, so the slice data is identical to the sequential encoding.
+ * \param pcPic         picture class
+ * \param pcSubstreams  substreams of the slice-segment, one per tile
+ */
+Void TEncSlice::xEncodeTilesParallel( TComPic* pcPic, TComOutputBitstream* pcSubstreams )
+{
+  TComSlice* const pcSlice           = pcPic->getSlice(getSliceIdx());
+  const UInt       startCtuTsAddr    = pcSlice->getSliceSegmentCurStartCtuTsAddr();
+  const UInt       boundingCtuTsAddr = pcSlice->getSliceSegmentCurEndCtuTsAddr();
+
+  xInitParallelCtuUnits( pcPic, startCtuTsAddr, boundingCtuTsAddr, false );
+
+  const Int numUnits = Int(m_parallelCtuUnits.size());
+  for( Int unitIdx = 0; unitIdx < numUnits; unitIdx++ )
+  {
+    m_pcThreadPool->addJob( [this, pcPic, pcSubstreams, unitIdx]( Int threadIdx ) { xEncodeParallelTile( pcPic, pcSubstreams, unitIdx, threadIdx ); } );
+  }
+  m_pcThreadPool->waitForJobs();
+
+  // write sub-stream sizes
+  UInt numBinsCoded = m_pcBinCABAC->getBinsCoded();
+  for( Int unitIdx = 0; unitIdx < numUnits; unitIdx++ )
+  {
+    const ParallelCtuUnit &unit = m_parallelCtuUnits[unitIdx];
+    if ( unit.boundingCtuTsAddr != boundingCtuTsAddr )
+    {
+      const UInt uiSubStrm = pcPic->getSubstreamForCtuAddr(pcPic->getPicSym()->getCtuTsToRsAddrMap(unit.startCtuTsAddr), true, pcSlice);
+      pcSlice->addSubstreamSize( (pcSubstreams[uiSubStrm].getNumberOfWrittenBits() >> 3) + pcSubstreams[uiSubStrm].countStartCodeEmulations() );
+    }
+    numBinsCoded += unit.numBinsCoded;
+  }
+  m_pcBinCABAC->setBinsCoded( numBinsCoded );
+
+  // continue with the state at the end of the last tile, as after the sequential loop
+  m_pcSbacCoder->loadContexts( m_ctuWorkers[m_parallelCtuUnits.back().threadIdx]->getSbacCoder() );
+}
+
+/** Encodes the CTUs of one tile with the tools of a worker thread, following the steps of the sequential loop in encodeSlice.
+ * \param pcPic         picture class
+ * \param pcSubstreams  substreams of the slice-segment, one per tile
+ * \param unitIdx       index of the unit
+ * \param threadIdx     index of the thread (and of its tools)
+ */
+Void TEncSlice::xEncodeParallelTile( TComPic* pcPic, TComOutputBitstream* pcSubstreams, const Int unitIdx, const Int threadIdx )
+{
+  ParallelCtuUnit  &unit           = m_parallelCtuUnits[unitIdx];
+  TEncCtuWorker*    pcWorker       = m_ctuWorkers[threadIdx];
+  TComSlice* const  pcSlice        = pcPic->getSlice(getSliceIdx());
+  TEncEntropy*      pcEntropyCoder = pcWorker->getEntropyCoder();
+  TEncSbac*         pcSbacCoder    = pcWorker->getSbacCoder();
+  TEncBinCABAC*     pcBinCABAC     = pcWorker->getBinCABAC();
+
+  const UInt firstCtuRsAddr        = pcPic->getPicSym()->getCtuTsToRsAddrMap(unit.startCtuTsAddr);
+  const UInt firstCtuRsAddrOfTile  = pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(firstCtuRsAddr))->getFirstCtuRsAddr();
+  const UInt uiSubStrm             = pcPic->getSubstreamForCtuAddr(firstCtuRsAddr, true, pcSlice);
+
+  unit.threadIdx = threadIdx;
+
+  // start from the state at the start of the slice-segment, or reset it at the start of the tile
+  pcSbacCoder->load( m_pcSbacCoder );
+  pcEntropyCoder->setEntropyCoder ( pcSbacCoder );
+  pcEntropyCoder->setBitstream( &pcSubstreams[uiSubStrm] );
+  if ( firstCtuRsAddr == firstCtuRsAddrOfTile )
+  {
+    pcEntropyCoder->resetEntropy(pcSlice);
+  }
+
+  pcBinCABAC->setBinCountingEnableFlag( true );
+  pcBinCABAC->setBinsCoded(0);
+
+  for( UInt ctuTsAddr = unit.startCtuTsAddr; ctuTsAddr < unit.boundingCtuTsAddr; ++ctuTsAddr )
+  {
+    const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+
+    xEncodeSAOBlkParam( pcPic, pcSlice, ctuRsAddr, pcEntropyCoder );
+
+    pcWorker->getCuEncoder()->encodeCtu( pcPic->getCtu( ctuRsAddr ) );
+  }
+
+  // terminate the sub-stream (end of slice-segment or end of tile)
+  pcEntropyCoder->encodeTerminatingBit(1);
+  pcEntropyCoder->encodeSliceFinish();
+  // Byte-alignment in slice_data() when new tile
+  pcSubstreams[uiSubStrm].writeByteAlignment();
+
+  unit.numBinsCoded = pcBinCABAC->getBinsCoded();
+}
+
+/** Determines whether the CTUs of the slice-segment can be compressed concurrently.
+ * Tools which make a CTU depend on the results of all previously compressed CTUs (or which update the shared lambda
+ * of the encoder) require the sequential compression.
+ * \param pcSlice               slice to be compressed
+ * \param bCompressEntireSlice  the entire slice (not slice segment) is compressed
+ * \returns true if the CTUs can be compressed concurrently
+ */
+Bool TEncSlice::xUseParallelCompression( const TComSlice* pcSlice, const Bool bCompressEntireSlice ) const
+{
+  const Bool tilesEnabled = pcSlice->getPPS()->getNumTileColumnsMinus1() > 0 || pcSlice->getPPS()->getNumTileRowsMinus1() > 0;
+  if ( m_ctuWorkers.empty() || !( m_pcCfg->getEntropyCodingSyncEnabledFlag() || tilesEnabled ) )
+  {
+    return false;
+  }
+  // the QP and lambda of each CTU depend on the bits of the previous CTUs
+  if ( m_pcCfg->getUseRateCtrl() )
+  {
+    return false;
+  }
+  // the end of the slice (segment) depends on the bits of the previous CTUs
+  if ( pcSlice->getSliceMode() == FIXED_NUMBER_OF_BYTES || ( !bCompressEntireSlice && pcSlice->getSliceSegmentMode() == FIXED_NUMBER_OF_BYTES ) )
+  {
+    return false;
+  }
+#if ADAPTIVE_QP_SELECTION
+  // the ARL statistics are collected in the transform & quantization class of the encoder
+  if ( m_pcCfg->getUseAdaptQpSelect() )
+  {
+    return false;
+  }
+#endif
+  // the lambda of the slice is updated for each CU
+  if ( m_pcCfg->getLumaLevelToDeltaQPMapping().isEnabled() )
+  {
+    return false;
+  }
+#if JVET_V0078
+  if ( m_pcCfg->getSmoothQPReductionEnable() )
+  {
+    return false;
+  }
+#endif
+#if JVET_Y0077_BIM
+  if ( m_pcCfg->getBIM() )
+  {
+    return false;
+  }
+#endif
+  return true;
+}
+
+/** Splits the CTUs of the slice-segment into units processed concurrently.
+ * A unit starts at the start of the slice-segment, at each tile and, if requested, at each CTU row of a tile.
+ * \param pcPic              picture class
+ * \param startCtuTsAddr     first CTU of the slice-segment
+ * \param boundingCtuTsAddr  CTU following the last CTU of the slice-segment
+ * \param splitAtCtuRows     start a unit at each CTU row of a tile (wavefronts)
+ */
+Void TEncSlice::xInitParallelCtuUnits( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool splitAtCtuRows )
+{
+  TComPicSym* const pcPicSym         = pcPic->getPicSym();
+  const UInt        frameWidthInCtus = pcPicSym->getFrameWidthInCtus();
+
+  std::vector<Int> ctuUnitIdx( pcPicSym->getNumberOfCtusInFrame(), -1 );
+  m_parallelCtuUnits.clear();
+  for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
+  {
+    const UInt      ctuRsAddr            = pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr);
+    const UInt      tileIdx              = pcPicSym->getTileIdxMap(ctuRsAddr);
+    const TComTile *pCurrentTile         = pcPicSym->getTComTile(tileIdx);
+    const UInt      firstCtuRsAddrOfTile = pCurrentTile->getFirstCtuRsAddr();
+    const UInt      tileXPosInCtus       = firstCtuRsAddrOfTile % frameWidthInCtus;
+    const UInt      ctuXPosInCtus        = ctuRsAddr % frameWidthInCtus;
+
+    if ( ctuTsAddr == startCtuTsAddr || ctuRsAddr == firstCtuRsAddrOfTile || ( splitAtCtuRows && ctuXPosInCtus == tileXPosInCtus ) )
+    {
+      ParallelCtuUnit unit;
+      unit.startCtuTsAddr   = ctuTsAddr;
+      unit.startCtuXPos     = ctuXPosInCtus;
+      unit.boundingTileXPos = tileXPosInCtus + pCurrentTile->getTileWidthInCtus();
+      unit.aboveUnitIdx     = -1;
+      if ( splitAtCtuRows && ctuRsAddr >= frameWidthInCtus && pcPicSym->getTileIdxMap(ctuRsAddr - frameWidthInCtus) == tileIdx )
+      {
+        // the row above may start in a previous slice-segment: its last CTU in the tile identifies the unit holding it
+        const UInt lastCtuRsAddrAbove = ctuRsAddr - frameWidthInCtus - ctuXPosInCtus + unit.boundingTileXPos - 1;
+        unit.aboveUnitIdx   = ctuUnitIdx[lastCtuRsAddrAbove];
+      }
+      unit.storesSyncState  = false;
+      unit.numBits          = 0;
+      unit.numBinsCoded     = 0;
+      unit.threadIdx        = -1;
+      m_parallelCtuUnits.push_back( unit );
+    }
+
+    ParallelCtuUnit &unit  = m_parallelCtuUnits.back();
+    unit.boundingCtuTsAddr = ctuTsAddr + 1;
+    if ( splitAtCtuRows && ctuXPosInCtus == tileXPosInCtus + 1 )
+    {
+      unit.storesSyncState = true;
+    }
+    ctuUnitIdx[ctuRsAddr]  = Int(m_parallelCtuUnits.size()) - 1;
+  }
+}
+
+/** Checks whether the CTU above-right of a CTU (or above, at the right edge of the tile) is compressed by another of the current units.
+ * \param pcPic      picture class
+ * \param unitIdx    unit containing the CTU
+ * \param ctuRsAddr  CTU address in raster scan
+ * \returns true if that CTU belongs to a unit set up by xInitParallelCtuUnits other than unitIdx
+ */
+Bool TEncSlice::xIsCtuAboveRightInOtherParallelUnit( TComPic* pcPic, const Int unitIdx, const UInt ctuRsAddr ) const
+{
+  const TComPicSym* const pcPicSym         = pcPic->getPicSym();
+  const UInt              frameWidthInCtus = pcPicSym->getFrameWidthInCtus();
+  const ParallelCtuUnit  &unit             = m_parallelCtuUnits[unitIdx];
+  if ( ctuRsAddr < frameWidthInCtus || pcPicSym->getTileIdxMap(ctuRsAddr - frameWidthInCtus) != pcPicSym->getTileIdxMap(ctuRsAddr) )
+  {
+    return false;
+  }
+  const UInt ctuXPosInCtus       = ctuRsAddr % frameWidthInCtus;
+  const UInt aboveRightCtuRsAddr = ctuRsAddr - frameWidthInCtus + ( ctuXPosInCtus + 1 < unit.boundingTileXPos ? 1 : 0 );
+  const UInt aboveRightCtuTsAddr = pcPicSym->getCtuRsToTsAddrMap(aboveRightCtuRsAddr);
+  if ( aboveRightCtuTsAddr >= unit.startCtuTsAddr && aboveRightCtuTsAddr < unit.boundingCtuTsAddr )
+  {
+    return false;
+  }
+  return aboveRightCtuTsAddr >= m_parallelCtuUnits.front().startCtuTsAddr && aboveRightCtuTsAddr < m_parallelCtuUnits.back().boundingCtuTsAddr;
+}
+
+/** Compresses the CTUs of the slice-segment using the threads of the encoder.
+ * The CTUs are split into units starting at the start of the slice-segment, at each tile and, if wavefronts are enabled,
+ * at each CTU row of a tile. Tiles are compressed independently of each other. With wavefronts, a CTU is only compressed once the CTU above-right has been compressed and
+ * each unit starts with the context state stored after the second CTU of the row above, as in the sequential order.
+ * The compressed CTUs, the bits of the slice and the final context states are identical to the sequential compression.
+ * \param pcPic              picture class
+ * \param startCtuTsAddr     first CTU of the slice-segment
+ * \param boundingCtuTsAddr  CTU following the last CTU of the slice-segment
+ * \param bFastDeltaQP       fast delta QP mode of the slice
+ */
+Void TEncSlice::xCompressCtusParallel( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool bFastDeltaQP )
+{
+  TComSlice* const  pcSlice           = pcPic->getSlice(getSliceIdx());
+  TComPicSym* const pcPicSym          = pcPic->getPicSym();
+  const Bool        wavefrontsEnabled = m_pcCfg->getEntropyCodingSyncEnabledFlag();
+
+  xInitParallelCtuUnits( pcPic, startCtuTsAddr, boundingCtuTsAddr, wavefrontsEnabled );
+
+  const UInt numUnits = UInt(m_parallelCtuUnits.size());
+  while ( m_parallelCtuUnitSyncStates.size() < numUnits )
+  {
+    m_parallelCtuUnitSyncStates.push_back( new TEncSbac );
+  }
+  m_parallelCtuUnitProgress.init( numUnits );
+  for( UInt unitIdx = 0; unitIdx < numUnits; unitIdx++ )
+  {
+    m_parallelCtuUnitProgress.setProgress( unitIdx, m_parallelCtuUnits[unitIdx].startCtuXPos );
+  }
+
+  // initialize the CTU encoders beforehand: the availability checks of a CU may look at the slice of a CTU in a
+  // neighbouring tile, which is then not yet being compressed.
+  for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
+  {
+    const UInt ctuRsAddr = pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr);
+    pcPic->getCtu( ctuRsAddr )->initCtu( pcPic, ctuRsAddr );
+  }
+
+  // the slice-level set-up (lambdas, search ranges) has been made on the tools of the encoder
+  for( UInt threadIdx = 0; threadIdx < m_ctuWorkers.size(); threadIdx++ )
+  {
+    m_ctuWorkers[threadIdx]->initSlice( pcSlice, m_pcRdCost, m_pcTrQuant, bFastDeltaQP );
+  }
+
+  // the units are started in order, so a unit only waits for units which are already being compressed
+  for( Int unitIdx = 0; unitIdx < Int(numUnits); unitIdx++ )
+  {
+    m_pcThreadPool->addJob( [this, pcPic, unitIdx]( Int threadIdx ) { xCompressParallelCtuUnit( pcPic, unitIdx, threadIdx ); } );
+  }
+  m_pcThreadPool->waitForJobs();
+
+  // gather the results in the order of the sequential compression
+  Int lastSyncUnitIdx = -1;
+  for( UInt unitIdx = 0; unitIdx < numUnits; unitIdx++ )
+  {
+    const ParallelCtuUnit &unit = m_parallelCtuUnits[unitIdx];
+    pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + unit.numBits) );
+    pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits() + unit.numBits);
+    if ( unit.storesSyncState )
+    {
+      lastSyncUnitIdx = unitIdx;
+    }
+  }
+  if ( lastSyncUnitIdx >= 0 )
+  {
+    m_entropyCodingSyncContextState.loadContexts( m_parallelCtuUnitSyncStates[lastSyncUnitIdx] );
+  }
+
+  TEncCtuWorker* pcLastWorker = m_ctuWorkers[m_parallelCtuUnits.back().threadIdx];
+  m_pppcRDSbacCoder[0][CI_CURR_BEST]->load( pcLastWorker->getRDSbacCoder()[0][CI_CURR_BEST] );
+  m_pcRDGoOnSbacCoder->load( pcLastWorker->getRDGoOnSbacCoder() );
+
+  for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
+  {
+    TComDataCU* pCtu = pcPic->getCtu( pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr) );
+    m_uiPicTotalBits += pCtu->getTotalBits();
+    m_dPicRdCost     += pCtu->getTotalCost();
+    m_uiPicDist      += pCtu->getTotalDistortion();
+  }
+}
+
+/** Compresses the CTUs of one unit with the tools of a worker thread, following the steps of the sequential loop in compressSlice.
+ * \param pcPic      picture class
+ * \param unitIdx    index of the unit
+ * \param threadIdx  index of the thread (and of its tools)
+ */
+Void TEncSlice::xCompressParallelCtuUnit( TComPic* pcPic, const Int unitIdx, const Int threadIdx )
+{
+  ParallelCtuUnit  &unit             = m_parallelCtuUnits[unitIdx];
+  TEncCtuWorker*    pcWorker         = m_ctuWorkers[threadIdx];
+  TComSlice* const  pcSlice          = pcPic->getSlice(getSliceIdx());
+  const UInt        frameWidthInCtus = pcPic->getPicSym()->getFrameWidthInCtus();
+
+  TEncEntropy*      pcEntropyCoder   = pcWorker->getEntropyCoder();
+  TEncSbac*         pcCurrBestCoder  = pcWorker->getRDSbacCoder()[0][CI_CURR_BEST];
+  TEncSbac*         pcRDGoOnCoder    = pcWorker->getRDGoOnSbacCoder();
+  TEncBinCABAC*     pRDSbacCoder     = (TEncBinCABAC *) pcCurrBestCoder->getEncBinIf();
+  TComBitCounter    tempBitCounter;
+
+  unit.threadIdx = threadIdx;
+  unit.numBits   = 0;
+
+  // start from the state at the start of the slice-segment
+  pcCurrBestCoder->load( m_pppcRDSbacCoder[0][CI_CURR_BEST] );
+  pRDSbacCoder->setBinCountingEnableFlag( false );
+  pRDSbacCoder->setBinsCoded( 0 );
+
+  for( UInt ctuTsAddr = unit.startCtuTsAddr; ctuTsAddr < unit.boundingCtuTsAddr; ++ctuTsAddr )
+  {
+    const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+    const UInt firstCtuRsAddrOfTile = pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
+    const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
+    const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
+
+    // wait for the CTUs above and above-right
+    assert( unit.aboveUnitIdx >= 0 || !xIsCtuAboveRightInOtherParallelUnit( pcPic, unitIdx, ctuRsAddr ) );
+    if ( unit.aboveUnitIdx >= 0 )
+    {
+      m_parallelCtuUnitProgress.waitForProgress( unit.aboveUnitIdx, std::min( ctuXPosInCtus + 2, unit.boundingTileXPos ) );
+    }
+
+    // the CTU encoder has been initialized by xCompressCtusParallel
+    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+
+    // update CABAC state
+    if (ctuRsAddr == firstCtuRsAddrOfTile)
+    {
+      pcCurrBestCoder->resetEntropy(pcSlice);
+    }
+    else if ( ctuXPosInCtus == tileXPosInCtus && m_pcCfg->getEntropyCodingSyncEnabledFlag())
+    {
+      // reset and then update contexts to the state at the end of the top-right CTU (if within current slice and tile).
+      pcCurrBestCoder->resetEntropy(pcSlice);
+      // Sync if the Top-Right is available.
+      TComDataCU *pCtuUp = pCtu->getCtuAbove();
+      if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
+      {
+        TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+        if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+        {
+          // Top-Right is available: its state was stored either by the unit above or by a previous slice-segment.
+          const Int aboveUnitIdx = unit.aboveUnitIdx;
+          if ( aboveUnitIdx >= 0 && m_parallelCtuUnits[aboveUnitIdx].storesSyncState )
+          {
+            pcCurrBestCoder->loadContexts( m_parallelCtuUnitSyncStates[aboveUnitIdx] );
+          }
+          else
+          {
+            pcCurrBestCoder->loadContexts( &m_entropyCodingSyncContextState );
+          }
+        }
+      }
+    }
+
+    // set go-on entropy coder
+    pcEntropyCoder->setEntropyCoder ( pcRDGoOnCoder );
+    pcEntropyCoder->setBitstream( &tempBitCounter );
+    tempBitCounter.resetBits();
+    pcRDGoOnCoder->load( pcCurrBestCoder );
+
+    ((TEncBinCABAC*)pcRDGoOnCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+
+    // run CTU trial encoder
+    pcWorker->getCuEncoder()->compressCtu( pCtu );
+
+    // encode CTU and calculate the true bit counters.
+    pcEntropyCoder->setEntropyCoder ( pcCurrBestCoder );
+    pcEntropyCoder->setBitstream( &tempBitCounter );
+    pRDSbacCoder->setBinCountingEnableFlag( true );
+    pcCurrBestCoder->resetBits();
+    pRDSbacCoder->setBinsCoded( 0 );
+
+    pcWorker->getCuEncoder()->encodeCtu( pCtu );
+
+    pRDSbacCoder->setBinCountingEnableFlag( false );
+
+    unit.numBits += pcEntropyCoder->getNumberOfWrittenBits();
+
+    // Store probabilities of second CTU in line into buffer
+    if ( ctuXPosInCtus == tileXPosInCtus+1 && m_pcCfg->getEntropyCodingSyncEnabledFlag())
+    {
+      m_parallelCtuUnitSyncStates[unitIdx]->loadContexts( pcCurrBestCoder );
+    }
+
+    m_parallelCtuUnitProgress.setProgress( unitIdx, ctuXPosInCtus + 1 );
+  }
+
+  // stop use of temporary bit counter object.
+  pcCurrBestCoder->setBitstream(NULL);
+  pcRDGoOnCoder->setBitstream(NULL);
+}
+
 //! \}
@@ -43,7 +43,9 @@
 #include "TLibCommon/TComList.h"
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/TComThreadPool.h"
 #include "TEncCu.h"
+#include "TEncCtuWorker.h"
 #include "WeightPredAnalysis.h"
 #include "TEncRateCtrl.h"
 
@@ -100,6 +102,25 @@ private:
   SliceType               m_encCABACTableIdx;
   Int                     m_gopID;
 
+  // parallel CTU compression
+  struct ParallelCtuUnit
+  {
+    UInt                  startCtuTsAddr;                       ///< first CTU of the unit
+    UInt                  boundingCtuTsAddr;                    ///< CTU following the last CTU of the unit
+    UInt                  startCtuXPos;                         ///< horizontal position (in CTUs) of the first CTU
+    UInt                  boundingTileXPos;                     ///< horizontal position (in CTUs) following the right-most CTU of the tile
+    Int                   aboveUnitIdx;                         ///< unit holding the CTU row above in the same tile (-1: not compressed in this run)
+    Bool                  storesSyncState;                      ///< the unit contains the second CTU of the tile-row
+    UInt                  numBits;                              ///< sum of the bits written for the CTUs of the unit
+    UInt                  numBinsCoded;                         ///< number of bins written to the substream of the unit
+    Int                   threadIdx;                            ///< thread that compressed the unit
+  };
+  TComThreadPool*             m_pcThreadPool;                   ///< threads compressing CTUs concurrently
+  std::vector<TEncCtuWorker*> m_ctuWorkers;                     ///< CTU compression tools, one set per thread
+  std::vector<ParallelCtuUnit> m_parallelCtuUnits;              ///< units compressed/encoded concurrently in the current slice-segment
+  std::vector<TEncSbac*>  m_parallelCtuUnitSyncStates;          ///< context storage for the wavefront state stored by each unit
+  TComCtuRowProgress      m_parallelCtuUnitProgress;            ///< horizontal position following the last compressed CTU of each unit
+
   Double   calculateLambda( const TComSlice* pSlice, const Int GOPid, const Int depth, const Double refQP, const Double dQP, Int &iQP );
   Void     setUpLambda(TComSlice* slice, const Double dLambda, Int iQP);
   Void     calculateBoundingCtuTsAddrForSlice(UInt &startCtuTSAddrSlice, UInt &boundingCtuTSAddrSlice, Bool &haveReachedTileBoundary, TComPic* pcPic, const Int sliceMode, const Int sliceArgument);
@@ -111,6 +132,7 @@ public:
   Void    create              ( Int iWidth, Int iHeight, ChromaFormat chromaFormat, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth );
   Void    destroy             ();
   Void    init                ( TEncTop* pcEncTop );
+  Void    init                ( TEncTop* pcEncTop, TEncCtuWorker* pcTools );
   Void    resetEncoderDecisions() { m_encCABACTableIdx = I_SLICE; }
 
   /// preparation of slice encoding (reference marking, QP and lambda)
@@ -139,6 +161,16 @@ public:
 
 private:
   Double  xGetQPValueAccordingToLambda ( Double lambda );
+
+  Bool    xUseParallelCompression      ( const TComSlice* pcSlice, const Bool bCompressEntireSlice ) const;
+  Void    xInitParallelCtuUnits        ( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool splitAtCtuRows );
+  Void    xCompressCtusParallel        ( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool bFastDeltaQP );
+  Void    xCompressParallelCtuUnit     ( TComPic* pcPic, const Int unitIdx, const Int threadIdx );
+  Bool    xIsCtuAboveRightInOtherParallelUnit( TComPic* pcPic, const Int unitIdx, const UInt ctuRsAddr ) const;
+  Void    xEncodeSAOBlkParam           ( TComPic* pcPic, const TComSlice* pcSlice, const UInt ctuRsAddr, TEncEntropy* pcEntropyCoder );
+  Bool    xUseParallelEncoding         ( const TComSlice* pcSlice ) const;
+  Void    xEncodeTilesParallel         ( TComPic* pcPic, TComOutputBitstream* pcSubstreams );
+  Void    xEncodeParallelTile          ( TComPic* pcPic, TComOutputBitstream* pcSubstreams, const Int unitIdx, const Int threadIdx );
 };
 
 //! \}
@@ -36,6 +36,9 @@
 */
 #include "TEncTemporalFilter.h"
 #include <math.h>
+#if ENABLE_SIMD_OPT_MCTF
+#include "TLibCommon/x86/CommonDefX86.h"
+#endif
 
 
 // ====================================================================================================================
@@ -96,8 +99,32 @@ TEncTemporalFilter::TEncTemporalFilter() :
   m_GOPSize(0),
   m_framesToBeEncoded(0),
   m_bClipInputVideoToRec709Range(false),
-  m_inputColourSpaceConvert(NUMBER_INPUT_COLOUR_SPACE_CONVERSIONS)
-{}
+  m_inputColourSpaceConvert(NUMBER_INPUT_COLOUR_SPACE_CONVERSIONS),
+  m_motionErrorLuma(xMotionErrorLuma)
+{
+#if ENABLE_SIMD_OPT_MCTF
+  initTemporalFilterX86();
+#endif
+}
+
+#if ENABLE_SIMD_OPT_MCTF
+/**
+ * \brief Replace the C motion error with the kernel for the best vector extension of the CPU
+ */
+Void TEncTemporalFilter::initTemporalFilterX86()
+{
+  const X86_VEXT vext = getX86Extension();
+
+  if( vext >= AVX2 )
+  {
+    xInitTemporalFilterX86<AVX2>();
+  }
+  else if( vext >= SSE41 )
+  {
+    xInitTemporalFilterX86<SSE41>();
+  }
+}
+#endif
 
 void TEncTemporalFilter::init(const Int frameSkip,
                               const Int inputBitDepth[MAX_NUM_CHANNEL_TYPE],
@@ -118,13 +145,14 @@ void TEncTemporalFilter::init(const Int frameSkip,
                               const Int futureRefs,
                               const Int firstValidFrame,
 #if !JVET_Y0077_BIM
-                              const Int lastValidFrame)
+                              const Int lastValidFrame,
 #else
                               const Int lastValidFrame,
                               const Bool mctfEnabled,
                               std::map<Int, Int*> *adaptQPmap,
-                              const Bool bimEnabled)
+                              const Bool bimEnabled,
 #endif
+                              const Int numThreads)
 {
   m_FrameSkip = frameSkip;
   for (Int i = 0; i < MAX_NUM_CHANNEL_TYPE; i++)
@@ -159,6 +187,45 @@ void TEncTemporalFilter::init(const Int frameSkip,
   m_numCTU = ((width + 63) / 64) * ((height + 63) / 64);
   m_ctuAdaptQP = adaptQPmap;
 #endif
+
+  // tabulate the exponential of the bilateral filter, which only depends on the sample difference and on sw
+  const Double lumaSigmaSq = (m_QP - s_sigmaZeroPoint) * (m_QP - s_sigmaZeroPoint) * s_sigmaMultiplier;
+  const Double chromaSigmaSq = 30 * 30;
+  for (Int ch = 0; ch < MAX_NUM_CHANNEL_TYPE; ch++)
+  {
+    const Double sigmaSq = isChroma(ChannelType(ch)) ? chromaSigmaSq : lumaSigmaSq;
+    const Pel maxSampleValue = (1<<m_internalBitDepth[ch])-1;
+    const Double bitDepthDiffWeighting=1024.0 / (maxSampleValue+1);
+#if JVET_V0056_MCTF || JVET_Y0077_BIM
+    for (Int swIdx = 0; swIdx < 4; swIdx++)
+    {
+      Double sw = 1;
+      sw *= (swIdx & 2) ? 0.8 : 1.3; // noise >= 25
+      sw *= (swIdx & 1) ? 1 : 1.3;   // error >= 50
+#else
+    {
+      const Int swIdx = 0;
+#endif
+      m_bilateralWeights[ch][swIdx].resize(maxSampleValue + 1);
+      for (Int absDiff = 0; absDiff <= maxSampleValue; absDiff++)
+      {
+        Double diff = (Double)absDiff;
+        diff *= bitDepthDiffWeighting;
+        Double diffSq = diff * diff;
+#if JVET_V0056_MCTF || JVET_Y0077_BIM
+        m_bilateralWeights[ch][swIdx][absDiff] = exp(-diffSq / (2 * sw * sigmaSq));
+#else
+        m_bilateralWeights[ch][swIdx][absDiff] = exp(-diffSq / (2 * sigmaSq));
+#endif
+      }
+    }
+  }
+
+  m_threadPool.destroy();
+  if (numThreads > 1)
+  {
+    m_threadPool.create(numThreads);
+  }
 }
 
 // ====================================================================================================================
@@ -207,7 +274,7 @@ Bool TEncTemporalFilter::filter(TComPicYuv *orgPic, Int receivedPoc)
     subsampleLuma(origPadded, origSubsampled2);
     subsampleLuma(origSubsampled2, origSubsampled4);
 
-    // determine motion vectors
+    // read the reference pictures
     for (Int poc = firstFrame; poc <= lastFrame; poc++)
     {
       if (poc == currentFilePoc)
@@ -230,11 +297,24 @@ Bool TEncTemporalFilter::filter(TComPicYuv *orgPic, Int receivedPoc)
       }
       srcPic.picBuffer.extendPicBorder();
       srcPic.mvs.allocate(m_sourceWidth / 4, m_sourceHeight / 4);
-
-      motionEstimation(srcPic.mvs, origPadded, srcPic.picBuffer, origSubsampled2, origSubsampled4);
       srcPic.origOffset = poc - currentFilePoc;
     }
 
+    // determine motion vectors, one reference picture per thread
+    for (Int i = 0; i < Int(srcFrameInfo.size()); i++)
+    {
+      TemporalFilterSourcePicInfo &srcPic = srcFrameInfo[i];
+      if (m_threadPool.getNumThreads() > 0)
+      {
+        m_threadPool.addJob( [this, &srcPic, &origPadded, &origSubsampled2, &origSubsampled4]( Int ) { motionEstimation(srcPic.mvs, origPadded, srcPic.picBuffer, origSubsampled2, origSubsampled4); } );
+      }
+      else
+      {
+        motionEstimation(srcPic.mvs, origPadded, srcPic.picBuffer, origSubsampled2, origSubsampled4);
+      }
+    }
+    m_threadPool.waitForJobs();
+
     // filter
     TComPicYuv newOrgPic;
     newOrgPic.createWithoutCUInfo(m_sourceWidth, m_sourceHeight, m_chromaFormatIDC, true, s_padding, s_padding);
@@ -375,20 +455,32 @@ Int TEncTemporalFilter::motionErrorLuma(const TComPicYuv &orig,
                                         const Int bs,
                                         const Int besterror /* = 8 * 8 * 1024 * 1024*/) const
 {
-
-  const Pel* origOrigin = orig.getAddr(COMPONENT_Y);
   const Int origStride  = orig.getStride(COMPONENT_Y);
-  const Pel *buffOrigin = buffer.getAddr(COMPONENT_Y);
+  const Pel *origBlock  = orig.getAddr(COMPONENT_Y) + y * origStride + x;
   const Int buffStride  = buffer.getStride(COMPONENT_Y);
+  const Pel *buffBlock  = buffer.getAddr(COMPONENT_Y) + (y + (dy >> 4)) * buffStride + (x + (dx >> 4));
+  const Pel maxSampleValue = (1<<m_internalBitDepth[CHANNEL_TYPE_LUMA])-1;
+
+  return m_motionErrorLuma(origBlock, origStride, buffBlock, buffStride, bs, dx & 0xF, dy & 0xF, besterror, maxSampleValue);
+}
+
+Int TEncTemporalFilter::xMotionErrorLuma(const Pel *org,
+                                               Int orgStride,
+                                         const Pel *buf,
+                                               Int bufStride,
+                                               Int bs,
+                                               Int dxFrac,
+                                               Int dyFrac,
+                                               Int besterror,
+                                               Int maxSampleValue)
+{
   Int error = 0;// dx * 10 + dy * 10;
-  if (((dx | dy) & 0xF) == 0)
+  if ((dxFrac | dyFrac) == 0)
   {
-    dx /= s_motionVectorFactor;
-    dy /= s_motionVectorFactor;
     for (Int y1 = 0; y1 < bs; y1++)
     {
-      const Pel* origRowStart = origOrigin + (y+y1)*origStride + x;
-      const Pel* bufferRowStart = buffOrigin + (y+y1+dy)*buffStride + (x+dx);
+      const Pel* origRowStart = org + y1*orgStride;
+      const Pel* bufferRowStart = buf + y1*bufStride;
       for (Int x1 = 0; x1 < bs; x1 += 2)
       {
         Int diff = origRowStart[x1] - bufferRowStart[x1];
@@ -404,20 +496,18 @@ Int TEncTemporalFilter::motionErrorLuma(const TComPicYuv &orig,
   }
   else
   {
-    const Int *xFilter = s_interpolationFilter[dx & 0xF];
-    const Int *yFilter = s_interpolationFilter[dy & 0xF];
+    const Int *xFilter = s_interpolationFilter[dxFrac];
+    const Int *yFilter = s_interpolationFilter[dyFrac];
     Int tempArray[64 + 8][64];
 
-    Int iSum, iBase;
+    Int iSum;
     for (Int y1 = 1; y1 < bs + 7; y1++)
     {
-      const Int yOffset = y + y1 + (dy >> 4) - 3;
-      const Pel *sourceRow = buffOrigin + (yOffset)*buffStride + 0;
+      const Pel *sourceRow = buf + (y1 - 3)*bufStride;
       for (Int x1 = 0; x1 < bs; x1++)
       {
         iSum = 0;
-        iBase = x + x1 + (dx >> 4) - 3;
-        const Pel *rowStart = sourceRow + iBase;
+        const Pel *rowStart = sourceRow + x1 - 3;
 
         iSum += xFilter[1] * rowStart[1];
         iSum += xFilter[2] * rowStart[2];
@@ -430,10 +520,9 @@ Int TEncTemporalFilter::motionErrorLuma(const TComPicYuv &orig,
       }
     }
 
-    const Pel maxSampleValue = (1<<m_internalBitDepth[CHANNEL_TYPE_LUMA])-1;
     for (Int y1 = 0; y1 < bs; y1++)
     {
-      const Pel *origRow = origOrigin + (y+y1)*origStride + 0;
+      const Pel *origRow = org + y1*orgStride;
       for (Int x1 = 0; x1 < bs; x1++)
       {
         iSum = 0;
@@ -447,7 +536,7 @@ Int TEncTemporalFilter::motionErrorLuma(const TComPicYuv &orig,
         iSum = (iSum + (1 << 11)) >> 12;
         iSum = iSum < 0 ? 0 : (iSum > maxSampleValue ? maxSampleValue : iSum);
 
-        error += (iSum - origRow[x + x1]) * (iSum - origRow[x + x1]);
+        error += (iSum - origRow[x1]) * (iSum - origRow[x1]);
       }
       if (error > besterror)
       {
@@ -633,7 +722,7 @@ Void TEncTemporalFilter::motionEstimation(Array2D<MotionVector> &mv, const TComP
   motionEstimationLuma(mv, orgPic, buffer, 8, &mv_2, 1, true);
 }
 
-Void TEncTemporalFilter::applyMotion(const Array2D<MotionVector> &mvs, const TComPicYuv &input, TComPicYuv &output) const
+Void TEncTemporalFilter::applyMotion(const Array2D<MotionVector> &mvs, const TComPicYuv &input, TComPicYuv &output, const Int firstBlockRow, const Int endBlockRow) const
 {
   static const Int lumaBlockSize=8;
 
@@ -655,7 +744,7 @@ Void TEncTemporalFilter::applyMotion(const Array2D<MotionVector> &mvs, const TCo
           Pel *pDstImage=output.getAddr(compID);
           Int dstStride=output.getStride(compID);
 
-    for (Int y = 0, blockNumY = 0; y + blockSizeY <= height; y += blockSizeY, blockNumY++)
+    for (Int y = firstBlockRow * blockSizeY, blockNumY = firstBlockRow; y + blockSizeY <= height && blockNumY < endBlockRow; y += blockSizeY, blockNumY++)
     {
       for (Int x = 0, blockNumX = 0; x + blockSizeX <= width; x += blockSizeX, blockNumX++)
       {
@@ -725,43 +814,71 @@ Void TEncTemporalFilter::bilateralFilter(const TComPicYuv &orgPic,
                                          const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo,
 #endif
                                                TComPicYuv &newOrgPic,
-                                               Double overallStrength) const
+                                               Double overallStrength)
 {
+  static const Int lumaBlockSize=8;
   const int numRefs = Int(srcFrameInfo.size());
   std::vector<TComPicYuv> correctedPics(numRefs);
   for (Int i = 0; i < numRefs; i++)
   {
     correctedPics[i].createWithoutCUInfo( m_sourceWidth, m_sourceHeight, orgPic.getChromaFormat(), true, s_padding, s_padding );
-    applyMotion(srcFrameInfo[i].mvs, srcFrameInfo[i].picBuffer, correctedPics[i]);
+  }
+
+  // each row of 8x8 luma blocks only depends on the same block row of the motion compensated references
+  const Int numBlockRows = (m_sourceHeight + lumaBlockSize - 1) / lumaBlockSize;
+  if (m_threadPool.getNumThreads() > 0)
+  {
+    for (Int blockRow = 0; blockRow < numBlockRows; blockRow++)
+    {
+      m_threadPool.addJob( [this, &orgPic, &srcFrameInfo, &correctedPics, &newOrgPic, overallStrength, blockRow]( Int ) { bilateralFilterBlockRows(orgPic, srcFrameInfo, correctedPics, newOrgPic, overallStrength, blockRow, blockRow + 1); } );
+    }
+    m_threadPool.waitForJobs();
+  }
+  else
+  {
+    bilateralFilterBlockRows(orgPic, srcFrameInfo, correctedPics, newOrgPic, overallStrength, 0, numBlockRows);
+  }
+}
+
+Void TEncTemporalFilter::bilateralFilterBlockRows(const TComPicYuv &orgPic,
+#if JVET_V0056_MCTF || JVET_Y0077_BIM
+                                                        std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo,
+#else
+                                                  const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo,
+#endif
+                                                        std::vector<TComPicYuv> &correctedPics,
+                                                        TComPicYuv &newOrgPic,
+                                                        Double overallStrength,
+                                                        Int firstBlockRow,
+                                                        Int endBlockRow) const
+{
+  const int numRefs = Int(srcFrameInfo.size());
+  for (Int i = 0; i < numRefs; i++)
+  {
+    applyMotion(srcFrameInfo[i].mvs, srcFrameInfo[i].picBuffer, correctedPics[i], firstBlockRow, endBlockRow);
   }
 
   const Int refStrengthRow = m_futureRefs > 0 ? 0 : 1;
 
-  const Double lumaSigmaSq = (m_QP - s_sigmaZeroPoint) * (m_QP - s_sigmaZeroPoint) * s_sigmaMultiplier;
-  const Double chromaSigmaSq = 30 * 30;
-  
   for(Int c=0; c< getNumberValidComponents(m_chromaFormatIDC); c++)
   {
     const ComponentID compID=(ComponentID)c;
-    const Int height = orgPic.getHeight(compID);
+    static const Int lumaBlockSize=8;
+    const Int csx=getComponentScaleX(compID, m_chromaFormatIDC);
+    const Int csy=getComponentScaleY(compID, m_chromaFormatIDC);
+    const Int blkSizeX = lumaBlockSize>>csx;
+    const Int blkSizeY = lumaBlockSize>>csy;
+    const Int height = std::min<Int>(orgPic.getHeight(compID), endBlockRow * blkSizeY);
     const Int width  = orgPic.getWidth(compID);
-    const Pel *srcPelRow = orgPic.getAddr(compID);
     const Int srcStride = orgPic.getStride(compID);
-          Pel *dstPelRow = newOrgPic.getAddr(compID);
+    const Pel *srcPelRow = orgPic.getAddr(compID) + firstBlockRow * blkSizeY * srcStride;
     const Int dstStride = newOrgPic.getStride(compID);
-    const Double sigmaSq = isChroma(compID)? chromaSigmaSq : lumaSigmaSq;
+          Pel *dstPelRow = newOrgPic.getAddr(compID) + firstBlockRow * blkSizeY * dstStride;
     const Double weightScaling = overallStrength * (isChroma(compID) ? s_chromaFactor : 0.4);
     const Pel maxSampleValue = (1<<m_internalBitDepth[toChannelType(compID)])-1;
-    const Double bitDepthDiffWeighting=1024.0 / (maxSampleValue+1);
-#if JVET_V0056_MCTF || JVET_Y0077_BIM
-    static const Int lumaBlockSize=8;    
-    const Int csx=getComponentScaleX(compID, m_chromaFormatIDC);
-    const Int csy=getComponentScaleY(compID, m_chromaFormatIDC);
-    const Int blkSizeX = lumaBlockSize>>csx;
-    const Int blkSizeY = lumaBlockSize>>csy;    
-#endif
+    const std::vector<Double> *bilateralWeights = m_bilateralWeights[toChannelType(compID)];
 
-    for (Int y = 0; y < height; y++, srcPelRow+=srcStride, dstPelRow+=dstStride)
+    for (Int y = firstBlockRow * blkSizeY; y < height; y++, srcPelRow+=srcStride, dstPelRow+=dstStride)
     {
       const Pel *srcPel=srcPelRow;
             Pel *dstPel=dstPelRow;
@@ -827,21 +944,18 @@ Void TEncTemporalFilter::bilateralFilter(const TComPicYuv &orgPic,
 #endif
           const Pel *pCorrectedPelPtr=correctedPics[i].getAddr(compID)+(y*correctedPics[i].getStride(compID)+x);
           const Int refVal = (Int) *pCorrectedPelPtr;
-          Double diff = (Double)(refVal - orgVal);
-          diff *= bitDepthDiffWeighting;
-          Double diffSq = diff * diff;
+          const Int absDiff = std::abs(refVal - orgVal);
 #if JVET_V0056_MCTF || JVET_Y0077_BIM
           const Int index = std::min(3, std::abs(srcFrameInfo[i].origOffset) - 1);
-          Double ww = 1, sw = 1;
+          Double ww = 1;
           ww *= (noise < 25) ? 1 : 1.2;
-          sw *= (noise < 25) ? 1.3 : 0.8;
           ww *= (error < 50) ? 1.2 : ((error > 100) ? 0.8 : 1);
-          sw *= (error < 50) ? 1.3 : 1;
           ww *= ((minError + 1) / (error + 1));
-          const Double weight = weightScaling * s_refStrengths[refStrengthRow][index] * ww * exp(-diffSq / (2 * sw * sigmaSq));
+          const Int swIdx = ((noise < 25) ? 0 : 2) + ((error < 50) ? 0 : 1);
+          const Double weight = weightScaling * s_refStrengths[refStrengthRow][index] * ww * bilateralWeights[swIdx][absDiff];
 #else
           const Int index = std::min(1, std::abs(srcFrameInfo[i].origOffset) - 1);
-          const Double weight = weightScaling * s_refStrengths[refStrengthRow][index] * exp(-diffSq / (2 * sigmaSq));
+          const Double weight = weightScaling * s_refStrengths[refStrengthRow][index] * bilateralWeights[0][absDiff];
 #endif
           newVal += weight * refVal;
           temporalWeightSum += weight;
@@ -38,6 +38,7 @@
 #ifndef __TEMPORAL_FILTER__
 #define __TEMPORAL_FILTER__
 #include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/TComThreadPool.h"
 #include "Utilities/TVideoIOYuv.h"
 #include <sstream>
 #include <map>
@@ -130,17 +131,22 @@ public:
             const Int futureRefs,
             const Int firstValidFrame,
 #if !JVET_Y0077_BIM
-            const Int lastValidFrame);
+            const Int lastValidFrame,
 #else
             const Int lastValidFrame,
             const Bool mctfEnabled,
             std::map<Int, Int*> *adaptQPmap,
-            const Bool bimEnabled);
+            const Bool bimEnabled,
 #endif
+            const Int numThreads);
 
   Bool filter(TComPicYuv *orgPic, Int frame);
 
 private:
+  /// sum of squared errors between the bs x bs luma block org and the block of buf displaced by the fractional part (dxFrac, dyFrac)
+  /// of a motion vector, in units of 1/16 sample. Returns early with a partial sum larger than besterror.
+  typedef Int (*FpMotionErrorLuma)(const Pel *org, Int orgStride, const Pel *buf, Int bufStride, Int bs, Int dxFrac, Int dyFrac, Int besterror, Int maxSampleValue);
+
   // Private static member variables
   static const Double s_chromaFactor;
   static const Double s_sigmaMultiplier;
@@ -183,8 +189,21 @@ private:
   Int m_numCTU;
   std::map<Int, Int*> *m_ctuAdaptQP;
 #endif
+  std::vector<Double> m_bilateralWeights[MAX_NUM_CHANNEL_TYPE][4]; ///< exp(-diffSq / (2 * sw * sigmaSq)) per absolute sample difference, for each value of sw
+  TComThreadPool m_threadPool;          ///< threads estimating the motion of the references and filtering block rows concurrently
+  FpMotionErrorLuma m_motionErrorLuma;
 
   // Private functions
+  static Int xMotionErrorLuma(const Pel *org, Int orgStride, const Pel *buf, Int bufStride, Int bs, Int dxFrac, Int dyFrac, Int besterror, Int maxSampleValue);
+#if ENABLE_SIMD_OPT_MCTF
+  // SIMD kernels (x86/TEncTemporalFilterX86.h)
+  template<X86_VEXT vext>
+  static Int xMotionErrorLuma_SIMD(const Pel *org, Int orgStride, const Pel *buf, Int bufStride, Int bs, Int dxFrac, Int dyFrac, Int besterror, Int maxSampleValue);
+
+  template<X86_VEXT vext> Void xInitTemporalFilterX86();
+  Void initTemporalFilterX86();
+#endif
+
   Void subsampleLuma(const TComPicYuv &input, TComPicYuv &output, const Int factor = 2) const;
   Int motionErrorLuma(const TComPicYuv &orig, const TComPicYuv &buffer, const Int x, const Int y, Int dx, Int dy, const Int bs, const Int besterror = 8 * 8 * 1024 * 1024) const;
   Void motionEstimationLuma(Array2D<MotionVector> &mvs, const TComPicYuv &orig, const TComPicYuv &buffer, const Int bs,
@@ -192,11 +211,15 @@ private:
   Void motionEstimation(Array2D<MotionVector> &mvs, const TComPicYuv &orgPic, const TComPicYuv &buffer, const TComPicYuv &origSubsampled2, const TComPicYuv &origSubsampled4) const;
 
 #if JVET_V0056_MCTF
-  Void bilateralFilter(const TComPicYuv &orgPic, std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, TComPicYuv &newOrgPic, Double overallStrength) const;
+  Void bilateralFilter(const TComPicYuv &orgPic, std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, TComPicYuv &newOrgPic, Double overallStrength);
+  Void bilateralFilterBlockRows(const TComPicYuv &orgPic, std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, std::vector<TComPicYuv> &correctedPics,
+                                TComPicYuv &newOrgPic, Double overallStrength, Int firstBlockRow, Int endBlockRow) const;
 #else
-  Void bilateralFilter(const TComPicYuv &orgPic, const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, TComPicYuv &newOrgPic, Double overallStrength) const;
+  Void bilateralFilter(const TComPicYuv &orgPic, const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, TComPicYuv &newOrgPic, Double overallStrength);
+  Void bilateralFilterBlockRows(const TComPicYuv &orgPic, const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, std::vector<TComPicYuv> &correctedPics,
+                                TComPicYuv &newOrgPic, Double overallStrength, Int firstBlockRow, Int endBlockRow) const;
 #endif
-  Void applyMotion(const Array2D<MotionVector> &mvs, const TComPicYuv &input, TComPicYuv &output) const;
+  Void applyMotion(const Array2D<MotionVector> &mvs, const TComPicYuv &input, TComPicYuv &output, const Int firstBlockRow = 0, const Int endBlockRow = MAX_INT) const;
 }; // END CLASS DEFINITION TEncTemporalFilter
 
 //! \}
@@ -97,7 +97,7 @@ Void TEncTop::create ()
   m_cCuEncoder.         create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, m_chromaFormatIDC );
   if (m_bUseSAO)
   {
-    m_cEncSAO.create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth, m_log2SaoOffsetScale[CHANNEL_TYPE_LUMA], m_log2SaoOffsetScale[CHANNEL_TYPE_CHROMA] );
+    m_cEncSAO.create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth, m_log2SaoOffsetScale[CHANNEL_TYPE_LUMA], m_log2SaoOffsetScale[CHANNEL_TYPE_CHROMA], &m_cThreadPool );
     m_cEncSAO.createEncData(getSaoCtuBoundary());
   }
 #if ADAPTIVE_QP_SELECTION
@@ -107,8 +107,6 @@ Void TEncTop::create ()
   }
 #endif
 
-  m_cLoopFilter.create( m_maxTotalCUDepth );
-
   if ( m_RCEnableRateControl )
   {
 #if JVET_Y0105_SW_AND_QDF
@@ -148,6 +146,34 @@ Void TEncTop::create ()
       m_pppcRDSbacCoder   [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC [iDepth][iCIIdx] );
     }
   }
+
+  if ( m_numCtuThreads > 1 )
+  {
+    for ( Int threadIdx = 0; threadIdx < m_numCtuThreads; threadIdx++ )
+    {
+      TEncCtuWorker* pcWorker = new TEncCtuWorker;
+      pcWorker->create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, m_chromaFormatIDC );
+      m_ctuWorkers.push_back( pcWorker );
+    }
+    m_cThreadPool.create( m_numCtuThreads );
+  }
+  m_cLoopFilter.create( m_maxTotalCUDepth, &m_cThreadPool );
+
+  // the first picture of a group of pictures compressed concurrently uses m_cSliceEncoder, the others use their own
+  if ( m_numFrameThreads > 1 )
+  {
+    for ( Int threadIdx = 0; threadIdx < m_numFrameThreads - 1; threadIdx++ )
+    {
+      TEncCtuWorker* pcWorker = new TEncCtuWorker;
+      pcWorker->create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, m_chromaFormatIDC );
+      m_frameWorkers.push_back( pcWorker );
+
+      TEncSlice* pcSliceEncoder = new TEncSlice;
+      pcSliceEncoder->create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth );
+      m_frameSliceEncoders.push_back( pcSliceEncoder );
+    }
+    m_cFrameThreadPool.create( m_numFrameThreads - 1 );
+  }
 }
 
 Void TEncTop::destroy ()
@@ -161,6 +187,23 @@ Void TEncTop::destroy ()
   m_cLoopFilter.        destroy();
   m_cRateCtrl.          destroy();
   m_cSearch.            destroy();
+  m_cThreadPool.        destroy();
+  for ( Int threadIdx = 0; threadIdx < Int(m_ctuWorkers.size()); threadIdx++ )
+  {
+    m_ctuWorkers[threadIdx]->destroy();
+    delete m_ctuWorkers[threadIdx];
+  }
+  m_ctuWorkers.clear();
+  m_cFrameThreadPool.   destroy();
+  for ( Int threadIdx = 0; threadIdx < Int(m_frameSliceEncoders.size()); threadIdx++ )
+  {
+    m_frameSliceEncoders[threadIdx]->destroy();
+    delete m_frameSliceEncoders[threadIdx];
+    m_frameWorkers[threadIdx]->destroy();
+    delete m_frameWorkers[threadIdx];
+  }
+  m_frameSliceEncoders.clear();
+  m_frameWorkers.clear();
   Int iDepth;
   for ( iDepth = 0; iDepth < m_maxTotalCUDepth+1; iDepth++ )
   {
@@ -235,6 +278,19 @@ Void TEncTop::init(Bool isFieldCoding)
 
   // initialize encoder search class
   m_cSearch.init( this, &m_cTrQuant, m_iSearchRange, m_bipredSearchRange, m_motionEstimationSearchMethod, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth, &m_cEntropyCoder, &m_cRdCost, getRDSbacCoder(), getRDGoOnSbacCoder() );
+  m_cHierarchicalME.init( m_hierarchicalMESearchRange );
+
+  // initialize the CTU compression tools of the worker threads in the same way
+  for ( Int threadIdx = 0; threadIdx < Int(m_ctuWorkers.size()); threadIdx++ )
+  {
+    m_ctuWorkers[threadIdx]->init( this, sps0 );
+  }
+  for ( Int threadIdx = 0; threadIdx < Int(m_frameSliceEncoders.size()); threadIdx++ )
+  {
+    m_frameWorkers[threadIdx]->init( this, sps0 );
+    m_frameSliceEncoders[threadIdx]->init( this, m_frameWorkers[threadIdx] );
+    m_frameWorkers[threadIdx]->getCuEncoder()->setSliceEncoder( m_frameSliceEncoders[threadIdx] );
+  }
 
   m_iMaxRefPicNum = 0;
 }
@@ -361,6 +417,10 @@ Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvT
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
     }
+    if ( getUseHierarchicalME() )
+    {
+      m_cHierarchicalME.buildPyramid( dynamic_cast<TEncPic*>( pcPicCurr ) );
+    }
   }
 
   if ((m_iNumPicRcvd == 0) || (!flush && (m_iPOCLast != 0) && (m_iNumPicRcvd != m_iGOPSize) && (m_iGOPSize != 0)))
@@ -474,6 +534,10 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTr
       {
         m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcField ) );
       }
+      if ( getUseHierarchicalME() )
+      {
+        m_cHierarchicalME.buildPyramid( dynamic_cast<TEncPic*>( pcField ) );
+      }
     }
 
     if ( m_iNumPicRcvd && ((flush&&fieldNum==1) || (m_iPOCLast/2)==0 || m_iNumPicRcvd==m_iGOPSize ) )
@@ -548,20 +612,23 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic, Int ppsId )
 
   if (rpcPic==0)
   {
-    if ( getUseAdaptiveQP() )
+    if ( getUseAdaptiveQP() || getUseHierarchicalME() || getSubpelPlanes() > 0 )
     {
+      // the encoder side information of the picture: adaptive QP layers, the hierarchical motion search pyramid and the
+      // interpolated reference planes
+      const UInt uiMaxAQDepth = getUseAdaptiveQP() ? pps.getMaxCuDQPDepth() + 1 : 0;
       TEncPic* pcEPic = new TEncPic;
 #if REDUCED_ENCODER_MEMORY
 #if SHUTTER_INTERVAL_SEI_PROCESSING
-      pcEPic->create( sps, pps, pps.getMaxCuDQPDepth() + 1, getShutterFilterFlag() );
+      pcEPic->create( sps, pps, uiMaxAQDepth, getShutterFilterFlag() );
 #else
-      pcEPic->create( sps, pps, pps.getMaxCuDQPDepth()+1);
+      pcEPic->create( sps, pps, uiMaxAQDepth );
 #endif
 #else
 #if SHUTTER_INTERVAL_SEI_PROCESSING
-      pcEPic->create(sps, pps, pps.getMaxCuDQPDepth() + 1, false, getShutterFilterFlag() );
+      pcEPic->create(sps, pps, uiMaxAQDepth, false, getShutterFilterFlag() );
 #else
-      pcEPic->create( sps, pps, pps.getMaxCuDQPDepth()+1, false);
+      pcEPic->create( sps, pps, uiMaxAQDepth, false);
 #endif
 #endif
       rpcPic = pcEPic;
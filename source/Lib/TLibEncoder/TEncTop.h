@@ -44,6 +44,7 @@
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComLoopFilter.h"
 #include "TLibCommon/AccessUnit.h"
+#include "TLibCommon/TComThreadPool.h"
 
 #include "Utilities/TVideoIOYuv.h"
 
@@ -56,7 +57,9 @@
 #include "TEncSearch.h"
 #include "TEncSampleAdaptiveOffset.h"
 #include "TEncPreanalyzer.h"
+#include "TEncHierarchicalME.h"
 #include "TEncRateCtrl.h"
+#include "TEncCtuWorker.h"
 //! \ingroup TLibEncoder
 //! \{
 
@@ -109,8 +112,18 @@ private:
   // quality control
   TEncPreanalyzer         m_cPreanalyzer;                 ///< image characteristics analyzer for TM5-step3-like adaptive QP
 
+  // motion analysis
+  TEncHierarchicalME      m_cHierarchicalME;              ///< coarse motion search on subsampled original pictures
+
   TEncRateCtrl            m_cRateCtrl;                    ///< Rate control class
 
+  // parallel processing
+  TComThreadPool          m_cThreadPool;                  ///< threads compressing CTUs concurrently
+  std::vector<TEncCtuWorker*> m_ctuWorkers;               ///< CTU compression tools, one set per thread
+  TComThreadPool          m_cFrameThreadPool;             ///< threads compressing pictures concurrently
+  std::vector<TEncSlice*> m_frameSliceEncoders;           ///< slice encoders compressing pictures concurrently with m_cSliceEncoder
+  std::vector<TEncCtuWorker*> m_frameWorkers;             ///< compression tools of the slice encoders above
+
 protected:
   Void  xGetNewPicBuffer  ( TComPic*& rpcPic, Int ppsId ); ///< get picture buffer which will be processed. If ppsId<0, then the ppsMap will be queried for the first match.
   Void  xInitVPS          (TComVPS &vps, const TComSPS &sps); ///< initialize VPS from encoder options
@@ -153,6 +166,13 @@ public:
   TEncSbac***             getRDSbacCoder        () { return  m_pppcRDSbacCoder;       }
   TEncSbac*               getRDGoOnSbacCoder    () { return  &m_cRDGoOnSbacCoder;     }
   TEncRateCtrl*           getRateCtrl           () { return &m_cRateCtrl;             }
+  TEncHierarchicalME*     getHierarchicalME     () { return &m_cHierarchicalME;       }
+  TComThreadPool*         getThreadPool         () { return &m_cThreadPool;           }
+  Int                     getNumCtuWorkers      () const { return Int(m_ctuWorkers.size()); }
+  TEncCtuWorker*          getCtuWorker          ( Int idx ) { return m_ctuWorkers[idx]; }
+  TComThreadPool*         getFrameThreadPool    () { return &m_cFrameThreadPool;      }
+  Int                     getNumFrameSliceEncoders() const { return Int(m_frameSliceEncoders.size()); }
+  TEncSlice*              getFrameSliceEncoder  ( Int idx ) { return m_frameSliceEncoders[idx]; }
   Void selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid );
   Int getReferencePictureSetIdxForSOP(Int POCCurr, Int GOPid );
 
@@ -0,0 +1,255 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2022, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncTemporalFilterX86.h
+    \brief    SIMD motion error kernel for TEncTemporalFilter
+
+    Included by one translation unit per vector extension (x86/sse41, x86/avx2), each compiled with the
+    matching instruction set. The kernel returns exactly the value of TEncTemporalFilter::xMotionErrorLuma().
+    Pel is Short and sample values have at most 12 bits, so sample differences fit 16-bit lanes. The
+    horizontal filter sums are formed by _mm_madd_epi16 on interleaved pairs of taps and the vertical
+    filter works on the 32-bit intermediate values, both of which are exact.
+*/
+
+#include "TLibCommon/x86/CommonDefX86.h"
+#include "../TEncTemporalFilter.h"
+
+#if ENABLE_SIMD_OPT_MCTF
+#ifdef SIMDX86
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Helpers
+// ====================================================================================================================
+
+static inline Int xSumLanes32( const __m128i vsum32 )
+{
+  __m128i vsum = _mm_add_epi32( vsum32, _mm_shuffle_epi32( vsum32, 0x4e ) );
+  vsum = _mm_add_epi32( vsum, _mm_shuffle_epi32( vsum, 0xb1 ) );
+  return _mm_cvtsi128_si32( vsum );
+}
+
+/// the taps c0 and c1 interleaved, as needed for _mm_madd_epi16 with interleaved samples
+static inline __m128i xTapPair( const Int c0, const Int c1 )
+{
+  return _mm_setr_epi16( Short( c0 ), Short( c1 ), Short( c0 ), Short( c1 ), Short( c0 ), Short( c1 ), Short( c0 ), Short( c1 ) );
+}
+
+/// horizontal filter, taps 1 to 6, of one row of width bs starting 3 samples left of the block
+static inline Void xFilterRowHor( const Pel *rowStart, const Int bs, const __m128i vTaps[3], Int *dst )
+{
+  for( Int x1 = 0; x1 < bs; x1 += 8 )
+  {
+    const Pel    *src = rowStart + x1;
+    const __m128i v1  = _mm_loadu_si128( ( const __m128i* ) &src[1] );
+    const __m128i v2  = _mm_loadu_si128( ( const __m128i* ) &src[2] );
+    const __m128i v3  = _mm_loadu_si128( ( const __m128i* ) &src[3] );
+    const __m128i v4  = _mm_loadu_si128( ( const __m128i* ) &src[4] );
+    const __m128i v5  = _mm_loadu_si128( ( const __m128i* ) &src[5] );
+    const __m128i v6  = _mm_loadu_si128( ( const __m128i* ) &src[6] );
+    __m128i vlo = _mm_madd_epi16( _mm_unpacklo_epi16( v1, v2 ), vTaps[0] );
+    vlo = _mm_add_epi32( vlo, _mm_madd_epi16( _mm_unpacklo_epi16( v3, v4 ), vTaps[1] ) );
+    vlo = _mm_add_epi32( vlo, _mm_madd_epi16( _mm_unpacklo_epi16( v5, v6 ), vTaps[2] ) );
+    __m128i vhi = _mm_madd_epi16( _mm_unpackhi_epi16( v1, v2 ), vTaps[0] );
+    vhi = _mm_add_epi32( vhi, _mm_madd_epi16( _mm_unpackhi_epi16( v3, v4 ), vTaps[1] ) );
+    vhi = _mm_add_epi32( vhi, _mm_madd_epi16( _mm_unpackhi_epi16( v5, v6 ), vTaps[2] ) );
+    _mm_storeu_si128( ( __m128i* ) &dst[x1],     vlo );
+    _mm_storeu_si128( ( __m128i* ) &dst[x1 + 4], vhi );
+  }
+}
+
+#ifdef USE_AVX2
+/// xFilterRowHor() of two consecutive rows, one per 128-bit lane
+static inline Void xFilterTwoRowsHor( const Pel *rowStart, const Int stride, const Int bs, const __m256i vTaps[3], Int *dst, Int *dstNext )
+{
+  for( Int x1 = 0; x1 < bs; x1 += 8 )
+  {
+    const Pel *src = rowStart + x1;
+    __m256i    v[6];
+    for( Int k = 0; k < 6; k++ )
+    {
+      v[k] = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( ( const __m128i* ) &src[k + 1] ) ), _mm_loadu_si128( ( const __m128i* ) &src[stride + k + 1] ), 1 );
+    }
+    // columns 0-3 and 4-7 of both rows
+    __m256i vlo = _mm256_madd_epi16( _mm256_unpacklo_epi16( v[0], v[1] ), vTaps[0] );
+    vlo = _mm256_add_epi32( vlo, _mm256_madd_epi16( _mm256_unpacklo_epi16( v[2], v[3] ), vTaps[1] ) );
+    vlo = _mm256_add_epi32( vlo, _mm256_madd_epi16( _mm256_unpacklo_epi16( v[4], v[5] ), vTaps[2] ) );
+    __m256i vhi = _mm256_madd_epi16( _mm256_unpackhi_epi16( v[0], v[1] ), vTaps[0] );
+    vhi = _mm256_add_epi32( vhi, _mm256_madd_epi16( _mm256_unpackhi_epi16( v[2], v[3] ), vTaps[1] ) );
+    vhi = _mm256_add_epi32( vhi, _mm256_madd_epi16( _mm256_unpackhi_epi16( v[4], v[5] ), vTaps[2] ) );
+    _mm256_storeu_si256( ( __m256i* ) &dst[x1],     _mm256_permute2x128_si256( vlo, vhi, 0x20 ) );
+    _mm256_storeu_si256( ( __m256i* ) &dstNext[x1], _mm256_permute2x128_si256( vlo, vhi, 0x31 ) );
+  }
+}
+#endif
+
+// ====================================================================================================================
+// Kernel
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Int TEncTemporalFilter::xMotionErrorLuma_SIMD( const Pel *org, Int orgStride, const Pel *buf, Int bufStride, Int bs, Int dxFrac, Int dyFrac, Int besterror, Int maxSampleValue )
+{
+  if( ( bs & 7 ) != 0 || bs > 64 )
+  {
+    return xMotionErrorLuma( org, orgStride, buf, bufStride, bs, dxFrac, dyFrac, besterror, maxSampleValue );
+  }
+
+  Int error = 0;
+  if( ( dxFrac | dyFrac ) == 0 )
+  {
+    for( Int y1 = 0; y1 < bs; y1++, org += orgStride, buf += bufStride )
+    {
+      __m128i vsum = _mm_setzero_si128();
+      Int     x1   = 0;
+#ifdef USE_AVX2
+      if( vext >= AVX2 )
+      {
+        __m256i vsum256 = _mm256_setzero_si256();
+        for( ; x1 + 16 <= bs; x1 += 16 )
+        {
+          const __m256i vdiff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* ) &org[x1] ), _mm256_loadu_si256( ( const __m256i* ) &buf[x1] ) );
+          vsum256 = _mm256_add_epi32( vsum256, _mm256_madd_epi16( vdiff, vdiff ) );
+        }
+        vsum = _mm_add_epi32( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) );
+      }
+#endif
+      for( ; x1 < bs; x1 += 8 )
+      {
+        const __m128i vdiff = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* ) &org[x1] ), _mm_loadu_si128( ( const __m128i* ) &buf[x1] ) );
+        vsum = _mm_add_epi32( vsum, _mm_madd_epi16( vdiff, vdiff ) );
+      }
+      error += xSumLanes32( vsum );
+      if( error > besterror )
+      {
+        return error;
+      }
+    }
+    return error;
+  }
+
+  const Int *xFilter = s_interpolationFilter[dxFrac];
+  const Int *yFilter = s_interpolationFilter[dyFrac];
+  Int tempArray[64 + 8][64];
+
+  // horizontal filter of the rows 1 to bs + 6 (row r is sample row r - 3). The rows are filtered when the vertical filter
+  // first needs them, so that no row is filtered for a candidate that is discarded early.
+  const __m128i vTaps[3] = { xTapPair( xFilter[1], xFilter[2] ), xTapPair( xFilter[3], xFilter[4] ), xTapPair( xFilter[5], xFilter[6] ) };
+#ifdef USE_AVX2
+  const __m256i vTaps256[3] = { _mm256_broadcastsi128_si256( vTaps[0] ), _mm256_broadcastsi128_si256( vTaps[1] ), _mm256_broadcastsi128_si256( vTaps[2] ) };
+#endif
+  const Pel *rowStart     = buf - 2 * bufStride - 3;  // sample row of tempArray[1]
+  Int        numRowsHor   = 0;
+
+  // vertical filter, rounding, clipping and squared error against the original
+  for( Int y1 = 0; y1 < bs; y1++, org += orgStride )
+  {
+    while( numRowsHor < y1 + 6 )
+    {
+#ifdef USE_AVX2
+      if( vext >= AVX2 )
+      {
+        // bs + 6 is even
+        xFilterTwoRowsHor( rowStart + numRowsHor * bufStride, bufStride, bs, vTaps256, tempArray[numRowsHor + 1], tempArray[numRowsHor + 2] );
+        numRowsHor += 2;
+        continue;
+      }
+#endif
+      xFilterRowHor( rowStart + numRowsHor * bufStride, bs, vTaps, tempArray[numRowsHor + 1] );
+      numRowsHor++;
+    }
+
+    __m128i vsum = _mm_setzero_si128();
+    Int     x1   = 0;
+#ifdef USE_AVX2
+    if( vext >= AVX2 )
+    {
+      const __m256i vOffset = _mm256_set1_epi32( 1 << 11 );
+      const __m256i vMax    = _mm256_set1_epi32( maxSampleValue );
+      __m256i       vsum256 = _mm256_setzero_si256();
+      for( ; x1 + 8 <= bs; x1 += 8 )
+      {
+        __m256i v = _mm256_mullo_epi32( _mm256_loadu_si256( ( const __m256i* ) &tempArray[y1 + 1][x1] ), _mm256_set1_epi32( yFilter[1] ) );
+        for( Int k = 2; k <= 6; k++ )
+        {
+          v = _mm256_add_epi32( v, _mm256_mullo_epi32( _mm256_loadu_si256( ( const __m256i* ) &tempArray[y1 + k][x1] ), _mm256_set1_epi32( yFilter[k] ) ) );
+        }
+        v = _mm256_srai_epi32( _mm256_add_epi32( v, vOffset ), 12 );
+        v = _mm256_min_epi32( _mm256_max_epi32( v, _mm256_setzero_si256() ), vMax );
+        const __m256i vdiff = _mm256_sub_epi32( v, _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* ) &org[x1] ) ) );
+        vsum256 = _mm256_add_epi32( vsum256, _mm256_mullo_epi32( vdiff, vdiff ) );
+      }
+      vsum = _mm_add_epi32( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) );
+    }
+#endif
+    const __m128i vOffset = _mm_set1_epi32( 1 << 11 );
+    const __m128i vMax    = _mm_set1_epi32( maxSampleValue );
+    for( ; x1 < bs; x1 += 4 )
+    {
+      __m128i v = _mm_mullo_epi32( _mm_loadu_si128( ( const __m128i* ) &tempArray[y1 + 1][x1] ), _mm_set1_epi32( yFilter[1] ) );
+      for( Int k = 2; k <= 6; k++ )
+      {
+        v = _mm_add_epi32( v, _mm_mullo_epi32( _mm_loadu_si128( ( const __m128i* ) &tempArray[y1 + k][x1] ), _mm_set1_epi32( yFilter[k] ) ) );
+      }
+      v = _mm_srai_epi32( _mm_add_epi32( v, vOffset ), 12 );
+      v = _mm_min_epi32( _mm_max_epi32( v, _mm_setzero_si128() ), vMax );
+      const __m128i vdiff = _mm_sub_epi32( v, _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &org[x1] ) ) );
+      vsum = _mm_add_epi32( vsum, _mm_mullo_epi32( vdiff, vdiff ) );
+    }
+    error += xSumLanes32( vsum );
+    if( error > besterror )
+    {
+      return error;
+    }
+  }
+  return error;
+}
+
+// ====================================================================================================================
+// Registration
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TEncTemporalFilter::xInitTemporalFilterX86()
+{
+  m_motionErrorLuma = xMotionErrorLuma_SIMD<vext>;
+}
+
+template Void TEncTemporalFilter::xInitTemporalFilterX86<SIMDX86>();
+
+//! \}
+
+#endif // SIMDX86
+#endif // ENABLE_SIMD_OPT_MCTF